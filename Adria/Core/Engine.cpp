@@ -14,6 +14,7 @@
 #include "Utilities/Random.h"
 #include "Utilities/Timer.h"
 #include "Utilities/StringUtil.h"
+#include "Utilities/FileWatcher.h"
 #include "Editor/EditorEvents.h"
 
 
@@ -36,6 +37,14 @@ namespace adria
 		input_events.f6_pressed_event.AddMember(&Renderer::OnTakeScreenshot, *renderer);
 		input_events.f5_pressed_event.AddStatic(ShaderManager::CheckIfShadersHaveChanged);
 
+		asset_watcher = std::make_unique<FileWatcher>();
+		for (std::string const& asset_dir : { paths::ScenesDir, paths::TexturesDir })
+		{
+			if (std::filesystem::exists(asset_dir)) asset_watcher->AddPathToWatch(asset_dir);
+		}
+		asset_watcher->GetFilesModifiedEvent().AddMember(&Engine::OnAssetFilesChanged, *this);
+		current_scene_file = paths::ScenesDir + scene_file;
+
 		SceneConfig scene_config{};
 		if (ParseSceneConfig(scene_file, scene_config))
 		{
@@ -54,6 +63,7 @@ namespace adria
 
 	Engine::~Engine()
 	{
+		asset_watcher = nullptr;
 		g_TextureManager.Destroy();
 		ShaderManager::Destroy();
 		GfxShaderCompiler::Destroy();
@@ -90,10 +100,33 @@ namespace adria
 		}
 	}
 
+	void Engine::OnAssetFilesChanged(std::span<std::string const> files)
+	{
+		Bool gpu_idle = false;
+		for (std::string const& file : files)
+		{
+			std::error_code error;
+			if (std::filesystem::equivalent(file, current_scene_file, error))
+			{
+				SceneConfig scene_config{};
+				if (ParseSceneConfig(file, scene_config, false)) NewSceneRequest(file, scene_config);
+				continue;
+			}
+			if (!gpu_idle)
+			{
+				gfx->WaitForGPU();
+				gpu_idle = true;
+			}
+			g_TextureManager.ReloadTexture(file);
+		}
+	}
+
 	void Engine::Update(Float dt)
 	{
 		ZoneScopedN("Engine::Update");
+		if (asset_watcher->HasPendingChanges()) asset_watcher->CheckWatchedFiles();
 		HandleSceneRequest();
+		g_TextureManager.Update();
 		camera->Update(dt);
 		renderer->NewFrame(camera.get());
 		renderer->Update(dt);
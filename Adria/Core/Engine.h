@@ -14,6 +14,7 @@ namespace adria
 	struct EditorEvents;
 	class ImGuiManager;
 	class Camera;
+	class FileWatcher;
 
 	class Engine
 	{
@@ -39,16 +40,20 @@ namespace adria
 		std::unique_ptr<SceneLoader> scene_loader;
 		ViewportData viewport_data;
 		std::optional<SceneConfig> scene_request;
+		std::string current_scene_file;
+		std::unique_ptr<FileWatcher> asset_watcher;
 
 	private:
 		void InitializeScene(SceneConfig const&);
 		void ProcessCVarIniFile(std::string const&);
 
-		void NewSceneRequest(SceneConfig const& scene_cfg)
+		void NewSceneRequest(std::string const& scene_file, SceneConfig const& scene_cfg)
 		{
+			current_scene_file = scene_file;
 			scene_request = scene_cfg;
 		}
 		void HandleSceneRequest();
+		void OnAssetFilesChanged(std::span<std::string const> files);
 
 		void Update(Float dt);
 		void Render();
@@ -3,56 +3,268 @@
 #include <ctime>   
 #include <vector>
 #include <thread>
-#include "Utilities/ConcurrentQueue.h"
+#include <atomic>
+#include <mutex>
+#include <semaphore>
+#include <cstdarg>
 
 namespace adria
 {
-	struct QueueEntry
+	namespace
 	{
-		LogLevel level;
-		std::string str;
-		std::string filename;
-		Uint32 line;
-	};
+		using LogClock = std::chrono::steady_clock;
+
+		constexpr Uint64 LogRingCapacity = 1024;
+		constexpr Uint64 LogBatchSize = 64;
+		constexpr Uint64 LogMessageSize = 512;
+		static_assert((LogRingCapacity & (LogRingCapacity - 1)) == 0, "Log ring capacity has to be a power of two");
+
+		struct LogRecord
+		{
+			LogLevel level;
+			Uint32 line;
+			Char const* file;
+			Char* long_message;		//heap copy of messages that don't fit inline, owned by the record
+			Char message[LogMessageSize];
+
+			Char const* GetText() const { return long_message ? long_message : message; }
+		};
+
+		//bounded multi producer single consumer ring, producers reserve a slot, write the record in place and publish it
+		class LogRecordRing
+		{
+			struct Slot
+			{
+				std::atomic<Uint64> sequence;
+				LogRecord record;
+			};
+
+		public:
+			LogRecordRing() : slots(std::make_unique<Slot[]>(LogRingCapacity))
+			{
+				for (Uint64 i = 0; i < LogRingCapacity; ++i) slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+
+			//yields while the ring is full
+			LogRecord& BeginPush(Uint64& position)
+			{
+				position = enqueue_position.load(std::memory_order_relaxed);
+				while (true)
+				{
+					Slot& slot = slots[position & (LogRingCapacity - 1)];
+					Int64 const diff = (Int64)slot.sequence.load(std::memory_order_acquire) - (Int64)position;
+					if (diff == 0)
+					{
+						if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) return slot.record;
+					}
+					else
+					{
+						if (diff < 0) std::this_thread::yield();
+						position = enqueue_position.load(std::memory_order_relaxed);
+					}
+				}
+			}
+			void EndPush(Uint64 position)
+			{
+				slots[position & (LogRingCapacity - 1)].sequence.store(position + 1, std::memory_order_release);
+			}
+
+			LogRecord* Front()
+			{
+				Slot& slot = slots[dequeue_position & (LogRingCapacity - 1)];
+				return slot.sequence.load(std::memory_order_acquire) == dequeue_position + 1 ? &slot.record : nullptr;
+			}
+			void Pop()
+			{
+				slots[dequeue_position & (LogRingCapacity - 1)].sequence.store(dequeue_position + LogRingCapacity, std::memory_order_release);
+				++dequeue_position;
+			}
+
+		private:
+			std::unique_ptr<Slot[]> slots;
+			alignas(64) std::atomic<Uint64> enqueue_position = 0;
+			alignas(64) Uint64 dequeue_position = 0;
+		};
+	}
 
 	class LogManagerImpl
 	{
+		struct RegisteredLogger
+		{
+			std::unique_ptr<ILogger> logger;
+			Uint64 flush_interval_ms;
+			LogClock::time_point last_flush;
+			Bool flush_pending = false;
+
+			LogClock::time_point GetFlushTime() const
+			{
+				return last_flush + std::chrono::milliseconds(flush_interval_ms);
+			}
+		};
+
 	public:
 
 		LogManagerImpl() : log_thread(&LogManagerImpl::ProcessLogs, this) {}
 		~LogManagerImpl()
 		{
 			exit.store(true);
+			Wake();
 			log_thread.join();
 		}
 
 		void RegisterLogger(ILogger* logger)
 		{
-			loggers.emplace_back(logger);
+			std::lock_guard<std::mutex> lock(loggers_mutex);
+			loggers.push_back(RegisteredLogger{ .logger = std::unique_ptr<ILogger>(logger), .flush_interval_ms = logger ? logger->GetFlushIntervalMs() : ILogger::NeverFlush });
 		}
 		void Log(LogLevel level, Char const* str, Char const* filename, Uint32 line)
 		{
-			log_queue.Push(QueueEntry{ level, str, filename, line });
+			Uint64 position;
+			LogRecord& record = BeginRecord(position, level, filename, line);
+			Uint64 const length = strlen(str);
+			if (length < LogMessageSize)
+			{
+				memcpy(record.message, str, length + 1);
+			}
+			else
+			{
+				record.long_message = AllocateLongMessage(record, length);
+				memcpy(record.long_message ? record.long_message : record.message, str, record.long_message ? length : LogMessageSize - 1);
+			}
+			EndRecord(position);
+		}
+		void LogFormat(LogLevel level, Char const* filename, Uint32 line, Char const* format, va_list args)
+		{
+			Uint64 position;
+			LogRecord& record = BeginRecord(position, level, filename, line);
+			va_list args_copy;
+			va_copy(args_copy, args);
+			Int const length = vsnprintf(record.message, LogMessageSize, format, args);
+			if (length >= (Int)LogMessageSize)
+			{
+				record.long_message = AllocateLongMessage(record, length);
+				if (record.long_message) vsnprintf(record.long_message, length + 1, format, args_copy);
+			}
+			va_end(args_copy);
+			EndRecord(position);
 		}
 
-		std::vector<std::unique_ptr<ILogger>> loggers;
-		ConcurrentQueue<QueueEntry> log_queue;
-		std::thread log_thread;
+	private:
+		std::vector<RegisteredLogger> loggers;
+		std::mutex loggers_mutex;
+		LogRecordRing log_ring;
+		std::binary_semaphore wake_semaphore{ 0 };
+		std::atomic_bool log_thread_sleeping = false;
 		std::atomic_bool exit = false;
+		std::thread log_thread;
 
 	private:
+		LogRecord& BeginRecord(Uint64& position, LogLevel level, Char const* filename, Uint32 line)
+		{
+			LogRecord& record = log_ring.BeginPush(position);
+			record.level = level;
+			record.line = line;
+			record.file = filename;
+			record.long_message = nullptr;
+			record.message[0] = '\0';
+			record.message[LogMessageSize - 1] = '\0';
+			return record;
+		}
+		void EndRecord(Uint64 position)
+		{
+			log_ring.EndPush(position);
+			Wake();
+		}
+		//only the producer that finds the log thread asleep releases the semaphore, the others get away with a fence and a load
+		void Wake()
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (log_thread_sleeping.load(std::memory_order_relaxed) && log_thread_sleeping.exchange(false)) wake_semaphore.release();
+		}
+
+		//the record stays readable with a truncated message if the allocation fails
+		static Char* AllocateLongMessage(LogRecord& record, Uint64 length)
+		{
+			Char* long_message = new(std::nothrow) Char[length + 1];
+			if (long_message) long_message[length] = '\0';
+			return long_message;
+		}
+
 		void ProcessLogs()
 		{
-			QueueEntry entry{};
 			while (true)
 			{
-				Bool success = log_queue.TryPop(entry);
-				if (success)
+				Uint64 const drained_count = DrainBatch();
+				LogClock::time_point const flush_time = FlushLoggers(LogClock::now());
+				if (drained_count > 0) continue;
+				if (exit.load() && !log_ring.Front()) break;
+				WaitForRecords(flush_time);
+			}
+			FlushLoggers(LogClock::time_point::max());
+		}
+
+		//sleeps until a record is pushed, the manager is destroyed or the next logger flush is due
+		void WaitForRecords(LogClock::time_point flush_time)
+		{
+			log_thread_sleeping.store(true);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!log_ring.Front() && !exit.load())
+			{
+				if (flush_time == LogClock::time_point::max())
+				{
+					wake_semaphore.acquire();
+					return;
+				}
+				if (wake_semaphore.try_acquire_until(flush_time)) return;
+			}
+			//a producer that cleared the flag first releases the semaphore right after, take that release so the next wait doesn't return early
+			if (!log_thread_sleeping.exchange(false)) wake_semaphore.acquire();
+		}
+
+		//flushes the loggers whose flush interval has passed since their last flush and that logged something since, returns when the next one is due
+		LogClock::time_point FlushLoggers(LogClock::time_point now)
+		{
+			std::lock_guard<std::mutex> lock(loggers_mutex);
+			LogClock::time_point next_flush_time = LogClock::time_point::max();
+			for (RegisteredLogger& registered_logger : loggers)
+			{
+				if (!registered_logger.flush_pending) continue;
+				LogClock::time_point const flush_time = registered_logger.GetFlushTime();
+				if (flush_time <= now)
 				{
-					for (auto&& logger : loggers) if (logger) logger->Log(entry.level, entry.str.c_str(), entry.filename.c_str(), entry.line);
+					registered_logger.logger->Flush();
+					registered_logger.flush_pending = false;
+					registered_logger.last_flush = LogClock::now();
+				}
+				else
+				{
+					next_flush_time = std::min(next_flush_time, flush_time);
 				}
-				if (exit.load() && log_queue.Empty()) break;
 			}
+			return next_flush_time;
+		}
+
+		Uint64 DrainBatch()
+		{
+			std::lock_guard<std::mutex> lock(loggers_mutex);
+			Uint64 count = 0;
+			for (; count < LogBatchSize; ++count)
+			{
+				LogRecord* record = log_ring.Front();
+				if (!record) break;
+
+				for (RegisteredLogger const& registered_logger : loggers)
+				{
+					if (registered_logger.logger) registered_logger.logger->Log(record->level, record->GetText(), record->file, record->line);
+				}
+				delete[] record->long_message;
+				log_ring.Pop();
+			}
+			if (count > 0)
+			{
+				for (RegisteredLogger& registered_logger : loggers) registered_logger.flush_pending |= registered_logger.flush_interval_ms != ILogger::NeverFlush;
+			}
+			return count;
 		}
 	};
 
@@ -100,4 +312,11 @@ namespace adria
 	{
 		Log(level, str, location.file_name(), location.line());
 	}
+	void LogManager::LogFormat(LogLevel level, Char const* file, Uint32 line, Char const* format, ...)
+	{
+		va_list args;
+		va_start(args, format);
+		pimpl->LogFormat(level, file, line, format, args);
+		va_end(args);
+	}
 }
\ No newline at end of file
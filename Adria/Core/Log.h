@@ -14,6 +14,16 @@ namespace adria
 		LOG_ERROR
 	};
 
+	//logs below this level are compiled out, define ADRIA_MIN_LOG_LEVEL to override it
+#if !defined(ADRIA_MIN_LOG_LEVEL)
+#if defined(_DEBUG)
+#define ADRIA_MIN_LOG_LEVEL LOG_DEBUG
+#else
+#define ADRIA_MIN_LOG_LEVEL LOG_INFO
+#endif
+#endif
+	inline constexpr LogLevel MinLogLevel = LogLevel::ADRIA_MIN_LOG_LEVEL;
+
 	std::string LevelToString(LogLevel type);
 	std::string GetLogTime();
 	std::string LineInfoToString(Char const* file, Uint32 line);
@@ -21,8 +31,14 @@ namespace adria
 	class ILogger
 	{
 	public:
+		static constexpr Uint64 NeverFlush = Uint64(-1);
+
 		virtual ~ILogger() = default;
 		virtual void Log(LogLevel level, Char const* entry, Char const* file, Uint32 line) = 0;
+		//called on the log thread once the flush interval has passed since the last call and entries were logged since, loggers that buffer output write it out here
+		virtual void Flush() {}
+		//queried once on registration, loggers that don't buffer output are never flushed
+		virtual Uint64 GetFlushIntervalMs() const { return NeverFlush; }
 	};
 
 	class LogManager
@@ -33,8 +49,10 @@ namespace adria
 		~LogManager();
 
 		void Register(ILogger* logger);
+		//file has to have static storage duration, e.g. __FILE__
 		void Log(LogLevel level, Char const* str, Char const* file, Uint32 line);
 		void Log(LogLevel level, Char const* str, std::source_location location = std::source_location::current());
+		void LogFormat(LogLevel level, Char const* file, Uint32 line, Char const* format, ...);
 
 	private:
 		std::unique_ptr<class LogManagerImpl> pimpl;
@@ -43,10 +61,10 @@ namespace adria
 
 	#define ADRIA_LOG(level, ... ) [&]()  \
 	{ \
-		Uint64 const size = snprintf(nullptr, 0, __VA_ARGS__) + 1; \
-		std::unique_ptr<Char[]> buf = std::make_unique<Char[]>(size); \
-		snprintf(buf.get(), size, __VA_ARGS__); \
-		g_Log.Log(LogLevel::LOG_##level, buf.get(), __FILE__, __LINE__);  \
+		if constexpr (LogLevel::LOG_##level >= MinLogLevel) \
+		{ \
+			g_Log.LogFormat(LogLevel::LOG_##level, __FILE__, __LINE__, __VA_ARGS__);  \
+		} \
 	}()
 	#define ADRIA_DEBUG(...)	ADRIA_LOG(DEBUG, __VA_ARGS__)
 	#define ADRIA_INFO(...)		ADRIA_LOG(INFO, __VA_ARGS__)
@@ -1,23 +1,92 @@
+#include <format>
+#include <chrono>
+#include <filesystem>
 #include "FileLogger.h"
 #include "Core/Paths.h"
 
+namespace fs = std::filesystem;
+
 namespace adria
 {
+	namespace
+	{
+		std::string GetRotatedLogPath(std::string const& log_path, Uint32 index)
+		{
+			fs::path path(log_path);
+			return (path.parent_path() / std::format("{}.{}{}", path.stem().string(), index, path.extension().string())).string();
+		}
+	}
 
-	FileLogger::FileLogger(Char const* log_file, LogLevel logger_level) 
-		: log_stream{ paths::LogDir + log_file, std::ios::out }, logger_level{ logger_level }
-	{}
+	FileLogger::FileLogger(Char const* log_file, LogLevel logger_level, FileLoggerDesc const& desc)
+		: log_path{ paths::LogDir + log_file }, log_stream{ log_path, std::ios::out | std::ios::binary }, logger_level{ logger_level }, desc{ desc }
+	{
+		buffer.reserve(desc.buffer_size);
+	}
 
 	FileLogger::~FileLogger()
 	{
+		Flush();
 		log_stream.close();
 	}
 
 	void FileLogger::Log(LogLevel level, Char const* entry, Char const* file, uint32_t line)
 	{
 		if (level < logger_level) return;
-		log_stream << GetLogTime() + LineInfoToString(file, line) + LevelToString(level) + std::string(entry) << "\n";
+
+		auto const now = std::chrono::system_clock::now();
+		std::format_to(std::back_inserter(buffer), "{}[File: {}  Line: {}]{}{}\n", GetTimestamp(std::chrono::system_clock::to_time_t(now)), file, line, LevelToString(level), entry);
+
+		//the log thread calls Flush every flush_interval_ms while entries are logged
+		if (buffer.size() >= desc.buffer_size || level >= LogLevel::LOG_ERROR)
+		{
+			Flush();
+		}
 	}
 
-}
+	std::string const& FileLogger::GetTimestamp(std::time_t time)
+	{
+		if (time != timestamp_time || timestamp.empty())
+		{
+			std::tm local_time{};
+			localtime_s(&local_time, &time);
+			Char time_str[64];
+			std::strftime(time_str, sizeof(time_str), "[%a %b %d %H:%M:%S %Y]", &local_time);
+			timestamp = time_str;
+			timestamp_time = time;
+		}
+		return timestamp;
+	}
 
+	void FileLogger::Flush()
+	{
+		if (buffer.empty()) return;
+		if (desc.max_file_size > 0 && file_size > 0 && file_size + buffer.size() > desc.max_file_size) Rotate();
+
+		log_stream.write(buffer.data(), buffer.size());
+		log_stream.flush();
+		file_size += buffer.size();
+		buffer.clear();
+	}
+
+	void FileLogger::Rotate()
+	{
+		log_stream.close();
+		std::error_code ec;
+		if (desc.max_rotated_files == 0)
+		{
+			fs::remove(log_path, ec);
+		}
+		else
+		{
+			fs::remove(GetRotatedLogPath(log_path, desc.max_rotated_files), ec);
+			for (Uint32 i = desc.max_rotated_files - 1; i >= 1; --i)
+			{
+				fs::rename(GetRotatedLogPath(log_path, i), GetRotatedLogPath(log_path, i + 1), ec);
+			}
+			fs::rename(log_path, GetRotatedLogPath(log_path, 1), ec);
+		}
+		log_stream.open(log_path, std::ios::out | std::ios::binary | std::ios::trunc);
+		file_size = 0;
+	}
+
+}
@@ -1,17 +1,40 @@
 #pragma once
 #include <fstream>
+#include <ctime>
 
 namespace adria
 {
+	struct FileLoggerDesc
+	{
+		Uint64 buffer_size = 256 * 1024;
+		Uint64 flush_interval_ms = 1000;
+		Uint64 max_file_size = 64 * 1024 * 1024;
+		Uint32 max_rotated_files = 4;
+	};
+
 	class FileLogger : public ILogger
 	{
 	public:
-		FileLogger(Char const* log_file, LogLevel logger_level = LogLevel::LOG_DEBUG);
+		FileLogger(Char const* log_file, LogLevel logger_level = LogLevel::LOG_DEBUG, FileLoggerDesc const& desc = {});
 		virtual ~FileLogger() override;
 		virtual void Log(LogLevel level, Char const* entry, Char const* file, Uint32 line) override;
+		virtual void Flush() override;
+		virtual Uint64 GetFlushIntervalMs() const override { return desc.flush_interval_ms; }
 	private:
+		std::string log_path;
 		std::ofstream log_stream;
 		LogLevel const logger_level;
+		FileLoggerDesc const desc;
+
+		std::string buffer;
+		Uint64 file_size = 0;
+
+		std::time_t timestamp_time = 0;
+		std::string timestamp;
+
+	private:
+		std::string const& GetTimestamp(std::time_t time);
+		void Rotate();
 	};
 
-}
\ No newline at end of file
+}
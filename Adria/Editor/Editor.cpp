@@ -90,7 +90,7 @@ namespace adria
 
 		engine->Run();
 
-		if (reload_shaders)
+		if (reload_shaders || ShaderManager::HasPendingShaderChanges())
 		{
 			gfx->WaitForGPU();
 			ShaderManager::CheckIfShadersHaveChanged();
@@ -184,7 +184,7 @@ namespace adria
 						SceneConfig scene_config{};
 						if (ParseSceneConfig(file_path, scene_config, false))
 						{
-							engine->NewSceneRequest(scene_config);
+							engine->NewSceneRequest(file_path, scene_config);
 						}
 						free(file_path);
 					}
@@ -357,6 +357,12 @@ namespace adria
 				auto const& picking_data = engine->renderer->GetPickingData();
 				ImGui::Text("Picked Position: %f %f %f", picking_data.position.x, picking_data.position.y, picking_data.position.z);
 				ImGui::Text("Picked Normal: %f %f %f", picking_data.normal.x, picking_data.normal.y, picking_data.normal.z);
+				entt::entity const picked_mesh = engine->renderer->GetPickedMesh();
+				if (engine->reg.valid(picked_mesh) && engine->reg.all_of<Tag>(picked_mesh))
+				{
+					ImGui::Text("Picked Mesh: %s", engine->reg.get<Tag>(picked_mesh).name.c_str());
+					if (ImGui::Button("Select Picked Mesh")) selected_entity = picked_mesh;
+				}
 				if (ImGui::Button("Load Decal"))
 				{
 					params.position = Vector3(picking_data.position);
@@ -479,6 +485,7 @@ namespace adria
 						auto& tr = engine->reg.get<Transform>(selected_entity);
 						Vector3 translation(light->position.x, light->position.y, light->position.z);
 						tr.current_transform = Matrix::CreateTranslation(translation);
+						engine->reg.patch<Transform>(selected_entity);
 					}
 					ImGui::Checkbox("Active", &light->active);
 					if (light->active && changed)
@@ -523,6 +530,7 @@ namespace adria
 						ImGui::SliderFloat("Volumetric lighting Strength", &light->volumetric_strength, 0.0f, 0.1f);
 					}
 					ImGui::Checkbox("Lens Flare", &light->lens_flare);
+					engine->reg.patch<Light>(selected_entity);
 				}
 
 				auto material = engine->reg.try_get<Material>(selected_entity);
@@ -634,6 +642,7 @@ namespace adria
 					Matrix rotation_matrix = Matrix::CreateFromQuaternion(rotation);
 					Matrix translation_matrix = Matrix::CreateTranslation(translation);
 					transform->current_transform = translation_matrix * rotation_matrix * scale_matrix;
+					engine->reg.patch<Transform>(selected_entity);
 				}
 
 				auto decal = engine->reg.try_get<Decal>(selected_entity);
@@ -438,6 +438,78 @@ namespace adria
 		}
 	}
 
+	void GfxCommandList::BeginTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		TextureBarrier(texture, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+		else texture_barriers.back().SyncAfter = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
+	void GfxCommandList::EndTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		TextureBarrier(texture, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+		else texture_barriers.back().SyncBefore = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
+	void GfxCommandList::BeginBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		BufferBarrier(buffer, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+		else buffer_barriers.back().SyncAfter = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
+	void GfxCommandList::EndBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after)
+	{
+		ADRIA_ASSERT(flags_before != flags_after);
+		BufferBarrier(buffer, flags_before, flags_after);
+		if (use_legacy_barriers) legacy_barriers.back().Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+		else buffer_barriers.back().SyncBefore = D3D12_BARRIER_SYNC_SPLIT;
+	}
+
+	void GfxCommandList::AliasingBarrier(GfxTexture const& texture, GfxResourceState flags_after)
+	{
+		if (use_legacy_barriers)
+		{
+			D3D12_RESOURCE_BARRIER barrier{};
+			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+			barrier.Aliasing.pResourceBefore = nullptr;
+			barrier.Aliasing.pResourceAfter = texture.GetNative();
+			legacy_barriers.push_back(barrier);
+
+			//legacy barriers have no discard, activated render targets and depth stencils are discarded in their writable state instead
+			GfxResourceState initial_state = texture.GetDesc().initial_state;
+			GfxBindFlag const bind_flags = texture.GetDesc().bind_flags;
+			if (HasAnyFlag(bind_flags, GfxBindFlag::RenderTarget | GfxBindFlag::DepthStencil))
+			{
+				GfxResourceState const discard_state = HasFlag(bind_flags, GfxBindFlag::RenderTarget) ? GfxResourceState::RTV : GfxResourceState::DSV;
+				if (initial_state != discard_state) TextureBarrier(texture, initial_state, discard_state);
+				FlushBarriers();
+				cmd_list->DiscardResource(texture.GetNative(), nullptr);
+				++command_count;
+				initial_state = discard_state;
+			}
+			if (initial_state != flags_after) TextureBarrier(texture, initial_state, flags_after);
+		}
+		else
+		{
+			D3D12_TEXTURE_BARRIER barrier{};
+			barrier.SyncBefore = D3D12_BARRIER_SYNC_ALL;
+			barrier.SyncAfter = ToD3D12BarrierSync(flags_after);
+			barrier.AccessBefore = D3D12_BARRIER_ACCESS_NO_ACCESS;
+			barrier.AccessAfter = ToD3D12BarrierAccess(flags_after);
+			barrier.LayoutBefore = D3D12_BARRIER_LAYOUT_UNDEFINED;
+			barrier.LayoutAfter = ToD3D12BarrierLayout(flags_after);
+			barrier.pResource = texture.GetNative();
+			barrier.Subresources = CD3DX12_BARRIER_SUBRESOURCE_RANGE(D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+			barrier.Flags = D3D12_TEXTURE_BARRIER_FLAG_DISCARD;
+			texture_barriers.push_back(barrier);
+		}
+	}
+
 	void GfxCommandList::FlushBarriers()
 	{
 		if (use_legacy_barriers)
@@ -78,6 +78,11 @@ namespace adria
 		void TextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after, Uint32 subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
 		void BufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after);
 		void GlobalBarrier(GfxResourceState flags_before, GfxResourceState flags_after);
+		void AliasingBarrier(GfxTexture const& texture, GfxResourceState flags_after);
+		void BeginTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after);
+		void EndTextureBarrier(GfxTexture const& texture, GfxResourceState flags_before, GfxResourceState flags_after);
+		void BeginBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after);
+		void EndBufferBarrier(GfxBuffer const& buffer, GfxResourceState flags_before, GfxResourceState flags_after);
 		void FlushBarriers();
 
 		void CopyBuffer(GfxBuffer& dst, GfxBuffer const& src);
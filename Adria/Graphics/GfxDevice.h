@@ -69,11 +69,8 @@ namespace adria
 
 	class GfxNsightAftermathGpuCrashTracker;
 	class GfxNsightPerfManager;
-#if GFX_MULTITHREADED
+	//render graph passes can be recorded on worker threads, the render graph enables locking only then, see rg.Multithreaded
 	using GfxOnlineDescriptorAllocator = GfxRingDescriptorAllocator<true>;
-#else
-	using GfxOnlineDescriptorAllocator = GfxRingDescriptorAllocator<false>;
-#endif
 
 	struct GPUMemoryUsage
 	{
@@ -0,0 +1,40 @@
+#include "GfxHeap.h"
+#include "GfxDevice.h"
+
+namespace adria
+{
+	static constexpr D3D12_HEAP_FLAGS ToD3D12HeapFlags(GfxHeapUsage usage)
+	{
+		switch (usage)
+		{
+		case GfxHeapUsage::Buffers:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		case GfxHeapUsage::RenderTargetTextures:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+		case GfxHeapUsage::NonRenderTargetTextures:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		}
+		return D3D12_HEAP_FLAG_NONE;
+	}
+
+	GfxHeap::GfxHeap(GfxDevice* gfx, GfxHeapDesc const& desc) : gfx(gfx), desc(desc)
+	{
+		D3D12MA::ALLOCATION_DESC allocation_desc{};
+		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+		allocation_desc.ExtraHeapFlags = ToD3D12HeapFlags(desc.usage);
+
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info{};
+		allocation_info.SizeInBytes = desc.size;
+		allocation_info.Alignment = desc.alignment;
+
+		D3D12MA::Allocation* alloc = nullptr;
+		HRESULT hr = gfx->GetAllocator()->AllocateMemory(&allocation_desc, &allocation_info, &alloc);
+		GFX_CHECK_HR(hr);
+		allocation.reset(alloc);
+	}
+
+	GfxHeap::~GfxHeap()
+	{
+		gfx->AddToReleaseQueue(allocation.release());
+	}
+}
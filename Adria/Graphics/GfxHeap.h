@@ -0,0 +1,43 @@
+#pragma once
+#include "GfxResourceCommon.h"
+
+namespace adria
+{
+	class GfxDevice;
+
+	enum class GfxHeapUsage : Uint8
+	{
+		Buffers,
+		RenderTargetTextures,
+		NonRenderTargetTextures
+	};
+
+	struct GfxHeapDesc
+	{
+		Uint64 size = 0;
+		Uint64 alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+		GfxHeapUsage usage = GfxHeapUsage::NonRenderTargetTextures;
+	};
+
+	struct GfxAllocationInfo
+	{
+		Uint64 size = 0;
+		Uint64 alignment = 0;
+	};
+
+	class GfxHeap
+	{
+	public:
+		GfxHeap(GfxDevice* gfx, GfxHeapDesc const& desc);
+		ADRIA_NONCOPYABLE_NONMOVABLE(GfxHeap)
+		~GfxHeap();
+
+		GfxHeapDesc const& GetDesc() const { return desc; }
+		D3D12MA::Allocation* GetAllocation() const { return allocation.get(); }
+
+	private:
+		GfxDevice* gfx;
+		GfxHeapDesc desc;
+		ReleasablePtr<D3D12MA::Allocation> allocation = nullptr;
+	};
+}
@@ -3,7 +3,6 @@
 #define GFX_CHECK_HR(hr) if(FAILED(hr)) ADRIA_DEBUGBREAK();
 
 #define GFX_BACKBUFFER_COUNT 3
-#define GFX_MULTITHREADED 0
 #define GFX_SHADER_PRINTF 0
 #define GFX_ASYNC_COMPUTE 1
 #define USE_PIX
@@ -42,7 +42,7 @@ namespace adria
 			this);																// Set the GpuCrashTracker object as user data for the above callbacks.
 
 		std::filesystem::create_directory(paths::AftermathDir);
-		ShaderManager::GetShaderRecompiledEvent().AddMember(&GfxNsightAftermathGpuCrashTracker::OnShaderOrLibraryCompiled, *this);
+		ShaderManager::GetShaderCompiledEvent().AddMember(&GfxNsightAftermathGpuCrashTracker::OnShaderOrLibraryCompiled, *this);
 	}
 
 	GfxNsightAftermathGpuCrashTracker::~GfxNsightAftermathGpuCrashTracker()
@@ -1,3 +1,4 @@
+#include <mutex>
 #include "d3dx12_pipeline_state_stream.h"
 #include "GfxPipelineState.h"
 #include "GfxDevice.h"
@@ -323,6 +324,30 @@ namespace adria
 				element_descs[i] = desc;
 			}
 		}
+
+		//pipelines can be created while passes are recorded on worker threads (rg.Multithreaded),
+		//the event is only broadcast from the main thread between frames so adding and removing listeners is all that needs the lock
+		std::mutex shader_recompiled_event_mutex;
+
+		template<typename F>
+		auto UpdateShaderRecompiledListeners(F&& update)
+		{
+			std::lock_guard guard(shader_recompiled_event_mutex);
+			return update(ShaderManager::GetShaderRecompiledEvent());
+		}
+
+		//recompiled_shaders is sorted by hash, see ShaderManager::GetShaderRecompiledEvent
+		Bool ContainsAny(std::span<GfxShaderKey const> recompiled_shaders, std::initializer_list<GfxShaderKey> shaders)
+		{
+			auto HashLess = [](GfxShaderKey const& lhs, GfxShaderKey const& rhs) { return lhs.GetHash() < rhs.GetHash(); };
+			for (GfxShaderKey const& shader : shaders)
+			{
+				if (!shader.IsValid()) continue;
+				auto [first, last] = std::equal_range(recompiled_shaders.begin(), recompiled_shaders.end(), shader, HashLess);
+				if (std::find(first, last, shader) != last) return true;
+			}
+			return false;
+		}
 	}
 
 	GfxPipelineState::operator ID3D12PipelineState* () const
@@ -333,23 +358,15 @@ namespace adria
 	GfxGraphicsPipelineState::GfxGraphicsPipelineState(GfxDevice* gfx, GfxGraphicsPipelineStateDesc const& desc) : GfxPipelineState(gfx, GfxPipelineStateType::Graphics), desc(desc)
 	{
 		Create(desc);
-		event_handle = ShaderManager::GetShaderRecompiledEvent().AddMember(&GfxGraphicsPipelineState::OnShaderRecompiled, *this);
+		event_handle = UpdateShaderRecompiledListeners([this](ShaderRecompiledEvent& event) { return event.AddMember(&GfxGraphicsPipelineState::OnShaderRecompiled, *this); });
 	}
 	GfxGraphicsPipelineState::~GfxGraphicsPipelineState()
 	{
-		ShaderManager::GetShaderRecompiledEvent().Remove(event_handle);
+		UpdateShaderRecompiledListeners([this](ShaderRecompiledEvent& event) { event.Remove(event_handle); });
 	}
-	void GfxGraphicsPipelineState::OnShaderRecompiled(GfxShaderKey const& s)
+	void GfxGraphicsPipelineState::OnShaderRecompiled(std::span<GfxShaderKey const> recompiled_shaders)
 	{
-		GfxShaderKey shaders[] = { desc.VS, desc.PS, desc.GS, desc.HS, desc.DS };
-		for (Uint64 i = 0; i < ARRAYSIZE(shaders); ++i)
-		{
-			if (s == shaders[i])
-			{
-				Create(desc);
-				return;
-			}
-		}
+		if (ContainsAny(recompiled_shaders, { desc.VS, desc.PS, desc.GS, desc.HS, desc.DS })) Create(desc);
 	}
 	void GfxGraphicsPipelineState::Create(GfxGraphicsPipelineStateDesc const& desc)
 	{
@@ -383,15 +400,15 @@ namespace adria
 	GfxComputePipelineState::GfxComputePipelineState(GfxDevice* gfx, GfxComputePipelineStateDesc const& desc) : GfxPipelineState(gfx, GfxPipelineStateType::Compute), desc(desc)
 	{
 		Create(desc);
-		event_handle = ShaderManager::GetShaderRecompiledEvent().AddMember(&GfxComputePipelineState::OnShaderRecompiled, *this);
+		event_handle = UpdateShaderRecompiledListeners([this](ShaderRecompiledEvent& event) { return event.AddMember(&GfxComputePipelineState::OnShaderRecompiled, *this); });
 	}
 	GfxComputePipelineState::~GfxComputePipelineState()
 	{
-		ShaderManager::GetShaderRecompiledEvent().Remove(event_handle);
+		UpdateShaderRecompiledListeners([this](ShaderRecompiledEvent& event) { event.Remove(event_handle); });
 	}
-	void GfxComputePipelineState::OnShaderRecompiled(GfxShaderKey const& s)
+	void GfxComputePipelineState::OnShaderRecompiled(std::span<GfxShaderKey const> recompiled_shaders)
 	{
-		if (s == desc.CS) Create(desc);
+		if (ContainsAny(recompiled_shaders, { desc.CS })) Create(desc);
 	}
 	void GfxComputePipelineState::Create(GfxComputePipelineStateDesc const& desc)
 	{
@@ -404,15 +421,15 @@ namespace adria
 	GfxMeshShaderPipelineState::GfxMeshShaderPipelineState(GfxDevice* gfx, GfxMeshShaderPipelineStateDesc const& desc) : GfxPipelineState(gfx, GfxPipelineStateType::MeshShader), desc(desc)
 	{
 		Create(desc);
-		event_handle = ShaderManager::GetShaderRecompiledEvent().AddMember(&GfxMeshShaderPipelineState::OnShaderRecompiled, *this);
+		event_handle = UpdateShaderRecompiledListeners([this](ShaderRecompiledEvent& event) { return event.AddMember(&GfxMeshShaderPipelineState::OnShaderRecompiled, *this); });
 	}
 	GfxMeshShaderPipelineState::~GfxMeshShaderPipelineState()
 	{
-		ShaderManager::GetShaderRecompiledEvent().Remove(event_handle);
+		UpdateShaderRecompiledListeners([this](ShaderRecompiledEvent& event) { event.Remove(event_handle); });
 	}
-	void GfxMeshShaderPipelineState::OnShaderRecompiled(GfxShaderKey const& s)
+	void GfxMeshShaderPipelineState::OnShaderRecompiled(std::span<GfxShaderKey const> recompiled_shaders)
 	{
-		if (s == desc.AS || s == desc.MS || s == desc.PS) Create(desc);
+		if (ContainsAny(recompiled_shaders, { desc.AS, desc.MS, desc.PS })) Create(desc);
 	}
 	void GfxMeshShaderPipelineState::Create(GfxMeshShaderPipelineStateDesc const& desc)
 	{
@@ -64,7 +64,7 @@ namespace adria
 	private:
 		GfxGraphicsPipelineStateDesc desc;
 	private:
-		void OnShaderRecompiled(GfxShaderKey const&);
+		void OnShaderRecompiled(std::span<GfxShaderKey const>);
 		void Create(GfxGraphicsPipelineStateDesc const& desc);
 	};
 
@@ -83,7 +83,7 @@ namespace adria
 		GfxComputePipelineStateDesc desc;
 		
 	private:
-		void OnShaderRecompiled(GfxShaderKey const&);
+		void OnShaderRecompiled(std::span<GfxShaderKey const>);
 		void Create(GfxComputePipelineStateDesc const& desc);
 	};
 
@@ -112,7 +112,7 @@ namespace adria
 		GfxMeshShaderPipelineStateDesc desc;
 
 	private:
-		void OnShaderRecompiled(GfxShaderKey const&);
+		void OnShaderRecompiled(std::span<GfxShaderKey const>);
 		void Create(GfxMeshShaderPipelineStateDesc const& desc);
 	};
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #pragma once
+#include <atomic>
+#include <mutex>
+#include <span>
 #include "GfxPipelineState.h"
 #include "GfxShaderEnums.h"
 #include "Utilities/HashUtil.h"
@@ -8,12 +11,99 @@ namespace adria
 	template<typename PSO>
 	struct PSOTraits;
 
+	//compiles a batch of shaders in parallel and waits for it, Rendering passes ShaderManager::CompileShaders
+	using GfxShaderBatchCompiler = void(*)(std::span<GfxShaderKey const>);
+
+	//one bit of a permutation mask, ShaderStageCount adds the define to every stage of the pipeline
+	struct GfxPermutationDefine
+	{
+		Char const* name;
+		Char const* value = "1";
+		GfxShaderStage stage = GfxShaderStage::ShaderStageCount;
+	};
+
+	//descs are hashed field by field, the shader keys contribute their cached define hashes
+	inline void CombineHash(HashState& state, GfxRasterizerState const& rasterizer_state)
+	{
+		state.Combine(rasterizer_state.fill_mode);
+		state.Combine(rasterizer_state.cull_mode);
+		state.Combine(rasterizer_state.front_counter_clockwise);
+		state.Combine(rasterizer_state.depth_bias);
+		state.Combine(rasterizer_state.depth_bias_clamp);
+		state.Combine(rasterizer_state.slope_scaled_depth_bias);
+		state.Combine(rasterizer_state.depth_clip_enable);
+		state.Combine(rasterizer_state.multisample_enable);
+		state.Combine(rasterizer_state.antialiased_line_enable);
+		state.Combine(rasterizer_state.conservative_rasterization_enable);
+		state.Combine(rasterizer_state.forced_sample_count);
+	}
+	inline void CombineHash(HashState& state, GfxDepthStencilState::GfxDepthStencilOp const& depth_stencil_op)
+	{
+		state.Combine(depth_stencil_op.stencil_fail_op);
+		state.Combine(depth_stencil_op.stencil_depth_fail_op);
+		state.Combine(depth_stencil_op.stencil_pass_op);
+		state.Combine(depth_stencil_op.stencil_func);
+	}
+	inline void CombineHash(HashState& state, GfxDepthStencilState const& depth_state)
+	{
+		state.Combine(depth_state.depth_enable);
+		state.Combine(depth_state.depth_write_mask);
+		state.Combine(depth_state.depth_func);
+		state.Combine(depth_state.stencil_enable);
+		state.Combine(depth_state.stencil_read_mask);
+		state.Combine(depth_state.stencil_write_mask);
+		CombineHash(state, depth_state.front_face);
+		CombineHash(state, depth_state.back_face);
+	}
+	inline void CombineHash(HashState& state, GfxBlendState const& blend_state)
+	{
+		state.Combine(blend_state.alpha_to_coverage_enable);
+		state.Combine(blend_state.independent_blend_enable);
+		for (GfxBlendState::GfxRenderTargetBlendState const& render_target : blend_state.render_target)
+		{
+			state.Combine(render_target.blend_enable);
+			state.Combine(render_target.src_blend);
+			state.Combine(render_target.dest_blend);
+			state.Combine(render_target.blend_op);
+			state.Combine(render_target.src_blend_alpha);
+			state.Combine(render_target.dest_blend_alpha);
+			state.Combine(render_target.blend_op_alpha);
+			state.Combine(render_target.render_target_write_mask);
+		}
+	}
+	inline void CombineHash(HashState& state, GfxInputLayout const& input_layout)
+	{
+		for (GfxInputLayout::GfxInputElement const& element : input_layout.elements)
+		{
+			state.Combine(element.semantic_name);
+			state.Combine(element.semantic_index);
+			state.Combine(element.format);
+			state.Combine(element.input_slot);
+			state.Combine(element.aligned_byte_offset);
+			state.Combine(element.input_slot_class);
+		}
+	}
+	template<typename PSODesc>
+	void CombineRenderTargetHash(HashState& state, PSODesc const& desc)
+	{
+		state.Combine(desc.topology_type);
+		state.Combine(desc.num_render_targets);
+		for (Uint32 i = 0; i < desc.num_render_targets; ++i) state.Combine(desc.rtv_formats[i]);
+		state.Combine(desc.dsv_format);
+		state.Combine(desc.sample_mask);
+	}
+
 	struct GfxGraphicsPipelineStateDescHash
 	{
 		ADRIA_NODISCARD Uint64 operator()(GfxGraphicsPipelineStateDesc const& desc) const
 		{
 			HashState state;
-			state.Combine(crc64(reinterpret_cast<Char const*>(&desc), sizeof(GfxGraphicsPipelineStateDesc)));
+			CombineHash(state, desc.rasterizer_state);
+			CombineHash(state, desc.blend_state);
+			CombineHash(state, desc.depth_state);
+			CombineRenderTargetHash(state, desc);
+			CombineHash(state, desc.input_layout);
+			state.Combine(desc.root_signature);
 			state.Combine(desc.VS.GetHash());
 			state.Combine(desc.PS.GetHash());
 			state.Combine(desc.DS.GetHash());
@@ -27,7 +117,7 @@ namespace adria
 		ADRIA_NODISCARD Uint64 operator()(GfxComputePipelineStateDesc const& desc) const
 		{
 			HashState state;
-			state.Combine(crc64(reinterpret_cast<Char const*>(&desc), sizeof(GfxComputePipelineStateDesc)));
+			state.Combine(desc.root_signature);
 			state.Combine(desc.CS.GetHash());
 			return state;
 		}
@@ -37,7 +127,11 @@ namespace adria
 		ADRIA_NODISCARD Uint64 operator()(GfxMeshShaderPipelineStateDesc const& desc) const
 		{
 			HashState state;
-			state.Combine(crc64(reinterpret_cast<Char const*>(&desc), sizeof(GfxMeshShaderPipelineStateDesc)));
+			CombineHash(state, desc.rasterizer_state);
+			CombineHash(state, desc.blend_state);
+			CombineHash(state, desc.depth_state);
+			CombineRenderTargetHash(state, desc);
+			state.Combine(desc.root_signature);
 			state.Combine(desc.AS.GetHash());
 			state.Combine(desc.MS.GetHash());
 			state.Combine(desc.PS.GetHash());
@@ -105,6 +199,13 @@ namespace adria
 			: gfx(gfx), base_pso_desc(desc), current_pso_desc(desc)
 		{
 		}
+		//bit i of the mask passed to Get(mask) enables permutation_defines[i], every mask gets its own slot
+		GfxPipelineStatePermutations(GfxDevice* gfx, PSODesc const& desc, std::span<GfxPermutationDefine const> permutation_defines)
+			: gfx(gfx), base_pso_desc(desc), current_pso_desc(desc), permutation_defines(permutation_defines.begin(), permutation_defines.end()),
+			permutation_psos(1ull << permutation_defines.size())
+		{
+			ADRIA_ASSERT(permutation_defines.size() <= MaxPermutationDefines);
+		}
 		~GfxPipelineStatePermutations() = default;
 		ADRIA_NONCOPYABLE(GfxPipelineStatePermutations)
 
@@ -192,11 +293,100 @@ namespace adria
 			return pso;
 		}
 
+		//passes can call this from worker threads (rg.Multithreaded), a missing permutation is created under the lock
+		PSO* Get(Uint32 permutation_mask) const
+		{
+			ADRIA_ASSERT(permutation_mask < permutation_psos.size());
+			std::atomic<PSO*>& permutation_pso = permutation_psos[permutation_mask];
+			if (PSO* pso = permutation_pso.load(std::memory_order_acquire)) return pso;
+
+			std::lock_guard guard(permutation_mutex);
+			if (PSO* pso = permutation_pso.load(std::memory_order_relaxed)) return pso;
+			PSO* pso = created_permutation_psos.emplace_back(std::make_unique<PSO>(gfx, GetPermutationDesc(permutation_mask))).get();
+			permutation_pso.store(pso, std::memory_order_release);
+			return pso;
+		}
+
+		//compiles the shaders of all given permutations in parallel up front, then creates their pipelines
+		void Prewarm(std::span<Uint32 const> permutation_masks, GfxShaderBatchCompiler compile_shaders) const
+		{
+			std::vector<GfxShaderKey> shader_keys;
+			for (Uint32 permutation_mask : permutation_masks)
+			{
+				ADRIA_ASSERT(permutation_mask < permutation_psos.size());
+				if (permutation_psos[permutation_mask].load(std::memory_order_acquire)) continue;
+				AddShaderKeys(GetPermutationDesc(permutation_mask), shader_keys);
+			}
+			compile_shaders(shader_keys);
+			for (Uint32 permutation_mask : permutation_masks) Get(permutation_mask);
+		}
+
 	private:
+		static constexpr Uint64 MaxPermutationDefines = 16;
+
 		GfxDevice* gfx;
 		PSODesc const base_pso_desc;
 		mutable PSOPermutationMap pso_permutations;
 		mutable PSODesc current_pso_desc;
+		std::vector<GfxPermutationDefine> const permutation_defines;
+		mutable std::vector<std::atomic<PSO*>> permutation_psos;
+		mutable std::vector<std::unique_ptr<PSO>> created_permutation_psos;
+		mutable std::mutex permutation_mutex;
+
+	private:
+		PSODesc GetPermutationDesc(Uint32 permutation_mask) const
+		{
+			PSODesc desc = base_pso_desc;
+			for (Uint32 i = 0; i < permutation_defines.size(); ++i)
+			{
+				if (permutation_mask & (1u << i)) AddDefine(desc, permutation_defines[i]);
+			}
+			return desc;
+		}
+
+		static void AddShaderKeys(PSODesc const& desc, std::vector<GfxShaderKey>& shader_keys)
+		{
+			auto AddShaderKey = [&shader_keys](GfxShaderKey const& shader_key)
+			{
+				if (shader_key.IsValid()) shader_keys.push_back(shader_key);
+			};
+			if constexpr (PSOType == GfxPipelineStateType::Graphics)
+			{
+				AddShaderKey(desc.VS); AddShaderKey(desc.PS); AddShaderKey(desc.DS); AddShaderKey(desc.HS); AddShaderKey(desc.GS);
+			}
+			else if constexpr (PSOType == GfxPipelineStateType::Compute)
+			{
+				AddShaderKey(desc.CS);
+			}
+			else if constexpr (PSOType == GfxPipelineStateType::MeshShader)
+			{
+				AddShaderKey(desc.AS); AddShaderKey(desc.MS); AddShaderKey(desc.PS);
+			}
+		}
+
+		static void AddDefine(PSODesc& desc, GfxPermutationDefine const& define)
+		{
+			using enum GfxShaderStage;
+			Bool const all_stages = define.stage == ShaderStageCount;
+			if constexpr (PSOType == GfxPipelineStateType::Graphics)
+			{
+				if (all_stages || define.stage == VS) desc.VS.AddDefine(define.name, define.value);
+				if (all_stages || define.stage == PS) desc.PS.AddDefine(define.name, define.value);
+				if (all_stages || define.stage == DS) desc.DS.AddDefine(define.name, define.value);
+				if (all_stages || define.stage == HS) desc.HS.AddDefine(define.name, define.value);
+				if (all_stages || define.stage == GS) desc.GS.AddDefine(define.name, define.value);
+			}
+			else if constexpr (PSOType == GfxPipelineStateType::Compute)
+			{
+				if (all_stages || define.stage == CS) desc.CS.AddDefine(define.name, define.value);
+			}
+			else if constexpr (PSOType == GfxPipelineStateType::MeshShader)
+			{
+				if (all_stages || define.stage == MS) desc.MS.AddDefine(define.name, define.value);
+				if (all_stages || define.stage == AS) desc.AS.AddDefine(define.name, define.value);
+				if (all_stages || define.stage == PS) desc.PS.AddDefine(define.name, define.value);
+			}
+		}
 	};
 
 	using GfxGraphicsPipelineStatePermutations	 = GfxPipelineStatePermutations<GfxGraphicsPipelineState>;
@@ -1,6 +1,6 @@
-#if GFX_MULTITHREADED
+#include <algorithm>
 #include <mutex>
-#endif
+#include <thread>
 #include "GfxProfiler.h"
 #include "GfxDevice.h"
 #include "GfxCommandList.h"
@@ -15,9 +15,7 @@ namespace adria
 		GfxDevice* gfx = nullptr;
 		std::unique_ptr<GfxQueryHeap> query_heap;
 		std::unique_ptr<GfxBuffer> query_readback_buffer;
-#if GFX_MULTITHREADED
 		std::mutex stack_mutex;
-#endif
 		GfxProfilerTreeAllocator profile_allocators[FRAME_COUNT];
 		GfxProfilerTree profiler_trees[FRAME_COUNT];
 		GfxProfilerTree* current_profiler_tree = nullptr;
@@ -26,8 +24,11 @@ namespace adria
 		{
 			GfxCommandList* cmd_list = nullptr;
 			GfxProfilerTreeNode* tree_node = nullptr;
+			std::thread::id thread_id;
 		};
-		std::stack<QueryData> query_data;
+		//scopes of different command lists can be open at once when render graph passes are recorded on worker threads
+		std::vector<QueryData> query_data;
+		std::thread::id frame_thread_id;
 		Uint32 scope_counter = 0;
 
 		GfxProfiler::Impl() 
@@ -54,6 +55,7 @@ namespace adria
 		void NewFrame()
 		{
 			ADRIA_ASSERT(query_data.empty()); 
+			frame_thread_id = std::this_thread::get_id();
 			current_profiler_tree = &profiler_trees[gfx->GetBackbufferIndex()];
 			current_profiler_tree->Clear();
 			profile_allocators[gfx->GetBackbufferIndex()].Reset();
@@ -61,15 +63,12 @@ namespace adria
 		}
 		void BeginProfileScope(GfxCommandList* cmd_list, Char const* name)
 		{
-#if GFX_MULTITHREADED
 			std::lock_guard lock(stack_mutex);
-#endif
 			Uint32 profile_index = scope_counter++;
 			GfxProfilerTreeNode* tree_node = nullptr;
-			if (!query_data.empty())
+			if (QueryData* parent_data = FindParentScope(cmd_list))
 			{
-				QueryData& parent_data = query_data.top();
-				tree_node = parent_data.tree_node->EmplaceChild(name, cmd_list, profile_index, 0.0f);
+				tree_node = parent_data->tree_node->EmplaceChild(name, cmd_list, profile_index, 0.0f);
 			}
 			else
 			{
@@ -77,24 +76,35 @@ namespace adria
 				current_profiler_tree->EmplaceRoot(name, cmd_list, profile_index, 0.0f);
 				tree_node = current_profiler_tree->GetRoot();
 			}
-			QueryData& scope_data = query_data.emplace(cmd_list, tree_node);
+			query_data.emplace_back(cmd_list, tree_node, std::this_thread::get_id());
 			Uint32 begin_query_index = profile_index * 2;
 			cmd_list->BeginQuery(*query_heap, begin_query_index);
 		}
 		void EndProfileScope(GfxCommandList* cmd_list)
 		{
-			ADRIA_ASSERT(!query_data.empty());
-#if GFX_MULTITHREADED
 			std::lock_guard lock(stack_mutex);
-#endif
-			QueryData& scope_data = query_data.top();
-			ADRIA_ASSERT(scope_data.cmd_list == cmd_list);
-			query_data.pop();
+			auto it = std::find_if(query_data.rbegin(), query_data.rend(), [cmd_list](QueryData const& data) { return data.cmd_list == cmd_list; });
+			ADRIA_ASSERT(it != query_data.rend());
+			QueryData scope_data = *it;
+			query_data.erase(std::next(it).base());
 
 			Uint32 profile_index = scope_data.tree_node->GetData().index;
 			Uint32 end_query_index = profile_index * 2 + 1;
 			cmd_list->EndQuery(*query_heap, end_query_index);
 		}
+		//a scope nests in the innermost open scope of its command list, the first scope of a worker command list nests in the innermost scope of the frame thread
+		QueryData* FindParentScope(GfxCommandList* cmd_list)
+		{
+			for (Uint64 i = query_data.size(); i-- > 0;)
+			{
+				if (query_data[i].cmd_list == cmd_list) return &query_data[i];
+			}
+			for (Uint64 i = query_data.size(); i-- > 0;)
+			{
+				if (query_data[i].thread_id == frame_thread_id) return &query_data[i];
+			}
+			return query_data.empty() ? nullptr : &query_data.back();
+		}
 		GfxProfilerTree const* GetProfilerTree() const
 		{
 			Uint64 gpu_frequency = 0;
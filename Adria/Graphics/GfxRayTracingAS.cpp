@@ -43,7 +43,7 @@ namespace adria
 			D3D12_RAYTRACING_GEOMETRY_DESC d3d12_desc{};
 			d3d12_desc.Type = D3D12_RAYTRACING_GEOMETRY_TYPE_TRIANGLES;
 			d3d12_desc.Flags = geometry.opaque ? D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE : D3D12_RAYTRACING_GEOMETRY_FLAG_NONE;
-			d3d12_desc.Triangles.Transform3x4 = NULL;
+			d3d12_desc.Triangles.Transform3x4 = geometry.transform_address;
 			d3d12_desc.Triangles.VertexBuffer.StartAddress = geometry.vertex_buffer->GetGpuAddress() + geometry.vertex_buffer_offset;
 			d3d12_desc.Triangles.VertexBuffer.StrideInBytes = geometry.vertex_stride;
 			d3d12_desc.Triangles.VertexCount = geometry.vertex_count;
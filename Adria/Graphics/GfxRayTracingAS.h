@@ -45,6 +45,9 @@ namespace adria
 		Uint32 index_count;
 		GfxFormat index_format;
 
+		//optional 3x4 row major matrix applied to the vertices, used to expand quantized positions
+		Uint64 transform_address = 0;
+
 		Bool opaque;
 	};
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "GfxFormat.h"
+#include "GfxResourceState.h"
 #include "D3D12MemAlloc.h"
 #include "Utilities/EnumUtil.h"
 #include "Utilities/StringUtil.h"
@@ -156,44 +157,6 @@ namespace adria
 	};
 	ENABLE_ENUM_BIT_OPERATORS(GfxBufferMiscFlag);
 
-	enum class GfxResourceState : Uint64
-	{
-		None = 0,
-		Common = 1 << 0,
-		Present = 1 << 1,
-		RTV = 1 << 2,
-		DSV = 1 << 3,
-		DSV_ReadOnly = 1 << 4,
-		VertexSRV = 1 << 5,
-		PixelSRV = 1 << 6,
-		ComputeSRV = 1 << 7,
-		VertexUAV = 1 << 8,
-		PixelUAV = 1 << 9,
-		ComputeUAV = 1 << 10,
-		ClearUAV = 1 << 11,
-		CopyDst = 1 << 12,
-		CopySrc = 1 << 13,
-		ShadingRate = 1 << 14,
-		IndexBuffer = 1 << 15,
-		IndirectArgs = 1 << 16,
-		ASRead = 1 << 17,
-		ASWrite = 1 << 18,
-		Discard = 1 << 19,
-
-		AllVertex = VertexSRV | VertexUAV,
-		AllPixel = PixelSRV | PixelUAV,
-		AllCompute = ComputeSRV | ComputeUAV,
-		AllSRV = VertexSRV | PixelSRV | ComputeSRV,
-		AllUAV = VertexUAV | PixelUAV | ComputeUAV,
-		AllDSV = DSV | DSV_ReadOnly,
-		AllCopy = CopyDst | CopySrc,
-		AllAS = ASRead | ASWrite,
-		GenericRead = CopySrc | AllSRV,
-		GenericWrite = CopyDst | AllUAV,
-		AllShading = AllSRV | AllUAV | ShadingRate | ASRead
-	};
-	ENABLE_ENUM_BIT_OPERATORS(GfxResourceState);
-
 	inline D3D12_BARRIER_SYNC ToD3D12BarrierSync(GfxResourceState flags)
 	{
 		using enum GfxResourceState;
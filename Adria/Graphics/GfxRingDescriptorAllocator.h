@@ -21,7 +21,8 @@ namespace adria
 		{
 			Uint64 start = INVALID_ALLOC_OFFSET;
 			{
-				std::lock_guard guard(alloc_mutex);
+				std::unique_lock guard(alloc_mutex, std::defer_lock);
+				if (thread_safe) guard.lock();
 				start = ring_offset_allocator.Allocate(count);
 			}
 			ADRIA_ASSERT(start != INVALID_ALLOC_OFFSET && "Don't have enough space");
@@ -39,8 +40,15 @@ namespace adria
 			ring_offset_allocator.ReleaseCompletedFrames(completed_frame);
 		}
 
+		//only takes the lock while allocations can come from several threads, must not be changed while they do
+		void SetThreadSafe(Bool _thread_safe) requires UseMutex
+		{
+			thread_safe = _thread_safe;
+		}
+
 	private:
 		mutable Mutex alloc_mutex;
 		RingOffsetAllocator ring_offset_allocator;
+		Bool thread_safe = UseMutex;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include <filesystem>
+#include "GfxShaderCache.h"
+#include "Utilities/FilesUtil.h"
+#include "Utilities/HashUtil.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint32 ArchiveMagic = 0x48435341; //ASCH
+		constexpr Uint32 ArchiveVersion = 2;
+		constexpr Uint64 MaxUnusedRuns = 16;
+
+		struct ArchiveHeader
+		{
+			Uint32 magic;
+			Uint32 version;
+			Uint64 run;
+			Uint64 entry_count;
+			Uint64 dependency_count;
+			Uint64 index_offset;
+		};
+
+		class ArchiveReader
+		{
+		public:
+			ArchiveReader(Uint8 const* data, Uint64 size, Uint64 offset) : data(data), size(size), offset(offset) {}
+
+			template<typename T>
+			Bool Read(T& value)
+			{
+				if (offset + sizeof(T) > size) return false;
+				memcpy(&value, data + offset, sizeof(T));
+				offset += sizeof(T);
+				return true;
+			}
+			Bool Read(std::string& value)
+			{
+				Uint32 length = 0;
+				if (!Read(length) || offset + length > size) return false;
+				value.assign(reinterpret_cast<Char const*>(data + offset), length);
+				offset += length;
+				return true;
+			}
+
+		private:
+			Uint8 const* data;
+			Uint64 size;
+			Uint64 offset;
+		};
+
+		template<typename T>
+		void Write(std::ofstream& os, T const& value)
+		{
+			os.write(reinterpret_cast<Char const*>(&value), sizeof(T));
+		}
+		void Write(std::ofstream& os, std::string const& value)
+		{
+			Write(os, (Uint32)value.size());
+			os.write(value.data(), value.size());
+		}
+	}
+
+	GfxShaderCache::GfxShaderCache(std::string const& archive_path, Uint64 compiler_version) : archive_path(archive_path), compiler_version(compiler_version)
+	{
+		run = LoadArchive() + 1;
+	}
+
+	GfxShaderCache::~GfxShaderCache()
+	{
+		Save();
+	}
+
+	Bool GfxShaderCache::Load(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
+	{
+		Uint64 const input_hash = GetInputHash(input);
+		std::vector<std::string> includes;
+		{
+			std::lock_guard lock(mutex);
+			auto it = dependencies.find(input_hash);
+			if (it == dependencies.end()) return false;
+			includes = it->second;
+		}
+
+		Uint64 content_hash = 0;
+		if (!GetContentHash(includes, content_hash)) return false;
+		HashState key;
+		key.Combine(input_hash);
+		key.Combine(content_hash);
+
+		{
+			std::lock_guard lock(mutex);
+			if (auto it = new_entries.find(key); it != new_entries.end())
+			{
+				NewEntry const& entry = it->second;
+				output.shader.SetShaderData(entry.blob.data(), entry.blob.size());
+				memcpy(output.shader_hash, entry.shader_hash, sizeof(output.shader_hash));
+			}
+			else if (auto it = entries.find(key); it != entries.end())
+			{
+				Entry const& entry = it->second;
+				output.shader.SetShaderData(archive.GetData() + entry.blob_offset, entry.blob_size);
+				memcpy(output.shader_hash, entry.shader_hash, sizeof(output.shader_hash));
+				used_keys.insert(key);
+			}
+			else return false;
+		}
+		output.shader.SetDesc(input);
+		output.includes = std::move(includes);
+		return true;
+	}
+
+	void GfxShaderCache::Store(GfxShaderCompileInput const& input, GfxShaderCompileOutput const& output)
+	{
+		Uint64 content_hash = 0;
+		if (!GetContentHash(output.includes, content_hash)) return;
+
+		Uint64 const input_hash = GetInputHash(input);
+		HashState key;
+		key.Combine(input_hash);
+		key.Combine(content_hash);
+
+		NewEntry entry{};
+		entry.input_hash = input_hash;
+		memcpy(entry.shader_hash, output.shader_hash, sizeof(entry.shader_hash));
+		Uint8 const* shader_data = static_cast<Uint8 const*>(output.shader.GetData());
+		entry.blob.assign(shader_data, shader_data + output.shader.GetSize());
+
+		std::lock_guard lock(mutex);
+		dependencies[input_hash] = output.includes;
+		new_entries[key] = std::move(entry);
+		dirty = true;
+	}
+
+	void GfxShaderCache::InvalidateFile(std::string const& file)
+	{
+		std::lock_guard lock(file_hash_mutex);
+		file_hashes.erase(NormalizePath(file));
+	}
+
+	void GfxShaderCache::Save()
+	{
+		std::lock_guard lock(mutex);
+		SaveArchive();
+	}
+
+	void GfxShaderCache::SaveArchive()
+	{
+		if (!dirty) return;
+
+		std::string const temp_archive_path = archive_path + ".tmp";
+		{
+			std::ofstream os(temp_archive_path, std::ios::binary);
+			if (!os)
+			{
+				ADRIA_LOG(WARNING, "Could not write shader cache archive %s", temp_archive_path.c_str());
+				return;
+			}
+
+			std::vector<Entry> saved_entries;
+			saved_entries.reserve(entries.size() + new_entries.size());
+
+			ArchiveHeader header{};
+			Write(os, header);
+			Uint64 blob_offset = sizeof(ArchiveHeader);
+			for (auto const& [key, entry] : entries)
+			{
+				if (new_entries.contains(key)) continue;
+				Uint64 const last_used_run = used_keys.contains(key) ? run : entry.last_used_run;
+				if (run - last_used_run > MaxUnusedRuns) continue;
+
+				os.write(reinterpret_cast<Char const*>(archive.GetData() + entry.blob_offset), entry.blob_size);
+				Entry& saved_entry = saved_entries.emplace_back(entry);
+				saved_entry.blob_offset = blob_offset;
+				saved_entry.last_used_run = last_used_run;
+				blob_offset += entry.blob_size;
+			}
+			for (auto const& [key, new_entry] : new_entries)
+			{
+				os.write(reinterpret_cast<Char const*>(new_entry.blob.data()), new_entry.blob.size());
+				Entry& saved_entry = saved_entries.emplace_back();
+				saved_entry.key = key;
+				saved_entry.input_hash = new_entry.input_hash;
+				memcpy(saved_entry.shader_hash, new_entry.shader_hash, sizeof(saved_entry.shader_hash));
+				saved_entry.blob_offset = blob_offset;
+				saved_entry.blob_size = new_entry.blob.size();
+				saved_entry.last_used_run = run;
+				blob_offset += new_entry.blob.size();
+			}
+
+			//inputs whose entries were all dropped don't need their include lists anymore, they are compiled again on the next request anyway
+			std::unordered_set<Uint64> saved_inputs;
+			for (Entry const& entry : saved_entries) saved_inputs.insert(entry.input_hash);
+
+			header.magic = ArchiveMagic;
+			header.version = ArchiveVersion;
+			header.run = run;
+			header.entry_count = saved_entries.size();
+			header.dependency_count = 0;
+			header.index_offset = blob_offset;
+			for (Entry const& entry : saved_entries) Write(os, entry);
+			for (auto const& [input_hash, includes] : dependencies)
+			{
+				if (!saved_inputs.contains(input_hash)) continue;
+				++header.dependency_count;
+				Write(os, input_hash);
+				Write(os, (Uint32)includes.size());
+				for (std::string const& include : includes) Write(os, include);
+			}
+			os.seekp(0);
+			Write(os, header);
+		}
+
+		archive.Close();
+		std::error_code error;
+		fs::rename(temp_archive_path, archive_path, error);
+		if (error) ADRIA_LOG(WARNING, "Could not replace shader cache archive %s: %s", archive_path.c_str(), error.message().c_str());
+		LoadArchive();
+	}
+
+	Uint64 GfxShaderCache::LoadArchive()
+	{
+		entries.clear();
+		new_entries.clear();
+		dependencies.clear();
+		used_keys.clear();
+		dirty = false;
+
+		if (!archive.Open(archive_path)) return 0;
+
+		ArchiveHeader header{};
+		ArchiveReader header_reader(archive.GetData(), archive.GetSize(), 0);
+		if (!header_reader.Read(header) || header.magic != ArchiveMagic || header.version != ArchiveVersion)
+		{
+			ADRIA_LOG(WARNING, "Shader cache archive %s has an unknown format and will be rebuilt", archive_path.c_str());
+			archive.Close();
+			return 0;
+		}
+
+		ArchiveReader reader(archive.GetData(), archive.GetSize(), header.index_offset);
+		entries.reserve(header.entry_count);
+		for (Uint64 i = 0; i < header.entry_count; ++i)
+		{
+			Entry entry{};
+			if (!reader.Read(entry) || entry.blob_offset + entry.blob_size > header.index_offset) break;
+			entries[entry.key] = entry;
+		}
+		dependencies.reserve(header.dependency_count);
+		for (Uint64 i = 0; i < header.dependency_count; ++i)
+		{
+			Uint64 input_hash = 0;
+			Uint32 include_count = 0;
+			if (!reader.Read(input_hash) || !reader.Read(include_count)) break;
+			std::vector<std::string>& includes = dependencies[input_hash];
+			includes.resize(include_count);
+			for (std::string& include : includes) reader.Read(include);
+		}
+		return header.run;
+	}
+
+	Uint64 GfxShaderCache::GetInputHash(GfxShaderCompileInput const& input) const
+	{
+		std::string const file = NormalizePath(input.file);
+		HashState state;
+		state.Combine(ArchiveVersion);
+		state.Combine(compiler_version);
+		state.Combine(crc64(file.c_str(), file.size()));
+		state.Combine(crc64(input.entry_point.c_str(), input.entry_point.size()));
+		state.Combine((Uint64)input.stage);
+		state.Combine((Uint64)input.model);
+		state.Combine((Uint64)input.flags);
+		for (GfxShaderDefine const& define : input.defines)
+		{
+			state.Combine(crc64(define.name.c_str(), define.name.size()));
+			state.Combine(crc64(define.value.c_str(), define.value.size()));
+		}
+		return state;
+	}
+
+	Bool GfxShaderCache::GetFileHash(std::string const& file, Uint64& file_hash)
+	{
+		std::string normalized_file = NormalizePath(file);
+		{
+			std::lock_guard lock(file_hash_mutex);
+			if (auto it = file_hashes.find(normalized_file); it != file_hashes.end())
+			{
+				file_hash = it->second;
+				return true;
+			}
+		}
+
+		std::ifstream is(normalized_file, std::ios::binary | std::ios::ate);
+		if (!is) return false;
+		std::string content(static_cast<Uint64>(is.tellg()), '\0');
+		is.seekg(0);
+		is.read(content.data(), content.size());
+		file_hash = crc64(content.c_str(), content.size());
+
+		std::lock_guard lock(file_hash_mutex);
+		file_hashes.emplace(std::move(normalized_file), file_hash);
+		return true;
+	}
+
+	Bool GfxShaderCache::GetContentHash(std::vector<std::string> const& files, Uint64& content_hash)
+	{
+		HashState state;
+		for (std::string const& file : files)
+		{
+			Uint64 file_hash = 0;
+			if (!GetFileHash(file, file_hash)) return false;
+			state.Combine(file_hash);
+		}
+		content_hash = state;
+		return true;
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include "GfxShaderCompiler.h"
+#include "Utilities/MemoryMappedFile.h"
+
+namespace adria
+{
+	//content addressed shader binaries packed into a single archive: header, blobs, then the index
+	//a binary is keyed by the compile input (file, entry point, target, defines, flags) combined with the hash of the contents of the source and all of its includes,
+	//the include list of the last compile of every input is stored in the archive so the content hash can be computed without running the compiler
+	class GfxShaderCache
+	{
+		struct Entry
+		{
+			Uint64 key;
+			Uint64 input_hash;
+			Uint64 shader_hash[2];
+			Uint64 blob_offset;
+			Uint64 blob_size;
+			Uint64 last_used_run;
+		};
+
+		struct NewEntry
+		{
+			Uint64 input_hash;
+			Uint64 shader_hash[2];
+			std::vector<Uint8> blob;
+		};
+
+	public:
+		//compiler_version is part of every key, binaries of a different compiler are never returned
+		GfxShaderCache(std::string const& archive_path, Uint64 compiler_version);
+		ADRIA_NONCOPYABLE_NONMOVABLE(GfxShaderCache)
+		~GfxShaderCache();
+
+		Bool Load(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output);
+		void Store(GfxShaderCompileInput const& input, GfxShaderCompileOutput const& output);
+		//drops the remembered content hash of a file that changed on disk
+		void InvalidateFile(std::string const& file);
+		//writes the archive if anything was added, entries not used for a number of runs and include lists of inputs without entries are dropped
+		//called after every batch of compiles, e.g. ShaderManager::CompileShaders or a hot reload, and on destruction so Store never writes the archive
+		void Save();
+
+	private:
+		std::string archive_path;
+		Uint64 compiler_version;
+		MemoryMappedFile archive;
+		//this run of the application, one past the run that wrote the archive, it stays the same for every save of the run
+		Uint64 run = 0;
+
+		std::mutex mutex;
+		std::unordered_map<Uint64, Entry> entries;
+		std::unordered_map<Uint64, NewEntry> new_entries;
+		std::unordered_map<Uint64, std::vector<std::string>> dependencies;
+		std::unordered_set<Uint64> used_keys;
+		Bool dirty = false;
+
+		std::mutex file_hash_mutex;
+		std::unordered_map<std::string, Uint64> file_hashes;
+
+	private:
+		Uint64 LoadArchive();
+		void SaveArchive();
+		Uint64 GetInputHash(GfxShaderCompileInput const& input) const;
+		Bool GetFileHash(std::string const& file, Uint64& file_hash);
+		Bool GetContentHash(std::vector<std::string> const& files, Uint64& content_hash);
+	};
+}
@@ -1,16 +1,14 @@
 #pragma comment(lib, "dxcompiler.lib")
 #include <d3dcompiler.h>
 #include <filesystem>
+#include <mutex>
 #include "dxcapi.h"
-#include "cereal/archives/binary.hpp"
-#include "cereal/types/string.hpp"
-#include "cereal/types/vector.hpp"
 #include "GfxShaderCompiler.h"
+#include "GfxShaderCache.h"
 #include "GfxMacros.h"
 #include "Core/Paths.h"
 #include "Utilities/StringUtil.h"
 #include "Utilities/FilesUtil.h"
-#include "Utilities/HashUtil.h"
 #include "Utilities/Ref.h"
 
 
@@ -18,15 +16,57 @@ namespace adria
 {
 	namespace
 	{
-		Ref<IDxcLibrary> library = nullptr;
-		Ref<IDxcCompiler3> compiler = nullptr;
-		Ref<IDxcUtils> utils = nullptr;
-		Ref<IDxcIncludeHandler> include_handler = nullptr;
+		//dxc compiler objects are not thread safe, every compiling thread borrows its own set from the pool
+		struct DxcContext
+		{
+			Ref<IDxcLibrary> library = nullptr;
+			Ref<IDxcCompiler3> compiler = nullptr;
+			Ref<IDxcUtils> utils = nullptr;
+			Ref<IDxcIncludeHandler> include_handler = nullptr;
+		};
+		std::vector<std::unique_ptr<DxcContext>> free_contexts;
+		std::mutex context_mutex;
+
+		std::unique_ptr<DxcContext> AcquireContext()
+		{
+			{
+				std::lock_guard lock(context_mutex);
+				if (!free_contexts.empty())
+				{
+					std::unique_ptr<DxcContext> context = std::move(free_contexts.back());
+					free_contexts.pop_back();
+					return context;
+				}
+			}
+			std::unique_ptr<DxcContext> context = std::make_unique<DxcContext>();
+			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(context->library.GetAddressOf())));
+			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(context->compiler.GetAddressOf())));
+			GFX_CHECK_HR(context->library->CreateIncludeHandler(context->include_handler.GetAddressOf()));
+			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(context->utils.GetAddressOf())));
+			return context;
+		}
+		void ReleaseContext(std::unique_ptr<DxcContext>&& context)
+		{
+			std::lock_guard lock(context_mutex);
+			free_contexts.push_back(std::move(context));
+		}
+
+		std::unique_ptr<GfxShaderCache> shader_cache;
+
+		struct ScopedDxcContext
+		{
+			ScopedDxcContext() : context(AcquireContext()) {}
+			~ScopedDxcContext() { ReleaseContext(std::move(context)); }
+			DxcContext* operator->() const { return context.get(); }
+			DxcContext& operator*() const { return *context; }
+
+			std::unique_ptr<DxcContext> context;
+		};
 	}
 	class GfxIncludeHandler : public IDxcIncludeHandler
 	{
 	public:
-		GfxIncludeHandler() {}
+		explicit GfxIncludeHandler(DxcContext& context) : context(context) {}
 
 		HRESULT STDMETHODCALLTYPE LoadSource(_In_ LPCWSTR pFilename, _COM_Outptr_result_maybenull_ IDxcBlob** ppIncludeSource) override
 		{
@@ -51,13 +91,13 @@ namespace adria
 			if (already_included)
 			{
 				static const Char nullStr[] = " ";
-				utils->CreateBlob(nullStr, ARRAYSIZE(nullStr), CP_UTF8, encoding.GetAddressOf());
+				context.utils->CreateBlob(nullStr, ARRAYSIZE(nullStr), CP_UTF8, encoding.GetAddressOf());
 				*ppIncludeSource = encoding.Detach();
 				return S_OK;
 			}
 
 			std::wstring winclude_file = ToWideString(include_file);
-			HRESULT hr = utils->LoadFile(winclude_file.c_str(), nullptr, encoding.GetAddressOf());
+			HRESULT hr = context.utils->LoadFile(winclude_file.c_str(), nullptr, encoding.GetAddressOf());
 			if (SUCCEEDED(hr))
 			{
 				include_files.push_back(include_file);
@@ -69,13 +109,16 @@ namespace adria
 		}
 		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, _COM_Outptr_ void __RPC_FAR* __RPC_FAR* ppvObject) override
 		{
-			return include_handler->QueryInterface(riid, ppvObject);
+			return context.include_handler->QueryInterface(riid, ppvObject);
 		}
 
 		ULONG STDMETHODCALLTYPE AddRef(void) override { return 1; }
 		ULONG STDMETHODCALLTYPE Release(void) override { return 1; }
 
 		std::vector<std::string> include_files;
+
+	private:
+		DxcContext& context;
 	};
 	
 	inline constexpr std::wstring GetTarget(GfxShaderStage stage, GfxShaderModel model)
@@ -150,94 +193,38 @@ namespace adria
 
 	namespace GfxShaderCompiler
 	{
-		static Bool CheckCache(Char const* cache_path, GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
+		void Initialize()
 		{
-			std::string cache_binary(cache_path); cache_binary += ".bin";
-			std::string cache_metadata(cache_path); cache_metadata += ".meta";
-
-			if (!FileExists(cache_binary) || !FileExists(cache_metadata)) return false;
-			if (GetFileLastWriteTime(cache_binary) < GetFileLastWriteTime(input.file)) return false;
-
-			std::ifstream is(cache_metadata, std::ios::binary);
-			cereal::BinaryInputArchive metadata_archive(is);
-
-			metadata_archive(output.shader_hash);
-			metadata_archive(output.includes);
-			Uint64 binary_size = 0;
-			metadata_archive(binary_size);
-
-			//check if the one of the includes was modified after the cache binary was generated
-			for (std::string const& include : output.includes)
+			std::unique_ptr<DxcContext> context = AcquireContext();
+			Uint32 major_version = 0, minor_version = 0;
+			Ref<IDxcVersionInfo> version_info;
+			if (SUCCEEDED(context->compiler->QueryInterface(IID_PPV_ARGS(version_info.GetAddressOf()))))
 			{
-				if (GetFileLastWriteTime(cache_binary) < GetFileLastWriteTime(include)) 
-					return false;
+				version_info->GetVersion(&major_version, &minor_version);
 			}
-
-			std::ifstream is2(cache_binary, std::ios::binary);
-			cereal::BinaryInputArchive binary_archive(is2);
-
-			std::unique_ptr<Char[]> binary_data(new Char[binary_size]);
-			binary_archive.loadBinary(binary_data.get(), binary_size);
-			output.shader.SetShaderData(binary_data.get(), binary_size);
-			output.shader.SetDesc(input);
-			return true;
-		}
-		static Bool SaveToCache(Char const* cache_path, GfxShaderCompileOutput const& output)
-		{
-			std::string cache_metadata(cache_path); cache_metadata += ".meta";
-			std::ofstream os(cache_metadata, std::ios::binary);
-			cereal::BinaryOutputArchive metadata_archive(os);
-			metadata_archive(output.shader_hash);
-			metadata_archive(output.includes);
-			metadata_archive(output.shader.GetSize());
-
-			std::string cache_binary(cache_path); cache_binary += ".bin";
-			std::ofstream os2(cache_binary, std::ios::binary);
-			cereal::BinaryOutputArchive binary_archive(os2);
-			binary_archive.saveBinary(output.shader.GetData(), output.shader.GetSize());
-
-			return true;
-		}
-
-		void Initialize()
-		{
-			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(library.GetAddressOf())));
-			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(compiler.GetAddressOf())));
-			GFX_CHECK_HR(library->CreateIncludeHandler(include_handler.GetAddressOf()));
-			GFX_CHECK_HR(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(utils.GetAddressOf())));
+			ReleaseContext(std::move(context));
 
 			std::filesystem::create_directory(paths::ShaderPDBDir);
+			std::filesystem::create_directory(paths::ShaderCacheDir);
+			shader_cache = std::make_unique<GfxShaderCache>(paths::ShaderCacheDir + "ShaderCache.bin", ((Uint64)major_version << 32) | minor_version);
 		}
 		void Destroy()
 		{
-			include_handler.Reset();
-			compiler.Reset();
-			library.Reset();
-			utils.Reset();
+			shader_cache = nullptr;
+			std::lock_guard lock(context_mutex);
+			free_contexts.clear();
 		}
 		Bool CompileShader(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output)
 		{
-			std::string define_key;
-			for (GfxShaderDefine const& define : input.defines)
-			{
-				define_key += define.name;
-				define_key += define.value;
-			}
-			Uint64 define_hash = crc64(define_key.c_str(), define_key.size());
-			std::string build_string = input.flags & GfxShaderCompilerFlag_Debug ? "debug" : "release";
-			Char cache_path[256];
-			sprintf_s(cache_path, "%s%s_%s_%llx_%s", paths::ShaderCacheDir.c_str(), GetFilenameWithoutExtension(input.file).c_str(),
-												     input.entry_point.c_str(), define_hash, build_string.c_str());
-
-			if (CheckCache(cache_path, input, output)) return true;
+			if (shader_cache->Load(input, output)) return true;
 			ADRIA_LOG(INFO, "Shader '%s.%s' not found in cache. Compiling...", input.file.c_str(), input.entry_point.c_str());
 
-			compile:
+			ScopedDxcContext context;
 			Uint32 code_page = CP_UTF8;
 			Ref<IDxcBlobEncoding> source_blob;
 
 			std::wstring shader_source = ToWideString(input.file);
-			HRESULT hr = library->CreateBlobFromFile(shader_source.data(), &code_page, source_blob.GetAddressOf());
+			HRESULT hr = context->library->CreateBlobFromFile(shader_source.data(), &code_page, source_blob.GetAddressOf());
 			GFX_CHECK_HR(hr);
 
 			std::wstring name = ToWideString(GetFilenameWithoutExtension(input.file));
@@ -291,29 +278,34 @@ namespace adria
 			source_buffer.Ptr = source_blob->GetBufferPointer();
 			source_buffer.Size = source_blob->GetBufferSize();
 			source_buffer.Encoding = DXC_CP_ACP;
-			GfxIncludeHandler custom_include_handler{};
+			GfxIncludeHandler custom_include_handler(*context);
 
 			Ref<IDxcResult> result;
-			hr = compiler->Compile(
+			hr = context->compiler->Compile(
 				&source_buffer,
 				compile_args.data(), (Uint32)compile_args.size(),
 				&custom_include_handler,
 				IID_PPV_ARGS(result.GetAddressOf()));
 
+			HRESULT status = E_FAIL;
+			if (SUCCEEDED(hr)) result->GetStatus(&status);
+
 			Ref<IDxcBlobUtf8> errors;
-			if (SUCCEEDED(result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(errors.GetAddressOf()), nullptr)))
+			Char const* err_msg = nullptr;
+			if (SUCCEEDED(hr) && SUCCEEDED(result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(errors.GetAddressOf()), nullptr)) && errors && errors->GetStringLength() > 0)
 			{
-				if (errors && errors->GetStringLength() > 0)
-				{
-					Char const* err_msg = errors->GetStringPointer();
-					ADRIA_LOG(ERROR, "%s", err_msg);
-					std::string msg = "Click OK after you fixed the following errors: \n";
-					msg += err_msg;
-					Int32 result = MessageBoxA(NULL, msg.c_str(), NULL, MB_OKCANCEL);
-					if (result == IDOK) goto compile;
-					else if (result == IDCANCEL) return false;
-				}
+				err_msg = errors->GetStringPointer();
 			}
+			if (FAILED(status))
+			{
+				output.errors = err_msg ? std::string(err_msg) : input.file + ": compilation failed without errors\n";
+				ADRIA_LOG(ERROR, "%s", output.errors.c_str());
+				//the retry after the user fixed the source has to hash the files again instead of using the hashes of the broken ones
+				for (std::string const& include_file : custom_include_handler.include_files) shader_cache->InvalidateFile(include_file);
+				shader_cache->InvalidateFile(input.file);
+				return false;
+			}
+			if (err_msg) ADRIA_LOG(WARNING, "%s", err_msg);
 			
 			Ref<IDxcBlob> blob;
 			GFX_CHECK_HR(result->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(blob.GetAddressOf()), nullptr));
@@ -325,7 +317,7 @@ namespace adria
 				if (SUCCEEDED(result->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(pdb_blob.GetAddressOf()), pdb_path_utf16.GetAddressOf())))
 				{
 					Ref<IDxcBlobUtf8> pdb_path_utf8;
-					if (SUCCEEDED(utils->GetBlobAsUtf8(pdb_path_utf16.Get(), pdb_path_utf8.GetAddressOf())))
+					if (SUCCEEDED(context->utils->GetBlobAsUtf8(pdb_path_utf16.Get(), pdb_path_utf8.GetAddressOf())))
 					{
 						Char pdb_path[256];
 						sprintf_s(pdb_path, "%s%s", paths::ShaderPDBDir.c_str(), pdb_path_utf8->GetStringPointer());
@@ -350,15 +342,24 @@ namespace adria
 			output.shader.SetShaderData(blob->GetBufferPointer(), blob->GetBufferSize());
 			output.includes = std::move(custom_include_handler.include_files);
 			output.includes.push_back(input.file);
-			SaveToCache(cache_path, output);
+			shader_cache->Store(input, output);
 			return true;
 		}
+		void InvalidateCachedFile(std::string const& filename)
+		{
+			shader_cache->InvalidateFile(filename);
+		}
+		void SaveCache()
+		{
+			shader_cache->Save();
+		}
 		void ReadBlobFromFile(std::string const& filename, GfxShaderBlob& blob)
 		{
 			std::wstring wide_filename = ToWideString(filename);
 			Uint32 code_page = CP_UTF8;
 			Ref<IDxcBlobEncoding> source_blob;
-			HRESULT hr = library->CreateBlobFromFile(wide_filename.data(), &code_page, source_blob.GetAddressOf());
+			ScopedDxcContext context;
+			HRESULT hr = context->library->CreateBlobFromFile(wide_filename.data(), &code_page, source_blob.GetAddressOf());
 			GFX_CHECK_HR(hr);
 			blob.resize(source_blob->GetBufferSize());
 			memcpy(blob.data(), source_blob->GetBufferPointer(), source_blob->GetBufferSize());
@@ -9,6 +9,8 @@ namespace adria
 		GfxShader shader;
 		std::vector<std::string> includes;
 		Uint64 shader_hash[2];
+		//compiler errors of a failed compile, they are reported by the caller since compiles run on worker threads
+		std::string errors;
 	};
 	using GfxShaderCompileInput = GfxShaderDesc;
 
@@ -17,6 +19,10 @@ namespace adria
 		void Initialize();
 		void Destroy();
 		Bool CompileShader(GfxShaderCompileInput const& input, GfxShaderCompileOutput& output);
+		//has to be called when a shader source changes on disk, cached binaries are looked up by the content hashes of their files
+		void InvalidateCachedFile(std::string const& filename);
+		//writes the binaries compiled since the last save to the shader cache, call it once a batch of compiles finished
+		void SaveCache();
 		void ReadBlobFromFile(std::string const& filename, GfxShaderBlob& blob);
 	}
 }
\ No newline at end of file
@@ -1,3 +1,6 @@
+#include <deque>
+#include <mutex>
+#include <unordered_map>
 #include "GfxShaderKey.h"
 #include "GfxShader.h"
 #include "Rendering/ShaderManager.h"
@@ -5,10 +8,48 @@
 
 namespace adria
 {
+	namespace
+	{
+		//every distinct define is stored once for the lifetime of the application, keys only point to it so copying a key doesn't copy strings
+		class GfxShaderDefineTable
+		{
+		public:
+			//passes add the same few defines every frame, each thread remembers the ones it interned so only new defines take the lock
+			GfxShaderDefine const* Intern(Char const* name, Char const* value, Uint64 define_hash)
+			{
+				thread_local std::unordered_map<Uint64, GfxShaderDefine const*> thread_define_map;
+				GfxShaderDefine const*& define = thread_define_map[define_hash];
+				if (!define) define = InternShared(name, value, define_hash);
+				return define;
+			}
+
+		private:
+			std::mutex mutex;
+			std::deque<GfxShaderDefine> defines;
+			std::unordered_map<Uint64, GfxShaderDefine const*> define_map;
+
+		private:
+			GfxShaderDefine const* InternShared(Char const* name, Char const* value, Uint64 define_hash)
+			{
+				std::lock_guard lock(mutex);
+				auto [it, inserted] = define_map.try_emplace(define_hash, nullptr);
+				if (inserted) it->second = &defines.emplace_back(name, value);
+				ADRIA_ASSERT(it->second->name == name && it->second->value == value);
+				return it->second;
+			}
+		};
+		GfxShaderDefineTable& GetShaderDefineTable()
+		{
+			static GfxShaderDefineTable define_table;
+			return define_table;
+		}
+	}
+
 	struct GfxShaderKey::Impl
 	{
 		ShaderID id = ShaderID_Invalid;
-		std::vector<GfxShaderDefine> defines;
+		std::vector<GfxShaderDefine const*> defines;
+		Uint64 defines_hash = 0;
 	};
 
 	GfxShaderKey::GfxShaderKey()
@@ -26,6 +67,7 @@ namespace adria
 		impl = std::make_unique<Impl>();
 		impl->id = k.impl->id;
 		impl->defines = k.impl->defines;
+		impl->defines_hash = k.impl->defines_hash;
 	}
 
 	GfxShaderKey::~GfxShaderKey() = default;
@@ -39,6 +81,7 @@ namespace adria
 	{
 		impl->id = k.impl->id;
 		impl->defines = k.impl->defines;
+		impl->defines_hash = k.impl->defines_hash;
 		return *this;
 	}
 
@@ -49,7 +92,16 @@ namespace adria
 
 	void GfxShaderKey::AddDefine(Char const* name, Char const* value)
 	{
-		impl->defines.emplace_back(name, value);
+		//define strings are hashed once here, GetHash only mixes in the shader id
+		HashState define_state;
+		define_state.Combine(crc64(name, strlen(name)));
+		define_state.Combine(crc64(value, strlen(value)));
+		impl->defines.push_back(GetShaderDefineTable().Intern(name, value, define_state));
+
+		HashState state;
+		state.Combine(impl->defines_hash);
+		state.Combine((Uint64)define_state);
+		impl->defines_hash = state;
 	}
 
 	Bool GfxShaderKey::IsValid() const
@@ -62,9 +114,12 @@ namespace adria
 		return impl->id;
 	}
 
-	std::vector<GfxShaderDefine> const& GfxShaderKey::GetDefines() const
+	std::vector<GfxShaderDefine> GfxShaderKey::GetDefines() const
 	{
-		return impl->defines;
+		std::vector<GfxShaderDefine> defines;
+		defines.reserve(impl->defines.size());
+		for (GfxShaderDefine const* define : impl->defines) defines.push_back(*define);
+		return defines;
 	}
 
 	ShaderID GfxShaderKey::GetShaderID() const
@@ -76,15 +131,10 @@ namespace adria
 	{
 		if (!impl) return 0;
 
-		std::string define_key;
-		for (GfxShaderDefine const& define : impl->defines)
-		{
-			define_key += define.name;
-			define_key += define.value;
-		}
-		define_key += std::to_string(impl->id);
-		Uint64 define_hash = crc64(define_key.c_str(), define_key.size());
-		return define_hash;
+		HashState state;
+		state.Combine(impl->defines_hash);
+		state.Combine((Uint64)impl->id);
+		return state;
 	}
 
 	Bool GfxShaderKey::operator==(GfxShaderKey const& key) const
@@ -22,7 +22,8 @@ namespace adria
 		void AddDefine(Char const* name, Char const* value = "");
 		Bool IsValid() const;
 
-		std::vector<GfxShaderDefine> const& GetDefines() const;
+		//defines are interned, this copies them out for the compiler
+		std::vector<GfxShaderDefine> GetDefines() const;
 		ShaderID GetShaderID() const;
 		Uint64 GetHash() const;
 
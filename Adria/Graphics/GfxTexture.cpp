@@ -3,16 +3,13 @@
 #include "GfxBuffer.h"
 #include "GfxCommandList.h"
 #include "GfxLinearDynamicAllocator.h"
+#include "GfxHeap.h"
 #include "d3dx12.h"
 
 namespace adria
 {
-	GfxTexture::GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data) : gfx(gfx), desc(desc)
+	static D3D12_RESOURCE_DESC ToD3D12ResourceDesc(GfxTextureDesc const& desc)
 	{
-		HRESULT hr = E_FAIL;
-		D3D12MA::ALLOCATION_DESC allocation_desc{};
-		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
-
 		D3D12_RESOURCE_DESC resource_desc{};
 		resource_desc.Format = ConvertGfxFormat(desc.format);
 		resource_desc.Width = desc.width;
@@ -58,8 +55,12 @@ namespace adria
 			ADRIA_ASSERT(false && "Invalid Texture Type!");
 			break;
 		}
+		return resource_desc;
+	}
+
+	static D3D12_CLEAR_VALUE* ToD3D12ClearValue(GfxTextureDesc const& desc, D3D12_CLEAR_VALUE& clear_value)
+	{
 		D3D12_CLEAR_VALUE* clear_value_ptr = nullptr;
-		D3D12_CLEAR_VALUE clear_value{};
 		if (HasFlag(desc.bind_flags, GfxBindFlag::DepthStencil) && desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil)
 		{
 			clear_value.DepthStencil.Depth = desc.clear_value.depth_stencil.depth;
@@ -110,6 +111,18 @@ namespace adria
 			}
 			clear_value_ptr = &clear_value;
 		}
+		return clear_value_ptr;
+	}
+
+	GfxTexture::GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data) : gfx(gfx), desc(desc)
+	{
+		HRESULT hr = E_FAIL;
+		D3D12MA::ALLOCATION_DESC allocation_desc{};
+		allocation_desc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		D3D12_CLEAR_VALUE clear_value{};
+		D3D12_CLEAR_VALUE* clear_value_ptr = ToD3D12ClearValue(desc, clear_value);
 
 		GfxResourceState initial_state = desc.initial_state;
 		if (data.sub_data != nullptr)
@@ -236,6 +249,44 @@ namespace adria
 	{
 	}
 
+	GfxTexture::GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxHeap const& heap, Uint64 heap_offset) : gfx(gfx), desc(desc)
+	{
+		ADRIA_ASSERT(desc.heap_type == GfxResourceUsage::Default);
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		D3D12_CLEAR_VALUE clear_value{};
+		D3D12_CLEAR_VALUE* clear_value_ptr = ToD3D12ClearValue(desc, clear_value);
+
+		HRESULT hr = E_FAIL;
+		auto allocator = gfx->GetAllocator();
+		if (gfx->GetCapabilities().SupportsEnhancedBarriers())
+		{
+			D3D12_RESOURCE_DESC1 resource_desc1 = CD3DX12_RESOURCE_DESC1(resource_desc);
+			hr = allocator->CreateAliasingResource2(
+				heap.GetAllocation(), heap_offset,
+				&resource_desc1,
+				ToD3D12BarrierLayout(desc.initial_state),
+				clear_value_ptr, 0, nullptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		else
+		{
+			hr = allocator->CreateAliasingResource(
+				heap.GetAllocation(), heap_offset,
+				&resource_desc,
+				ToD3D12LegacyResourceState(desc.initial_state),
+				clear_value_ptr,
+				IID_PPV_ARGS(resource.GetAddressOf())
+			);
+		}
+		GFX_CHECK_HR(hr);
+
+		if (desc.mip_levels == 0)
+		{
+			const_cast<GfxTextureDesc&>(desc).mip_levels = (uint32_t)log2(std::max<Uint32>(desc.width, desc.height)) + 1;
+		}
+	}
+
 	GfxTexture::~GfxTexture()
 	{
 		if (mapped_data != nullptr)
@@ -251,6 +302,23 @@ namespace adria
 		}
 	}
 
+	GfxAllocationInfo GfxTexture::GetAllocationInfo(GfxDevice* gfx, GfxTextureDesc const& desc)
+	{
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		D3D12_RESOURCE_ALLOCATION_INFO allocation_info = gfx->GetDevice()->GetResourceAllocationInfo(0, 1, &resource_desc);
+		return GfxAllocationInfo{ .size = allocation_info.SizeInBytes, .alignment = allocation_info.Alignment };
+	}
+
+	Uint64 GfxTexture::GetUploadSize(GfxDevice* gfx, GfxTextureDesc const& desc)
+	{
+		D3D12_RESOURCE_DESC resource_desc = ToD3D12ResourceDesc(desc);
+		Uint32 subresource_count = std::max<Uint32>(1u, desc.mip_levels);
+		if (desc.type != GfxTextureType_3D) subresource_count *= desc.array_size;
+		Uint64 upload_size = 0;
+		gfx->GetDevice()->GetCopyableFootprints(&resource_desc, 0, subresource_count, 0, nullptr, nullptr, nullptr, &upload_size);
+		return upload_size;
+	}
+
 	Uint32 GfxTexture::GetRowPitch(Uint32 mip_level) const
 	{
 		ADRIA_ASSERT(mip_level < desc.mip_levels);
@@ -1,5 +1,6 @@
 #pragma once
 #include "GfxResourceCommon.h"
+#include "GfxHeap.h"
 
 namespace adria
 {
@@ -112,6 +113,7 @@ namespace adria
 		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxTextureData const& data);
 		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc);
 		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, void* backbuffer); //constructor used by swapchain for creating backbuffer texture
+		GfxTexture(GfxDevice* gfx, GfxTextureDesc const& desc, GfxHeap const& heap, Uint64 heap_offset); //constructor used for placing texture in an existing heap
 		ADRIA_NONCOPYABLE_NONMOVABLE(GfxTexture)
 		~GfxTexture();
 
@@ -137,6 +139,10 @@ namespace adria
 
 		void SetName(Char const* name);
 
+		static GfxAllocationInfo GetAllocationInfo(GfxDevice* gfx, GfxTextureDesc const& desc);
+		//size of the upload buffer region that holds all subresources of a texture
+		static Uint64 GetUploadSize(GfxDevice* gfx, GfxTextureDesc const& desc);
+
 	private:
 		GfxDevice* gfx;
 		Ref<ID3D12Resource> resource;
@@ -0,0 +1,137 @@
+#include <array>
+#include <immintrin.h>
+#include "BoundingBoxCulling.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/AllocatorUtil.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint64 MinParallelCullingBoxes = 16384;
+		constexpr Uint64 CullingChunkWordCount = 32;
+
+#if defined(__AVX__)
+		using FloatN = __m256;
+		constexpr Uint64 Width = 8;
+		inline FloatN LoadN(Float const* p) { return _mm256_loadu_ps(p); }
+		inline FloatN SetN(Float f) { return _mm256_set1_ps(f); }
+		inline FloatN ZeroN() { return _mm256_setzero_ps(); }
+		inline FloatN AddN(FloatN a, FloatN b) { return _mm256_add_ps(a, b); }
+		inline FloatN MulN(FloatN a, FloatN b) { return _mm256_mul_ps(a, b); }
+		inline FloatN OrN(FloatN a, FloatN b) { return _mm256_or_ps(a, b); }
+		inline FloatN GreaterN(FloatN a, FloatN b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+		inline Uint64 MaskN(FloatN a) { return (Uint64)_mm256_movemask_ps(a); }
+#else
+		using FloatN = __m128;
+		constexpr Uint64 Width = 4;
+		inline FloatN LoadN(Float const* p) { return _mm_loadu_ps(p); }
+		inline FloatN SetN(Float f) { return _mm_set1_ps(f); }
+		inline FloatN ZeroN() { return _mm_setzero_ps(); }
+		inline FloatN AddN(FloatN a, FloatN b) { return _mm_add_ps(a, b); }
+		inline FloatN MulN(FloatN a, FloatN b) { return _mm_mul_ps(a, b); }
+		inline FloatN OrN(FloatN a, FloatN b) { return _mm_or_ps(a, b); }
+		inline FloatN GreaterN(FloatN a, FloatN b) { return _mm_cmpgt_ps(a, b); }
+		inline Uint64 MaskN(FloatN a) { return (Uint64)_mm_movemask_ps(a); }
+#endif
+		constexpr Uint64 WidthMask = (1ull << Width) - 1;
+	}
+
+	void BoundingBoxSoA::Resize(Uint64 _count)
+	{
+		count = _count;
+		Uint64 const padded_count = Align(count, BlockSize);
+		for (std::vector<Float>* component : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z })
+		{
+			component->assign(padded_count, 0.0f);
+		}
+	}
+
+	CullingView MakeCullingView(BoundingFrustum const& frustum)
+	{
+		DirectX::XMVECTOR planes[6];
+		frustum.GetPlanes(&planes[0], &planes[1], &planes[2], &planes[3], &planes[4], &planes[5]);
+		CullingView view{};
+		for (Uint64 i = 0; i < 6; ++i) view.planes[i] = planes[i];
+		return view;
+	}
+
+	//the six slabs of an AABB as outward planes, which turns the plane test into an exact AABB overlap test
+	CullingView MakeCullingView(BoundingBox const& box)
+	{
+		Vector3 const max = Vector3(box.Center) + Vector3(box.Extents);
+		Vector3 const min = Vector3(box.Center) - Vector3(box.Extents);
+		CullingView view{};
+		view.planes =
+		{
+			Vector4( 1.0f,  0.0f,  0.0f, -max.x), Vector4(-1.0f,  0.0f,  0.0f, min.x),
+			Vector4( 0.0f,  1.0f,  0.0f, -max.y), Vector4( 0.0f, -1.0f,  0.0f, min.y),
+			Vector4( 0.0f,  0.0f,  1.0f, -max.z), Vector4( 0.0f,  0.0f, -1.0f, min.z)
+		};
+		return view;
+	}
+
+	void CullBoundingBoxWords(std::span<CullingView const> views, BoundingBoxSoA const& boxes, std::span<Uint64> visibility, Uint64 first_word, Uint64 last_word)
+	{
+		constexpr Uint64 BlockSize = BoundingBoxSoA::BlockSize;
+		Uint64 const word_count = boxes.GetMaskWordCount();
+		ADRIA_ASSERT(visibility.size() >= views.size() * word_count);
+
+		for (Uint64 word = first_word; word < last_word; ++word)
+		{
+			for (Uint64 v = 0; v < views.size(); ++v) visibility[v * word_count + word] = 0;
+
+			Uint64 const block_start = word * BlockSize;
+			for (Uint64 j = 0; j < BlockSize; j += Width)
+			{
+				Uint64 const i = block_start + j;
+				FloatN const cx = LoadN(&boxes.center_x[i]), cy = LoadN(&boxes.center_y[i]), cz = LoadN(&boxes.center_z[i]);
+				FloatN const ex = LoadN(&boxes.extent_x[i]), ey = LoadN(&boxes.extent_y[i]), ez = LoadN(&boxes.extent_z[i]);
+				for (Uint64 v = 0; v < views.size(); ++v)
+				{
+					FloatN outside = ZeroN();
+					for (Vector4 const& plane : views[v].planes)
+					{
+						FloatN distance = AddN(MulN(SetN(plane.x), cx), SetN(plane.w));
+						distance = AddN(distance, MulN(SetN(plane.y), cy));
+						distance = AddN(distance, MulN(SetN(plane.z), cz));
+						FloatN radius = MulN(SetN(std::abs(plane.x)), ex);
+						radius = AddN(radius, MulN(SetN(std::abs(plane.y)), ey));
+						radius = AddN(radius, MulN(SetN(std::abs(plane.z)), ez));
+						outside = OrN(outside, GreaterN(distance, radius));
+					}
+					visibility[v * word_count + word] |= (~MaskN(outside) & WidthMask) << j;
+				}
+			}
+
+			Uint64 const valid_count = std::min(BlockSize, boxes.count - block_start);
+			if (valid_count < BlockSize)
+			{
+				for (Uint64 v = 0; v < views.size(); ++v) visibility[v * word_count + word] &= (1ull << valid_count) - 1;
+			}
+		}
+	}
+
+	void CullBoundingBoxes(CullingView const& view, BoundingBoxSoA const& boxes, std::span<Uint64> visibility)
+	{
+		CullBoundingBoxWords(std::span<CullingView const>(&view, 1), boxes, visibility, 0, boxes.GetMaskWordCount());
+	}
+
+	void CullBoundingBoxesMultiView(std::span<CullingView const> views, BoundingBoxSoA const& boxes, std::span<Uint64> visibility)
+	{
+		Uint64 const word_count = boxes.GetMaskWordCount();
+		if (boxes.Size() < MinParallelCullingBoxes)
+		{
+			CullBoundingBoxWords(views, boxes, visibility, 0, word_count);
+			return;
+		}
+
+		//chunks are claimed one by one, so views that cull more boxes in some regions than in others still balance out
+		Uint64 const chunk_count = DivideAndRoundUp(word_count, CullingChunkWordCount);
+		ParallelFor(chunk_count, [views, &boxes, visibility, word_count](Uint64 chunk)
+			{
+				Uint64 const first_word = chunk * CullingChunkWordCount;
+				CullBoundingBoxWords(views, boxes, visibility, first_word, std::min(first_word + CullingChunkWordCount, word_count));
+			});
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <span>
+#include <DirectXCollision.h>
+
+namespace adria
+{
+	struct CullingView;
+
+	//world space AABBs in structure of arrays layout, padded to whole culling blocks so the kernels never read past the end
+	class BoundingBoxSoA
+	{
+		friend void CullBoundingBoxWords(std::span<CullingView const>, BoundingBoxSoA const&, std::span<Uint64>, Uint64, Uint64);
+	public:
+		static constexpr Uint64 BlockSize = 64;
+
+		void Resize(Uint64 count);
+		void Set(Uint64 i, BoundingBox const& box)
+		{
+			center_x[i] = box.Center.x; center_y[i] = box.Center.y; center_z[i] = box.Center.z;
+			extent_x[i] = box.Extents.x; extent_y[i] = box.Extents.y; extent_z[i] = box.Extents.z;
+		}
+		Uint64 Size() const { return count; }
+		Uint64 GetMaskWordCount() const { return (count + BlockSize - 1) / BlockSize; }
+
+	private:
+		Uint64 count = 0;
+		std::vector<Float> center_x, center_y, center_z;
+		std::vector<Float> extent_x, extent_y, extent_z;
+	};
+
+	//convex volume as six outward facing planes, a box is culled if it lies fully outside of any of them
+	struct CullingView
+	{
+		std::array<Vector4, 6> planes;
+	};
+	CullingView MakeCullingView(BoundingFrustum const& frustum);
+	CullingView MakeCullingView(BoundingBox const& box);
+
+	//bit i of visibility is set if box i intersects the view, visibility needs GetMaskWordCount() words
+	void CullBoundingBoxes(CullingView const& view, BoundingBoxSoA const& boxes, std::span<Uint64> visibility);
+	//tests every box against all views while it is loaded, view v writes the words starting at v * GetMaskWordCount()
+	//large box counts are split in chunks of 2048 boxes that the caller and g_ThreadPool claim with ParallelFor
+	void CullBoundingBoxesMultiView(std::span<CullingView const> views, BoundingBoxSoA const& boxes, std::span<Uint64> visibility);
+
+	inline Bool IsVisible(std::span<Uint64 const> visibility, Uint64 i)
+	{
+		return (visibility[i / BoundingBoxSoA::BlockSize] >> (i % BoundingBoxSoA::BlockSize)) & 1;
+	}
+}
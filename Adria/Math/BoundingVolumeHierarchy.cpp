@@ -0,0 +1,440 @@
+#include <cfloat>
+#include <bit>
+#include "BoundingVolumeHierarchy.h"
+#include "BoundingBoxCulling.h"
+
+namespace adria
+{
+	namespace
+	{
+		enum class Containment : Uint8
+		{
+			Outside,
+			Intersects,
+			Inside
+		};
+
+		Float SurfaceArea(Float const* min, Float const* max)
+		{
+			Float const dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+			return dx * dy + dy * dz + dz * dx;
+		}
+
+		void SetBounds(Float* min, Float* max, BoundingBox const& box)
+		{
+			min[0] = box.Center.x - box.Extents.x; min[1] = box.Center.y - box.Extents.y; min[2] = box.Center.z - box.Extents.z;
+			max[0] = box.Center.x + box.Extents.x; max[1] = box.Center.y + box.Extents.y; max[2] = box.Center.z + box.Extents.z;
+		}
+
+		void GrowBounds(Float* min, Float* max, Float const* other_min, Float const* other_max)
+		{
+			for (Uint32 axis = 0; axis < 3; ++axis)
+			{
+				min[axis] = std::min(min[axis], other_min[axis]);
+				max[axis] = std::max(max[axis], other_max[axis]);
+			}
+		}
+
+		Containment ClassifyBounds(Float const* min, Float const* max, CullingView const& view)
+		{
+			Containment result = Containment::Inside;
+			for (Vector4 const& plane : view.planes)
+			{
+				Float const distance = plane.x * (min[0] + max[0]) * 0.5f + plane.y * (min[1] + max[1]) * 0.5f + plane.z * (min[2] + max[2]) * 0.5f + plane.w;
+				Float const radius = (std::abs(plane.x) * (max[0] - min[0]) + std::abs(plane.y) * (max[1] - min[1]) + std::abs(plane.z) * (max[2] - min[2])) * 0.5f;
+				if (distance > radius) return Containment::Outside;
+				if (distance > -radius) result = Containment::Intersects;
+			}
+			return result;
+		}
+	}
+
+	template<typename NodeTest, typename PrimitiveTest>
+	void BoundingVolumeHierarchy::Traverse(NodeTest&& node_test, PrimitiveTest&& primitive_test, std::vector<Uint32>& ids) const
+	{
+		if (nodes.empty()) return;
+
+		Uint32 stack[MaxDepth + 1];
+		Uint32 stack_size = 0;
+		stack[stack_size++] = 0;
+		while (stack_size > 0)
+		{
+			Node const& node = nodes[stack[--stack_size]];
+
+			Containment const containment = node_test(node.min, node.max);
+			if (containment == Containment::Outside) continue;
+			if (containment == Containment::Inside)
+			{
+				for (Uint32 i = 0; i < node.primitive_count; ++i) ids.push_back(primitives[node.first_primitive + i].id);
+			}
+			else if (node.left_child == 0)
+			{
+				for (Uint32 i = 0; i < node.primitive_count; ++i)
+				{
+					Primitive const& primitive = primitives[node.first_primitive + i];
+					if (primitive_test(primitive.min, primitive.max) != Containment::Outside) ids.push_back(primitive.id);
+				}
+			}
+			else
+			{
+				ADRIA_ASSERT(stack_size + 2 <= MaxDepth + 1);
+				stack[stack_size++] = node.left_child + 1;
+				stack[stack_size++] = node.left_child;
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::Build(std::span<BoundingBox const> boxes)
+	{
+		Clear();
+		if (boxes.empty()) return;
+
+		Uint32 const primitive_count = (Uint32)boxes.size();
+		primitives.resize(primitive_count);
+		primitive_slots.resize(primitive_count);
+		primitive_leaves.resize(primitive_count);
+		for (Uint32 i = 0; i < primitive_count; ++i)
+		{
+			SetBounds(primitives[i].min, primitives[i].max, boxes[i]);
+			primitives[i].id = i;
+		}
+
+		nodes.reserve(2 * primitive_count);
+		Node& root = nodes.emplace_back();
+		root.left_child = 0;
+		root.first_primitive = 0;
+		root.primitive_count = primitive_count;
+		root.parent = 0;
+		UpdateNodeBounds(0);
+		Subdivide(0);
+
+		for (Uint32 slot = 0; slot < primitive_count; ++slot) primitive_slots[primitives[slot].id] = slot;
+	}
+
+	void BoundingVolumeHierarchy::Clear()
+	{
+		nodes.clear();
+		primitives.clear();
+		primitive_slots.clear();
+		primitive_leaves.clear();
+		dirty_leaves.clear();
+	}
+
+	void BoundingVolumeHierarchy::UpdateBounds(Uint32 id, BoundingBox const& box)
+	{
+		ADRIA_ASSERT(id < primitive_leaves.size());
+		Primitive& primitive = primitives[primitive_slots[id]];
+		SetBounds(primitive.min, primitive.max, box);
+		dirty_leaves.push_back(primitive_leaves[id]);
+	}
+
+	void BoundingVolumeHierarchy::Refit()
+	{
+		if (dirty_leaves.empty()) return;
+
+		//walking every path costs more than one bottom-up sweep once a larger part of the scene moved
+		if (dirty_leaves.size() * 8 > nodes.size())
+		{
+			for (Uint64 i = nodes.size(); i-- > 0;) UpdateNodeBounds((Uint32)i);
+		}
+		else
+		{
+			std::sort(dirty_leaves.begin(), dirty_leaves.end());
+			dirty_leaves.erase(std::unique(dirty_leaves.begin(), dirty_leaves.end()), dirty_leaves.end());
+			for (Uint32 node_index : dirty_leaves)
+			{
+				while (true)
+				{
+					UpdateNodeBounds(node_index);
+					if (node_index == 0) break;
+					node_index = nodes[node_index].parent;
+				}
+			}
+		}
+		dirty_leaves.clear();
+	}
+
+	void BoundingVolumeHierarchy::QueryFrustum(BoundingFrustum const& frustum, std::vector<Uint32>& ids) const
+	{
+		CullingView const view = MakeCullingView(frustum);
+		auto FrustumTest = [&view](Float const* min, Float const* max) { return ClassifyBounds(min, max, view); };
+		Traverse(FrustumTest, FrustumTest, ids);
+	}
+
+	void BoundingVolumeHierarchy::QueryBox(BoundingBox const& box, std::vector<Uint32>& ids) const
+	{
+		Float const box_min[3] = { box.Center.x - box.Extents.x, box.Center.y - box.Extents.y, box.Center.z - box.Extents.z };
+		Float const box_max[3] = { box.Center.x + box.Extents.x, box.Center.y + box.Extents.y, box.Center.z + box.Extents.z };
+		auto BoxTest = [&](Float const* min, Float const* max)
+		{
+			Containment result = Containment::Inside;
+			for (Uint32 axis = 0; axis < 3; ++axis)
+			{
+				if (min[axis] > box_max[axis] || max[axis] < box_min[axis]) return Containment::Outside;
+				if (min[axis] < box_min[axis] || max[axis] > box_max[axis]) result = Containment::Intersects;
+			}
+			return result;
+		};
+		Traverse(BoxTest, BoxTest, ids);
+	}
+
+	void BoundingVolumeHierarchy::QuerySphere(BoundingSphere const& sphere, std::vector<Uint32>& ids) const
+	{
+		Float const center[3] = { sphere.Center.x, sphere.Center.y, sphere.Center.z };
+		Float const radius_sq = sphere.Radius * sphere.Radius;
+		auto SphereTest = [&](Float const* min, Float const* max)
+		{
+			Float closest_sq = 0.0f, farthest_sq = 0.0f;
+			for (Uint32 axis = 0; axis < 3; ++axis)
+			{
+				Float const closest = std::clamp(center[axis], min[axis], max[axis]) - center[axis];
+				Float const farthest = std::max(center[axis] - min[axis], max[axis] - center[axis]);
+				closest_sq += closest * closest;
+				farthest_sq += farthest * farthest;
+			}
+			if (closest_sq > radius_sq) return Containment::Outside;
+			return farthest_sq <= radius_sq ? Containment::Inside : Containment::Intersects;
+		};
+		Traverse(SphereTest, SphereTest, ids);
+	}
+
+	void BoundingVolumeHierarchy::QueryRay(Ray const& ray, Float max_distance, std::vector<Uint32>& ids) const
+	{
+		Float const origin[3] = { ray.position.x, ray.position.y, ray.position.z };
+		//1 / 0 would give 0 * inf = NaN for slabs starting at the origin, an axis the ray is parallel to only needs the origin inside the slab
+		Bool const parallel[3] = { ray.direction.x == 0.0f, ray.direction.y == 0.0f, ray.direction.z == 0.0f };
+		Float const inv_direction[3] = { parallel[0] ? 0.0f : 1.0f / ray.direction.x, parallel[1] ? 0.0f : 1.0f / ray.direction.y, parallel[2] ? 0.0f : 1.0f / ray.direction.z };
+		auto RayTest = [&](Float const* min, Float const* max)
+		{
+			Float t_min = 0.0f, t_max = max_distance;
+			for (Uint32 axis = 0; axis < 3; ++axis)
+			{
+				if (parallel[axis])
+				{
+					if (origin[axis] < min[axis] || origin[axis] > max[axis]) return Containment::Outside;
+					continue;
+				}
+				Float t0 = (min[axis] - origin[axis]) * inv_direction[axis];
+				Float t1 = (max[axis] - origin[axis]) * inv_direction[axis];
+				if (t0 > t1) std::swap(t0, t1);
+				t_min = std::max(t_min, t0);
+				t_max = std::min(t_max, t1);
+			}
+			return t_min <= t_max ? Containment::Intersects : Containment::Outside;
+		};
+		Traverse(RayTest, RayTest, ids);
+	}
+
+	void BoundingVolumeHierarchy::CullMultiView(std::span<CullingView const> views, std::span<Uint64> visibility) const
+	{
+		Uint64 const word_count = GetMaskWordCount();
+		ADRIA_ASSERT(visibility.size() >= views.size() * word_count);
+		std::fill_n(visibility.begin(), views.size() * word_count, 0ull);
+		if (nodes.empty()) return;
+
+		struct StackEntry
+		{
+			Uint32 node_index;
+			Uint64 view_mask;
+		};
+		StackEntry stack[MaxDepth + 1];
+		Uint32 stack_size = 0;
+		for (Uint64 first_view = 0; first_view < views.size(); first_view += 64)
+		{
+			Uint64 const group_size = std::min<Uint64>(64, views.size() - first_view);
+			auto MarkVisible = [&](Uint64 view, Uint32 id)
+			{
+				visibility[(first_view + view) * word_count + id / 64] |= 1ull << (id % 64);
+			};
+
+			stack[stack_size++] = { 0, group_size == 64 ? ~0ull : (1ull << group_size) - 1 };
+			while (stack_size > 0)
+			{
+				StackEntry entry = stack[--stack_size];
+				Node const& node = nodes[entry.node_index];
+
+				for (Uint64 mask = entry.view_mask; mask != 0; mask &= mask - 1)
+				{
+					Uint64 const view = std::countr_zero(mask);
+					Containment const containment = ClassifyBounds(node.min, node.max, views[first_view + view]);
+					if (containment == Containment::Intersects) continue;
+
+					entry.view_mask &= ~(1ull << view);
+					if (containment == Containment::Inside)
+					{
+						for (Uint32 i = 0; i < node.primitive_count; ++i) MarkVisible(view, primitives[node.first_primitive + i].id);
+					}
+				}
+				if (entry.view_mask == 0) continue;
+
+				if (node.left_child == 0)
+				{
+					for (Uint32 i = 0; i < node.primitive_count; ++i)
+					{
+						Primitive const& primitive = primitives[node.first_primitive + i];
+						for (Uint64 mask = entry.view_mask; mask != 0; mask &= mask - 1)
+						{
+							Uint64 const view = std::countr_zero(mask);
+							if (ClassifyBounds(primitive.min, primitive.max, views[first_view + view]) != Containment::Outside) MarkVisible(view, primitive.id);
+						}
+					}
+				}
+				else
+				{
+					ADRIA_ASSERT(stack_size + 2 <= MaxDepth + 1);
+					stack[stack_size++] = { node.left_child + 1, entry.view_mask };
+					stack[stack_size++] = { node.left_child, entry.view_mask };
+				}
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::Subdivide(Uint32 root_index)
+	{
+		struct Bin
+		{
+			Float  min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			Float  max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			Uint32 primitive_count = 0;
+		};
+
+		struct StackEntry
+		{
+			Uint32 node_index;
+			Uint32 depth;
+		};
+		std::vector<StackEntry> stack{ { root_index, 0 } };
+		while (!stack.empty())
+		{
+			auto const [node_index, depth] = stack.back();
+			stack.pop_back();
+
+			Uint32 const first = nodes[node_index].first_primitive;
+			Uint32 const count = nodes[node_index].primitive_count;
+			auto MakeLeaf = [&]()
+			{
+				for (Uint32 i = 0; i < count; ++i) primitive_leaves[primitives[first + i].id] = node_index;
+			};
+			if (count <= MaxLeafSize || depth == MaxDepth)
+			{
+				MakeLeaf();
+				continue;
+			}
+
+			Float centroid_min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+			Float centroid_max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+			for (Uint32 i = 0; i < count; ++i)
+			{
+				Primitive const& primitive = primitives[first + i];
+				Float const centroid[3] = { (primitive.min[0] + primitive.max[0]) * 0.5f, (primitive.min[1] + primitive.max[1]) * 0.5f, (primitive.min[2] + primitive.max[2]) * 0.5f };
+				GrowBounds(centroid_min, centroid_max, centroid, centroid);
+			}
+
+			Float best_cost = FLT_MAX;
+			Uint32 best_axis = 0, best_split = 0;
+			for (Uint32 axis = 0; axis < 3; ++axis)
+			{
+				Float const extent = centroid_max[axis] - centroid_min[axis];
+				if (extent <= 0.0f) continue;
+
+				Bin bins[BinCount];
+				Float const scale = BinCount / extent;
+				for (Uint32 i = 0; i < count; ++i)
+				{
+					Primitive const& primitive = primitives[first + i];
+					Float const centroid = (primitive.min[axis] + primitive.max[axis]) * 0.5f;
+					Bin& bin = bins[std::min(BinCount - 1, (Uint32)((centroid - centroid_min[axis]) * scale))];
+					GrowBounds(bin.min, bin.max, primitive.min, primitive.max);
+					++bin.primitive_count;
+				}
+
+				Float right_areas[BinCount];
+				Uint32 right_counts[BinCount];
+				Bin right_bounds;
+				for (Uint32 i = BinCount - 1; i > 0; --i)
+				{
+					GrowBounds(right_bounds.min, right_bounds.max, bins[i].min, bins[i].max);
+					right_bounds.primitive_count += bins[i].primitive_count;
+					right_areas[i] = right_bounds.primitive_count ? SurfaceArea(right_bounds.min, right_bounds.max) : 0.0f;
+					right_counts[i] = right_bounds.primitive_count;
+				}
+
+				Bin left_bounds;
+				for (Uint32 split = 1; split < BinCount; ++split)
+				{
+					GrowBounds(left_bounds.min, left_bounds.max, bins[split - 1].min, bins[split - 1].max);
+					left_bounds.primitive_count += bins[split - 1].primitive_count;
+					if (left_bounds.primitive_count == 0 || right_counts[split] == 0) continue;
+
+					Float const cost = left_bounds.primitive_count * SurfaceArea(left_bounds.min, left_bounds.max) + right_counts[split] * right_areas[split];
+					if (cost < best_cost)
+					{
+						best_cost = cost;
+						best_axis = axis;
+						best_split = split;
+					}
+				}
+			}
+
+			Float const leaf_cost = count * SurfaceArea(nodes[node_index].min, nodes[node_index].max);
+			if (best_split == 0 || best_cost >= leaf_cost)
+			{
+				MakeLeaf();
+				continue;
+			}
+
+			Float const scale = BinCount / (centroid_max[best_axis] - centroid_min[best_axis]);
+			auto middle = std::partition(primitives.begin() + first, primitives.begin() + first + count, [&](Primitive const& primitive)
+				{
+					Float const centroid = (primitive.min[best_axis] + primitive.max[best_axis]) * 0.5f;
+					return std::min(BinCount - 1, (Uint32)((centroid - centroid_min[best_axis]) * scale)) < best_split;
+				});
+			Uint32 const left_count = (Uint32)(middle - (primitives.begin() + first));
+			if (left_count == 0 || left_count == count)
+			{
+				MakeLeaf();
+				continue;
+			}
+
+			Uint32 const left_child = (Uint32)nodes.size();
+			Node& left = nodes.emplace_back();
+			left.left_child = 0;
+			left.first_primitive = first;
+			left.primitive_count = left_count;
+			left.parent = node_index;
+			Node& right = nodes.emplace_back();
+			right.left_child = 0;
+			right.first_primitive = first + left_count;
+			right.primitive_count = count - left_count;
+			right.parent = node_index;
+			nodes[node_index].left_child = left_child;
+
+			UpdateNodeBounds(left_child);
+			UpdateNodeBounds(left_child + 1);
+			stack.push_back({ left_child + 1, depth + 1 });
+			stack.push_back({ left_child, depth + 1 });
+		}
+	}
+
+	void BoundingVolumeHierarchy::UpdateNodeBounds(Uint32 node_index)
+	{
+		Node& node = nodes[node_index];
+		std::fill_n(node.min, 3, FLT_MAX);
+		std::fill_n(node.max, 3, -FLT_MAX);
+		if (node.left_child == 0)
+		{
+			for (Uint32 i = 0; i < node.primitive_count; ++i)
+			{
+				Primitive const& primitive = primitives[node.first_primitive + i];
+				GrowBounds(node.min, node.max, primitive.min, primitive.max);
+			}
+		}
+		else
+		{
+			Node const& left = nodes[node.left_child];
+			Node const& right = nodes[node.left_child + 1];
+			GrowBounds(node.min, node.max, left.min, left.max);
+			GrowBounds(node.min, node.max, right.min, right.max);
+		}
+	}
+}
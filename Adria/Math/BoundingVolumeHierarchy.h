@@ -0,0 +1,72 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <DirectXCollision.h>
+
+namespace adria
+{
+	struct CullingView;
+
+	//binned SAH bounding volume hierarchy over world space AABBs, primitives are identified by their index in the Build span
+	class BoundingVolumeHierarchy
+	{
+		static constexpr Uint32 MaxLeafSize = 4;
+		static constexpr Uint32 BinCount = 16;
+		//nodes at this depth become leaves whatever their size, so a traversal never needs more than MaxDepth + 1 stack entries
+		static constexpr Uint32 MaxDepth = 64;
+
+		struct Node
+		{
+			Float  min[3];
+			Float  max[3];
+			Uint32 left_child;	//0 for leaves, right child is left_child + 1
+			Uint32 first_primitive;
+			Uint32 primitive_count;
+			Uint32 parent;
+		};
+
+		struct Primitive
+		{
+			Float  min[3];
+			Float  max[3];
+			Uint32 id;
+		};
+
+	public:
+		BoundingVolumeHierarchy() = default;
+
+		void Build(std::span<BoundingBox const> boxes);
+		void Clear();
+
+		//moves a primitive, the tree is updated on the next Refit
+		void UpdateBounds(Uint32 id, BoundingBox const& box);
+		//only the paths from moved primitives to the root are refitted, the topology is kept
+		void Refit();
+
+		Uint32 GetPrimitiveCount() const { return (Uint32)primitives.size(); }
+		Uint32 GetNodeCount() const { return (Uint32)nodes.size(); }
+		Uint64 GetMaskWordCount() const { return (primitives.size() + 63) / 64; }
+
+		//ids of the primitives whose bounds intersect the query volume, appended in no particular order
+		void QueryFrustum(BoundingFrustum const& frustum, std::vector<Uint32>& ids) const;
+		void QueryBox(BoundingBox const& box, std::vector<Uint32>& ids) const;
+		void QuerySphere(BoundingSphere const& sphere, std::vector<Uint32>& ids) const;
+		void QueryRay(Ray const& ray, Float max_distance, std::vector<Uint32>& ids) const;
+
+		//same output as CullBoundingBoxesMultiView, subtrees fully inside a view are accepted without testing their primitives
+		void CullMultiView(std::span<CullingView const> views, std::span<Uint64> visibility) const;
+
+	private:
+		std::vector<Node>	nodes;
+		std::vector<Primitive> primitives;		//in leaf order, every node covers a contiguous range
+		std::vector<Uint32> primitive_slots;	//id -> index into primitives
+		std::vector<Uint32> primitive_leaves;	//id -> leaf node
+		std::vector<Uint32> dirty_leaves;
+
+	private:
+		void Subdivide(Uint32 node_index);
+		void UpdateNodeBounds(Uint32 node_index);
+		template<typename NodeTest, typename PrimitiveTest>
+		void Traverse(NodeTest&& node_test, PrimitiveTest&& primitive_test, std::vector<Uint32>& ids) const;
+	};
+}
@@ -27,6 +27,12 @@ namespace adria
 		DirectX::PackedVector::XMHALF2 packed(x, y);
 		return packed.v;
 	}
+	Vector2 UnpackTwoFloatsFromUint32(Uint32 packed)
+	{
+		DirectX::PackedVector::XMHALF2 half2;
+		half2.v = packed;
+		return Vector2(DirectX::PackedVector::XMConvertHalfToFloat(half2.x), DirectX::PackedVector::XMConvertHalfToFloat(half2.y));
+	}
 	Uint64 PackFourFloatsToUint64(Float x, Float y, Float z, Float w)
 	{
 		DirectX::PackedVector::XMHALF4 packed(x, y, z, w);
@@ -40,4 +46,35 @@ namespace adria
 		Uint32 packed_value = (static_cast<Uint32>(value1) << 16) | static_cast<Uint32>(value2);
 		return packed_value;
 	}
+
+	Int16 PackSnorm16(Float value)
+	{
+		return (Int16)std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+	}
+	Float UnpackSnorm16(Int16 value)
+	{
+		return std::max(value / 32767.0f, -1.0f);
+	}
+
+	Vector2 EncodeNormalOctahedron(Vector3 const& n)
+	{
+		Float const l1_norm = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+		if (l1_norm == 0.0f) return Vector2(0.0f, 0.0f);
+
+		Vector2 f(n.x / l1_norm, n.y / l1_norm);
+		if (n.z < 0.0f)
+		{
+			f = Vector2((1.0f - std::abs(f.y)) * (f.x >= 0.0f ? 1.0f : -1.0f), (1.0f - std::abs(f.x)) * (f.y >= 0.0f ? 1.0f : -1.0f));
+		}
+		return f;
+	}
+	Vector3 DecodeNormalOctahedron(Vector2 const& f)
+	{
+		Vector3 n(f.x, f.y, 1.0f - std::abs(f.x) - std::abs(f.y));
+		Float const t = std::clamp(-n.z, 0.0f, 1.0f);
+		n.x += n.x >= 0.0f ? -t : t;
+		n.y += n.y >= 0.0f ? -t : t;
+		n.Normalize();
+		return n;
+	}
 }
@@ -12,7 +12,15 @@ namespace adria
 	Uint32 PackToUint(Float(&arr)[3]);
 
 	Uint32 PackTwoFloatsToUint32(Float x, Float y);
+	Vector2 UnpackTwoFloatsFromUint32(Uint32 packed);
 	Uint64 PackFourFloatsToUint64(Float x, Float y, Float z, Float w);
 
 	Uint32 PackTwoUint16ToUint32(Uint16 value1, Uint16 value2);
+
+	Int16 PackSnorm16(Float value);
+	Float UnpackSnorm16(Int16 value);
+
+	//matches EncodeNormalOctahedron and DecodeNormalOctahedron in Packing.hlsli
+	Vector2 EncodeNormalOctahedron(Vector3 const& n);
+	Vector3 DecodeNormalOctahedron(Vector2 const& f);
 }
\ No newline at end of file
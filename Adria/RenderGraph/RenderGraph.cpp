@@ -1,4 +1,3 @@
-#include <stack>
 #include <format>
 #include <fstream>
 #include "RenderGraph.h"
@@ -10,12 +9,11 @@
 #include "Core/Paths.h"
 #include "Core/ConsoleManager.h"
 #include "Graphics/GfxTracyProfiler.h"
-
-#if GFX_MULTITHREADED
-#define RG_MULTITHREADED 1
-#else
-#define RG_MULTITHREADED 0
-#endif
+#include "Graphics/GfxCommandQueue.h"
+#include "Graphics/GfxRingDescriptorAllocator.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/HashUtil.h"
+#include "Utilities/Timer.h"
 
 ADRIA_DEBUGZONE_BEGIN
 
@@ -27,9 +25,41 @@ namespace adria
 #else
 	static constexpr Bool g_UseDependencyLevels = true;
 #endif
+	static constexpr Uint64 g_MinParallelPasses = 2;
 
 	static TAutoConsoleVariable<Bool> RGCullPasses("rg.CullPasses", true, "Determines if the render graph should cull unused passes or not");
 	static TAutoConsoleVariable<Bool> RGAsyncCompute("rg.AsyncCompute", false, "Determines if the async compute is enabled or not");
+	static TAutoConsoleVariable<Bool> RGTransientAliasing("rg.TransientAliasing", true, "Determines if transient textures are placed in shared heaps and alias memory based on their lifetimes");
+	static TAutoConsoleVariable<Bool> RGBarrierPlanner("rg.BarrierPlanner", true, "Determines if the render graph should merge read to read transitions and split transitions that can begin before the consuming dependency level");
+	static TAutoConsoleVariable<Bool> RGMultithreaded("rg.Multithreaded", false, "Determines if passes of a dependency level are recorded into their own command lists on worker threads");
+	static TAutoConsoleVariable<Bool> RGUseCompileCache("rg.CompileCache", true, "Determines if the render graph should reuse compilation results of structurally identical graphs");
+
+	namespace
+	{
+		constexpr Uint64 MixHash(Uint64 x)
+		{
+			x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+			x ^= x >> 27; x *= 0x94d049bb133111ebull;
+			x ^= x >> 31;
+			return x;
+		}
+
+		template<typename IdType>
+		Uint64 HashIdSet(std::unordered_set<IdType> const& ids)
+		{
+			Uint64 hash = MixHash(ids.size());
+			for (IdType const& id : ids) hash += MixHash(id.id);
+			return hash;
+		}
+
+		template<typename IdType>
+		Uint64 HashStateMap(std::unordered_map<IdType, GfxResourceState> const& state_map)
+		{
+			Uint64 hash = MixHash(state_map.size());
+			for (auto const& [id, state] : state_map) hash += MixHash(MixHash(id.id) ^ (Uint64)state);
+			return hash;
+		}
+	}
 
 	RGTextureId RenderGraph::DeclareTexture(RGResourceName name, RGTextureDesc const& desc)
 	{
@@ -98,6 +128,11 @@ namespace adria
 	}
 
 	RenderGraph::~RenderGraph()
+	{
+		Reset();
+	}
+
+	void RenderGraph::Reset()
 	{
 		for (auto& [tex_id, view_vector] : texture_view_map)
 		{
@@ -123,34 +158,69 @@ namespace adria
 		{
 			for (auto [view, type] : view_vector) gfx->FreeDescriptorCPU(view, GfxDescriptorHeapType::CBV_SRV_UAV);
 		}
+
+		blackboard.Clear();
+		passes.clear();
+		textures.clear();
+		buffers.clear();
+		events.clear();
+		pending_event_indices.clear();
+		dependencies = {};
+		dependency_levels = {};
+		texture_timeline = {};
+		buffer_timeline = {};
+		barrier_plan_stats = {};
+		texture_name_id_map.clear();
+		buffer_name_id_map.clear();
+		buffer_uav_counter_map.clear();
+		texture_view_desc_map.clear();
+		texture_view_map.clear();
+		buffer_view_desc_map.clear();
+		buffer_view_map.clear();
+		allocator.Reset();
 	}
 
 	void RenderGraph::Compile()
 	{
 		ZoneScopedN("RenderGraph::Compile");
-		BuildAdjacencyLists();
-		TopologicalSort();
-		if (g_UseDependencyLevels)
+		Timer compile_timer;
+
+		Bool const use_compile_cache = compile_cache != nullptr && RGUseCompileCache.Get();
+		Uint64 graph_hash = 0;
+		RGCompileCache::CompiledGraph const* compiled_graph = nullptr;
+		if (use_compile_cache)
 		{
-			BuildDependencyLevels();
+			graph_hash = ComputeGraphHash();
+			compiled_graph = compile_cache->Find(graph_hash);
+		}
+
+		if (compiled_graph)
+		{
+			LoadCompiledGraph(*compiled_graph);
 		}
 		else
 		{
-			Uint64 max_level = passes.size();
-			dependency_levels.reserve(max_level);
-			for (Uint32 i = 0; i < max_level; ++i)
+			ResolveDependencies();
+			CullPasses();
+			ResolveAsync();
+			ResolveEvents();
+			CalculateResourcesLifetime();
+			texture_timeline = allocator.AllocateArray<ResourceStateTimeline>(textures.size());
+			buffer_timeline = allocator.AllocateArray<ResourceStateTimeline>(buffers.size());
+			for (DependencyLevel& dependency_level : dependency_levels)
 			{
-				dependency_levels.emplace_back(*this, i);
-				dependency_levels[i].AddPass(passes[i]);
+				dependency_level.Setup();
 			}
+			PlanDependencyLevelBarriers();
+			if (use_compile_cache) SaveCompiledGraph(compile_cache->Add(graph_hash));
 		}
-		CullPasses();
-		ResolveAsync();
-		ResolveEvents();
-		CalculateResourcesLifetime();
-		for (DependencyLevel& dependency_level : dependency_levels)
+		CreateImportedResourceViews();
+
+		if (use_compile_cache)
 		{
-			dependency_level.Setup();
+			Float const compile_time = (Float)compile_timer.Elapsed();
+			if (compiled_graph) compile_cache->OnHit(compile_time);
+			else compile_cache->OnMiss(compile_time);
 		}
 		if (g_DumpRenderGraph) Dump("rendergraph.gv");
 	}
@@ -158,16 +228,16 @@ namespace adria
 	void RenderGraph::Execute()
 	{
 		ZoneScopedN("RenderGraph::Execute");
-#if RG_MULTITHREADED
-		Execute_Multithreaded();
-#else
-		Execute_Singlethreaded();
-#endif
+		Bool const multithreaded = RGMultithreaded.Get();
+		gfx->GetDescriptorAllocator()->SetThreadSafe(multithreaded);
+		if (multithreaded) Execute_Multithreaded();
+		else Execute_Singlethreaded();
 	}
 
 	void RenderGraph::Execute_Singlethreaded()
 	{
 		pool.Tick();
+		PlaceTransientTextures();
 
 		RenderGraphExecutionContext exec_ctx{};
 		exec_ctx.gfx = gfx;
@@ -186,7 +256,167 @@ namespace adria
 
 	void RenderGraph::Execute_Multithreaded()
 	{
-		ADRIA_ASSERT_MSG(false, "Not yet implemented!");
+		pool.Tick();
+		PlaceTransientTextures();
+
+		RenderGraphExecutionContext exec_ctx{};
+		exec_ctx.gfx = gfx;
+		exec_ctx.graphics_cmd_list = gfx->GetGraphicsCommandList();
+		exec_ctx.compute_cmd_list = gfx->GetComputeCommandList();
+		exec_ctx.graphics_fence = &gfx->GetGraphicsFence();
+		exec_ctx.compute_fence = &gfx->GetComputeFence();
+		exec_ctx.graphics_fence_value = gfx->GetGraphicsFenceValue();
+		exec_ctx.compute_fence_value = gfx->GetComputeFenceValue();
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			DependencyLevel& dependency_level = dependency_levels[i];
+			dependency_level.Execute_Multithreaded(exec_ctx);
+		}
+	}
+
+	void RenderGraph::PlaceTransientTextures()
+	{
+		if (!RGTransientAliasing.Get())
+		{
+			pool.PlaceTransientTextures({});
+			return;
+		}
+
+		std::span<Uint64> texture_indices;
+		std::span<RGTransientTexture> transient_textures = CollectTransientTextures(texture_indices);
+		std::span<RGPlacedTexture const> placed_textures = pool.PlaceTransientTextures(transient_textures);
+		for (Uint64 i = 0; i < transient_textures.size(); ++i)
+		{
+			RGPlacedTexture const& placed_texture = placed_textures[i];
+			RGTexture* texture = textures[texture_indices[i]];
+			texture->resource = placed_texture.texture.get();
+			texture->placed = true;
+			texture->aliased = placed_texture.aliased || placed_texture.newly_placed;
+		}
+	}
+
+	//placeable transient textures with the dependency levels they are alive in, texture_indices maps them back to textures
+	std::span<RGTransientTexture> RenderGraph::CollectTransientTextures(std::span<Uint64>& texture_indices)
+	{
+		std::span<Uint32> first_level = allocator.AllocateArray<Uint32>(textures.size());
+		std::span<Uint32> last_level = allocator.AllocateArray<Uint32>(textures.size());
+		std::fill(first_level.begin(), first_level.end(), Uint32(-1));
+		std::fill(last_level.begin(), last_level.end(), Uint32(-1));
+		for (Uint32 i = 0; i < dependency_levels.size(); ++i)
+		{
+			DependencyLevel const& dependency_level = dependency_levels[i];
+			for (RGTextureId tex_id : dependency_level.texture_creates) first_level[tex_id.id] = i;
+			for (TextureStateEntry const& entry : dependency_level.texture_states)
+			{
+				if (entry.destroyed) last_level[entry.id.id] = i;
+			}
+		}
+
+		//async compute passes overlap later dependency levels on the gpu so their textures cannot alias
+		for (RGPassBase* pass : passes)
+		{
+			if (pass->IsCulled() || pass->type != RGPassType::AsyncCompute) continue;
+			for (RGTextureId tex_id : pass->texture_reads)  first_level[tex_id.id] = Uint32(-1);
+			for (RGTextureId tex_id : pass->texture_writes) first_level[tex_id.id] = Uint32(-1);
+		}
+
+		Uint64 transient_texture_count = 0;
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			if (IsTransientTexturePlaceable(i, first_level, last_level)) ++transient_texture_count;
+		}
+		std::span<RGTransientTexture> transient_textures = allocator.AllocateArray<RGTransientTexture>(transient_texture_count);
+		texture_indices = allocator.AllocateArray<Uint64>(transient_texture_count);
+		transient_texture_count = 0;
+		for (Uint64 i = 0; i < textures.size(); ++i)
+		{
+			if (!IsTransientTexturePlaceable(i, first_level, last_level)) continue;
+			texture_indices[transient_texture_count] = i;
+			RGTransientTexture& transient_texture = transient_textures[transient_texture_count++];
+			transient_texture.desc = textures[i]->desc;
+			transient_texture.first_level = first_level[i];
+			transient_texture.last_level = last_level[i];
+		}
+		return transient_textures;
+	}
+
+	void RenderGraph::PlanDependencyLevelBarriers()
+	{
+		barrier_plan_stats = {};
+		if (!RGBarrierPlanner.Get()) return;
+
+		//split barriers cannot span a submission of the graphics command list
+		std::span<Bool> level_fences = allocator.AllocateArray<Bool>(dependency_levels.size());
+		std::span<Bool> fixed_textures = allocator.AllocateArray<Bool>(textures.size());
+		std::span<Bool> fixed_buffers = allocator.AllocateArray<Bool>(buffers.size());
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			level_fences[i] = RGMultithreaded.Get();
+			for (RGPassBase* pass : dependency_levels[i].passes)
+			{
+				if (pass->IsCulled()) continue;
+				if (pass->wait_value != UINT64_MAX || pass->signal_value != UINT64_MAX) level_fences[i] = true;
+#if GFX_ASYNC_COMPUTE
+				if (pass->type == RGPassType::AsyncCompute && RGAsyncCompute.Get())
+				{
+					level_fences[i] = true;
+					for (auto const& [resource, state] : pass->texture_state_map) fixed_textures[resource.id] = true;
+					for (auto const& [resource, state] : pass->buffer_state_map) fixed_buffers[resource.id] = true;
+				}
+#endif
+			}
+		}
+
+		auto PlanResourceBarriers = [this, level_fences]<typename ResourceId>(std::span<ResourceStateEntry<ResourceId>> DependencyLevel::* level_states,
+			Uint64 resource_count, std::span<Bool const> fixed_resources)
+			{
+				Uint64 use_count = 0;
+				for (DependencyLevel const& dependency_level : dependency_levels) use_count += (dependency_level.*level_states).size();
+
+				std::span<RGBarrierPlanUse> uses = allocator.AllocateArray<RGBarrierPlanUse>(use_count);
+				use_count = 0;
+				for (Uint32 i = 0; i < dependency_levels.size(); ++i)
+				{
+					for (ResourceStateEntry<ResourceId> const& entry : dependency_levels[i].*level_states)
+					{
+						RGBarrierPlanUse& use = uses[use_count++];
+						use.resource = static_cast<Uint32>(entry.id.id);
+						use.level = i;
+						use.state = entry.state;
+					}
+				}
+
+				RGBarrierPlanInput plan_input{};
+				plan_input.uses = uses;
+				plan_input.resource_count = static_cast<Uint32>(resource_count);
+				plan_input.fixed_resources = fixed_resources;
+				plan_input.level_fences = level_fences;
+				RGBarrierPlanStats const stats = PlanBarriers(plan_input);
+
+				use_count = 0;
+				for (DependencyLevel& dependency_level : dependency_levels)
+				{
+					for (ResourceStateEntry<ResourceId>& entry : dependency_level.*level_states)
+					{
+						RGBarrierPlanUse const& use = uses[use_count++];
+						ADRIA_ASSERT(use.has_prev_state == entry.has_prev_state);
+						entry.state = use.planned_state;
+						if (use.has_prev_state) entry.prev_state = use.prev_state;
+						entry.split_begin = use.split_begin;
+						entry.split_end = use.split_end;
+						entry.next_state = use.next_state;
+					}
+				}
+				return stats;
+			};
+		barrier_plan_stats += PlanResourceBarriers(&DependencyLevel::texture_states, textures.size(), fixed_textures);
+		barrier_plan_stats += PlanResourceBarriers(&DependencyLevel::buffer_states, buffers.size(), fixed_buffers);
+	}
+
+	Bool RenderGraph::IsTransientTexturePlaceable(Uint64 i, std::span<Uint32 const> first_level, std::span<Uint32 const> last_level) const
+	{
+		RGTexture const* rg_texture = textures[i].get();
+		return !rg_texture->imported && first_level[i] != Uint32(-1) && last_level[i] != Uint32(-1) && pool.CanPlaceTexture(rg_texture->desc);
 	}
 
 	void RenderGraph::AddExportBufferCopyPass(RGResourceName export_buffer, GfxBuffer* buffer)
@@ -228,74 +458,42 @@ namespace adria
 			}, RGPassType::Copy, RGPassFlags::ForceNoCull);
 	}
 
-	void RenderGraph::BuildAdjacencyLists()
+	void RenderGraph::ResolveDependencies()
 	{
-		adjacency_lists.resize(passes.size());
-		for (Uint64 i = 0; i < passes.size(); ++i)
-		{
-			RGPassBase* pass = passes[i];
-			std::vector<Uint64>& pass_adjacency_list = adjacency_lists[i];
-			for (Uint64 j = i + 1; j < passes.size(); ++j)
+		auto GetResourceIndices = [this]<typename ResourceId>(std::unordered_set<ResourceId> const& resources)
 			{
-				RGPassBase* other_pass = passes[j];
-				Bool depends = false;
-				for (RGTextureId other_node_read : other_pass->texture_reads)
-				{
-					if (pass->texture_writes.find(other_node_read) != pass->texture_writes.end())
-					{
-						pass_adjacency_list.push_back(j);
-						depends = true;
-						break;
-					}
-				}
-				if (depends) continue;
-
-				for (RGBufferId other_node_read : other_pass->buffer_reads)
-				{
-					if (pass->buffer_writes.find(other_node_read) != pass->buffer_writes.end())
-					{
-						pass_adjacency_list.push_back(j);
-						break;
-					}
-				}
-			}
-		}
-	}
+				std::span<Uint32> indices = allocator.AllocateArray<Uint32>(resources.size());
+				Uint64 index_count = 0;
+				for (ResourceId resource : resources) indices[index_count++] = resource.id;
+				return std::span<Uint32 const>(indices);
+			};
 
-	void RenderGraph::TopologicalSort()
-	{
-		std::vector<Uint64> sort{};
-		std::vector<Bool>  visited(passes.size(), false);
-		for (Uint64 i = 0; i < passes.size(); i++)
+		std::span<RGPassAccesses> pass_accesses = allocator.AllocateArray<RGPassAccesses>(passes.size());
+		for (Uint64 i = 0; i < passes.size(); ++i)
 		{
-			if (visited[i] == false) DepthFirstSearch(i, visited, topologically_sorted_passes);
+			RGPassBase const* pass = passes[i];
+			pass_accesses[i].texture_reads = GetResourceIndices(pass->texture_reads);
+			pass_accesses[i].texture_writes = GetResourceIndices(pass->texture_writes);
+			pass_accesses[i].buffer_reads = GetResourceIndices(pass->buffer_reads);
+			pass_accesses[i].buffer_writes = GetResourceIndices(pass->buffer_writes);
 		}
-		std::reverse(topologically_sorted_passes.begin(), topologically_sorted_passes.end());
+		dependencies = BuildDependencies(allocator, pass_accesses, textures.size(), buffers.size(), g_UseDependencyLevels);
+		CreateDependencyLevels();
 	}
 
-	void RenderGraph::BuildDependencyLevels()
+	void RenderGraph::CreateDependencyLevels()
 	{
-		std::vector<Uint64> distances(topologically_sorted_passes.size(), 0);
-		for (Uint64 u = 0; u < topologically_sorted_passes.size(); ++u)
+		static_assert(std::is_trivially_destructible_v<DependencyLevel>, "Dependency levels live in the arena which doesn't run their destructors");
+		Uint64 const level_count = dependencies.dependency_levels.GetListCount();
+		DependencyLevel* levels = static_cast<DependencyLevel*>(allocator.Allocate(sizeof(DependencyLevel) * level_count, alignof(DependencyLevel)));
+		for (Uint32 i = 0; i < level_count; ++i)
 		{
-			Uint64 i = topologically_sorted_passes[u];
-			for (Uint64 v : adjacency_lists[i])
-			{
-				if (distances[v] < distances[i] + 1) distances[v] = distances[i] + 1;
-			}
-		}
-
-		Uint64 max_level = *std::max_element(std::begin(distances), std::end(distances)) + 1;
-		dependency_levels.reserve(max_level);
-		for (Uint32 i = 0; i < max_level; ++i)
-		{
-			dependency_levels.emplace_back(*this, i); 
-		}
-		for (Uint32 i = 0; i < passes.size(); ++i)
-		{
-			Uint64 level = distances[i];
-			dependency_levels[level].AddPass(passes[i]);
+			DependencyLevel* dependency_level = new (levels + i) DependencyLevel(*this, i);
+			std::span<Uint32 const> level_passes = dependencies.dependency_levels[i];
+			dependency_level->passes = allocator.AllocateArray<RGPassBase*>(level_passes.size());
+			for (Uint64 j = 0; j < level_passes.size(); ++j) dependency_level->passes[j] = passes[level_passes[j]];
 		}
+		dependency_levels = std::span<DependencyLevel>(levels, level_count);
 	}
 
 	void RenderGraph::CullPasses()
@@ -331,14 +529,15 @@ namespace adria
 			return;
 		}
 
-		std::stack<RenderGraphResource*> zero_ref_resources;
-		for (auto& texture : textures) if (texture->ref_count == 0) zero_ref_resources.push(texture.get());
-		for (auto& buffer : buffers)   if (buffer->ref_count == 0) zero_ref_resources.push(buffer.get());
+		//every resource reaches a zero ref count at most once so the stack never holds more than all of them
+		std::span<RenderGraphResource*> zero_ref_resources = allocator.AllocateArray<RenderGraphResource*>(textures.size() + buffers.size());
+		Uint64 zero_ref_count = 0;
+		for (auto& texture : textures) if (texture->ref_count == 0) zero_ref_resources[zero_ref_count++] = texture.get();
+		for (auto& buffer : buffers)   if (buffer->ref_count == 0) zero_ref_resources[zero_ref_count++] = buffer.get();
 
-		while (!zero_ref_resources.empty())
+		while (zero_ref_count > 0)
 		{
-			RenderGraphResource* unreferenced_resource = zero_ref_resources.top();
-			zero_ref_resources.pop();
+			RenderGraphResource* unreferenced_resource = zero_ref_resources[--zero_ref_count];
 			RGPassBase* writer = unreferenced_resource->writer;
 			if (writer == nullptr || !writer->CanBeCulled()) continue;
 			if (--writer->ref_count == 0)
@@ -346,12 +545,12 @@ namespace adria
 				for (RGTextureId id : writer->texture_reads)
 				{
 					RGTexture* texture = GetRGTexture(id);
-					if (--texture->ref_count == 0) zero_ref_resources.push(texture);
+					if (--texture->ref_count == 0) zero_ref_resources[zero_ref_count++] = texture;
 				}
 				for (RGBufferId id : writer->buffer_reads)
 				{
 					RGBuffer* buffer = GetRGBuffer(id);
-					if (--buffer->ref_count == 0) zero_ref_resources.push(buffer);
+					if (--buffer->ref_count == 0) zero_ref_resources[zero_ref_count++] = buffer;
 				}
 			}
 		}
@@ -392,26 +591,58 @@ namespace adria
 			}
 		}
 
+		auto AssignDestroys = [this]<typename ResourceId, typename Resource>(std::vector<std::unique_ptr<Resource>> const& resources, std::span<ResourceId> RGPassBase::* pass_destroys)
+			{
+				std::span<Uint32> destroy_counts = allocator.AllocateArray<Uint32>(passes.size());
+				for (auto const& resource : resources)
+				{
+					if (resource->last_used_by != nullptr) ++destroy_counts[resource->last_used_by->id];
+				}
+				for (RGPassBase* pass : passes)
+				{
+					pass->*pass_destroys = allocator.AllocateArray<ResourceId>(destroy_counts[pass->id]);
+					destroy_counts[pass->id] = 0;
+				}
+				for (Uint64 i = 0; i < resources.size(); ++i)
+				{
+					if (RGPassBase* pass = resources[i]->last_used_by) (pass->*pass_destroys)[destroy_counts[pass->id]++] = ResourceId(i);
+				}
+			};
+		AssignDestroys(textures, &RGPassBase::texture_destroys);
+		AssignDestroys(buffers, &RGPassBase::buffer_destroys);
+	}
+
+	void RenderGraph::CreateImportedResourceViews()
+	{
 		for (Uint64 i = 0; i < textures.size(); ++i)
 		{
-			if (textures[i]->last_used_by != nullptr) textures[i]->last_used_by->texture_destroys.insert(RGTextureId(i));
 			if (textures[i]->imported) CreateTextureViews(RGTextureId(i));
 		}
 		for (Uint64 i = 0; i < buffers.size(); ++i)
 		{
-			if (buffers[i]->last_used_by != nullptr) buffers[i]->last_used_by->buffer_destroys.insert(RGBufferId(i));
 			if (buffers[i]->imported) CreateBufferViews(RGBufferId(i));
 		}
 	}
 
-	void RenderGraph::DepthFirstSearch(Uint64 i, std::vector<Bool>& visited, std::vector<Uint64>& topologically_sorted_passes)
+	RGPassBase* RenderGraph::FindPreviousGraphicsPass(std::span<Uint32 const> pass_indices, Uint64 pass_index) const
+	{
+		auto it = std::lower_bound(pass_indices.begin(), pass_indices.end(), pass_index);
+		while (it != pass_indices.begin())
+		{
+			RGPassBase* pre_pass = passes[*--it];
+			if (!pre_pass->IsCulled() && pre_pass->type != RGPassType::AsyncCompute) return pre_pass;
+		}
+		return nullptr;
+	}
+
+	RGPassBase* RenderGraph::FindNextGraphicsPass(std::span<Uint32 const> pass_indices, Uint64 pass_index) const
 	{
-		visited[i] = true;
-		for (auto j : adjacency_lists[i])
+		for (auto it = std::upper_bound(pass_indices.begin(), pass_indices.end(), pass_index); it != pass_indices.end(); ++it)
 		{
-			if (!visited[j]) DepthFirstSearch(j, visited, topologically_sorted_passes);
+			RGPassBase* post_pass = passes[*it];
+			if (!post_pass->IsCulled() && post_pass->type != RGPassType::AsyncCompute) return post_pass;
 		}
-		topologically_sorted_passes.push_back(i);
+		return nullptr;
 	}
 
 	void RenderGraph::ResolveAsync()
@@ -428,7 +659,7 @@ namespace adria
 		Uint64 compute_fence = 0;
 		Uint64 graphics_fence = 0;
 
-		for (Uint64 pass_index : topologically_sorted_passes)
+		for (Uint64 pass_index : dependencies.topologically_sorted_passes)
 		{
 			RGPassBase* pass = passes[pass_index];
 			if (pass->IsCulled()) continue;
@@ -437,58 +668,30 @@ namespace adria
 			{
 				for (RGTextureId read_texture : pass->texture_reads)
 				{
-					for (Int64 i = (Int64)pass_index - 1; i >= 0; --i)
+					if (RGPassBase* pre_pass = FindPreviousGraphicsPass(dependencies.texture_writers[read_texture.id], pass_index))
 					{
-						RGPassBase* pre_pass = passes[i];
-						if (pre_pass->IsCulled() || pre_pass->type == RGPassType::AsyncCompute) continue;
-
-						if (pre_pass->texture_writes.find(read_texture) != pre_pass->texture_writes.end())
-						{
-							pre_graphics_queue_passes.insert(pre_pass);
-							break;
-						}
+						pre_graphics_queue_passes.insert(pre_pass);
 					}
 				}
 				for (RGBufferId read_buffer : pass->buffer_reads)
 				{
-					for (Int64 i = (Int64)pass_index - 1; i >= 0; --i)
+					if (RGPassBase* pre_pass = FindPreviousGraphicsPass(dependencies.buffer_writers[read_buffer.id], pass_index))
 					{
-						RGPassBase* pre_pass = passes[i];
-						if (pre_pass->IsCulled() || pre_pass->type == RGPassType::AsyncCompute) continue;
-
-						if (pre_pass->buffer_writes.find(read_buffer) != pre_pass->buffer_writes.end())
-						{
-							pre_graphics_queue_passes.insert(pre_pass);
-							break;
-						}
+						pre_graphics_queue_passes.insert(pre_pass);
 					}
 				}
 				for (RGTextureId write_texture : pass->texture_writes)
 				{
-					for (Uint64 i = pass_index + 1; i < passes.size(); ++i)
+					if (RGPassBase* post_pass = FindNextGraphicsPass(dependencies.texture_readers[write_texture.id], pass_index))
 					{
-						RGPassBase* post_pass = passes[i];
-						if (post_pass->IsCulled() || post_pass->type == RGPassType::AsyncCompute) continue;
-
-						if (post_pass->texture_reads.find(write_texture) != post_pass->texture_reads.end())
-						{
-							post_graphics_queue_passes.insert(post_pass);
-							break;
-						}
+						post_graphics_queue_passes.insert(post_pass);
 					}
 				}
 				for (RGBufferId write_buffer : pass->buffer_writes)
 				{
-					for (Uint64 i = pass_index + 1; i < passes.size(); ++i)
+					if (RGPassBase* post_pass = FindNextGraphicsPass(dependencies.buffer_readers[write_buffer.id], pass_index))
 					{
-						RGPassBase* post_pass = passes[i];
-						if (post_pass->IsCulled() || post_pass->type == RGPassType::AsyncCompute) continue;
-
-						if (post_pass->buffer_reads.find(write_buffer) != post_pass->buffer_reads.end())
-						{
-							pre_graphics_queue_passes.insert(post_pass);
-							break;
-						}
+						post_graphics_queue_passes.insert(post_pass);
 					}
 				}
 				compute_queue_passes.push_back(pass);
@@ -539,7 +742,9 @@ namespace adria
 
 	void RenderGraph::ResolveEvents()
 	{
-		std::vector<Uint32> events_to_start;
+		//an event is started by a single pass so culled passes never carry more than all of them
+		std::span<Uint32> events_to_start = allocator.AllocateArray<Uint32>(events.size());
+		Uint64 events_to_start_count = 0;
 		Uint32 events_to_add = 0;
 		RGPassBase* last_active_pass = nullptr;
 		for (RGPassBase* const pass : passes)
@@ -549,22 +754,174 @@ namespace adria
 				while (pass->num_events_to_end > 0 && pass->events_to_start.size() > 0)
 				{
 					pass->num_events_to_end--;
-					pass->events_to_start.pop_back();
+					pass->events_to_start = pass->events_to_start.first(pass->events_to_start.size() - 1);
 				}
-				for (Uint32 event_idx : pass->events_to_start) events_to_start.push_back(event_idx);
+				for (Uint32 event_idx : pass->events_to_start) events_to_start[events_to_start_count++] = event_idx;
 				events_to_add += pass->num_events_to_end;
 			}
 			else
 			{
-				for (Uint32 eventIndex : events_to_start) pass->events_to_start.push_back(eventIndex);
+				if (events_to_start_count > 0)
+				{
+					std::span<Uint32> pass_events_to_start = allocator.AllocateArray<Uint32>(pass->events_to_start.size() + events_to_start_count);
+					auto it = std::copy(pass->events_to_start.begin(), pass->events_to_start.end(), pass_events_to_start.begin());
+					std::copy_n(events_to_start.begin(), events_to_start_count, it);
+					pass->events_to_start = pass_events_to_start;
+				}
 				pass->num_events_to_end += events_to_add;
-				events_to_start.clear();
+				events_to_start_count = 0;
 				events_to_add = 0;
 				last_active_pass = pass;
 			}
 		}
 		if (last_active_pass) last_active_pass->num_events_to_end += events_to_add;
-		ADRIA_ASSERT(events_to_start.empty());
+		ADRIA_ASSERT(events_to_start_count == 0);
+	}
+
+	Uint64 RenderGraph::ComputeGraphHash() const
+	{
+		HashState hash;
+		hash.Combine(RGCullPasses.Get());
+		hash.Combine(RGAsyncCompute.Get());
+		hash.Combine(RGBarrierPlanner.Get());
+		hash.Combine(RGMultithreaded.Get());
+
+		hash.Combine(passes.size());
+		for (RGPassBase const* pass : passes)
+		{
+			hash.Combine(pass->name);
+			hash.Combine((Uint64)pass->type);
+			hash.Combine((Uint64)pass->flags);
+			hash.Combine(HashIdSet(pass->texture_creates));
+			hash.Combine(HashIdSet(pass->texture_reads));
+			hash.Combine(HashIdSet(pass->texture_writes));
+			hash.Combine(HashStateMap(pass->texture_state_map));
+			hash.Combine(HashIdSet(pass->buffer_creates));
+			hash.Combine(HashIdSet(pass->buffer_reads));
+			hash.Combine(HashIdSet(pass->buffer_writes));
+			hash.Combine(HashStateMap(pass->buffer_state_map));
+			hash.Combine(pass->events_to_start.size());
+			for (Uint32 event_idx : pass->events_to_start) hash.Combine(event_idx);
+			hash.Combine(pass->num_events_to_end);
+		}
+
+		hash.Combine(textures.size());
+		for (auto const& texture : textures)
+		{
+			GfxTextureDesc const& desc = texture->desc;
+			hash.Combine(texture->imported);
+			hash.Combine((Uint64)desc.type);
+			hash.Combine(desc.width);
+			hash.Combine(desc.height);
+			hash.Combine(desc.depth);
+			hash.Combine(desc.array_size);
+			hash.Combine(desc.mip_levels);
+			hash.Combine((Uint64)desc.format);
+			hash.Combine((Uint64)desc.bind_flags);
+			hash.Combine((Uint64)desc.initial_state);
+		}
+		hash.Combine(buffers.size());
+		for (auto const& buffer : buffers)
+		{
+			GfxBufferDesc const& desc = buffer->desc;
+			hash.Combine(buffer->imported);
+			hash.Combine(desc.size);
+			hash.Combine(desc.stride);
+			hash.Combine((Uint64)desc.format);
+			hash.Combine((Uint64)desc.bind_flags);
+			hash.Combine((Uint64)desc.misc_flags);
+		}
+		return hash;
+	}
+
+	void RenderGraph::SaveCompiledGraph(RGCompileCache::CompiledGraph& compiled_graph) const
+	{
+		compiled_graph.dependencies.Save(dependencies);
+
+		compiled_graph.dependency_levels.resize(dependency_levels.size());
+		for (Uint64 i = 0; i < dependency_levels.size(); ++i)
+		{
+			DependencyLevel const& dependency_level = dependency_levels[i];
+			RGCompileCache::CompiledDependencyLevel& compiled_level = compiled_graph.dependency_levels[i];
+			compiled_level.texture_states.assign(dependency_level.texture_states.begin(), dependency_level.texture_states.end());
+			compiled_level.texture_creates.assign(dependency_level.texture_creates.begin(), dependency_level.texture_creates.end());
+			compiled_level.buffer_states.assign(dependency_level.buffer_states.begin(), dependency_level.buffer_states.end());
+			compiled_level.buffer_creates.assign(dependency_level.buffer_creates.begin(), dependency_level.buffer_creates.end());
+		}
+		compiled_graph.barrier_plan_stats = barrier_plan_stats;
+
+		compiled_graph.passes.resize(passes.size());
+		for (Uint64 i = 0; i < passes.size(); ++i)
+		{
+			RGPassBase const* pass = passes[i];
+			RGCompileCache::CompiledPass& compiled_pass = compiled_graph.passes[i];
+			compiled_pass.ref_count = pass->ref_count;
+			compiled_pass.wait_graphics_pass_id = pass->wait_graphics_pass_id;
+			compiled_pass.signal_graphics_pass_id = pass->signal_graphics_pass_id;
+			compiled_pass.signal_value = pass->signal_value;
+			compiled_pass.wait_value = pass->wait_value;
+			compiled_pass.events_to_start.assign(pass->events_to_start.begin(), pass->events_to_start.end());
+			compiled_pass.num_events_to_end = pass->num_events_to_end;
+		}
+
+		auto SaveResource = [](RenderGraphResource const& resource)
+			{
+				RGCompileCache::CompiledResource compiled_resource{};
+				compiled_resource.ref_count = resource.ref_count;
+				compiled_resource.writer = resource.writer ? resource.writer->id : UINT64_MAX;
+				compiled_resource.last_used_by = resource.last_used_by ? resource.last_used_by->id : UINT64_MAX;
+				return compiled_resource;
+			};
+		compiled_graph.textures.resize(textures.size());
+		for (Uint64 i = 0; i < textures.size(); ++i) compiled_graph.textures[i] = SaveResource(*textures[i]);
+		compiled_graph.buffers.resize(buffers.size());
+		for (Uint64 i = 0; i < buffers.size(); ++i) compiled_graph.buffers[i] = SaveResource(*buffers[i]);
+	}
+
+	void RenderGraph::LoadCompiledGraph(RGCompileCache::CompiledGraph const& compiled_graph)
+	{
+		ZoneScopedN("RenderGraph::LoadCompiledGraph");
+		dependencies = compiled_graph.dependencies.Load(allocator);
+		CreateDependencyLevels();
+
+		auto LoadArray = [this]<typename T>(std::vector<T> const& compiled_array)
+			{
+				std::span<T> array = allocator.AllocateArray<T>(compiled_array.size());
+				std::copy(compiled_array.begin(), compiled_array.end(), array.begin());
+				return array;
+			};
+		for (Uint32 i = 0; i < compiled_graph.dependency_levels.size(); ++i)
+		{
+			RGCompileCache::CompiledDependencyLevel const& compiled_level = compiled_graph.dependency_levels[i];
+			DependencyLevel& dependency_level = dependency_levels[i];
+			dependency_level.texture_states = LoadArray(compiled_level.texture_states);
+			dependency_level.texture_creates = LoadArray(compiled_level.texture_creates);
+			dependency_level.buffer_states = LoadArray(compiled_level.buffer_states);
+			dependency_level.buffer_creates = LoadArray(compiled_level.buffer_creates);
+		}
+		barrier_plan_stats = compiled_graph.barrier_plan_stats;
+
+		for (Uint64 i = 0; i < passes.size(); ++i)
+		{
+			RGPassBase* pass = passes[i];
+			RGCompileCache::CompiledPass const& compiled_pass = compiled_graph.passes[i];
+			pass->ref_count = compiled_pass.ref_count;
+			pass->wait_graphics_pass_id = compiled_pass.wait_graphics_pass_id;
+			pass->signal_graphics_pass_id = compiled_pass.signal_graphics_pass_id;
+			pass->signal_value = compiled_pass.signal_value;
+			pass->wait_value = compiled_pass.wait_value;
+			pass->events_to_start = LoadArray(compiled_pass.events_to_start);
+			pass->num_events_to_end = compiled_pass.num_events_to_end;
+		}
+
+		auto LoadResource = [this](RenderGraphResource& resource, RGCompileCache::CompiledResource const& compiled_resource)
+			{
+				resource.ref_count = compiled_resource.ref_count;
+				resource.writer = compiled_resource.writer != UINT64_MAX ? passes[compiled_resource.writer] : nullptr;
+				resource.last_used_by = compiled_resource.last_used_by != UINT64_MAX ? passes[compiled_resource.last_used_by] : nullptr;
+			};
+		for (Uint64 i = 0; i < textures.size(); ++i) LoadResource(*textures[i], compiled_graph.textures[i]);
+		for (Uint64 i = 0; i < buffers.size(); ++i) LoadResource(*buffers[i], compiled_graph.buffers[i]);
 	}
 
 	RGTexture* RenderGraph::GetRGTexture(RGTextureId handle) const
@@ -995,35 +1352,92 @@ namespace adria
 		return views[res_id.GetViewId()].first;
 	}
 
-	void RenderGraph::DependencyLevel::AddPass(RenderGraphPassBase* pass)
-	{
-		passes.push_back(pass);
-		texture_reads.insert(pass->texture_reads.begin(), pass->texture_reads.end());
-		texture_writes.insert(pass->texture_writes.begin(), pass->texture_writes.end());
-		buffer_reads.insert(pass->buffer_reads.begin(), pass->buffer_reads.end());
-		buffer_writes.insert(pass->buffer_writes.begin(), pass->buffer_writes.end());
-	}
-
 	void RenderGraph::DependencyLevel::Setup()
 	{
+		Uint64 max_texture_states = 0, max_buffer_states = 0;
+		Uint64 texture_create_count = 0, buffer_create_count = 0;
+		for (RGPassBase* pass : passes)
+		{
+			if (pass->IsCulled()) continue;
+			max_texture_states += pass->texture_state_map.size();
+			max_buffer_states += pass->buffer_state_map.size();
+			texture_create_count += pass->texture_creates.size();
+			buffer_create_count += pass->buffer_creates.size();
+		}
+		texture_states = rg.allocator.AllocateArray<TextureStateEntry>(max_texture_states);
+		buffer_states = rg.allocator.AllocateArray<BufferStateEntry>(max_buffer_states);
+		texture_creates = rg.allocator.AllocateArray<RGTextureId>(texture_create_count);
+		buffer_creates = rg.allocator.AllocateArray<RGBufferId>(buffer_create_count);
+
+		auto AddResourceState = [this]<typename ResourceId>(std::span<ResourceStateTimeline> timeline, std::span<ResourceStateEntry<ResourceId>> states,
+			Uint64& state_count, ResourceId id, GfxResourceState state)
+			{
+				ResourceStateTimeline& resource_timeline = timeline[id.id];
+				if (resource_timeline.last_level == level_index)
+				{
+					states[resource_timeline.last_entry].state |= state;
+					return;
+				}
+				ResourceStateEntry<ResourceId>& entry = states[state_count];
+				entry.id = id;
+				entry.state = state;
+				entry.has_prev_state = resource_timeline.last_level != Uint32(-1);
+				entry.prev_state = resource_timeline.last_state;
+				resource_timeline.last_level = level_index;
+				resource_timeline.last_entry = static_cast<Uint32>(state_count++);
+			};
+
+		Uint64 texture_state_count = 0, buffer_state_count = 0;
+		texture_create_count = 0, buffer_create_count = 0;
 		for (RGPassBase* pass : passes)
 		{
 			if (pass->IsCulled()) continue;
 
-			texture_creates.insert(pass->texture_creates.begin(), pass->texture_creates.end());
-			texture_destroys.insert(pass->texture_destroys.begin(), pass->texture_destroys.end());
 			for (auto [resource, state] : pass->texture_state_map)
 			{
-				texture_state_map[resource] |= state;
+				AddResourceState(rg.texture_timeline, texture_states, texture_state_count, resource, state);
 			}
+			for (RGTextureId resource : pass->texture_creates) texture_creates[texture_create_count++] = resource;
 
-			buffer_creates.insert(pass->buffer_creates.begin(), pass->buffer_creates.end());
-			buffer_destroys.insert(pass->buffer_destroys.begin(), pass->buffer_destroys.end());
 			for (auto [resource, state] : pass->buffer_state_map)
 			{
-				buffer_state_map[resource] |= state;
+				AddResourceState(rg.buffer_timeline, buffer_states, buffer_state_count, resource, state);
 			}
+			for (RGBufferId resource : pass->buffer_creates) buffer_creates[buffer_create_count++] = resource;
 		}
+		texture_states = texture_states.first(texture_state_count);
+		buffer_states = buffer_states.first(buffer_state_count);
+
+		for (RGPassBase* pass : passes)
+		{
+			if (pass->IsCulled()) continue;
+
+			for (RGTextureId resource : pass->texture_creates)
+			{
+				ResourceStateTimeline const& resource_timeline = rg.texture_timeline[resource.id];
+				if (resource_timeline.last_level == level_index) texture_states[resource_timeline.last_entry].created = true;
+			}
+			for (RGTextureId resource : pass->texture_destroys)
+			{
+				ResourceStateTimeline const& resource_timeline = rg.texture_timeline[resource.id];
+				ADRIA_ASSERT(resource_timeline.last_level == level_index);
+				texture_states[resource_timeline.last_entry].destroyed = true;
+			}
+			for (RGBufferId resource : pass->buffer_creates)
+			{
+				ResourceStateTimeline const& resource_timeline = rg.buffer_timeline[resource.id];
+				if (resource_timeline.last_level == level_index) buffer_states[resource_timeline.last_entry].created = true;
+			}
+			for (RGBufferId resource : pass->buffer_destroys)
+			{
+				ResourceStateTimeline const& resource_timeline = rg.buffer_timeline[resource.id];
+				ADRIA_ASSERT(resource_timeline.last_level == level_index);
+				buffer_states[resource_timeline.last_entry].destroyed = true;
+			}
+		}
+
+		for (TextureStateEntry const& entry : texture_states) rg.texture_timeline[entry.id.id].last_state = entry.state;
+		for (BufferStateEntry const& entry : buffer_states)   rg.buffer_timeline[entry.id.id].last_state = entry.state;
 	}
 
 	void RenderGraph::DependencyLevel::Execute(RenderGraphExecutionContext const& exec_ctx)
@@ -1053,197 +1467,243 @@ namespace adria
 				}
 			}
 
-			for (Uint32 event_idx : pass->events_to_start)
-			{
-				cmd_list->BeginEvent(rg.events[event_idx].name, GfxEventColor(0xff, 0xff, 0x00));
-			}
+			ExecutePass(pass, cmd_list);
 
-			RenderGraphContext rg_resources(rg, *pass);
-			if (pass->type == RGPassType::Graphics)
+			if (pass->signal_value != UINT64_MAX)
 			{
-				GfxRenderPassDesc render_pass_desc{};
-				render_pass_desc.flags = GfxRenderPassFlagBit_None;
-				render_pass_desc.rtv_attachments.reserve(pass->render_targets_info.size());
-				for (auto const& render_target_info : pass->render_targets_info)
+				cmd_list->End();
+				if (pass->type == RGPassType::AsyncCompute)
+				{
+					cmd_list->Signal(*exec_ctx.compute_fence, exec_ctx.compute_fence_value + pass->signal_value);
+					exec_ctx.gfx->SetComputeFenceValue(exec_ctx.compute_fence_value + pass->signal_value);
+				}
+				else
 				{
-					GfxColorAttachmentDesc rtv_desc{};
+					cmd_list->Signal(*exec_ctx.graphics_fence, exec_ctx.graphics_fence_value + pass->signal_value);
+					exec_ctx.gfx->SetGraphicsFenceValue(exec_ctx.graphics_fence_value + pass->signal_value);
+				}
+				cmd_list->Submit();
+				cmd_list->Begin();
+			}
+		} 
+		PostExecute(exec_ctx.graphics_cmd_list);
+	}
 
-					RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
-					RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
-					SplitAccessOp(render_target_info.render_target_access, load_access, store_access);
+	void RenderGraph::DependencyLevel::Execute_Multithreaded(RenderGraphExecutionContext const& exec_ctx)
+	{
+		RenderGraphParallelRecorder<RGPassBase, GfxCommandList>& parallel_recorder = rg.pool.GetParallelRecorder();
+		parallel_recorder.Clear();
+		for (RGPassBase* pass : passes)
+		{
+			if (pass->IsCulled()) continue;
+#if GFX_ASYNC_COMPUTE
+			if (pass->type == RGPassType::AsyncCompute && RGAsyncCompute.Get())
+			{
+				Execute(exec_ctx);
+				return;
+			}
+#endif
+			if (pass->wait_value != UINT64_MAX || pass->signal_value != UINT64_MAX)
+			{
+				Execute(exec_ctx);
+				return;
+			}
+			//render graph events can span passes so they have to be recorded into one command list
+			if (!pass->events_to_start.empty() || pass->num_events_to_end > 0)
+			{
+				Execute(exec_ctx);
+				return;
+			}
+			parallel_recorder.AddPass(pass);
+		}
+		if (parallel_recorder.GetPassCount() < g_MinParallelPasses)
+		{
+			Execute(exec_ctx);
+			return;
+		}
 
-					switch (load_access)
-					{
-					case RGLoadAccessOp::Clear:
-						rtv_desc.beginning_access = GfxLoadAccessOp::Clear;
-						break;
-					case RGLoadAccessOp::Discard:
-						rtv_desc.beginning_access = GfxLoadAccessOp::Discard;
-						break;
-					case RGLoadAccessOp::Preserve:
-						rtv_desc.beginning_access = GfxLoadAccessOp::Preserve;
-						break;
-					case RGLoadAccessOp::NoAccess:
-						rtv_desc.beginning_access = GfxLoadAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
-					}
+		PreExecute(exec_ctx.graphics_cmd_list);
+		parallel_recorder.Record(exec_ctx.graphics_cmd_list,
+			[this]() { return rg.pool.AllocateCommandList(); },
+			[this](RGPassBase* pass, GfxCommandList* cmd_list) { ExecutePass(pass, cmd_list); },
+			[](Uint64 count, auto&& task) { ParallelFor(count, task); });
+		PostExecute(exec_ctx.graphics_cmd_list);
+	}
 
-					switch (store_access)
-					{
-					case RGStoreAccessOp::Resolve:
-						rtv_desc.ending_access = GfxStoreAccessOp::Resolve;
-						break;
-					case RGStoreAccessOp::Discard:
-						rtv_desc.ending_access = GfxStoreAccessOp::Discard;
-						break;
-					case RGStoreAccessOp::Preserve:
-						rtv_desc.ending_access = GfxStoreAccessOp::Preserve;
-						break;
-					case RGStoreAccessOp::NoAccess:
-						rtv_desc.ending_access = GfxStoreAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
-					}
+	void RenderGraph::DependencyLevel::ExecutePass(RGPassBase* pass, GfxCommandList* cmd_list)
+	{
+		for (Uint32 event_idx : pass->events_to_start)
+		{
+			cmd_list->BeginEvent(rg.events[event_idx].name, GfxEventColor(0xff, 0xff, 0x00));
+		}
 
-					RGTextureId rt_texture = render_target_info.render_target_handle.GetResourceId();
-					GfxTexture* texture = rg.GetTexture(rt_texture);
+		RenderGraphContext rg_resources(rg, *pass);
+		if (pass->type == RGPassType::Graphics)
+		{
+			GfxRenderPassDesc render_pass_desc{};
+			render_pass_desc.flags = GfxRenderPassFlagBit_None;
+			render_pass_desc.rtv_attachments.reserve(pass->render_targets_info.size());
+			for (auto const& render_target_info : pass->render_targets_info)
+			{
+				GfxColorAttachmentDesc rtv_desc{};
 
-					GfxTextureDesc const& desc = texture->GetDesc();
-					GfxClearValue const& clear_value = desc.clear_value;
-					if (clear_value.active_member != GfxClearValue::GfxActiveMember::None)
-					{
-						ADRIA_ASSERT_MSG(clear_value.active_member == GfxClearValue::GfxActiveMember::Color, "Invalid Clear Value for Render Target");
-						rtv_desc.clear_value = desc.clear_value;
-						rtv_desc.clear_value.format = desc.format;
-					}
-					else if(rtv_desc.beginning_access == GfxLoadAccessOp::Clear)
-					{
-						rtv_desc.clear_value.format = desc.format;
-						rtv_desc.clear_value = GfxClearValue(0.0f, 0.0f, 0.0f, 0.0f);
-					}
+				RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
+				RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
+				SplitAccessOp(render_target_info.render_target_access, load_access, store_access);
 
-					rtv_desc.cpu_handle = rg.GetRenderTarget(render_target_info.render_target_handle);
-					render_pass_desc.rtv_attachments.push_back(rtv_desc);
+				switch (load_access)
+				{
+				case RGLoadAccessOp::Clear:
+					rtv_desc.beginning_access = GfxLoadAccessOp::Clear;
+					break;
+				case RGLoadAccessOp::Discard:
+					rtv_desc.beginning_access = GfxLoadAccessOp::Discard;
+					break;
+				case RGLoadAccessOp::Preserve:
+					rtv_desc.beginning_access = GfxLoadAccessOp::Preserve;
+					break;
+				case RGLoadAccessOp::NoAccess:
+					rtv_desc.beginning_access = GfxLoadAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
 				}
 
-				if (pass->depth_stencil.has_value())
+				switch (store_access)
 				{
-					auto const& depth_stencil_info = pass->depth_stencil.value();
-					if (depth_stencil_info.depth_read_only)
-					{
-						render_pass_desc.flags |= GfxRenderPassFlagBit_ReadOnlyDepth;
-					}
-					
-					GfxDepthAttachmentDesc dsv_desc{};
-					RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
-					RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
-					SplitAccessOp(depth_stencil_info.depth_access, load_access, store_access);
+				case RGStoreAccessOp::Resolve:
+					rtv_desc.ending_access = GfxStoreAccessOp::Resolve;
+					break;
+				case RGStoreAccessOp::Discard:
+					rtv_desc.ending_access = GfxStoreAccessOp::Discard;
+					break;
+				case RGStoreAccessOp::Preserve:
+					rtv_desc.ending_access = GfxStoreAccessOp::Preserve;
+					break;
+				case RGStoreAccessOp::NoAccess:
+					rtv_desc.ending_access = GfxStoreAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
+				}
 
-					switch (load_access)
-					{
-					case RGLoadAccessOp::Clear:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::Clear;
-						break;
-					case RGLoadAccessOp::Discard:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::Discard;
-						break;
-					case RGLoadAccessOp::Preserve:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::Preserve;
-						break;
-					case RGLoadAccessOp::NoAccess:
-						dsv_desc.depth_beginning_access = GfxLoadAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
-					}
+				RGTextureId rt_texture = render_target_info.render_target_handle.GetResourceId();
+				GfxTexture* texture = rg.GetTexture(rt_texture);
 
-					switch (store_access)
-					{
-					case RGStoreAccessOp::Resolve:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::Resolve;
-						break;
-					case RGStoreAccessOp::Discard:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::Discard;
-						break;
-					case RGStoreAccessOp::Preserve:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::Preserve;
-						break;
-					case RGStoreAccessOp::NoAccess:
-						dsv_desc.depth_ending_access = GfxStoreAccessOp::NoAccess;
-						break;
-					default:
-						ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
-					}
+				GfxTextureDesc const& desc = texture->GetDesc();
+				GfxClearValue const& clear_value = desc.clear_value;
+				if (clear_value.active_member != GfxClearValue::GfxActiveMember::None)
+				{
+					ADRIA_ASSERT_MSG(clear_value.active_member == GfxClearValue::GfxActiveMember::Color, "Invalid Clear Value for Render Target");
+					rtv_desc.clear_value = desc.clear_value;
+					rtv_desc.clear_value.format = desc.format;
+				}
+				else if(rtv_desc.beginning_access == GfxLoadAccessOp::Clear)
+				{
+					rtv_desc.clear_value.format = desc.format;
+					rtv_desc.clear_value = GfxClearValue(0.0f, 0.0f, 0.0f, 0.0f);
+				}
 
-					RGTextureId ds_texture = depth_stencil_info.depth_stencil_handle.GetResourceId();
-					GfxTexture* texture = rg.GetTexture(ds_texture);
+				rtv_desc.cpu_handle = rg.GetRenderTarget(render_target_info.render_target_handle);
+				render_pass_desc.rtv_attachments.push_back(rtv_desc);
+			}
 
-					GfxTextureDesc const& desc = texture->GetDesc();
-					if (desc.clear_value.active_member != GfxClearValue::GfxActiveMember::None)
-					{
-						ADRIA_ASSERT_MSG(desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil, "Invalid Clear Value for Depth Stencil");
-						dsv_desc.clear_value = desc.clear_value;
-						dsv_desc.clear_value.format = desc.format;
-					}
-					else if (dsv_desc.depth_beginning_access == GfxLoadAccessOp::Clear)
-					{
-						dsv_desc.clear_value.format = desc.format;
-						dsv_desc.clear_value = GfxClearValue(0.0f, 0);
-					}
+			if (pass->depth_stencil.has_value())
+			{
+				auto const& depth_stencil_info = pass->depth_stencil.value();
+				if (depth_stencil_info.depth_read_only)
+				{
+					render_pass_desc.flags |= GfxRenderPassFlagBit_ReadOnlyDepth;
+				}
+				
+				GfxDepthAttachmentDesc dsv_desc{};
+				RGLoadAccessOp load_access = RGLoadAccessOp::NoAccess;
+				RGStoreAccessOp store_access = RGStoreAccessOp::NoAccess;
+				SplitAccessOp(depth_stencil_info.depth_access, load_access, store_access);
 
-					dsv_desc.cpu_handle = rg.GetDepthStencil(depth_stencil_info.depth_stencil_handle);
+				switch (load_access)
+				{
+				case RGLoadAccessOp::Clear:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::Clear;
+					break;
+				case RGLoadAccessOp::Discard:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::Discard;
+					break;
+				case RGLoadAccessOp::Preserve:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::Preserve;
+					break;
+				case RGLoadAccessOp::NoAccess:
+					dsv_desc.depth_beginning_access = GfxLoadAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Load Access!");
+				}
 
-					//todo add stencil
-					render_pass_desc.dsv_attachment = dsv_desc;
+				switch (store_access)
+				{
+				case RGStoreAccessOp::Resolve:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::Resolve;
+					break;
+				case RGStoreAccessOp::Discard:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::Discard;
+					break;
+				case RGStoreAccessOp::Preserve:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::Preserve;
+					break;
+				case RGStoreAccessOp::NoAccess:
+					dsv_desc.depth_ending_access = GfxStoreAccessOp::NoAccess;
+					break;
+				default:
+					ADRIA_ASSERT_MSG(false, "Invalid Store Access!");
 				}
-				ADRIA_ASSERT_MSG((pass->viewport_width != 0 && pass->viewport_height != 0), "Viewport Width/Height is 0! The call to builder.SetViewport is probably missing...");
-				render_pass_desc.width = pass->viewport_width;
-				render_pass_desc.height = pass->viewport_height;
-				render_pass_desc.legacy = pass->UseLegacyRenderPasses();
-
-				ZoneTransientN(__tracy, pass->name.c_str(), true);
-				AdriaGfxScopedEvent(cmd_list, pass->name.c_str());
-				TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
-				cmd_list->SetContext(GfxCommandList::Context::Graphics);
-				cmd_list->BeginRenderPass(render_pass_desc);
-				pass->Execute(rg_resources, cmd_list);
-				cmd_list->EndRenderPass();
-			}
-			else
-			{
-				ZoneTransientN(__tracy, pass->name.c_str(), true);
-				AdriaGfxScopedEvent(cmd_list, pass->name.c_str());
-				TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
-				cmd_list->SetContext(GfxCommandList::Context::Compute);
-				pass->Execute(rg_resources, cmd_list);
-			}
 
-			for (Uint32 i = 0; i < pass->num_events_to_end; ++i)
-			{
-				cmd_list->EndEvent();
-			}
+				RGTextureId ds_texture = depth_stencil_info.depth_stencil_handle.GetResourceId();
+				GfxTexture* texture = rg.GetTexture(ds_texture);
 
-			if (pass->signal_value != UINT64_MAX)
-			{
-				cmd_list->End();
-				if (pass->type == RGPassType::AsyncCompute)
+				GfxTextureDesc const& desc = texture->GetDesc();
+				if (desc.clear_value.active_member != GfxClearValue::GfxActiveMember::None)
 				{
-					cmd_list->Signal(*exec_ctx.compute_fence, exec_ctx.compute_fence_value + pass->signal_value);
-					exec_ctx.gfx->SetComputeFenceValue(exec_ctx.compute_fence_value + pass->signal_value);
+					ADRIA_ASSERT_MSG(desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil, "Invalid Clear Value for Depth Stencil");
+					dsv_desc.clear_value = desc.clear_value;
+					dsv_desc.clear_value.format = desc.format;
 				}
-				else
+				else if (dsv_desc.depth_beginning_access == GfxLoadAccessOp::Clear)
 				{
-					cmd_list->Signal(*exec_ctx.graphics_fence, exec_ctx.graphics_fence_value + pass->signal_value);
-					exec_ctx.gfx->SetGraphicsFenceValue(exec_ctx.graphics_fence_value + pass->signal_value);
+					dsv_desc.clear_value.format = desc.format;
+					dsv_desc.clear_value = GfxClearValue(0.0f, 0);
 				}
-				cmd_list->Submit();
-				cmd_list->Begin();
+
+				dsv_desc.cpu_handle = rg.GetDepthStencil(depth_stencil_info.depth_stencil_handle);
+
+				//todo add stencil
+				render_pass_desc.dsv_attachment = dsv_desc;
 			}
-		} 
-		PostExecute(exec_ctx.graphics_cmd_list);
+			ADRIA_ASSERT_MSG((pass->viewport_width != 0 && pass->viewport_height != 0), "Viewport Width/Height is 0! The call to builder.SetViewport is probably missing...");
+			render_pass_desc.width = pass->viewport_width;
+			render_pass_desc.height = pass->viewport_height;
+			render_pass_desc.legacy = pass->UseLegacyRenderPasses();
+
+			ZoneTransientN(__tracy, pass->name.c_str(), true);
+			AdriaGfxScopedEvent(cmd_list, pass->name.c_str());
+			TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
+			cmd_list->SetContext(GfxCommandList::Context::Graphics);
+			cmd_list->BeginRenderPass(render_pass_desc);
+			pass->Execute(rg_resources, cmd_list);
+			cmd_list->EndRenderPass();
+		}
+		else
+		{
+			ZoneTransientN(__tracy, pass->name.c_str(), true);
+			AdriaGfxScopedEvent(cmd_list, pass->name.c_str());
+			TracyGfxProfileScope(cmd_list->GetNative(), pass->name.c_str());
+			cmd_list->SetContext(GfxCommandList::Context::Compute);
+			pass->Execute(rg_resources, cmd_list);
+		}
+
+		for (Uint32 i = 0; i < pass->num_events_to_end; ++i)
+		{
+			cmd_list->EndEvent();
+		}
 	}
 
 	void RenderGraph::DependencyLevel::PreExecute(GfxCommandList* cmd_list)
@@ -1251,74 +1711,46 @@ namespace adria
 		for (RGTextureId tex_id : texture_creates)
 		{
 			RGTexture* rg_texture = rg.GetRGTexture(tex_id);
-			rg_texture->resource = rg.pool.AllocateTexture(rg_texture->desc);
+			if (!rg_texture->placed) rg_texture->resource = rg.pool.AllocateTexture(rg_texture->desc, rg_texture->pool_handle);
 			rg.CreateTextureViews(tex_id);
 			rg_texture->SetName();
 		}
 		for (RGBufferId buf_id : buffer_creates)
 		{
 			RGBuffer* rg_buffer = rg.GetRGBuffer(buf_id);
-			rg_buffer->resource = rg.pool.AllocateBuffer(rg_buffer->desc);
+			rg_buffer->resource = rg.pool.AllocateBuffer(rg_buffer->desc, rg_buffer->pool_handle);
 			rg.CreateBufferViews(buf_id);
 			rg_buffer->SetName();
 		}
-		for (auto const& [tex_id, state] : texture_state_map)
+		for (TextureStateEntry const& entry : texture_states)
 		{
-			RGTexture* rg_texture = rg.GetRGTexture(tex_id);
+			RGTexture* rg_texture = rg.GetRGTexture(entry.id);
 			GfxTexture* texture = rg_texture->resource;
-			if (texture_creates.contains(tex_id))
+			RGBarrierResource barrier_resource{};
+			barrier_resource.initial_state = entry.created ? texture->GetDesc().initial_state : rg_texture->desc.initial_state;
+			barrier_resource.imported = rg_texture->imported;
+			barrier_resource.aliased = rg_texture->aliased;
+			RGBarrier const barrier = GetBarrierBeforeUse(entry, barrier_resource);
+			switch (barrier.type)
 			{
-				if (!HasFlag(texture->GetDesc().initial_state, state))
-				{
-					cmd_list->TextureBarrier(*texture, texture->GetDesc().initial_state, state);
-				}
-				continue;
-			}
-			Bool found = false;
-			for (Int32 j = (Int32)level_index - 1; j >= 0; --j)
-			{
-				auto& prev_dependency_level = rg.dependency_levels[j];
-				if (prev_dependency_level.texture_state_map.contains(tex_id))
-				{
-					GfxResourceState prev_state = prev_dependency_level.texture_state_map[tex_id];
-					if (prev_state != state) cmd_list->TextureBarrier(*texture, prev_state, state);
-					found = true;
-					break;
-				}
-			}
-			if (!found && rg_texture->imported)
-			{
-				GfxResourceState prev_state = rg_texture->desc.initial_state;
-				if (prev_state != state) cmd_list->TextureBarrier(*texture, prev_state, state);
+			case RGBarrierType::Aliasing:	cmd_list->AliasingBarrier(*texture, barrier.after); break;
+			case RGBarrierType::SplitEnd:	cmd_list->EndTextureBarrier(*texture, barrier.before, barrier.after); break;
+			case RGBarrierType::Transition:	cmd_list->TextureBarrier(*texture, barrier.before, barrier.after); break;
+			default: break;
 			}
 		}
-		for (auto const& [buf_id, state] : buffer_state_map)
+		for (BufferStateEntry const& entry : buffer_states)
 		{
-			RGBuffer* rg_buffer = rg.GetRGBuffer(buf_id);
+			RGBuffer* rg_buffer = rg.GetRGBuffer(entry.id);
 			GfxBuffer* buffer = rg_buffer->resource;
-			if (buffer_creates.contains(buf_id))
-			{
-				if (state != GfxResourceState::Common)
-				{
-					cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, state);
-				}
-				continue;
-			}
-			Bool found = false;
-			for (Int32 j = (Int32)level_index - 1; j >= 0; --j)
-			{
-				auto& prev_dependency_level = rg.dependency_levels[j];
-				if (prev_dependency_level.buffer_state_map.contains(buf_id))
-				{
-					GfxResourceState prev_state = prev_dependency_level.buffer_state_map[buf_id];
-					if (prev_state != state) cmd_list->BufferBarrier(*buffer, prev_state, state);
-					found = true;
-					break;
-				}
-			}
-			if (!found && rg_buffer->imported)
+			RGBarrierResource barrier_resource{};
+			barrier_resource.imported = rg_buffer->imported;
+			RGBarrier const barrier = GetBarrierBeforeUse(entry, barrier_resource);
+			switch (barrier.type)
 			{
-				if (GfxResourceState::Common != state) cmd_list->BufferBarrier(*buffer, GfxResourceState::Common, state);
+			case RGBarrierType::SplitEnd:	cmd_list->EndBufferBarrier(*buffer, barrier.before, barrier.after); break;
+			case RGBarrierType::Transition:	cmd_list->BufferBarrier(*buffer, barrier.before, barrier.after); break;
+			default: break;
 			}
 		}
 		cmd_list->FlushBarriers();
@@ -1326,24 +1758,26 @@ namespace adria
 
 	void RenderGraph::DependencyLevel::PostExecute(GfxCommandList* cmd_list)
 	{
-		for (RGTextureId tex_id : texture_destroys)
+		for (TextureStateEntry const& entry : texture_states)
 		{
-			RGTexture* rg_texture = rg.GetRGTexture(tex_id);
+			RGTexture* rg_texture = rg.GetRGTexture(entry.id);
 			GfxTexture* texture = rg_texture->resource;
+			if (entry.split_begin) cmd_list->BeginTextureBarrier(*texture, entry.state, entry.next_state);
+			if (!entry.destroyed) continue;
+
 			GfxResourceState initial_state = texture->GetDesc().initial_state;
-			ADRIA_ASSERT(texture_state_map.contains(tex_id));
-			GfxResourceState state = texture_state_map[tex_id];
-			if (initial_state != state) cmd_list->TextureBarrier(*texture, state, initial_state);
-			if (!rg_texture->imported) rg.pool.ReleaseTexture(rg_texture->resource);
+			if (initial_state != entry.state) cmd_list->TextureBarrier(*texture, entry.state, initial_state);
+			if (!rg_texture->imported && !rg_texture->placed) rg.pool.ReleaseTexture(rg_texture->pool_handle);
 		}
-		for (RGBufferId buf_id : buffer_destroys)
+		for (BufferStateEntry const& entry : buffer_states)
 		{
-			RGBuffer* rg_buffer = rg.GetRGBuffer(buf_id);
+			RGBuffer* rg_buffer = rg.GetRGBuffer(entry.id);
 			GfxBuffer* buffer = rg_buffer->resource;
-			ADRIA_ASSERT(buffer_state_map.contains(buf_id));
-			GfxResourceState state = buffer_state_map[buf_id];
-			if (state != GfxResourceState::Common) cmd_list->BufferBarrier(*buffer, state, GfxResourceState::Common);
-			if (!rg_buffer->imported) rg.pool.ReleaseBuffer(rg_buffer->resource);
+			if (entry.split_begin) cmd_list->BeginBufferBarrier(*buffer, entry.state, entry.next_state);
+			if (!entry.destroyed) continue;
+
+			if (entry.state != GfxResourceState::Common) cmd_list->BufferBarrier(*buffer, entry.state, GfxResourceState::Common);
+			if (!rg_buffer->imported) rg.pool.ReleaseBuffer(rg_buffer->pool_handle);
 		}
 		cmd_list->FlushBarriers();
 	}
@@ -1406,6 +1840,15 @@ namespace adria
 
 		graphviz.defaults += std::format("graph [style=invis, rankdir=\"{}\", ordering=out, splines=spline]\n", style.rank_dir);
 		graphviz.defaults += std::format("node [shape=record, fontname=\"{}\", fontsize={}, margin=\"0.2,0.03\"]\n", style.font.name, style.font.size);
+		if (RGTransientAliasing.Get())
+		{
+			std::span<Uint64> texture_indices;
+			RGTransientMemoryStats const transient_memory_stats = pool.ComputeTransientMemoryStats(CollectTransientTextures(texture_indices));
+			auto ToMB = [](Uint64 size) { return size / (1024.0f * 1024.0f); };
+			graphviz.defaults += std::format("graph [labelloc=\"t\", fontname=\"{}\", label=<placed transient textures: {} ({} aliased)<br/>transient memory without aliasing: {:.2f} MB<br/>transient memory with aliasing: {:.2f} MB<br/>peak live transient memory: {:.2f} MB>]\n", style.font.name,
+				transient_memory_stats.placed_texture_count, transient_memory_stats.aliased_texture_count, ToMB(transient_memory_stats.unaliased_size),
+				ToMB(transient_memory_stats.aliased_size), ToMB(transient_memory_stats.peak_live_size));
+		}
 
 		auto PairHash = [](std::pair<Uint64, Uint64> const& p)
 			{
@@ -1537,18 +1980,18 @@ namespace adria
 		}
 
 		render_graph_data += "\nAdjacency lists: \n";
-		for (Uint64 i = 0; i < adjacency_lists.size(); ++i)
+		for (Uint64 i = 0; i < dependencies.adjacency_lists.GetListCount(); ++i)
 		{
-			auto& list = adjacency_lists[i];
+			auto list = dependencies.adjacency_lists[i];
 			render_graph_data += std::format("{}. {}'s adjacency list: ", i, passes[i]->name);
 			for (auto j : list) render_graph_data += std::format(" {} ", j);
 			render_graph_data += "\n";
 		}
 
 		render_graph_data += "\nTopologically sorted passes: \n";
-		for (Uint64 i = 0; i < topologically_sorted_passes.size(); ++i)
+		for (Uint64 i = 0; i < dependencies.topologically_sorted_passes.size(); ++i)
 		{
-			Uint64& topologically_sorted_pass = topologically_sorted_passes[i];
+			Uint32 topologically_sorted_pass = dependencies.topologically_sorted_passes[i];
 			render_graph_data += std::format("{}. : {}\n", i, passes[topologically_sorted_pass]->name);
 		}
 
@@ -1559,17 +2002,19 @@ namespace adria
 			render_graph_data += std::format("Dependency level {}: \n", i);
 			for (auto pass : level.passes) render_graph_data += std::format("{}\n", pass->name);
 			render_graph_data += "\nTexture usage:\n";
-			for (auto [tex_id, state] : level.texture_state_map)
+			for (auto const& entry : level.texture_states)
 			{
-				render_graph_data += std::format("Texture ID: {}, State: {}\n", tex_id.id, ConvertBarrierFlagsToString(state));
+				render_graph_data += std::format("Texture ID: {}, State: {}\n", entry.id.id, ConvertBarrierFlagsToString(entry.state));
 			}
 			render_graph_data += "\nBuffer usage:\n";
-			for (auto [buf_id, state] : level.buffer_state_map)
+			for (auto const& entry : level.buffer_states)
 			{
-				render_graph_data += std::format("Buffer ID: {}, State: {}\n", buf_id.id, ConvertBarrierFlagsToString(state));
+				render_graph_data += std::format("Buffer ID: {}, State: {}\n", entry.id.id, ConvertBarrierFlagsToString(entry.state));
 			}
 			render_graph_data += "\n";
 		}
+		render_graph_data += std::format("\nBarriers: requested {}, planned {}, removed {}, split {}\n", barrier_plan_stats.requested_barrier_count,
+			barrier_plan_stats.planned_barrier_count, barrier_plan_stats.GetRemovedBarrierCount(), barrier_plan_stats.split_barrier_count);
 		render_graph_data += "\nTextures: \n";
 		for (Uint64 i = 0; i < textures.size(); ++i)
 		{
@@ -4,6 +4,9 @@
 #include "RenderGraphResourcePool.h"
 #include "RenderGraphEvent.h"
 #include "RenderGraphAllocator.h"
+#include "RenderGraphCompileCache.h"
+#include "RenderGraphDependencies.h"
+#include "RenderGraphBarrierPlanner.h"
 #include "Graphics/GfxDevice.h"
 
 namespace adria
@@ -24,45 +27,55 @@ namespace adria
 			Uint64 compute_fence_value;
 		};
 
+		template<typename ResourceId>
+		using ResourceStateEntry = RGResourceStateEntry<ResourceId>;
+		using TextureStateEntry = RGTextureStateEntry;
+		using BufferStateEntry = RGBufferStateEntry;
+
+		//per resource, the state it was left in by the last dependency level that used it
+		struct ResourceStateTimeline
+		{
+			GfxResourceState last_state = GfxResourceState::Common;
+			Uint32 last_level = Uint32(-1);
+			Uint32 last_entry = 0;
+		};
+
 		class DependencyLevel
 		{
 			friend RenderGraph;
 		public:
 
 			DependencyLevel(RenderGraph& rg, Uint32 level_index) : rg(rg), level_index(level_index) {}
-			void AddPass(RenderGraphPassBase* pass);
 			void Setup();
 			void Execute(RenderGraphExecutionContext const& exec_ctx);
+			void Execute_Multithreaded(RenderGraphExecutionContext const& exec_ctx);
 
 		private:
 			RenderGraph& rg;
 			Uint32 level_index;
-			std::vector<RenderGraphPassBase*> passes;
-			std::unordered_set<RGTextureId> texture_creates;
-			std::unordered_set<RGTextureId> texture_reads;
-			std::unordered_set<RGTextureId> texture_writes;
-			std::unordered_set<RGTextureId> texture_destroys;
-			std::unordered_map<RGTextureId, GfxResourceState> texture_state_map;
-
-			std::unordered_set<RGBufferId> buffer_creates;
-			std::unordered_set<RGBufferId> buffer_reads;
-			std::unordered_set<RGBufferId> buffer_writes;
-			std::unordered_set<RGBufferId> buffer_destroys;
-			std::unordered_map<RGBufferId, GfxResourceState> buffer_state_map;
+			std::span<RenderGraphPassBase*> passes;
+
+			std::span<TextureStateEntry> texture_states;
+			std::span<RGTextureId>		 texture_creates;
+			std::span<BufferStateEntry>  buffer_states;
+			std::span<RGBufferId>		 buffer_creates;
 
 		private:
 			void PreExecute(GfxCommandList*);
+			void ExecutePass(RenderGraphPassBase*, GfxCommandList*);
 			void PostExecute(GfxCommandList*);
 		};
 
 	public:
-		RenderGraph(RGResourcePool& pool) : pool(pool), allocator(128 * 1024), gfx(pool.GetDevice()) {}
+		RenderGraph(RGResourcePool& pool, RGAllocator& allocator, RGCompileCache* compile_cache = nullptr) : pool(pool), compile_cache(compile_cache), gfx(pool.GetDevice()), allocator(allocator) {}
 		ADRIA_NONCOPYABLE(RenderGraph)
 		ADRIA_DEFAULT_MOVABLE(RenderGraph)
 		~RenderGraph();
 
 		void Compile();
 		void Execute();
+		//frees the views and passes of the executed frame and empties the graph, its containers keep their capacity for the next frame
+		void Reset();
 
 		template<typename PassData, typename... Args> requires std::is_constructible_v<RenderGraphPass<PassData>, Args...>
 		ADRIA_MAYBE_UNUSED decltype(auto) AddPass(Args&&... args)
@@ -71,7 +84,8 @@ namespace adria
 			RGPassBase*& pass = passes.back(); pass->id = passes.size() - 1;
 			RenderGraphBuilder builder(*this, *pass);
 			pass->Setup(builder);
-			for (Uint32 event_idx : pending_event_indices) pass->events_to_start.push_back(event_idx);
+			pass->events_to_start = allocator.AllocateArray<Uint32>(pending_event_indices.size());
+			std::copy(pending_event_indices.begin(), pending_event_indices.end(), pass->events_to_start.begin());
 			pending_event_indices.clear();
 			return *dynamic_cast<RenderGraphPass<PassData>*>(pass);
 		}
@@ -82,6 +96,8 @@ namespace adria
 		void ExportTexture(RGResourceName name, GfxTexture* texture);
 		void ExportBuffer(RGResourceName name, GfxBuffer* buffer);
 
+		RGBarrierPlanStats const& GetBarrierPlanStats() const { return barrier_plan_stats; }
+
 		RGBlackboard const& GetBlackboard() const { return blackboard; }
 		RGBlackboard& GetBlackboard() { return blackboard; }
 
@@ -93,8 +109,9 @@ namespace adria
 
 	private:
 		RGResourcePool& pool;
+		RGCompileCache* compile_cache;
 		GfxDevice* gfx;
-		RGAllocator allocator;
+		RGAllocator& allocator;
 		RGBlackboard blackboard;
 
 		std::vector<RGPassBase*> passes;
@@ -104,9 +121,11 @@ namespace adria
 		std::vector<RGEvent> events;
 		std::vector<Uint32>  pending_event_indices;
 
-		std::vector<std::vector<Uint64>> adjacency_lists;
-		std::vector<Uint64> topologically_sorted_passes;
-		std::vector<DependencyLevel> dependency_levels;
+		RGDependencies dependencies;
+		std::span<DependencyLevel> dependency_levels;
+		std::span<ResourceStateTimeline> texture_timeline;
+		std::span<ResourceStateTimeline> buffer_timeline;
+		RGBarrierPlanStats barrier_plan_stats;
 
 		std::unordered_map<RGResourceName, RGTextureId> texture_name_id_map;
 		std::unordered_map<RGResourceName, RGBufferId>  buffer_name_id_map;
@@ -120,14 +139,22 @@ namespace adria
 
 	private:
 
-		void BuildAdjacencyLists();
-		void TopologicalSort();
-		void BuildDependencyLevels();
+		void ResolveDependencies();
+		void CreateDependencyLevels();
 		void CullPasses();
 		void CalculateResourcesLifetime();
-		void DepthFirstSearch(Uint64 i, std::vector<Bool>& visited, std::vector<Uint64>& sort);
+		void CreateImportedResourceViews();
 		void ResolveAsync();
+		RGPassBase* FindPreviousGraphicsPass(std::span<Uint32 const> pass_indices, Uint64 pass_index) const;
+		RGPassBase* FindNextGraphicsPass(std::span<Uint32 const> pass_indices, Uint64 pass_index) const;
 		void ResolveEvents();
+		void PlanDependencyLevelBarriers();
+		void PlaceTransientTextures();
+		std::span<RGTransientTexture> CollectTransientTextures(std::span<Uint64>& texture_indices);
+		Bool IsTransientTexturePlaceable(Uint64 i, std::span<Uint32 const> first_level, std::span<Uint32 const> last_level) const;
+		Uint64 ComputeGraphHash() const;
+		void SaveCompiledGraph(RGCompileCache::CompiledGraph& compiled_graph) const;
+		void LoadCompiledGraph(RGCompileCache::CompiledGraph const& compiled_graph);
 		Uint32 AddEvent(Char const* name)
 		{
 			events.emplace_back(name);
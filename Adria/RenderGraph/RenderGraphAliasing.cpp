@@ -0,0 +1,92 @@
+#include <algorithm>
+#include "RenderGraphAliasing.h"
+#include "Utilities/AllocatorUtil.h"
+
+namespace adria
+{
+	namespace
+	{
+		struct PlacedRange
+		{
+			Uint64 begin;
+			Uint64 end;
+		};
+
+		Bool LifetimesOverlap(RGAliasingRequest const& a, RGAliasingRequest const& b)
+		{
+			return a.first_level <= b.last_level && b.first_level <= a.last_level;
+		}
+	}
+
+	RGAliasingLayout ComputeAliasingLayout(std::span<RGAliasingRequest const> requests)
+	{
+		RGAliasingLayout layout{};
+		layout.offsets.resize(requests.size(), 0);
+		layout.aliased.resize(requests.size(), false);
+
+		std::vector<Uint32> placement_order(requests.size());
+		for (Uint32 i = 0; i < placement_order.size(); ++i) placement_order[i] = i;
+		std::stable_sort(placement_order.begin(), placement_order.end(), [&](Uint32 a, Uint32 b) { return requests[a].size > requests[b].size; });
+
+		std::vector<Uint32> placed;
+		std::vector<PlacedRange> occupied_ranges;
+		placed.reserve(requests.size());
+		occupied_ranges.reserve(requests.size());
+		for (Uint32 request_index : placement_order)
+		{
+			RGAliasingRequest const& request = requests[request_index];
+			layout.unaliased_size += request.size;
+			layout.heap_alignment = std::max(layout.heap_alignment, request.alignment);
+
+			occupied_ranges.clear();
+			for (Uint32 placed_index : placed)
+			{
+				if (!LifetimesOverlap(request, requests[placed_index])) continue;
+				Uint64 const begin = layout.offsets[placed_index];
+				occupied_ranges.push_back(PlacedRange{ begin, begin + requests[placed_index].size });
+			}
+			std::sort(occupied_ranges.begin(), occupied_ranges.end(), [](PlacedRange const& a, PlacedRange const& b) { return a.begin < b.begin; });
+
+			Uint64 offset = 0;
+			for (PlacedRange const& range : occupied_ranges)
+			{
+				if (Align(offset, request.alignment) + request.size <= range.begin) break;
+				offset = std::max(offset, range.end);
+			}
+			offset = Align(offset, request.alignment);
+
+			layout.offsets[request_index] = offset;
+			layout.heap_size = std::max(layout.heap_size, offset + request.size);
+			placed.push_back(request_index);
+		}
+
+		Uint32 level_count = 0;
+		for (RGAliasingRequest const& request : requests) level_count = std::max(level_count, request.last_level + 1);
+		std::vector<Int64> live_size_deltas(level_count + 1, 0);
+		for (RGAliasingRequest const& request : requests)
+		{
+			live_size_deltas[request.first_level] += request.size;
+			live_size_deltas[request.last_level + 1] -= request.size;
+		}
+		Int64 live_size = 0;
+		for (Uint32 level = 0; level < level_count; ++level)
+		{
+			live_size += live_size_deltas[level];
+			layout.peak_live_size = std::max(layout.peak_live_size, (Uint64)live_size);
+		}
+
+		for (Uint64 i = 0; i < requests.size(); ++i)
+		{
+			for (Uint64 j = i + 1; j < requests.size(); ++j)
+			{
+				Bool const memory_overlaps = layout.offsets[i] < layout.offsets[j] + requests[j].size && layout.offsets[j] < layout.offsets[i] + requests[i].size;
+				if (memory_overlaps)
+				{
+					layout.aliased[i] = true;
+					layout.aliased[j] = true;
+				}
+			}
+		}
+		return layout;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+
+namespace adria
+{
+	//one transient resource to place: memory requirements and the inclusive range of dependency levels it is alive in
+	struct RenderGraphAliasingRequest
+	{
+		Uint64 size;
+		Uint64 alignment;
+		Uint32 first_level;
+		Uint32 last_level;
+	};
+	using RGAliasingRequest = RenderGraphAliasingRequest;
+
+	struct RenderGraphAliasingLayout
+	{
+		std::vector<Uint64> offsets;
+		std::vector<Bool> aliased;			//memory range overlaps another request's
+		Uint64 heap_size = 0;
+		Uint64 heap_alignment = 0;
+		Uint64 unaliased_size = 0;			//memory needed if every request got its own allocation
+		Uint64 peak_live_size = 0;			//most memory alive in one level, no placement can get the heap below it
+	};
+	using RGAliasingLayout = RenderGraphAliasingLayout;
+
+	//CPU only interval packing: requests alive in overlapping level ranges never share memory
+	RGAliasingLayout ComputeAliasingLayout(std::span<RGAliasingRequest const> requests);
+}
@@ -1,9 +1,12 @@
 #pragma once
 #include <vector>
+#include "Utilities/AllocatorUtil.h"
 
 namespace adria
 {
 	class RenderGraph;
+
+	//chunked arena: grows on demand, Reset runs the destructors of non-trivial objects and keeps the memory for the next frame
 	class RenderGraphAllocator
 	{
 		friend class RenderGraph;
@@ -11,6 +14,7 @@ namespace adria
 		struct AllocatedObject
 		{
 			virtual ~AllocatedObject() = default;
+			AllocatedObject* next = nullptr;
 		};
 		template<typename T> requires (!std::is_trivial_v<T>)
 		struct NonTrivialAllocatedObject : public AllocatedObject
@@ -22,25 +26,29 @@ namespace adria
 
 			T object;
 		};
+
+		struct Chunk
+		{
+			std::unique_ptr<Uint8[]> data;
+			Uint64 capacity;
+		};
+
 	public:
-		RenderGraphAllocator(Uint64 size)
-			: capacity(size), data(new Uint8[size]), current_offset(data)
+		explicit RenderGraphAllocator(Uint64 chunk_size) : chunk_size(chunk_size)
 		{
+			AddChunk(chunk_size);
 		}
+		ADRIA_NONCOPYABLE_NONMOVABLE(RenderGraphAllocator)
 		~RenderGraphAllocator()
 		{
-			for (Uint32 i = 0; i < non_trivial_object_allocations.size(); ++i)
-			{
-				non_trivial_object_allocations[i]->~AllocatedObject();
-			}
-			delete[] data;
+			DestroyObjects();
 		}
 
 		template<typename T, typename ...Args>
 		ADRIA_NODISCARD T* AllocateObject(Args&&... args)
 		{
 			using AllocatedType = std::conditional_t<std::is_trivial_v<T>, T, NonTrivialAllocatedObject<T>>;
-			void* alloc = Allocate(sizeof(AllocatedType));
+			void* alloc = Allocate(sizeof(AllocatedType), alignof(AllocatedType));
 			AllocatedType* allocation = new (alloc) AllocatedType(std::forward<Args>(args)...);
 
 			if constexpr (std::is_trivial_v<T>)
@@ -49,27 +57,92 @@ namespace adria
 			}
 			else
 			{
-				non_trivial_object_allocations.push_back(allocation);
+				allocation->next = non_trivial_objects;
+				non_trivial_objects = allocation;
 				return &allocation->object;
 			}
 		}
 
-		ADRIA_NODISCARD void* Allocate(Uint64 size)
+		template<typename T> requires std::is_trivially_destructible_v<T>
+		ADRIA_NODISCARD std::span<T> AllocateArray(Uint64 count)
+		{
+			if (count == 0) return {};
+			T* array = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+			std::uninitialized_value_construct_n(array, count);
+			return std::span<T>(array, count);
+		}
+
+		ADRIA_NODISCARD void* Allocate(Uint64 size, Uint64 align = alignof(std::max_align_t))
 		{
-			ADRIA_ASSERT(current_offset - data + size < capacity);
-			void* current_data = current_offset;
-			current_offset += size;
-			return current_data;
+			Uint64 offset = GetAlignedOffset(align);
+			while (offset + size > chunks[current_chunk].capacity)
+			{
+				used_size += chunks[current_chunk].capacity - current_offset;
+				if (++current_chunk == chunks.size()) AddChunk(std::max(chunk_size, size + align));
+				current_offset = 0;
+				offset = GetAlignedOffset(align);
+			}
+			used_size += offset + size - current_offset;
+			current_offset = offset + size;
+			return chunks[current_chunk].data.get() + offset;
 		}
 
-		Uint64 GetSize() const { return static_cast<Uint64>(current_offset - data); }
-		Uint64 GetCapacity() const { return capacity; }
+		void Reset()
+		{
+			DestroyObjects();
+			high_water_mark = std::max(high_water_mark, used_size);
+			if (chunks.size() > 1)
+			{
+				chunks.clear();
+				chunk_size = std::max(chunk_size, Align(high_water_mark, 64 * 1024));
+				AddChunk(chunk_size);
+			}
+			current_chunk = 0;
+			current_offset = 0;
+			used_size = 0;
+		}
+
+		Uint64 GetSize() const { return used_size; }
+		Uint64 GetCapacity() const
+		{
+			Uint64 capacity = 0;
+			for (Chunk const& chunk : chunks) capacity += chunk.capacity;
+			return capacity;
+		}
+		Uint64 GetHighWaterMark() const { return std::max(high_water_mark, used_size); }
+		Uint64 GetChunkCount() const { return chunks.size(); }
+
+	private:
+		std::vector<Chunk> chunks;
+		Uint64 chunk_size;
+		Uint64 current_chunk = 0;
+		Uint64 current_offset = 0;
+		Uint64 used_size = 0;
+		Uint64 high_water_mark = 0;
+		AllocatedObject* non_trivial_objects = nullptr;
 
 	private:
-		std::vector<AllocatedObject*> non_trivial_object_allocations;
-		Uint64 capacity;
-		Uint8* data;
-		Uint8* current_offset;
+		//chunks are only aligned to the default new alignment, so the address and not the offset is aligned
+		Uint64 GetAlignedOffset(Uint64 align) const
+		{
+			Uintptr const base = reinterpret_cast<Uintptr>(chunks[current_chunk].data.get());
+			return Align(base + current_offset, align) - base;
+		}
+
+		void AddChunk(Uint64 capacity)
+		{
+			chunks.push_back(Chunk{ std::make_unique<Uint8[]>(capacity), capacity });
+		}
+
+		void DestroyObjects()
+		{
+			while (non_trivial_objects)
+			{
+				AllocatedObject* next = non_trivial_objects->next;
+				non_trivial_objects->~AllocatedObject();
+				non_trivial_objects = next;
+			}
+		}
 	};
 	using RGAllocator = RenderGraphAllocator;
 }
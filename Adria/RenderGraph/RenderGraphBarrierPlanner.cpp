@@ -0,0 +1,76 @@
+#include <vector>
+#include "RenderGraphBarrierPlanner.h"
+
+namespace adria
+{
+	namespace
+	{
+		constexpr GfxResourceState MergeableReadStates = GfxResourceState::AllSRV | GfxResourceState::CopySrc | GfxResourceState::DSV_ReadOnly
+													   | GfxResourceState::IndexBuffer | GfxResourceState::IndirectArgs;
+
+		Bool IsMergeableRead(GfxResourceState state)
+		{
+			return state != GfxResourceState::None && !HasAnyFlag(state, ~MergeableReadStates);
+		}
+	}
+
+	RGBarrierPlanStats PlanBarriers(RGBarrierPlanInput const& input)
+	{
+		std::span<RGBarrierPlanUse> uses = input.uses;
+		constexpr Uint32 InvalidUse = Uint32(-1);
+
+		std::vector<Uint32> last_use(input.resource_count, InvalidUse);
+		std::vector<Uint32> prev_use(uses.size(), InvalidUse);
+		std::vector<Uint32> read_run(uses.size());
+		for (Uint32 i = 0; i < uses.size(); ++i)
+		{
+			RGBarrierPlanUse& use = uses[i];
+			prev_use[i] = last_use[use.resource];
+			last_use[use.resource] = i;
+
+			use.planned_state = use.state;
+			read_run[i] = i;
+			if (prev_use[i] != InvalidUse && !input.fixed_resources[use.resource] && IsMergeableRead(use.state) && IsMergeableRead(uses[prev_use[i]].state))
+			{
+				read_run[i] = read_run[prev_use[i]];
+			}
+			uses[read_run[i]].planned_state |= use.state;
+		}
+		for (Uint32 i = 0; i < uses.size(); ++i)
+		{
+			uses[i].planned_state = uses[read_run[i]].planned_state;
+		}
+
+		std::vector<Uint32> fence_count(input.level_fences.size() + 1, 0);
+		for (Uint64 level = 0; level < input.level_fences.size(); ++level)
+		{
+			fence_count[level + 1] = fence_count[level] + (input.level_fences[level] ? 1 : 0);
+		}
+
+		RGBarrierPlanStats stats{};
+		for (Uint32 i = 0; i < uses.size(); ++i)
+		{
+			RGBarrierPlanUse& use = uses[i];
+			if (prev_use[i] == InvalidUse) continue;
+
+			RGBarrierPlanUse& previous = uses[prev_use[i]];
+			use.has_prev_state = true;
+			use.prev_state = previous.planned_state;
+			if (previous.state != use.state) ++stats.requested_barrier_count;
+			if (use.prev_state == use.planned_state) continue;
+			++stats.planned_barrier_count;
+
+			//the transition can begin after the previous use's level if no level in between submits the command list
+			Bool const levels_in_between = use.level > previous.level + 1;
+			Bool const fenced = fence_count[use.level] - fence_count[previous.level + 1] > 0;
+			if (levels_in_between && !fenced && !input.fixed_resources[use.resource])
+			{
+				previous.split_begin = true;
+				previous.next_state = use.planned_state;
+				use.split_end = true;
+				++stats.split_barrier_count;
+			}
+		}
+		return stats;
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <span>
+#include "RenderGraphResourceId.h"
+#include "Graphics/GfxResourceState.h"
+
+namespace adria
+{
+	//one use of a resource by a dependency level, the planner fills the output fields in place
+	struct RenderGraphBarrierPlanUse
+	{
+		//input
+		Uint32 resource;
+		Uint32 level;
+		GfxResourceState state;
+
+		//output
+		GfxResourceState planned_state;		//state after merging consecutive read only uses
+		GfxResourceState prev_state;		//planned state of the previous use of the resource
+		Bool has_prev_state = false;
+		Bool split_begin = false;			//begin the transition to the next use after this use's level
+		Bool split_end = false;				//the transition from the previous use ends right before this use's level
+		GfxResourceState next_state;		//destination of the split transition started after this use
+	};
+	using RGBarrierPlanUse = RenderGraphBarrierPlanUse;
+
+	struct RenderGraphBarrierPlanInput
+	{
+		std::span<RGBarrierPlanUse> uses;			//ordered by level, at most one use per resource per level
+		Uint32 resource_count;
+		std::span<Bool const> fixed_resources;		//resources whose states and barriers must stay as requested, e.g. used by async compute
+		std::span<Bool const> level_fences;			//levels that submit their command list, split barriers cannot span them
+	};
+	using RGBarrierPlanInput = RenderGraphBarrierPlanInput;
+
+	struct RenderGraphBarrierPlanStats
+	{
+		Uint32 requested_barrier_count = 0;		//transitions between consecutive uses without planning
+		Uint32 planned_barrier_count = 0;
+		Uint32 split_barrier_count = 0;
+		Uint32 GetRemovedBarrierCount() const { return requested_barrier_count - planned_barrier_count; }
+
+		RenderGraphBarrierPlanStats& operator+=(RenderGraphBarrierPlanStats const& other)
+		{
+			requested_barrier_count += other.requested_barrier_count;
+			planned_barrier_count += other.planned_barrier_count;
+			split_barrier_count += other.split_barrier_count;
+			return *this;
+		}
+	};
+	using RGBarrierPlanStats = RenderGraphBarrierPlanStats;
+
+	//pure function of its input: merges read to read transitions and splits transitions that can begin earlier than the consuming level
+	RGBarrierPlanStats PlanBarriers(RGBarrierPlanInput const& input);
+
+	//planned state of a resource in one dependency level and the barriers around it
+	template<typename ResourceId>
+	struct RenderGraphResourceStateEntry
+	{
+		ResourceId id;
+		GfxResourceState state = GfxResourceState::Common;
+		GfxResourceState prev_state = GfxResourceState::Common;
+		Bool has_prev_state = false;
+		Bool created = false;
+		Bool destroyed = false;
+		Bool split_begin = false;
+		Bool split_end = false;
+		GfxResourceState next_state = GfxResourceState::Common;
+	};
+	template<typename ResourceId>
+	using RGResourceStateEntry = RenderGraphResourceStateEntry<ResourceId>;
+	using RGTextureStateEntry = RGResourceStateEntry<RGTextureId>;
+	using RGBufferStateEntry = RGResourceStateEntry<RGBufferId>;
+
+	enum class RenderGraphBarrierType : Uint8
+	{
+		None,
+		Transition,
+		SplitEnd,
+		Aliasing
+	};
+	using RGBarrierType = RenderGraphBarrierType;
+
+	struct RenderGraphBarrier
+	{
+		RGBarrierType type = RGBarrierType::None;
+		GfxResourceState before = GfxResourceState::None;
+		GfxResourceState after = GfxResourceState::None;
+
+		Bool operator==(RenderGraphBarrier const&) const = default;
+	};
+	using RGBarrier = RenderGraphBarrier;
+
+	struct RenderGraphBarrierResource
+	{
+		GfxResourceState initial_state = GfxResourceState::Common;	//state created and imported resources are in before their first use
+		Bool imported = false;
+		Bool aliased = false;	//placed in memory other resources use, activating it discards its contents
+	};
+	using RGBarrierResource = RenderGraphBarrierResource;
+
+	//barrier recorded before the level of a planned use
+	template<typename StateEntry>
+	RGBarrier GetBarrierBeforeUse(StateEntry const& entry, RGBarrierResource const& resource)
+	{
+		if (entry.created)
+		{
+			if (resource.aliased) return RGBarrier{ RGBarrierType::Aliasing, GfxResourceState::None, entry.state };
+			if ((resource.initial_state & entry.state) != entry.state) return RGBarrier{ RGBarrierType::Transition, resource.initial_state, entry.state };
+		}
+		else if (entry.has_prev_state)
+		{
+			if (entry.split_end) return RGBarrier{ RGBarrierType::SplitEnd, entry.prev_state, entry.state };
+			if (entry.prev_state != entry.state) return RGBarrier{ RGBarrierType::Transition, entry.prev_state, entry.state };
+		}
+		else if (resource.imported && resource.initial_state != entry.state)
+		{
+			return RGBarrier{ RGBarrierType::Transition, resource.initial_state, entry.state };
+		}
+		return RGBarrier{};
+	}
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <vector>
+#include "RenderGraphBarrierPlanner.h"
+#include "RenderGraphDependencies.h"
+
+namespace adria
+{
+	struct RenderGraphCompileCacheStats
+	{
+		Uint64 hit_count = 0;
+		Uint64 miss_count = 0;
+		Float  last_compile_time = 0.0f;		//us
+		Float  average_full_compile_time = 0.0f;	//us
+		Float  total_saved_compile_time = 0.0f;	//us
+
+		Float GetHitRate() const
+		{
+			Uint64 const total = hit_count + miss_count;
+			return total > 0 ? (Float)hit_count / total : 0.0f;
+		}
+	};
+	using RGCompileCacheStats = RenderGraphCompileCacheStats;
+
+	class RenderGraphCompileCache
+	{
+		friend class RenderGraph;
+
+		static constexpr Uint64 MaxEntries = 8;
+
+		struct CompiledPass
+		{
+			Uint64 ref_count;
+			Uint64 wait_graphics_pass_id;
+			Uint64 signal_graphics_pass_id;
+			Uint64 signal_value;
+			Uint64 wait_value;
+			std::vector<Uint32> events_to_start;
+			Uint32 num_events_to_end;
+		};
+
+		struct CompiledResource
+		{
+			Uint64 ref_count;
+			Uint64 writer;
+			Uint64 last_used_by;
+		};
+
+		//planned resource states of a dependency level, so a hit skips setting up levels and planning barriers
+		struct CompiledDependencyLevel
+		{
+			std::vector<RGTextureStateEntry> texture_states;
+			std::vector<RGTextureId> texture_creates;
+			std::vector<RGBufferStateEntry> buffer_states;
+			std::vector<RGBufferId> buffer_creates;
+		};
+
+		struct CompiledGraph
+		{
+			Uint64 hash;
+			Uint64 last_used_frame;
+			RGCompiledDependencies dependencies;
+			std::vector<CompiledDependencyLevel> dependency_levels;
+			std::vector<CompiledPass> passes;
+			std::vector<CompiledResource> textures;
+			std::vector<CompiledResource> buffers;
+			RGBarrierPlanStats barrier_plan_stats;
+		};
+
+	public:
+		RenderGraphCompileCache() = default;
+		ADRIA_NONCOPYABLE(RenderGraphCompileCache)
+		~RenderGraphCompileCache() = default;
+
+		RGCompileCacheStats const& GetStats() const { return stats; }
+		void Clear()
+		{
+			compiled_graphs.clear();
+		}
+
+	private:
+		std::vector<CompiledGraph> compiled_graphs;
+		RGCompileCacheStats stats;
+		Uint64 frame_index = 0;
+
+	private:
+		CompiledGraph const* Find(Uint64 hash)
+		{
+			++frame_index;
+			for (CompiledGraph& compiled_graph : compiled_graphs)
+			{
+				if (compiled_graph.hash == hash)
+				{
+					compiled_graph.last_used_frame = frame_index;
+					return &compiled_graph;
+				}
+			}
+			return nullptr;
+		}
+
+		CompiledGraph& Add(Uint64 hash)
+		{
+			if (compiled_graphs.size() >= MaxEntries)
+			{
+				auto lru = std::min_element(compiled_graphs.begin(), compiled_graphs.end(),
+					[](CompiledGraph const& a, CompiledGraph const& b) { return a.last_used_frame < b.last_used_frame; });
+				compiled_graphs.erase(lru);
+			}
+			CompiledGraph& compiled_graph = compiled_graphs.emplace_back();
+			compiled_graph.hash = hash;
+			compiled_graph.last_used_frame = frame_index;
+			return compiled_graph;
+		}
+
+		void OnHit(Float compile_time)
+		{
+			++stats.hit_count;
+			stats.last_compile_time = compile_time;
+			if (stats.average_full_compile_time > compile_time)
+			{
+				stats.total_saved_compile_time += stats.average_full_compile_time - compile_time;
+			}
+		}
+
+		void OnMiss(Float compile_time)
+		{
+			++stats.miss_count;
+			stats.last_compile_time = compile_time;
+			stats.average_full_compile_time += (compile_time - stats.average_full_compile_time) / stats.miss_count;
+		}
+	};
+	using RGCompileCache = RenderGraphCompileCache;
+}
@@ -45,6 +45,9 @@ namespace adria
 
 		RenderGraphPassBase* writer = nullptr;
 		RenderGraphPassBase* last_used_by = nullptr;
+		Uint32 pool_handle = Uint32(-1);
+		Bool placed = false;
+		Bool aliased = false;
 		Char const* name = "";
 	};
 	using RGResource = RenderGraphResource;
@@ -0,0 +1,183 @@
+#include "RenderGraphDependencies.h"
+
+namespace adria
+{
+	namespace
+	{
+		RGIndexLists BuildResourceAccessLists(RGAllocator& allocator, std::span<RGPassAccesses const> passes, Uint64 resource_count,
+			std::span<Uint32 const> RGPassAccesses::* accesses)
+		{
+			RGIndexLists lists{};
+			lists.offsets = allocator.AllocateArray<Uint32>(resource_count + 1);
+			for (RGPassAccesses const& pass : passes)
+			{
+				for (Uint32 resource : pass.*accesses) ++lists.offsets[resource + 1];
+			}
+			for (Uint64 i = 0; i < resource_count; ++i) lists.offsets[i + 1] += lists.offsets[i];
+
+			lists.values = allocator.AllocateArray<Uint32>(lists.offsets[resource_count]);
+			std::span<Uint32> cursors = allocator.AllocateArray<Uint32>(resource_count);
+			std::copy(lists.offsets.begin(), lists.offsets.end() - 1, cursors.begin());
+			for (Uint32 i = 0; i < passes.size(); ++i)
+			{
+				for (Uint32 resource : passes[i].*accesses) lists.values[cursors[resource]++] = i;
+			}
+			return lists;
+		}
+
+		//calls add_edge(writer, reader) once for every pass that reads something an earlier pass wrote
+		template<typename F>
+		void ForEachDependency(std::span<RGPassAccesses const> passes, RGDependencies const& dependencies, std::span<Uint32> last_dependent_pass, F&& add_edge)
+		{
+			std::fill(last_dependent_pass.begin(), last_dependent_pass.end(), Uint32(-1));
+			auto AddDependencies = [&](std::span<Uint32 const> writers, Uint32 pass_index)
+				{
+					for (Uint32 writer_index : writers)
+					{
+						if (writer_index >= pass_index) break;
+						if (last_dependent_pass[writer_index] == pass_index) continue;
+
+						last_dependent_pass[writer_index] = pass_index;
+						add_edge(writer_index, pass_index);
+					}
+				};
+			for (Uint32 i = 0; i < passes.size(); ++i)
+			{
+				for (Uint32 read_texture : passes[i].texture_reads) AddDependencies(dependencies.texture_writers[read_texture], i);
+				for (Uint32 read_buffer : passes[i].buffer_reads)   AddDependencies(dependencies.buffer_writers[read_buffer], i);
+			}
+		}
+
+		RGIndexLists BuildAdjacencyLists(RGAllocator& allocator, std::span<RGPassAccesses const> passes, RGDependencies const& dependencies)
+		{
+			Uint64 const pass_count = passes.size();
+			std::span<Uint32> last_dependent_pass = allocator.AllocateArray<Uint32>(pass_count);
+
+			RGIndexLists adjacency_lists{};
+			adjacency_lists.offsets = allocator.AllocateArray<Uint32>(pass_count + 1);
+			ForEachDependency(passes, dependencies, last_dependent_pass, [&](Uint32 writer, Uint32) { ++adjacency_lists.offsets[writer + 1]; });
+			for (Uint64 i = 0; i < pass_count; ++i) adjacency_lists.offsets[i + 1] += adjacency_lists.offsets[i];
+
+			adjacency_lists.values = allocator.AllocateArray<Uint32>(adjacency_lists.offsets[pass_count]);
+			std::span<Uint32> cursors = allocator.AllocateArray<Uint32>(pass_count);
+			std::copy(adjacency_lists.offsets.begin(), adjacency_lists.offsets.end() - 1, cursors.begin());
+			ForEachDependency(passes, dependencies, last_dependent_pass, [&](Uint32 writer, Uint32 reader) { adjacency_lists.values[cursors[writer]++] = reader; });
+			return adjacency_lists;
+		}
+
+		//iterative depth first search with an explicit stack, visits passes in the same order as the recursive one did
+		std::span<Uint32> TopologicalSort(RGAllocator& allocator, RGIndexLists const& adjacency_lists)
+		{
+			Uint64 const pass_count = adjacency_lists.GetListCount();
+			std::span<Bool>   visited = allocator.AllocateArray<Bool>(pass_count);
+			std::span<Uint32> stack = allocator.AllocateArray<Uint32>(pass_count);
+			std::span<Uint32> next_edge = allocator.AllocateArray<Uint32>(pass_count);
+			std::span<Uint32> sorted_passes = allocator.AllocateArray<Uint32>(pass_count);
+
+			Uint64 sorted_count = 0;
+			for (Uint32 root = 0; root < pass_count; ++root)
+			{
+				if (visited[root]) continue;
+				visited[root] = true;
+				stack[0] = root;
+				next_edge[0] = 0;
+				Uint64 depth = 1;
+				while (depth > 0)
+				{
+					Uint32 const pass = stack[depth - 1];
+					std::span<Uint32 const> adjacent_passes = adjacency_lists[pass];
+					if (next_edge[depth - 1] < adjacent_passes.size())
+					{
+						Uint32 const adjacent_pass = adjacent_passes[next_edge[depth - 1]++];
+						if (visited[adjacent_pass]) continue;
+						visited[adjacent_pass] = true;
+						stack[depth] = adjacent_pass;
+						next_edge[depth] = 0;
+						++depth;
+					}
+					else
+					{
+						sorted_passes[sorted_count++] = pass;
+						--depth;
+					}
+				}
+			}
+			std::reverse(sorted_passes.begin(), sorted_passes.end());
+			return sorted_passes;
+		}
+
+		RGIndexLists BuildDependencyLevels(RGAllocator& allocator, RGDependencies const& dependencies, Bool use_dependency_levels)
+		{
+			Uint64 const pass_count = dependencies.topologically_sorted_passes.size();
+			std::span<Uint32> distances = allocator.AllocateArray<Uint32>(pass_count);
+			Uint64 level_count = pass_count;
+			if (use_dependency_levels)
+			{
+				level_count = 0;
+				for (Uint32 pass : dependencies.topologically_sorted_passes)
+				{
+					for (Uint32 adjacent_pass : dependencies.adjacency_lists[pass])
+					{
+						distances[adjacent_pass] = std::max(distances[adjacent_pass], distances[pass] + 1);
+					}
+					level_count = std::max<Uint64>(level_count, distances[pass] + 1);
+				}
+			}
+			else
+			{
+				for (Uint32 i = 0; i < pass_count; ++i) distances[i] = i;
+			}
+
+			RGIndexLists dependency_levels{};
+			dependency_levels.offsets = allocator.AllocateArray<Uint32>(level_count + 1);
+			for (Uint32 distance : distances) ++dependency_levels.offsets[distance + 1];
+			for (Uint64 i = 0; i < level_count; ++i) dependency_levels.offsets[i + 1] += dependency_levels.offsets[i];
+
+			dependency_levels.values = allocator.AllocateArray<Uint32>(pass_count);
+			std::span<Uint32> cursors = allocator.AllocateArray<Uint32>(level_count);
+			std::copy(dependency_levels.offsets.begin(), dependency_levels.offsets.end() - 1, cursors.begin());
+			for (Uint32 i = 0; i < pass_count; ++i) dependency_levels.values[cursors[distances[i]]++] = i;
+			return dependency_levels;
+		}
+
+		std::span<Uint32> LoadArray(RGAllocator& allocator, std::vector<Uint32> const& compiled_array)
+		{
+			std::span<Uint32> array = allocator.AllocateArray<Uint32>(compiled_array.size());
+			std::copy(compiled_array.begin(), compiled_array.end(), array.begin());
+			return array;
+		}
+	}
+
+	void RenderGraphCompiledDependencies::Save(RGDependencies const& dependencies)
+	{
+		adjacency_offsets.assign(dependencies.adjacency_lists.offsets.begin(), dependencies.adjacency_lists.offsets.end());
+		adjacency.assign(dependencies.adjacency_lists.values.begin(), dependencies.adjacency_lists.values.end());
+		topologically_sorted_passes.assign(dependencies.topologically_sorted_passes.begin(), dependencies.topologically_sorted_passes.end());
+		level_offsets.assign(dependencies.dependency_levels.offsets.begin(), dependencies.dependency_levels.offsets.end());
+		level_passes.assign(dependencies.dependency_levels.values.begin(), dependencies.dependency_levels.values.end());
+	}
+
+	RGDependencies RenderGraphCompiledDependencies::Load(RGAllocator& allocator) const
+	{
+		RGDependencies dependencies{};
+		dependencies.adjacency_lists.offsets = LoadArray(allocator, adjacency_offsets);
+		dependencies.adjacency_lists.values = LoadArray(allocator, adjacency);
+		dependencies.topologically_sorted_passes = LoadArray(allocator, topologically_sorted_passes);
+		dependencies.dependency_levels.offsets = LoadArray(allocator, level_offsets);
+		dependencies.dependency_levels.values = LoadArray(allocator, level_passes);
+		return dependencies;
+	}
+
+	RGDependencies BuildDependencies(RGAllocator& allocator, std::span<RGPassAccesses const> passes, Uint64 texture_count, Uint64 buffer_count, Bool use_dependency_levels)
+	{
+		RGDependencies dependencies{};
+		dependencies.texture_writers = BuildResourceAccessLists(allocator, passes, texture_count, &RGPassAccesses::texture_writes);
+		dependencies.texture_readers = BuildResourceAccessLists(allocator, passes, texture_count, &RGPassAccesses::texture_reads);
+		dependencies.buffer_writers = BuildResourceAccessLists(allocator, passes, buffer_count, &RGPassAccesses::buffer_writes);
+		dependencies.buffer_readers = BuildResourceAccessLists(allocator, passes, buffer_count, &RGPassAccesses::buffer_reads);
+		dependencies.adjacency_lists = BuildAdjacencyLists(allocator, passes, dependencies);
+		dependencies.topologically_sorted_passes = TopologicalSort(allocator, dependencies.adjacency_lists);
+		dependencies.dependency_levels = BuildDependencyLevels(allocator, dependencies, use_dependency_levels);
+		return dependencies;
+	}
+}
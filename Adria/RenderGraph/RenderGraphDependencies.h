@@ -0,0 +1,62 @@
+#pragma once
+#include <span>
+#include <vector>
+#include "RenderGraphAllocator.h"
+
+namespace adria
+{
+	//resources a pass reads and writes, as indices into the texture and buffer arrays of the graph
+	struct RenderGraphPassAccesses
+	{
+		std::span<Uint32 const> texture_reads;
+		std::span<Uint32 const> texture_writes;
+		std::span<Uint32 const> buffer_reads;
+		std::span<Uint32 const> buffer_writes;
+	};
+	using RGPassAccesses = RenderGraphPassAccesses;
+
+	//flat array of lists, list i is values[offsets[i], offsets[i + 1])
+	struct RenderGraphIndexLists
+	{
+		std::span<Uint32> offsets;
+		std::span<Uint32> values;
+
+		Uint64 GetListCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+		std::span<Uint32 const> operator[](Uint64 i) const
+		{
+			return std::span<Uint32 const>(values.data() + offsets[i], offsets[i + 1] - offsets[i]);
+		}
+	};
+	using RGIndexLists = RenderGraphIndexLists;
+
+	//structure of a graph, every array lives in the per-frame arena
+	struct RenderGraphDependencies
+	{
+		RGIndexLists texture_writers;		//per resource, passes in ascending order
+		RGIndexLists texture_readers;
+		RGIndexLists buffer_writers;
+		RGIndexLists buffer_readers;
+		RGIndexLists adjacency_lists;
+		std::span<Uint32> topologically_sorted_passes;
+		RGIndexLists dependency_levels;		//per level, passes in ascending order
+	};
+	using RGDependencies = RenderGraphDependencies;
+
+	//the part of the dependencies the compile cache keeps, the access index is only needed while compiling
+	struct RenderGraphCompiledDependencies
+	{
+		std::vector<Uint32> adjacency_offsets;
+		std::vector<Uint32> adjacency;
+		std::vector<Uint32> topologically_sorted_passes;
+		std::vector<Uint32> level_offsets;
+		std::vector<Uint32> level_passes;
+
+		void Save(RGDependencies const& dependencies);
+		RGDependencies Load(RGAllocator& allocator) const;
+	};
+	using RGCompiledDependencies = RenderGraphCompiledDependencies;
+
+	//builds the access index, adjacency lists, a topological order and the dependency levels, only allocating from the arena
+	//without dependency levels every pass gets a level of its own
+	RGDependencies BuildDependencies(RGAllocator& allocator, std::span<RGPassAccesses const> passes, Uint64 texture_count, Uint64 buffer_count, Bool use_dependency_levels = true);
+}
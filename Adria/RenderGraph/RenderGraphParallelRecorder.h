@@ -0,0 +1,52 @@
+#pragma once
+#include <span>
+#include <vector>
+
+namespace adria
+{
+	//records the passes of a dependency level into their own command lists on worker threads
+	//the main command list is submitted first so the level lists run after the barriers recorded into it, then they are submitted in pass order
+	//pass and command list arrays are kept between levels and frames so recording a level does not allocate
+	template<typename PassType, typename CommandListType>
+	class RenderGraphParallelRecorder
+	{
+	public:
+		RenderGraphParallelRecorder() = default;
+		ADRIA_NONCOPYABLE(RenderGraphParallelRecorder)
+		~RenderGraphParallelRecorder() = default;
+
+		void Clear()
+		{
+			passes.clear();
+			cmd_lists.clear();
+		}
+		void AddPass(PassType* pass)
+		{
+			passes.push_back(pass);
+		}
+		Uint64 GetPassCount() const { return passes.size(); }
+
+		//allocate_cmd_list runs on the calling thread, record_pass(pass, cmd_list) runs on the threads parallel_for(count, task) distributes the passes to
+		template<typename AllocateCommandList, typename RecordPass, typename ParallelForFn>
+		void Record(CommandListType* main_cmd_list, AllocateCommandList&& allocate_cmd_list, RecordPass&& record_pass, ParallelForFn&& parallel_for)
+		{
+			cmd_lists.resize(passes.size());
+			for (CommandListType*& cmd_list : cmd_lists) cmd_list = allocate_cmd_list();
+
+			parallel_for(passes.size(), [this, &record_pass](Uint64 i)
+				{
+					record_pass(passes[i], cmd_lists[i]);
+					cmd_lists[i]->End();
+				});
+
+			main_cmd_list->End();
+			main_cmd_list->Submit();
+			main_cmd_list->GetQueue().ExecuteCommandLists(std::span<CommandListType*>(cmd_lists));
+			main_cmd_list->Begin();
+		}
+
+	private:
+		std::vector<PassType*> passes;
+		std::vector<CommandListType*> cmd_lists;
+	};
+}
@@ -120,20 +120,20 @@ namespace adria
 		std::unordered_set<RGTextureId> texture_creates;
 		std::unordered_set<RGTextureId> texture_reads;
 		std::unordered_set<RGTextureId> texture_writes;
-		std::unordered_set<RGTextureId> texture_destroys;
+		std::span<RGTextureId> texture_destroys;
 		std::unordered_map<RGTextureId, GfxResourceState> texture_state_map;
 		
 		std::unordered_set<RGBufferId> buffer_creates;
 		std::unordered_set<RGBufferId> buffer_reads;
 		std::unordered_set<RGBufferId> buffer_writes;
-		std::unordered_set<RGBufferId> buffer_destroys;
+		std::span<RGBufferId> buffer_destroys;
 		std::unordered_map<RGBufferId, GfxResourceState> buffer_state_map;
 
 		std::vector<RenderTargetInfo> render_targets_info;
 		std::optional<DepthStencilInfo> depth_stencil = std::nullopt;
 		Uint32 viewport_width = 0, viewport_height = 0;
 
-		std::vector<Uint32>				events_to_start;
+		std::span<Uint32>				events_to_start;
 		Uint32							num_events_to_end = 0;
 
 		Uint64 wait_graphics_pass_id	= UINT64_MAX;
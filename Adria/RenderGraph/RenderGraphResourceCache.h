@@ -0,0 +1,229 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
+
+namespace adria
+{
+	using RenderGraphPoolHandle = Uint32;
+	using RGPoolHandle = RenderGraphPoolHandle;
+	inline constexpr RGPoolHandle InvalidRGPoolHandle = RGPoolHandle(-1);
+
+	struct RenderGraphResourcePoolStats
+	{
+		Uint64 texture_hits = 0;
+		Uint64 texture_misses = 0;
+		Uint64 buffer_hits = 0;
+		Uint64 buffer_misses = 0;
+		Uint64 evictions = 0;
+		Uint64 pooled_memory = 0;
+		Uint32 pooled_texture_count = 0;
+		Uint32 pooled_buffer_count = 0;
+	};
+	using RGResourcePoolStats = RenderGraphResourcePoolStats;
+
+	//pooled resources bucketed by desc hash and evicted after unused frames or over a memory budget, least recently used first
+	//it never creates resources so it can be driven without a device
+	template<typename TextureType, typename BufferType>
+	class RenderGraphResourceCache
+	{
+		template<typename ResourceType>
+		struct PooledResource
+		{
+			std::unique_ptr<ResourceType> resource;
+			Uint64 bucket_hash = 0;
+			Uint64 size = 0;
+			Uint64 last_used_frame = 0;
+			Bool active = false;
+		};
+
+		//pooled resources live in slots addressed by RGPoolHandle, inactive ones are also kept in per desc hash free lists
+		template<typename ResourceType>
+		struct ResourcePool
+		{
+			std::vector<PooledResource<ResourceType>> slots;
+			std::vector<RGPoolHandle> empty_slots;
+			std::unordered_map<Uint64, std::vector<RGPoolHandle>> free_lists;
+		};
+
+		struct EvictionCandidate
+		{
+			Uint64 last_used_frame;
+			RGPoolHandle handle;
+			Bool is_texture;
+		};
+
+	public:
+		RenderGraphResourceCache() = default;
+		ADRIA_NONCOPYABLE(RenderGraphResourceCache)
+		~RenderGraphResourceCache() = default;
+
+		void Tick(Uint32 eviction_frame_count, Uint64 memory_budget)
+		{
+			EvictUnusedResources(texture_pool, eviction_frame_count);
+			EvictUnusedResources(buffer_pool, eviction_frame_count);
+			if (memory_budget > 0 && stats.pooled_memory > memory_budget) EvictOverBudget(memory_budget);
+
+			stats.pooled_texture_count = (Uint32)(texture_pool.slots.size() - texture_pool.empty_slots.size());
+			stats.pooled_buffer_count = (Uint32)(buffer_pool.slots.size() - buffer_pool.empty_slots.size());
+			++frame_index;
+		}
+
+		//returns nullptr on a miss, the caller creates the resource and adds it
+		template<typename IsCompatible>
+		TextureType* FindTexture(Uint64 bucket_hash, IsCompatible&& is_compatible, RGPoolHandle& handle)
+		{
+			TextureType* texture = FindPooledResource(texture_pool, bucket_hash, is_compatible, handle);
+			if (texture) ++stats.texture_hits;
+			else ++stats.texture_misses;
+			return texture;
+		}
+		TextureType* AddTexture(std::unique_ptr<TextureType>&& texture, Uint64 bucket_hash, Uint64 size, RGPoolHandle& handle)
+		{
+			handle = AddPooledResource(texture_pool, std::move(texture), bucket_hash, size);
+			return texture_pool.slots[handle].resource.get();
+		}
+		void ReleaseTexture(RGPoolHandle handle)
+		{
+			ReleasePooledResource(texture_pool, handle);
+		}
+
+		template<typename IsCompatible>
+		BufferType* FindBuffer(Uint64 bucket_hash, IsCompatible&& is_compatible, RGPoolHandle& handle)
+		{
+			BufferType* buffer = FindPooledResource(buffer_pool, bucket_hash, is_compatible, handle);
+			if (buffer) ++stats.buffer_hits;
+			else ++stats.buffer_misses;
+			return buffer;
+		}
+		BufferType* AddBuffer(std::unique_ptr<BufferType>&& buffer, Uint64 bucket_hash, Uint64 size, RGPoolHandle& handle)
+		{
+			handle = AddPooledResource(buffer_pool, std::move(buffer), bucket_hash, size);
+			return buffer_pool.slots[handle].resource.get();
+		}
+		void ReleaseBuffer(RGPoolHandle handle)
+		{
+			ReleasePooledResource(buffer_pool, handle);
+		}
+
+		RGResourcePoolStats const& GetStats() const { return stats; }
+
+	private:
+		Uint64 frame_index = 0;
+		ResourcePool<TextureType> texture_pool;
+		ResourcePool<BufferType>  buffer_pool;
+		RGResourcePoolStats stats;
+
+	private:
+		template<typename ResourceType, typename IsCompatible>
+		ResourceType* FindPooledResource(ResourcePool<ResourceType>& pool, Uint64 bucket_hash, IsCompatible& is_compatible, RGPoolHandle& handle)
+		{
+			auto it = pool.free_lists.find(bucket_hash);
+			if (it == pool.free_lists.end()) return nullptr;
+
+			std::vector<RGPoolHandle>& free_list = it->second;
+			for (Uint64 i = free_list.size(); i-- > 0;)
+			{
+				PooledResource<ResourceType>& pooled_resource = pool.slots[free_list[i]];
+				if (!is_compatible(*pooled_resource.resource)) continue;
+
+				handle = free_list[i];
+				free_list[i] = free_list.back();
+				free_list.pop_back();
+				pooled_resource.active = true;
+				pooled_resource.last_used_frame = frame_index;
+				return pooled_resource.resource.get();
+			}
+			return nullptr;
+		}
+
+		template<typename ResourceType>
+		RGPoolHandle AddPooledResource(ResourcePool<ResourceType>& pool, std::unique_ptr<ResourceType>&& resource, Uint64 bucket_hash, Uint64 size)
+		{
+			RGPoolHandle handle = InvalidRGPoolHandle;
+			if (!pool.empty_slots.empty())
+			{
+				handle = pool.empty_slots.back();
+				pool.empty_slots.pop_back();
+			}
+			else
+			{
+				handle = (RGPoolHandle)pool.slots.size();
+				pool.slots.emplace_back();
+			}
+
+			PooledResource<ResourceType>& pooled_resource = pool.slots[handle];
+			pooled_resource.resource = std::move(resource);
+			pooled_resource.bucket_hash = bucket_hash;
+			pooled_resource.size = size;
+			pooled_resource.last_used_frame = frame_index;
+			pooled_resource.active = true;
+			stats.pooled_memory += size;
+			return handle;
+		}
+
+		template<typename ResourceType>
+		void ReleasePooledResource(ResourcePool<ResourceType>& pool, RGPoolHandle handle)
+		{
+			ADRIA_ASSERT(handle < pool.slots.size() && pool.slots[handle].active);
+			PooledResource<ResourceType>& pooled_resource = pool.slots[handle];
+			pooled_resource.active = false;
+			pool.free_lists[pooled_resource.bucket_hash].push_back(handle);
+		}
+
+		template<typename ResourceType>
+		void EvictPooledResource(ResourcePool<ResourceType>& pool, RGPoolHandle handle)
+		{
+			PooledResource<ResourceType>& pooled_resource = pool.slots[handle];
+			ADRIA_ASSERT(!pooled_resource.active && pooled_resource.resource != nullptr);
+
+			std::vector<RGPoolHandle>& free_list = pool.free_lists[pooled_resource.bucket_hash];
+			auto it = std::find(free_list.begin(), free_list.end(), handle);
+			ADRIA_ASSERT(it != free_list.end());
+			*it = free_list.back();
+			free_list.pop_back();
+
+			stats.pooled_memory -= pooled_resource.size;
+			++stats.evictions;
+			pooled_resource = {};
+			pool.empty_slots.push_back(handle);
+		}
+
+		template<typename ResourceType>
+		void EvictUnusedResources(ResourcePool<ResourceType>& pool, Uint32 eviction_frame_count)
+		{
+			for (RGPoolHandle handle = 0; handle < pool.slots.size(); ++handle)
+			{
+				PooledResource<ResourceType> const& pooled_resource = pool.slots[handle];
+				if (pooled_resource.resource && !pooled_resource.active && pooled_resource.last_used_frame + eviction_frame_count < frame_index)
+				{
+					EvictPooledResource(pool, handle);
+				}
+			}
+		}
+
+		void EvictOverBudget(Uint64 memory_budget)
+		{
+			std::vector<EvictionCandidate> candidates;
+			for (RGPoolHandle handle = 0; handle < texture_pool.slots.size(); ++handle)
+			{
+				PooledResource<TextureType> const& pooled_texture = texture_pool.slots[handle];
+				if (pooled_texture.resource && !pooled_texture.active) candidates.push_back(EvictionCandidate{ pooled_texture.last_used_frame, handle, true });
+			}
+			for (RGPoolHandle handle = 0; handle < buffer_pool.slots.size(); ++handle)
+			{
+				PooledResource<BufferType> const& pooled_buffer = buffer_pool.slots[handle];
+				if (pooled_buffer.resource && !pooled_buffer.active) candidates.push_back(EvictionCandidate{ pooled_buffer.last_used_frame, handle, false });
+			}
+			std::sort(candidates.begin(), candidates.end(), [](EvictionCandidate const& a, EvictionCandidate const& b) { return a.last_used_frame < b.last_used_frame; });
+
+			for (EvictionCandidate const& candidate : candidates)
+			{
+				if (stats.pooled_memory <= memory_budget) break;
+				if (candidate.is_texture) EvictPooledResource(texture_pool, candidate.handle);
+				else EvictPooledResource(buffer_pool, candidate.handle);
+			}
+		}
+	};
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include "RenderGraphResourcePool.h"
+#include "Core/ConsoleManager.h"
+#include "Utilities/HashUtil.h"
+
+namespace adria
+{
+	static TAutoConsoleVariable<Int> RGPoolEvictionFrames("rg.Pool.EvictionFrames", 4, "Number of frames an unused pooled render graph resource is kept alive for");
+	static TAutoConsoleVariable<Int> RGPoolBudget("rg.Pool.Budget", 0, "Memory budget in MB for pooled render graph resources, least recently used unused resources are evicted above it. 0 - no budget");
+
+	namespace
+	{
+		//hashes only the fields GfxTextureDesc::IsCompatible requires to be equal
+		Uint64 HashCompatibleTextureDesc(GfxTextureDesc const& desc)
+		{
+			HashState hash{};
+			hash.Combine((Uint32)desc.type);
+			hash.Combine(desc.width);
+			hash.Combine(desc.height);
+			hash.Combine(desc.array_size);
+			hash.Combine((Uint32)desc.format);
+			hash.Combine(desc.sample_count);
+			hash.Combine((Uint32)desc.heap_type);
+			hash.Combine((Uint32)desc.clear_value.active_member);
+			if (desc.clear_value.active_member == GfxClearValue::GfxActiveMember::Color)
+			{
+				for (Float c : desc.clear_value.color.color) hash.Combine(c);
+			}
+			else if (desc.clear_value.active_member == GfxClearValue::GfxActiveMember::DepthStencil)
+			{
+				hash.Combine(desc.clear_value.depth_stencil.depth);
+				hash.Combine(desc.clear_value.depth_stencil.stencil);
+			}
+			return hash;
+		}
+
+		Uint64 HashBufferDesc(GfxBufferDesc const& desc)
+		{
+			HashState hash{};
+			hash.Combine(desc.size);
+			hash.Combine((Uint32)desc.resource_usage);
+			hash.Combine((Uint32)desc.bind_flags);
+			hash.Combine((Uint32)desc.misc_flags);
+			hash.Combine(desc.stride);
+			hash.Combine((Uint32)desc.format);
+			return hash;
+		}
+	}
+
+	void RenderGraphResourcePool::Tick()
+	{
+		Uint32 const eviction_frame_count = (Uint32)std::max(RGPoolEvictionFrames.Get(), 0);
+		Uint64 const memory_budget = (Uint64)std::max(RGPoolBudget.Get(), 0) * 1024 * 1024;
+		cache.Tick(eviction_frame_count, memory_budget);
+		cmd_list_count = 0;
+	}
+
+	GfxTexture* RenderGraphResourcePool::AllocateTexture(GfxTextureDesc const& desc, RGPoolHandle& handle)
+	{
+		Uint64 const bucket_hash = HashCompatibleTextureDesc(desc);
+		if (GfxTexture* texture = cache.FindTexture(bucket_hash, [&desc](GfxTexture const& texture) { return texture.GetDesc().IsCompatible(desc); }, handle))
+		{
+			return texture;
+		}
+		Uint64 const size = GfxTexture::GetAllocationInfo(device, desc).size;
+		return cache.AddTexture(std::make_unique<GfxTexture>(device, desc), bucket_hash, size, handle);
+	}
+
+	void RenderGraphResourcePool::ReleaseTexture(RGPoolHandle handle)
+	{
+		cache.ReleaseTexture(handle);
+	}
+
+	GfxBuffer* RenderGraphResourcePool::AllocateBuffer(GfxBufferDesc const& desc, RGPoolHandle& handle)
+	{
+		Uint64 const bucket_hash = HashBufferDesc(desc);
+		if (GfxBuffer* buffer = cache.FindBuffer(bucket_hash, [&desc](GfxBuffer const& buffer) { return buffer.GetDesc() == desc; }, handle))
+		{
+			return buffer;
+		}
+		return cache.AddBuffer(std::make_unique<GfxBuffer>(device, desc), bucket_hash, desc.size, handle);
+	}
+
+	void RenderGraphResourcePool::ReleaseBuffer(RGPoolHandle handle)
+	{
+		cache.ReleaseBuffer(handle);
+	}
+
+	Bool RenderGraphResourcePool::CanPlaceTexture(GfxTextureDesc const& desc) const
+	{
+		return desc.heap_type == GfxResourceUsage::Default && !HasFlag(desc.misc_flags, GfxTextureMiscFlag::Shared);
+	}
+
+	std::span<RGPlacedTexture const> RenderGraphResourcePool::PlaceTransientTextures(std::span<RGTransientTexture const> transient_textures)
+	{
+		if (std::equal(transient_textures.begin(), transient_textures.end(), placed_transient_textures.begin(), placed_transient_textures.end()))
+		{
+			for (RGPlacedTexture& placed_texture : placed_textures) placed_texture.newly_placed = false;
+			return placed_textures;
+		}
+
+		placed_transient_textures.assign(transient_textures.begin(), transient_textures.end());
+		placed_textures.clear();
+		placed_textures.resize(transient_textures.size());
+		transient_memory_stats = {};
+		if (transient_textures.empty())
+		{
+			for (std::unique_ptr<GfxHeap>& heap : transient_heaps) heap.reset();
+			return placed_textures;
+		}
+
+		std::vector<RGAliasingRequest> aliasing_requests;
+		std::vector<Uint64> request_textures;
+		for (Uint32 heap_index = 0; heap_index < TransientHeapCount; ++heap_index)
+		{
+			GfxHeapUsage const heap_usage = heap_index == 0 ? GfxHeapUsage::RenderTargetTextures : GfxHeapUsage::NonRenderTargetTextures;
+			GetAliasingRequests(transient_textures, heap_usage, aliasing_requests, request_textures);
+			if (aliasing_requests.empty()) continue;
+
+			RGAliasingLayout layout = ComputeAliasingLayout(aliasing_requests);
+			std::unique_ptr<GfxHeap>& heap = transient_heaps[heap_index];
+			if (!heap || heap->GetDesc().size < layout.heap_size || heap->GetDesc().alignment < layout.heap_alignment)
+			{
+				GfxHeapDesc heap_desc{};
+				heap_desc.size = layout.heap_size;
+				heap_desc.alignment = layout.heap_alignment;
+				heap_desc.usage = heap_usage;
+				heap = std::make_unique<GfxHeap>(device, heap_desc);
+			}
+
+			for (Uint64 i = 0; i < request_textures.size(); ++i)
+			{
+				RGTransientTexture const& transient_texture = transient_textures[request_textures[i]];
+				RGPlacedTexture& placed_texture = placed_textures[request_textures[i]];
+				placed_texture.texture = std::make_unique<GfxTexture>(device, transient_texture.desc, *heap, layout.offsets[i]);
+				placed_texture.aliased = layout.aliased[i];
+				placed_texture.newly_placed = true;
+				if (layout.aliased[i]) ++transient_memory_stats.aliased_texture_count;
+			}
+			transient_memory_stats.unaliased_size += layout.unaliased_size;
+			transient_memory_stats.aliased_size += layout.heap_size;
+			transient_memory_stats.peak_live_size += layout.peak_live_size;
+			transient_memory_stats.heap_size += heap->GetDesc().size;
+		}
+		transient_memory_stats.placed_texture_count = static_cast<Uint32>(transient_textures.size());
+		return placed_textures;
+	}
+
+	RGTransientMemoryStats RenderGraphResourcePool::ComputeTransientMemoryStats(std::span<RGTransientTexture const> transient_textures) const
+	{
+		RGTransientMemoryStats stats{};
+		std::vector<RGAliasingRequest> aliasing_requests;
+		std::vector<Uint64> request_textures;
+		for (Uint32 heap_index = 0; heap_index < TransientHeapCount; ++heap_index)
+		{
+			GfxHeapUsage const heap_usage = heap_index == 0 ? GfxHeapUsage::RenderTargetTextures : GfxHeapUsage::NonRenderTargetTextures;
+			GetAliasingRequests(transient_textures, heap_usage, aliasing_requests, request_textures);
+			if (aliasing_requests.empty()) continue;
+
+			RGAliasingLayout const layout = ComputeAliasingLayout(aliasing_requests);
+			for (Bool aliased : layout.aliased)
+			{
+				if (aliased) ++stats.aliased_texture_count;
+			}
+			stats.unaliased_size += layout.unaliased_size;
+			stats.aliased_size += layout.heap_size;
+			stats.peak_live_size += layout.peak_live_size;
+		}
+		stats.placed_texture_count = static_cast<Uint32>(transient_textures.size());
+		return stats;
+	}
+
+	GfxCommandList* RenderGraphResourcePool::AllocateCommandList()
+	{
+		auto& cmd_lists = cmd_list_pool[device->GetBackbufferIndex()];
+		if (cmd_list_count == cmd_lists.size())
+		{
+			cmd_lists.push_back(std::make_unique<GfxCommandList>(device, GfxCommandListType::Graphics, "Render Graph Command List"));
+		}
+		GfxCommandList* cmd_list = cmd_lists[cmd_list_count++].get();
+		cmd_list->ResetAllocator();
+		cmd_list->Begin();
+		return cmd_list;
+	}
+
+	GfxHeapUsage RenderGraphResourcePool::GetHeapUsage(GfxTextureDesc const& desc)
+	{
+		return HasAnyFlag(desc.bind_flags, GfxBindFlag::RenderTarget | GfxBindFlag::DepthStencil) ? GfxHeapUsage::RenderTargetTextures : GfxHeapUsage::NonRenderTargetTextures;
+	}
+
+	void RenderGraphResourcePool::GetAliasingRequests(std::span<RGTransientTexture const> transient_textures, GfxHeapUsage heap_usage,
+		std::vector<RGAliasingRequest>& aliasing_requests, std::vector<Uint64>& request_textures) const
+	{
+		aliasing_requests.clear();
+		request_textures.clear();
+		for (Uint64 i = 0; i < transient_textures.size(); ++i)
+		{
+			RGTransientTexture const& transient_texture = transient_textures[i];
+			if (GetHeapUsage(transient_texture.desc) != heap_usage) continue;
+
+			GfxAllocationInfo allocation_info = GfxTexture::GetAllocationInfo(device, transient_texture.desc);
+			aliasing_requests.push_back(RGAliasingRequest{ allocation_info.size, allocation_info.alignment, transient_texture.first_level, transient_texture.last_level });
+			request_textures.push_back(i);
+		}
+	}
+}
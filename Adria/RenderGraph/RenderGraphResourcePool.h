@@ -1,101 +1,89 @@
 #pragma once
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxTexture.h"
+#include "Graphics/GfxCommandList.h"
+#include "Graphics/GfxDevice.h"
+#include "Graphics/GfxHeap.h"
+#include "RenderGraphAliasing.h"
+#include "RenderGraphResourceCache.h"
+#include "RenderGraphParallelRecorder.h"
 
 namespace adria
 {
+	class RenderGraphPassBase;
+
+	struct RenderGraphTransientTexture
+	{
+		GfxTextureDesc desc;
+		Uint32 first_level;
+		Uint32 last_level;
+
+		Bool operator==(RenderGraphTransientTexture const&) const = default;
+	};
+	using RGTransientTexture = RenderGraphTransientTexture;
+
+	struct RenderGraphPlacedTexture
+	{
+		std::unique_ptr<GfxTexture> texture;
+		Bool aliased = false;		//memory range overlaps another transient texture's, it is activated every frame
+		Bool newly_placed = false;	//placed this frame into memory other resources may have used, it is activated once
+	};
+	using RGPlacedTexture = RenderGraphPlacedTexture;
+
+	struct RenderGraphTransientMemoryStats
+	{
+		Uint64 unaliased_size = 0;
+		Uint64 aliased_size = 0;
+		Uint64 peak_live_size = 0;
+		Uint64 heap_size = 0;
+		Uint32 placed_texture_count = 0;
+		Uint32 aliased_texture_count = 0;
+	};
+	using RGTransientMemoryStats = RenderGraphTransientMemoryStats;
+
 	class RenderGraphResourcePool
 	{
-		struct PooledTexture
-		{
-			std::unique_ptr<GfxTexture> texture;
-			Uint64 last_used_frame;
-		};
-
-		struct PooledBuffer
-		{
-			std::unique_ptr<GfxBuffer> buffer;
-			Uint64 last_used_frame;
-		};
+		static constexpr Uint32 TransientHeapCount = 2;
 
 	public:
 		explicit RenderGraphResourcePool(GfxDevice* device) : device(device) {}
 
-		void Tick()
-		{
-			for (Uint64 i = 0; i < texture_pool.size();)
-			{
-				PooledTexture& resource = texture_pool[i].first;
-				Bool active = texture_pool[i].second;
-				if (!active && resource.last_used_frame + 4 < frame_index)
-				{
-					std::swap(texture_pool[i], texture_pool.back());
-					texture_pool.pop_back();
-				}
-				else ++i;
-			}
-			++frame_index;
-		}
-
-		GfxTexture* AllocateTexture(GfxTextureDesc const& desc)
-		{
-			for (auto& [pool_texture, active] : texture_pool)
-			{
-				if (!active && pool_texture.texture->GetDesc().IsCompatible(desc))
-				{
-					pool_texture.last_used_frame = frame_index;
-					active = true;
-					return pool_texture.texture.get();
-				}
-			}
-			auto& texture = texture_pool.emplace_back(std::pair{ PooledTexture{ std::make_unique<GfxTexture>(device, desc), frame_index}, true }).first.texture;
-			return texture.get();
-		}
-		void ReleaseTexture(GfxTexture* texture)
-		{
-			for (auto& [pooled_texture, active] : texture_pool)
-			{
-				auto& texture_ptr = pooled_texture.texture;
-				if (active && texture_ptr.get() == texture)
-				{
-					active = false;
-				}
-			}
-		}
-
-		GfxBuffer* AllocateBuffer(GfxBufferDesc const& desc)
-		{
-			for (auto& [pool_buffer, active] : buffer_pool)
-			{
-				if (!active && pool_buffer.buffer->GetDesc() == desc)
-				{
-					pool_buffer.last_used_frame = frame_index;
-					active = true;
-					return pool_buffer.buffer.get();
-				}
-			}
-			auto& buffer = buffer_pool.emplace_back(std::pair{ PooledBuffer{ std::make_unique<GfxBuffer>(device, desc), frame_index}, true }).first.buffer;
-			return buffer.get();
-		}
-		void ReleaseBuffer(GfxBuffer* buffer)
-		{
-			for (auto& [pooled_buffer, active] : buffer_pool)
-			{
-				auto& buffer_ptr = pooled_buffer.buffer;
-				if (active && buffer_ptr.get() == buffer)
-				{
-					active = false;
-				}
-			}
-		}
+		void Tick();
+
+		GfxTexture* AllocateTexture(GfxTextureDesc const& desc, RGPoolHandle& handle);
+		void ReleaseTexture(RGPoolHandle handle);
+
+		GfxBuffer* AllocateBuffer(GfxBufferDesc const& desc, RGPoolHandle& handle);
+		void ReleaseBuffer(RGPoolHandle handle);
+
+		Bool CanPlaceTexture(GfxTextureDesc const& desc) const;
+		std::span<RGPlacedTexture const> PlaceTransientTextures(std::span<RGTransientTexture const> transient_textures);
+		//memory the transient textures would take with and without aliasing, nothing is placed and heap_size is left at 0
+		RGTransientMemoryStats ComputeTransientMemoryStats(std::span<RGTransientTexture const> transient_textures) const;
 
+		GfxCommandList* AllocateCommandList();
+		RenderGraphParallelRecorder<RenderGraphPassBase, GfxCommandList>& GetParallelRecorder() { return parallel_recorder; }
+
+		RGResourcePoolStats const& GetStats() const { return cache.GetStats(); }
+		RGTransientMemoryStats const& GetTransientMemoryStats() const { return transient_memory_stats; }
 		GfxDevice* GetDevice() const { return device; }
 
 	private:
 		GfxDevice* device = nullptr;
-		Uint64 frame_index = 0;
-		std::vector<std::pair<PooledTexture, Bool>> texture_pool;
-		std::vector<std::pair<PooledBuffer, Bool>>  buffer_pool;
+		RenderGraphResourceCache<GfxTexture, GfxBuffer> cache;
+		std::vector<std::unique_ptr<GfxCommandList>> cmd_list_pool[GFX_BACKBUFFER_COUNT];
+		Uint64 cmd_list_count = 0;
+		RenderGraphParallelRecorder<RenderGraphPassBase, GfxCommandList> parallel_recorder;
+
+		std::unique_ptr<GfxHeap> transient_heaps[TransientHeapCount];
+		std::vector<RGTransientTexture> placed_transient_textures;
+		std::vector<RGPlacedTexture> placed_textures;
+		RGTransientMemoryStats transient_memory_stats;
+
+	private:
+		static GfxHeapUsage GetHeapUsage(GfxTextureDesc const& desc);
+		void GetAliasingRequests(std::span<RGTransientTexture const> transient_textures, GfxHeapUsage heap_usage,
+			std::vector<RGAliasingRequest>& aliasing_requests, std::vector<Uint64>& request_textures) const;
 	};
 	using RGResourcePool = RenderGraphResourcePool;
 
@@ -3,6 +3,7 @@
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxCommandList.h"
+#include "Graphics/GfxLinearDynamicAllocator.h"
 
 namespace adria
 {
@@ -28,14 +29,29 @@ namespace adria
 			GfxRayTracingGeometry& rt_geometry = rt_geometries.emplace_back();
 			rt_geometry.vertex_buffer = geometry_buffer;
 			rt_geometry.vertex_buffer_offset = submesh.positions_offset;
-			rt_geometry.vertex_format = GfxFormat::R32G32B32_FLOAT;
+			rt_geometry.vertex_format = submesh.quantized ? GfxFormat::R16G16B16A16_SNORM : GfxFormat::R32G32B32_FLOAT;
 			rt_geometry.vertex_stride = GetGfxFormatStride(rt_geometry.vertex_format);
 			rt_geometry.vertex_count = submesh.vertices_count;
+			if (submesh.quantized)
+			{
+				//the transform maps the snorm positions back into the bounding box, the BLAS is built before the allocation is recycled
+				Vector3 const center(submesh.bounding_box.Center);
+				Vector3 const extents(submesh.bounding_box.Extents);
+				Float const transform[3][4] =
+				{
+					{ extents.x, 0.0f, 0.0f, center.x },
+					{ 0.0f, extents.y, 0.0f, center.y },
+					{ 0.0f, 0.0f, extents.z, center.z }
+				};
+				GfxDynamicAllocation transform_allocation = dynamic_allocator->Allocate(sizeof(transform), D3D12_RAYTRACING_TRANSFORM3X4_BYTE_ALIGNMENT);
+				transform_allocation.Update(transform, sizeof(transform));
+				rt_geometry.transform_address = transform_allocation.gpu_address;
+			}
 
 			rt_geometry.index_buffer = geometry_buffer;
 			rt_geometry.index_buffer_offset = submesh.indices_offset;
 			rt_geometry.index_count = submesh.indices_count;
-			rt_geometry.index_format = GfxFormat::R32_UINT;
+			rt_geometry.index_format = submesh.index_format;
 			rt_geometry.opaque = material.alpha_mode == MaterialAlphaMode::Opaque;
 
 			GfxRayTracingInstance& rt_instance = rt_instances.emplace_back();
@@ -18,4 +18,3 @@ namespace adria
 		else cmd_list->Draw(submesh.vertex_count, submesh.instance_count, submesh.start_vertex_location, submesh.start_instance_location);
 	}
 }
-
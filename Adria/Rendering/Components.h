@@ -2,6 +2,8 @@
 #include <memory>
 #include <DirectXCollision.h>
 #include "GeometryBufferCache.h"
+#include "Meshlet.h"
+#include "SubMeshGPU.h"
 #include "Graphics/GfxVertexFormat.h"
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxStates.h"
@@ -156,28 +158,6 @@ namespace adria
 	struct COMPONENT Ocean {};
 	struct COMPONENT Transparent {};
 
-	struct SubMeshGPU
-	{
-		Uint64 buffer_address;
-
-		Uint32 indices_offset;
-		Uint32 indices_count;
-		Uint32 vertices_count;
-
-		Uint32 positions_offset;
-		Uint32 uvs_offset;
-		Uint32 normals_offset;
-		Uint32 tangents_offset;
-
-		Uint32 meshlet_offset;
-		Uint32 meshlet_vertices_offset;
-		Uint32 meshlet_triangles_offset;
-		Uint32 meshlet_count;
-
-		Uint32 material_index;
-		DirectX::BoundingBox bounding_box;
-		GfxPrimitiveTopology topology;
-	};
 	struct SubMeshInstance
 	{
 		entt::entity parent;
@@ -201,6 +181,7 @@ namespace adria
 		Matrix world_transform;
 		BoundingBox bounding_box;
 		Bool camera_visibility = true;
+		Uint32 lod = 0;
 	};
 
 	void Draw(SubMesh const& submesh, GfxCommandList* cmd_list, Bool override_topology = false, GfxPrimitiveTopology new_topology = GfxPrimitiveTopology::Undefined);
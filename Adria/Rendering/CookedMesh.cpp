@@ -0,0 +1,224 @@
+#include <filesystem>
+#include "CookedMesh.h"
+#include "GeometryStreamCodec.h"
+#include "Utilities/AllocatorUtil.h"
+#include "Utilities/ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	namespace
+	{
+		constexpr Uint32 CookedMeshMagic = 0x534D4341; //ACMS
+		constexpr Uint32 CookedMeshVersion = 4;
+		//index streams of every lod, the four vertex streams and the three meshlet streams
+		constexpr Uint32 StreamsPerSubMesh = MESH_MAX_LODS + 7;
+
+		struct CookedMeshHeader
+		{
+			Uint32 magic;
+			Uint32 version;
+			Uint64 source_hash;
+			Uint64 submesh_size;
+			Uint64 submesh_count;
+			Uint64 submesh_offset;
+			Uint64 stream_offset;
+			Uint64 encoded_offset;
+			Uint64 encoded_size;
+			Uint64 geometry_size;
+		};
+		static_assert(std::is_trivially_copyable_v<SubMeshGPU>);
+
+		//every submesh has the same streams in the same order, the index streams of missing lods are empty
+		std::array<GeometryStream, StreamsPerSubMesh> GetGeometryStreams(SubMeshGPU const& submesh)
+		{
+			SubMeshStrides const strides = GetSubMeshStrides(submesh);
+			std::array<GeometryStream, StreamsPerSubMesh> streams{};
+			for (Uint32 lod = 0; lod < submesh.lod_count; ++lod)
+			{
+				SubMeshLOD const& submesh_lod = submesh.lods[lod];
+				Bool const triangle_list = submesh.topology == GfxPrimitiveTopology::TriangleList && submesh_lod.indices_count % 3 == 0;
+				streams[lod] = { submesh_lod.indices_offset, submesh_lod.indices_count, strides.index, triangle_list ? GeometryStreamCodec::IndexBuffer : GeometryStreamCodec::IndexSequence };
+			}
+
+			SubMeshLOD const& last_lod = submesh.lods[submesh.lod_count - 1];
+			Uint32 stream = MESH_MAX_LODS;
+			//vertex attributes are most of the geometry, they are copied straight from the mapping instead of being decoded
+			streams[stream++] = { submesh.positions_offset, submesh.vertices_count, strides.position, GeometryStreamCodec::Uncompressed };
+			streams[stream++] = { submesh.uvs_offset, submesh.vertices_count, strides.uv, GeometryStreamCodec::Uncompressed };
+			streams[stream++] = { submesh.normals_offset, submesh.vertices_count, strides.normal, GeometryStreamCodec::Uncompressed };
+			streams[stream++] = { submesh.tangents_offset, submesh.vertices_count, strides.tangent, GeometryStreamCodec::Uncompressed };
+			streams[stream++] = { submesh.meshlet_offset, last_lod.meshlet_start + last_lod.meshlet_count, sizeof(Meshlet), GeometryStreamCodec::Vertex };
+			streams[stream++] = { submesh.meshlet_vertices_offset, submesh.meshlet_vertices_count, sizeof(Uint32), GeometryStreamCodec::Vertex };
+			streams[stream++] = { submesh.meshlet_triangles_offset, submesh.meshlet_triangles_count, sizeof(MeshletTriangle), GeometryStreamCodec::Vertex };
+			return streams;
+		}
+	}
+
+	Bool CookedMesh::Save(std::string const& cooked_path, Uint64 source_hash, std::span<SubMeshGPU const> submeshes, std::span<Uint8 const> geometry)
+	{
+		//submeshes are encoded in parallel into their own buffers, stream offsets are relative to the submesh buffer until they are merged
+		std::vector<std::vector<Uint8>> encoded_submeshes(submeshes.size());
+		std::vector<EncodedStream> encoded_streams(submeshes.size() * StreamsPerSubMesh);
+		ParallelFor(submeshes.size(), [&](Uint64 i)
+			{
+				std::array<GeometryStream, StreamsPerSubMesh> const geometry_streams = GetGeometryStreams(submeshes[i]);
+				for (Uint32 j = 0; j < StreamsPerSubMesh; ++j)
+				{
+					GeometryStream const& stream = geometry_streams[j];
+					EncodedStream& encoded_stream = encoded_streams[i * StreamsPerSubMesh + j];
+					encoded_stream.offset = encoded_submeshes[i].size();
+					if (stream.count == 0) continue;
+
+					ADRIA_ASSERT(stream.offset + stream.count * stream.stride <= geometry.size());
+					EncodeGeometryStream(stream, geometry.data() + stream.offset, encoded_submeshes[i]);
+					encoded_stream.size = encoded_submeshes[i].size() - encoded_stream.offset;
+#if defined(_DEBUG)
+					std::vector<Uint8> decoded(stream.count * stream.stride);
+					ADRIA_ASSERT(DecodeGeometryStream(stream, encoded_submeshes[i].data() + encoded_stream.offset, encoded_stream.size, decoded.data()));
+					ADRIA_ASSERT(IsDecodedGeometryStreamEqual(stream, geometry.data() + stream.offset, decoded.data()));
+#endif
+				}
+			});
+
+		Uint64 encoded_size = 0;
+		for (Uint64 i = 0; i < submeshes.size(); ++i)
+		{
+			for (Uint32 j = 0; j < StreamsPerSubMesh; ++j) encoded_streams[i * StreamsPerSubMesh + j].offset += encoded_size;
+			encoded_size += encoded_submeshes[i].size();
+		}
+
+		std::string const temp_cooked_path = cooked_path + ".tmp";
+		{
+			std::ofstream os(temp_cooked_path, std::ios::binary);
+			if (!os)
+			{
+				ADRIA_LOG(WARNING, "Could not write cooked mesh %s", temp_cooked_path.c_str());
+				return false;
+			}
+
+			CookedMeshHeader header{};
+			header.magic = CookedMeshMagic;
+			header.version = CookedMeshVersion;
+			header.source_hash = source_hash;
+			header.submesh_size = sizeof(SubMeshGPU);
+			header.submesh_count = submeshes.size();
+			header.submesh_offset = Align(sizeof(CookedMeshHeader), alignof(SubMeshGPU));
+			header.stream_offset = Align(header.submesh_offset + submeshes.size_bytes(), alignof(EncodedStream));
+			header.encoded_offset = header.stream_offset + encoded_streams.size() * sizeof(EncodedStream);
+			header.encoded_size = encoded_size;
+			header.geometry_size = geometry.size();
+
+			std::vector<Char> padding(std::max(alignof(SubMeshGPU), alignof(EncodedStream)), 0);
+			os.write(reinterpret_cast<Char const*>(&header), sizeof(header));
+			os.write(padding.data(), header.submesh_offset - sizeof(header));
+			os.write(reinterpret_cast<Char const*>(submeshes.data()), submeshes.size_bytes());
+			os.write(padding.data(), header.stream_offset - header.submesh_offset - submeshes.size_bytes());
+			os.write(reinterpret_cast<Char const*>(encoded_streams.data()), encoded_streams.size() * sizeof(EncodedStream));
+			for (std::vector<Uint8> const& encoded_submesh : encoded_submeshes)
+			{
+				os.write(reinterpret_cast<Char const*>(encoded_submesh.data()), encoded_submesh.size());
+			}
+			if (!os)
+			{
+				ADRIA_LOG(WARNING, "Could not write cooked mesh %s", temp_cooked_path.c_str());
+				return false;
+			}
+		}
+
+		std::error_code error;
+		fs::rename(temp_cooked_path, cooked_path, error);
+		if (error)
+		{
+			ADRIA_LOG(WARNING, "Could not replace cooked mesh %s: %s", cooked_path.c_str(), error.message().c_str());
+			fs::remove(temp_cooked_path, error);
+			return false;
+		}
+		return true;
+	}
+
+	Bool CookedMesh::Open(std::string const& cooked_path, Uint64 source_hash)
+	{
+		Close();
+		if (!file.Open(cooked_path)) return false;
+
+		CookedMeshHeader header{};
+		if (file.GetSize() < sizeof(header))
+		{
+			Close();
+			return false;
+		}
+		memcpy(&header, file.GetData(), sizeof(header));
+		Bool valid = header.magic == CookedMeshMagic && header.version == CookedMeshVersion && header.source_hash == source_hash &&
+					 header.submesh_size == sizeof(SubMeshGPU) && header.submesh_offset % alignof(SubMeshGPU) == 0 &&
+					 header.submesh_offset + header.submesh_count * sizeof(SubMeshGPU) <= header.stream_offset &&
+					 header.stream_offset % alignof(EncodedStream) == 0 &&
+					 header.stream_offset + header.submesh_count * StreamsPerSubMesh * sizeof(EncodedStream) <= header.encoded_offset &&
+					 header.encoded_offset + header.encoded_size <= file.GetSize();
+		if (valid)
+		{
+			submeshes = std::span<SubMeshGPU const>(reinterpret_cast<SubMeshGPU const*>(file.GetData() + header.submesh_offset), header.submesh_count);
+			encoded_streams = std::span<EncodedStream const>(reinterpret_cast<EncodedStream const*>(file.GetData() + header.stream_offset), header.submesh_count * StreamsPerSubMesh);
+			encoded_data = std::span<Uint8 const>(file.GetData() + header.encoded_offset, header.encoded_size);
+			geometry_size = header.geometry_size;
+
+			//decoding writes wherever the records point, so every stream has to stay inside the geometry and encoded data
+			for (Uint64 i = 0; valid && i < submeshes.size(); ++i)
+			{
+				if (submeshes[i].lod_count == 0 || submeshes[i].lod_count > MESH_MAX_LODS)
+				{
+					valid = false;
+					break;
+				}
+				std::array<GeometryStream, StreamsPerSubMesh> const geometry_streams = GetGeometryStreams(submeshes[i]);
+				for (Uint32 j = 0; j < StreamsPerSubMesh; ++j)
+				{
+					GeometryStream const& stream = geometry_streams[j];
+					EncodedStream const& encoded_stream = encoded_streams[i * StreamsPerSubMesh + j];
+					if (stream.offset + stream.count * stream.stride > geometry_size || encoded_stream.offset + encoded_stream.size > encoded_data.size())
+					{
+						valid = false;
+						break;
+					}
+				}
+			}
+		}
+		if (!valid)
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void CookedMesh::Close()
+	{
+		submeshes = {};
+		encoded_streams = {};
+		encoded_data = {};
+		geometry_size = 0;
+		file.Close();
+	}
+
+	Bool CookedMesh::DecodeGeometry(Uint8* geometry) const
+	{
+		std::atomic<Bool> decoded = true;
+		ParallelFor(submeshes.size(), [&](Uint64 i)
+			{
+				std::array<GeometryStream, StreamsPerSubMesh> const geometry_streams = GetGeometryStreams(submeshes[i]);
+				for (Uint32 j = 0; j < StreamsPerSubMesh; ++j)
+				{
+					GeometryStream const& stream = geometry_streams[j];
+					EncodedStream const& encoded_stream = encoded_streams[i * StreamsPerSubMesh + j];
+					if (stream.count == 0) continue;
+					if (!DecodeGeometryStream(stream, encoded_data.data() + encoded_stream.offset, encoded_stream.size, geometry + stream.offset))
+					{
+						decoded = false;
+						return;
+					}
+				}
+			});
+		return decoded;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <span>
+#include <string>
+#include "SubMeshGPU.h"
+#include "Utilities/MemoryMappedFile.h"
+
+namespace adria
+{
+	//imported model geometry stored as a header, the submesh records and the streams of the geometry buffer
+	//index and meshlet streams are compressed with the meshoptimizer codecs, vertex attributes are stored as they are uploaded
+	//a cooked mesh is only opened for the source hash it was saved with, the hash covers the source files and the import settings
+	class CookedMesh
+	{
+		struct EncodedStream
+		{
+			Uint64 offset;
+			Uint64 size;
+		};
+
+	public:
+		CookedMesh() = default;
+		ADRIA_NONCOPYABLE(CookedMesh)
+		ADRIA_DEFAULT_MOVABLE(CookedMesh)
+		~CookedMesh() = default;
+
+		static Bool Save(std::string const& cooked_path, Uint64 source_hash, std::span<SubMeshGPU const> submeshes, std::span<Uint8 const> geometry);
+
+		Bool Open(std::string const& cooked_path, Uint64 source_hash);
+		void Close();
+
+		std::span<SubMeshGPU const> GetSubMeshes() const { return submeshes; }
+		Uint64 GetGeometrySize() const { return geometry_size; }
+		//geometry has to hold GetGeometrySize() bytes and can be mapped upload memory, streams are written front to back and the padding between them is left untouched
+		Bool DecodeGeometry(Uint8* geometry) const;
+
+	private:
+		MemoryMappedFile file;
+		std::span<SubMeshGPU const> submeshes;
+		std::span<EncodedStream const> encoded_streams;
+		std::span<Uint8 const> encoded_data;
+		Uint64 geometry_size = 0;
+	};
+}
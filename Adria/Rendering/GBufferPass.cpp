@@ -1,4 +1,5 @@
 #include <map>
+#include <bit>
 #include "GBufferPass.h"
 #include "ShaderStructs.h"
 #include "Components.h"
@@ -10,12 +11,36 @@
 #include "Graphics/GfxPipelineStatePermutations.h"
 #include "RenderGraph/RenderGraph.h"
 #include "Editor/GUICommand.h"
+#include "Utilities/RadixSort.h"
+#include "Utilities/Timer.h"
 #include "entt/entity/registry.hpp"
 
 using namespace DirectX;
 
 namespace adria
 {
+	enum GBufferPermutation : Uint32
+	{
+		GBufferPermutation_Rain				= 1 << 0,
+		GBufferPermutation_ViewMipMaps		= 1 << 1,
+		GBufferPermutation_TriangleOverdraw	= 1 << 2,
+		GBufferPermutation_MaterialID		= 1 << 3,
+		GBufferPermutation_Anisotropy		= 1 << 4,
+		GBufferPermutation_ClearCoat		= 1 << 5,
+		GBufferPermutation_Sheen			= 1 << 6,
+		GBufferPermutation_Mask				= 1 << 7,
+	};
+	static constexpr GfxPermutationDefine GBufferPermutationDefines[] =
+	{
+		{ "RAIN", "1", GfxShaderStage::PS },
+		{ "VIEW_MIPMAPS", "1", GfxShaderStage::PS },
+		{ "TRIANGLE_OVERDRAW", "1", GfxShaderStage::PS },
+		{ "MATERIAL_ID", "1", GfxShaderStage::PS },
+		{ "SHADING_EXTENSION_ANISOTROPY", "1", GfxShaderStage::PS },
+		{ "SHADING_EXTENSION_CLEARCOAT", "1", GfxShaderStage::PS },
+		{ "SHADING_EXTENSION_SHEEN", "1", GfxShaderStage::PS },
+		{ "MASK", "1", GfxShaderStage::PS },
+	};
 
 	GBufferPass::GBufferPass(entt::registry& reg, GfxDevice* gfx, Uint32 w, Uint32 h) :
 		reg{ reg }, gfx{ gfx }, width{ w }, height{ h }
@@ -58,28 +83,33 @@ namespace adria
 			},
 			[=](RenderGraphContext& context, GfxCommandList* cmd_list)
 			{
-				reg.sort<Batch>([&frame_data](Batch const& lhs, Batch const& rhs)
-					{ 
-						if(lhs.alpha_mode != rhs.alpha_mode) return lhs.alpha_mode < rhs.alpha_mode;
-						if(lhs.shading_extension != rhs.shading_extension)  return lhs.shading_extension < rhs.shading_extension;
-						Vector3 camera_position(frame_data.camera_position);
-						Float lhs_distance = Vector3::DistanceSquared(camera_position, lhs.bounding_box.Center);
-						Float rhs_distance = Vector3::DistanceSquared(camera_position, rhs.bounding_box.Center);
-						return lhs_distance < rhs_distance;
-					});
+				BuildDrawList(Vector3(frame_data.camera_position));
 
 				cmd_list->SetRootCBV(0, frame_data.frame_cbuffer_address);
 				GfxDevice* gfx = cmd_list->GetDevice();
 				GfxShadingRateInfo const& vrs = gfx->GetVRSInfo();
 				cmd_list->BeginVRS(vrs);
 
-				if (skip_alpha_blended) ProcessBatches(reg.view<Batch>(entt::exclude_t<Transparent>()), cmd_list);
-				else ProcessBatches(reg.view<Batch>(), cmd_list);
+				RecordDrawList(cmd_list);
 
 				cmd_list->EndVRS(vrs);
 			}, RGPassType::Graphics, RGPassFlags::None);
 	}
 
+	void GBufferPass::GUI()
+	{
+		QueueGUI([&]()
+			{
+				if (ImGui::TreeNode("GBuffer"))
+				{
+					ImGui::Text("Draws: %u, Pipelines: %u", stats.draw_count, stats.pso_count);
+					ImGui::Text("Draw List Build/Sort: %.1f us", stats.sort_time);
+					ImGui::Text("Draw List Record: %.1f us", stats.record_time);
+					ImGui::TreePop();
+				}
+			}, GUICommandGroup_Renderer);
+	}
+
 	void GBufferPass::OnResize(Uint32 w, Uint32 h)
 	{
 		width = w, height = h;
@@ -109,55 +139,120 @@ namespace adria
 		gbuffer_pso_desc.rtv_formats[3] = GfxFormat::R8G8B8A8_UNORM;
 		gbuffer_pso_desc.dsv_format = GfxFormat::D32_FLOAT;
 
-		gbuffer_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gbuffer_pso_desc);
+		gbuffer_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gbuffer_pso_desc, GBufferPermutationDefines);
+		gbuffer_pso_desc.rasterizer_state.cull_mode = GfxCullMode::None;
+		gbuffer_no_cull_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gbuffer_pso_desc, GBufferPermutationDefines);
+
+		static constexpr Uint32 MaterialPermutations[] =
+		{
+			0, GBufferPermutation_Anisotropy, GBufferPermutation_ClearCoat, GBufferPermutation_Sheen,
+			GBufferPermutation_Mask, GBufferPermutation_Mask | GBufferPermutation_Anisotropy, GBufferPermutation_Mask | GBufferPermutation_ClearCoat, GBufferPermutation_Mask | GBufferPermutation_Sheen
+		};
+		gbuffer_psos->Prewarm(MaterialPermutations, ShaderManager::CompileShaders);
+		gbuffer_no_cull_psos->Prewarm(std::span(MaterialPermutations).first(4), ShaderManager::CompileShaders);
 	}
 
-	template<typename View>
-	void GBufferPass::ProcessBatches(View view, GfxCommandList* cmd_list)
+	GfxPipelineState* GBufferPass::GetPSO(ShadingExtension extension, MaterialAlphaMode alpha_mode)
 	{
-		auto GetPSO = [this](ShadingExtension extension, MaterialAlphaMode alpha_mode)
-			{
-				using enum GfxShaderStage;
-				if (raining) gbuffer_psos->AddDefine<PS>("RAIN", "1");
-				if (debug_mipmaps) gbuffer_psos->AddDefine<PS>("VIEW_MIPMAPS", "1");
-				if (triangle_overdraw) gbuffer_psos->AddDefine<PS>("TRIANGLE_OVERDRAW", "1");
-				if (material_ids) gbuffer_psos->AddDefine<PS>("MATERIAL_ID", "1");
+		Uint32 permutation = 0;
+		if (raining) permutation |= GBufferPermutation_Rain;
+		if (debug_mipmaps) permutation |= GBufferPermutation_ViewMipMaps;
+		if (triangle_overdraw) permutation |= GBufferPermutation_TriangleOverdraw;
+		if (material_ids) permutation |= GBufferPermutation_MaterialID;
 
-				switch (extension)
-				{
-				case ShadingExtension::Anisotropy:	gbuffer_psos->AddDefine<PS>("SHADING_EXTENSION_ANISOTROPY", "1"); break;
-				case ShadingExtension::ClearCoat:	gbuffer_psos->AddDefine<PS>("SHADING_EXTENSION_CLEARCOAT", "1"); break;
-				case ShadingExtension::Sheen:		gbuffer_psos->AddDefine<PS>("SHADING_EXTENSION_SHEEN", "1"); break;
-				}
+		switch (extension)
+		{
+		case ShadingExtension::Anisotropy:	permutation |= GBufferPermutation_Anisotropy; break;
+		case ShadingExtension::ClearCoat:	permutation |= GBufferPermutation_ClearCoat; break;
+		case ShadingExtension::Sheen:		permutation |= GBufferPermutation_Sheen; break;
+		}
 
-				switch (alpha_mode)
-				{
-				case MaterialAlphaMode::Opaque: break;
-				case MaterialAlphaMode::Mask:   gbuffer_psos->AddDefine<PS>("MASK", "1"); break;
-				case MaterialAlphaMode::Blend:  gbuffer_psos->SetCullMode(GfxCullMode::None); break;
-				}
-				return gbuffer_psos->Get();
-			};
+		switch (alpha_mode)
+		{
+		case MaterialAlphaMode::Opaque: break;
+		case MaterialAlphaMode::Mask:   permutation |= GBufferPermutation_Mask; break;
+		case MaterialAlphaMode::Blend:  return gbuffer_no_cull_psos->Get(permutation);
+		}
+		return gbuffer_psos->Get(permutation);
+	}
+
+	//key layout: pso index (alpha mode major, shading extension minor) | 24-bit view distance | batch index
+	//the batch index only makes keys unique, so the radix sort skips its bytes and the sort is front to back per pso
+	void GBufferPass::BuildDrawList(Vector3 const& camera_position)
+	{
+		Timer timer;
+		constexpr Uint64 ShadingExtensionCount = (Uint64)ShadingExtension::Count;
+		constexpr Uint32 BatchIndexBytes = 4;
 
-		for (auto batch_entity : view)
+		draw_batches.clear();
+		draw_keys.clear();
+		auto batch_view = reg.view<Batch>();
+		for (auto batch_entity : batch_view)
 		{
-			Batch& batch = view.get<Batch>(batch_entity);
+			Batch const& batch = batch_view.get<Batch>(batch_entity);
 			if (!batch.camera_visibility) continue;
+			if (skip_alpha_blended && batch.alpha_mode == MaterialAlphaMode::Blend) continue;
 
-			GfxPipelineState* pso = GetPSO(batch.shading_extension, batch.alpha_mode);
-			cmd_list->SetPipelineState(pso);
+			Uint64 const pso_index = (Uint64)batch.alpha_mode * ShadingExtensionCount + (Uint64)batch.shading_extension;
+			Float const distance = Vector3::DistanceSquared(camera_position, batch.bounding_box.Center);
+			Uint64 const quantized_distance = std::bit_cast<Uint32>(distance) >> 8;
+			draw_keys.push_back((pso_index << 56) | (quantized_distance << 32) | draw_batches.size());
+			draw_batches.push_back(&batch);
+		}
+		draw_keys_scratch.resize(draw_keys.size());
+		RadixSort(draw_keys, draw_keys_scratch, BatchIndexBytes);
+
+		draw_items.resize(draw_keys.size());
+		stats.pso_count = 0;
+		Uint64 current_pso_index = UINT64_MAX;
+		GfxPipelineState* current_pso = nullptr;
+		for (Uint64 i = 0; i < draw_keys.size(); ++i)
+		{
+			Uint64 const pso_index = draw_keys[i] >> 56;
+			Batch const& batch = *draw_batches[draw_keys[i] & 0xffffffff];
+			if (pso_index != current_pso_index)
+			{
+				current_pso_index = pso_index;
+				current_pso = GetPSO(batch.shading_extension, batch.alpha_mode);
+				++stats.pso_count;
+			}
+
+			DrawItem& draw_item = draw_items[i];
+			draw_item.pso = current_pso;
+			SubMeshLOD const& lod = batch.submesh->lods[batch.lod];
+			draw_item.index_buffer_address = batch.submesh->buffer_address + lod.indices_offset;
+			draw_item.index_count = lod.indices_count;
+			draw_item.index_format = batch.submesh->index_format;
+			draw_item.instance_id = batch.instance_id;
+			draw_item.topology = batch.submesh->topology;
+		}
+		stats.draw_count = (Uint32)draw_items.size();
+		stats.sort_time = (Float)timer.Elapsed();
+	}
+
+	void GBufferPass::RecordDrawList(GfxCommandList* cmd_list)
+	{
+		Timer timer;
+		GfxPipelineState* current_pso = nullptr;
+		for (DrawItem const& draw_item : draw_items)
+		{
+			if (draw_item.pso != current_pso)
+			{
+				current_pso = draw_item.pso;
+				cmd_list->SetPipelineState(current_pso);
+			}
 
 			struct GBufferConstants
 			{
 				Uint32 instance_id;
-			} constants{ .instance_id = batch.instance_id };
+			} constants{ .instance_id = draw_item.instance_id };
 			cmd_list->SetRootConstants(1, constants);
 
-			GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
-			cmd_list->SetTopology(batch.submesh->topology);
+			GfxIndexBufferView ibv(draw_item.index_buffer_address, draw_item.index_count, draw_item.index_format);
+			cmd_list->SetTopology(draw_item.topology);
 			cmd_list->SetIndexBuffer(&ibv);
-			cmd_list->DrawIndexed(batch.submesh->indices_count);
+			cmd_list->DrawIndexed(draw_item.index_count);
 		}
+		stats.record_time = (Float)timer.Elapsed();
 	}
 }
-
@@ -7,8 +7,21 @@ namespace adria
 {
 	class GfxDevice;
 	class GfxCommandList;
+	class GfxPipelineState;
 	class RenderGraph;
+	struct Batch;
 	enum class RendererDebugView : Uint32;
+	enum class GfxPrimitiveTopology : Uint8;
+	enum class ShadingExtension : Uint8;
+	enum class MaterialAlphaMode : Uint8;
+
+	struct GBufferPassStats
+	{
+		Uint32 draw_count = 0;
+		Uint32 pso_count = 0;
+		Float  sort_time = 0.0f;	//us
+		Float  record_time = 0.0f;	//us
+	};
 
 	class GBufferPass
 	{
@@ -27,6 +40,7 @@ namespace adria
 		{
 			skip_alpha_blended = skip;
 		}
+		void GUI();
 
 	private:
 		entt::registry& reg;
@@ -38,10 +52,27 @@ namespace adria
 		Bool material_ids = false;
 		Bool skip_alpha_blended = false;
 		std::unique_ptr<GfxGraphicsPipelineStatePermutations> gbuffer_psos;
+		std::unique_ptr<GfxGraphicsPipelineStatePermutations> gbuffer_no_cull_psos;
+
+		struct DrawItem
+		{
+			GfxPipelineState* pso;
+			Uint64 index_buffer_address;
+			Uint32 index_count;
+			GfxFormat index_format;
+			Uint32 instance_id;
+			GfxPrimitiveTopology topology;
+		};
+		std::vector<Batch const*> draw_batches;
+		std::vector<Uint64>   draw_keys;
+		std::vector<Uint64>   draw_keys_scratch;
+		std::vector<DrawItem> draw_items;
+		GBufferPassStats	  stats;
 
 	private:
 		void CreatePSOs();
-		template<typename View>
-		void ProcessBatches(View view, GfxCommandList* cmd_list);
+		GfxPipelineState* GetPSO(ShadingExtension extension, MaterialAlphaMode alpha_mode);
+		void BuildDrawList(Vector3 const& camera_position);
+		void RecordDrawList(GfxCommandList* cmd_list);
 	};
 }
\ No newline at end of file
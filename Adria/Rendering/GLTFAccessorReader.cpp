@@ -0,0 +1,207 @@
+#include <immintrin.h>
+#include "cgltf.h"
+#include "GLTFAccessorReader.h"
+
+namespace adria
+{
+	namespace
+	{
+		//accessors whose elements are tightly packed can be read as a whole straight from the buffer view, sparse substitutions are applied afterwards
+		Uint8 const* GetPackedAccessorData(cgltf_accessor const* accessor)
+		{
+			if (!accessor->buffer_view) return nullptr;
+			if (accessor->stride != cgltf_calc_size(accessor->type, accessor->component_type)) return nullptr;
+			Uint8 const* data = cgltf_buffer_view_data(accessor->buffer_view);
+			return data ? data + accessor->offset : nullptr;
+		}
+
+		void WidenIndices(Uint16 const* src, Uint32* dst, Uint64 count)
+		{
+			__m128i const zero = _mm_setzero_si128();
+			Uint64 i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				__m128i const indices = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(indices, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(indices, zero));
+			}
+			for (; i < count; ++i) dst[i] = src[i];
+		}
+
+		void WidenIndices(Uint8 const* src, Uint32* dst, Uint64 count)
+		{
+			__m128i const zero = _mm_setzero_si128();
+			Uint64 i = 0;
+			for (; i + 16 <= count; i += 16)
+			{
+				__m128i const indices = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+				__m128i const indices_lo = _mm_unpacklo_epi8(indices, zero);
+				__m128i const indices_hi = _mm_unpackhi_epi8(indices, zero);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(indices_lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(indices_lo, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(indices_hi, zero));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(indices_hi, zero));
+			}
+			for (; i < count; ++i) dst[i] = src[i];
+		}
+
+		Uint32 ReadIndex(Uint8 const* data, cgltf_component_type component_type)
+		{
+			switch (component_type)
+			{
+			case cgltf_component_type_r_32u: { Uint32 index; memcpy(&index, data, sizeof(index)); return index; }
+			case cgltf_component_type_r_16u: { Uint16 index; memcpy(&index, data, sizeof(index)); return index; }
+			case cgltf_component_type_r_8u:  return *data;
+			}
+			return 0;
+		}
+
+		Bool ReadPackedIndices(cgltf_accessor const* accessor, Uint32* indices)
+		{
+			Uint8 const* data = GetPackedAccessorData(accessor);
+			if (!data) return false;
+
+			switch (accessor->component_type)
+			{
+			case cgltf_component_type_r_32u: memcpy(indices, data, accessor->count * sizeof(Uint32)); return true;
+			case cgltf_component_type_r_16u: WidenIndices(reinterpret_cast<Uint16 const*>(data), indices, accessor->count); return true;
+			case cgltf_component_type_r_8u:  WidenIndices(data, indices, accessor->count); return true;
+			}
+			return false;
+		}
+
+		void ReadStridedIndices(cgltf_accessor const* accessor, Uint32* indices)
+		{
+			Uint8 const* data = accessor->buffer_view ? cgltf_buffer_view_data(accessor->buffer_view) : nullptr;
+			if (!data)
+			{
+				memset(indices, 0, accessor->count * sizeof(Uint32));
+				return;
+			}
+			data += accessor->offset;
+			for (Uint64 i = 0; i < accessor->count; ++i) indices[i] = ReadIndex(data + i * accessor->stride, accessor->component_type);
+		}
+
+		void ApplySparseIndices(cgltf_accessor const* accessor, Uint32* indices)
+		{
+			cgltf_accessor_sparse const& sparse = accessor->sparse;
+			Uint8 const* sparse_indices = cgltf_buffer_view_data(sparse.indices_buffer_view);
+			Uint8 const* sparse_values = cgltf_buffer_view_data(sparse.values_buffer_view);
+			if (!sparse_indices || !sparse_values) return;
+
+			sparse_indices += sparse.indices_byte_offset;
+			sparse_values += sparse.values_byte_offset;
+			Uint64 const sparse_index_size = cgltf_component_size(sparse.indices_component_type);
+			Uint64 const value_size = cgltf_component_size(accessor->component_type);
+			for (Uint64 i = 0; i < sparse.count; ++i)
+			{
+				Uint32 const element = ReadIndex(sparse_indices + i * sparse_index_size, sparse.indices_component_type);
+				if (element < accessor->count) indices[element] = ReadIndex(sparse_values + i * value_size, accessor->component_type);
+			}
+		}
+
+		//swaps the last two indices of every triangle, four triangles are three registers:
+		//[a0 b0 c0 a1] [b1 c1 a2 b2] [c2 a3 b3 c3] -> [a0 c0 b0 a1] [c1 b1 a2 c2] [b2 a3 c3 b3]
+		void FlipWinding(std::vector<Uint32>& indices)
+		{
+			Uint64 const triangle_count = indices.size() / 3;
+			Uint64 t = 0;
+			for (; t + 4 <= triangle_count; t += 4)
+			{
+				Uint32* triangles = indices.data() + 3 * t;
+				__m128 const a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(triangles)));
+				__m128 const b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(triangles + 4)));
+				__m128 const c = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(triangles + 8)));
+
+				__m128 const b2_b3_c0_c0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 0, 3, 2));
+				__m128 const b3_b3_c1_c1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 3, 3));
+				__m128 const flipped_a = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 2, 0));
+				__m128 const flipped_b = _mm_shuffle_ps(b, b2_b3_c0_c0, _MM_SHUFFLE(2, 0, 0, 1));
+				__m128 const flipped_c = _mm_shuffle_ps(b3_b3_c1_c1, c, _MM_SHUFFLE(2, 3, 2, 0));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(triangles), _mm_castps_si128(flipped_a));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(triangles + 4), _mm_castps_si128(flipped_b));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(triangles + 8), _mm_castps_si128(flipped_c));
+			}
+			for (; t < triangle_count; ++t) std::swap(indices[3 * t + 1], indices[3 * t + 2]);
+		}
+
+		//cgltf_accessor_unpack_floats copies packed float accessors in one go and converts the others per element
+		template<typename T>
+		void UnpackAttribute(cgltf_accessor const& accessor, T* stream)
+		{
+			constexpr Uint64 StreamComponentCount = sizeof(T) / sizeof(Float);
+			Uint64 const component_count = cgltf_num_components(accessor.type);
+			if (component_count == StreamComponentCount)
+			{
+				cgltf_accessor_unpack_floats(&accessor, reinterpret_cast<Float*>(stream), accessor.count * StreamComponentCount);
+				return;
+			}
+
+			std::vector<Float> unpacked(accessor.count * component_count);
+			cgltf_accessor_unpack_floats(&accessor, unpacked.data(), unpacked.size());
+			Uint64 const copied_component_count = std::min(component_count, StreamComponentCount);
+			for (Uint64 i = 0; i < accessor.count; ++i)
+			{
+				memcpy(&stream[i].x, unpacked.data() + i * component_count, copied_component_count * sizeof(Float));
+			}
+		}
+
+		//cgltf steps through sparse values with the stride of the base accessor, they are tightly packed though, so they are unpacked as an accessor of their own
+		template<typename T>
+		void ApplySparseAttribute(cgltf_accessor const* accessor, std::vector<T>& stream)
+		{
+			cgltf_accessor_sparse const& sparse = accessor->sparse;
+			Uint8 const* sparse_indices = cgltf_buffer_view_data(sparse.indices_buffer_view);
+			if (!sparse_indices || !cgltf_buffer_view_data(sparse.values_buffer_view)) return;
+			sparse_indices += sparse.indices_byte_offset;
+
+			cgltf_accessor values_accessor = *accessor;
+			values_accessor.is_sparse = false;
+			values_accessor.buffer_view = sparse.values_buffer_view;
+			values_accessor.offset = sparse.values_byte_offset;
+			values_accessor.count = sparse.count;
+			values_accessor.stride = cgltf_calc_size(accessor->type, accessor->component_type);
+			std::vector<T> values(sparse.count, T{});
+			UnpackAttribute(values_accessor, values.data());
+
+			Uint64 const sparse_index_size = cgltf_component_size(sparse.indices_component_type);
+			for (Uint64 i = 0; i < sparse.count; ++i)
+			{
+				Uint32 const element = ReadIndex(sparse_indices + i * sparse_index_size, sparse.indices_component_type);
+				if (element < stream.size()) stream[element] = values[i];
+			}
+		}
+
+		template<typename T>
+		void ReadAttribute(cgltf_accessor const* accessor, std::vector<T>& stream)
+		{
+			stream.assign(accessor->count, T{});
+			cgltf_accessor base_accessor = *accessor;
+			base_accessor.is_sparse = false;
+			UnpackAttribute(base_accessor, stream.data());
+			if (accessor->is_sparse) ApplySparseAttribute(accessor, stream);
+		}
+	}
+
+	void ReadGLTFIndices(cgltf_accessor const* accessor, Bool flip_winding, std::vector<Uint32>& indices)
+	{
+		indices.resize(accessor->count);
+		if (!ReadPackedIndices(accessor, indices.data())) ReadStridedIndices(accessor, indices.data());
+		if (accessor->is_sparse) ApplySparseIndices(accessor, indices.data());
+		if (flip_winding) FlipWinding(indices);
+	}
+
+	void ReadGLTFAttribute(cgltf_accessor const* accessor, std::vector<Vector2>& stream)
+	{
+		ReadAttribute(accessor, stream);
+	}
+	void ReadGLTFAttribute(cgltf_accessor const* accessor, std::vector<Vector3>& stream)
+	{
+		ReadAttribute(accessor, stream);
+	}
+	void ReadGLTFAttribute(cgltf_accessor const* accessor, std::vector<Vector4>& stream)
+	{
+		ReadAttribute(accessor, stream);
+	}
+}
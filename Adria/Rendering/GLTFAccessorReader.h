@@ -0,0 +1,17 @@
+#pragma once
+
+struct cgltf_accessor;
+
+namespace adria
+{
+	//decode glTF accessors into the streams of MeshData, the results match cgltf_accessor_read_index and cgltf_accessor_read_float
+	//with sparse substitutions applied. Tightly packed indices and float attributes are copied in bulk instead of per element
+
+	//flip_winding swaps the last two indices of every triangle
+	void ReadGLTFIndices(cgltf_accessor const* accessor, Bool flip_winding, std::vector<Uint32>& indices);
+
+	//components the accessor has but the stream doesn't are dropped, components the stream has but the accessor doesn't are zero
+	void ReadGLTFAttribute(cgltf_accessor const* accessor, std::vector<Vector2>& stream);
+	void ReadGLTFAttribute(cgltf_accessor const* accessor, std::vector<Vector3>& stream);
+	void ReadGLTFAttribute(cgltf_accessor const* accessor, std::vector<Vector4>& stream);
+}
@@ -0,0 +1,81 @@
+#include "meshoptimizer.h"
+#include "GeometryStreamCodec.h"
+
+namespace adria
+{
+	void EncodeGeometryStream(GeometryStream const& stream, Uint8 const* data, std::vector<Uint8>& encoded)
+	{
+		Uint64 const encoded_offset = encoded.size();
+		Uint64 encoded_size = 0;
+		if (stream.codec == GeometryStreamCodec::Uncompressed)
+		{
+			encoded_size = stream.count * stream.stride;
+			encoded.insert(encoded.end(), data, data + encoded_size);
+		}
+		else if (stream.codec == GeometryStreamCodec::Vertex)
+		{
+			encoded.resize(encoded_offset + meshopt_encodeVertexBufferBound(stream.count, stream.stride));
+			encoded_size = meshopt_encodeVertexBuffer(encoded.data() + encoded_offset, encoded.size() - encoded_offset, data, stream.count, stream.stride);
+		}
+		else
+		{
+			std::vector<Uint32> indices(stream.count);
+			for (Uint64 i = 0; i < stream.count; ++i)
+			{
+				indices[i] = stream.stride == sizeof(Uint16) ? reinterpret_cast<Uint16 const*>(data)[i] : reinterpret_cast<Uint32 const*>(data)[i];
+			}
+			Uint64 const vertex_count = *std::max_element(indices.begin(), indices.end()) + 1;
+			if (stream.codec == GeometryStreamCodec::IndexBuffer)
+			{
+				encoded.resize(encoded_offset + meshopt_encodeIndexBufferBound(stream.count, vertex_count));
+				encoded_size = meshopt_encodeIndexBuffer(encoded.data() + encoded_offset, encoded.size() - encoded_offset, indices.data(), stream.count);
+			}
+			else
+			{
+				encoded.resize(encoded_offset + meshopt_encodeIndexSequenceBound(stream.count, vertex_count));
+				encoded_size = meshopt_encodeIndexSequence(encoded.data() + encoded_offset, encoded.size() - encoded_offset, indices.data(), stream.count);
+			}
+		}
+		ADRIA_ASSERT(encoded_size > 0);
+		encoded.resize(encoded_offset + encoded_size);
+	}
+
+	Bool DecodeGeometryStream(GeometryStream const& stream, Uint8 const* encoded, Uint64 encoded_size, Uint8* data)
+	{
+		switch (stream.codec)
+		{
+		case GeometryStreamCodec::Vertex:
+			return meshopt_decodeVertexBuffer(data, stream.count, stream.stride, encoded, encoded_size) == 0;
+		case GeometryStreamCodec::IndexBuffer:
+			return meshopt_decodeIndexBuffer(data, stream.count, stream.stride, encoded, encoded_size) == 0;
+		case GeometryStreamCodec::IndexSequence:
+			return meshopt_decodeIndexSequence(data, stream.count, stream.stride, encoded, encoded_size) == 0;
+		case GeometryStreamCodec::Uncompressed:
+			if (encoded_size != stream.count * stream.stride) return false;
+			memcpy(data, encoded, encoded_size);
+			return true;
+		}
+		return false;
+	}
+
+	Bool IsDecodedGeometryStreamEqual(GeometryStream const& stream, Uint8 const* data, Uint8 const* decoded)
+	{
+		if (stream.codec != GeometryStreamCodec::IndexBuffer) return memcmp(data, decoded, stream.count * stream.stride) == 0;
+
+		auto GetIndex = [&stream](Uint8 const* indices, Uint64 i) -> Uint32
+			{
+				return stream.stride == sizeof(Uint16) ? reinterpret_cast<Uint16 const*>(indices)[i] : reinterpret_cast<Uint32 const*>(indices)[i];
+			};
+		for (Uint64 i = 0; i + 3 <= stream.count; i += 3)
+		{
+			Uint32 const triangle[] = { GetIndex(data, i), GetIndex(data, i + 1), GetIndex(data, i + 2) };
+			Bool rotated = false;
+			for (Uint32 rotation = 0; rotation < 3 && !rotated; ++rotation)
+			{
+				rotated = triangle[rotation] == GetIndex(decoded, i) && triangle[(rotation + 1) % 3] == GetIndex(decoded, i + 1) && triangle[(rotation + 2) % 3] == GetIndex(decoded, i + 2);
+			}
+			if (!rotated) return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace adria
+{
+	enum class GeometryStreamCodec : Uint8
+	{
+		Vertex,
+		IndexBuffer,
+		IndexSequence,
+		Uncompressed
+	};
+
+	//count elements of stride bytes starting at offset in a geometry buffer, index streams have a stride of 2 or 4 bytes
+	//IndexBuffer compresses triangle lists best, IndexSequence takes any index order, Uncompressed streams are stored and loaded with a copy
+	struct GeometryStream
+	{
+		Uint64 offset;
+		Uint64 count;
+		Uint32 stride;
+		GeometryStreamCodec codec;
+	};
+
+	//appends the stream compressed with the meshoptimizer codecs to encoded, data points at its first element
+	void EncodeGeometryStream(GeometryStream const& stream, Uint8 const* data, std::vector<Uint8>& encoded);
+	//writes count * stride bytes to data, false if the encoded stream is corrupt
+	Bool DecodeGeometryStream(GeometryStream const& stream, Uint8 const* encoded, Uint64 encoded_size, Uint8* data);
+	//true if decoded holds the elements of data, IndexBuffer can rotate the indices of a triangle but keeps the winding and the triangle order
+	Bool IsDecodedGeometryStreamEqual(GeometryStream const& stream, Uint8 const* data, Uint8 const* decoded);
+}
@@ -0,0 +1,135 @@
+#include "meshoptimizer.h"
+#include "MeshProcessing.h"
+#include "Math/NormalsUtil.h"
+#include "Math/BoundingVolumeUtil.h"
+
+namespace adria
+{
+	namespace
+	{
+		//every LOD is simplified from the previous one to about half of its triangles, so its error relative to the full detail
+		//submesh is bounded by the sum of the errors along the chain. Borders are locked so neighbouring submeshes don't crack
+		void BuildLODs(MeshData& mesh_data, Uint32 lod_count)
+		{
+			mesh_data.lods.push_back(MeshLODData{ .first_index = 0, .index_count = (Uint32)mesh_data.indices.size() });
+
+			Uint64 const vertex_count = mesh_data.positions_stream.size();
+			if (mesh_data.topology != GfxPrimitiveTopology::TriangleList || vertex_count == 0) return;
+
+			Float const error_scale = meshopt_simplifyScale(&mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3));
+			std::vector<Uint32> source_indices = mesh_data.indices;
+			std::vector<Uint32> lod_indices(source_indices.size());
+			Float lod_error = 0.0f;
+			while (mesh_data.lods.size() < lod_count)
+			{
+				Uint64 const target_index_count = source_indices.size() / 6 * 3;
+				if (target_index_count < MeshLODMinTriangleCount * 3) break;
+
+				Float simplify_error = 0.0f;
+				Uint64 const index_count = meshopt_simplify(lod_indices.data(), source_indices.data(), source_indices.size(), &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3),
+					target_index_count, MeshLODMaxRelativeError, meshopt_SimplifyLockBorder, &simplify_error);
+				//the simplifier got stuck on the error bound or the locked borders, another LOD would cost about as much as this one
+				if (index_count == 0 || index_count > source_indices.size() * 3 / 4) break;
+
+				meshopt_optimizeVertexCache(lod_indices.data(), lod_indices.data(), index_count, vertex_count);
+				lod_error += simplify_error * error_scale;
+				mesh_data.lods.push_back(MeshLODData{ .first_index = (Uint32)mesh_data.indices.size(), .index_count = (Uint32)index_count, .error = lod_error });
+				mesh_data.indices.insert(mesh_data.indices.end(), lod_indices.begin(), lod_indices.begin() + index_count);
+				source_indices.assign(lod_indices.begin(), lod_indices.begin() + index_count);
+			}
+		}
+
+		void BuildMeshlets(MeshData& mesh_data, MeshLODData& lod)
+		{
+			Uint64 const vertex_count = mesh_data.positions_stream.size();
+			Uint32 const* lod_indices = mesh_data.indices.data() + lod.first_index;
+
+			Uint64 const max_meshlets = meshopt_buildMeshletsBound(lod.index_count, MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+			std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+			std::vector<Uint32> meshlet_vertices(max_meshlets * MESHLET_MAX_VERTICES);
+			std::vector<Uchar> meshlet_triangles(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
+
+			Uint64 meshlet_count = meshopt_buildMeshlets(meshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(),
+				lod_indices, lod.index_count, &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3),
+				MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, 0);
+
+			lod.first_meshlet = (Uint32)mesh_data.meshlets.size();
+			lod.meshlet_count = (Uint32)meshlet_count;
+			if (meshlet_count == 0) return;
+
+			//meshlets of all LODs are appended to the same streams, their offsets are made relative to the start of those
+			Uint32 const vertex_offset = (Uint32)mesh_data.meshlet_vertices.size();
+			Uint32 triangle_offset = (Uint32)mesh_data.meshlet_triangles.size();
+			meshopt_Meshlet const& last = meshlets[meshlet_count - 1];
+			mesh_data.meshlet_vertices.insert(mesh_data.meshlet_vertices.end(), meshlet_vertices.begin(), meshlet_vertices.begin() + last.vertex_offset + last.vertex_count);
+
+			for (Uint64 i = 0; i < meshlet_count; ++i)
+			{
+				meshopt_Meshlet const& m = meshlets[i];
+				meshopt_Bounds meshopt_bounds = meshopt_computeMeshletBounds(&meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset],
+					m.triangle_count, reinterpret_cast<Float const*>(mesh_data.positions_stream.data()), vertex_count, sizeof(Vector3));
+
+				Uchar* src_triangles = meshlet_triangles.data() + m.triangle_offset;
+				for (Uint32 triangle_idx = 0; triangle_idx < m.triangle_count; ++triangle_idx)
+				{
+					MeshletTriangle& tri = mesh_data.meshlet_triangles.emplace_back();
+					tri.V0 = *src_triangles++;
+					tri.V1 = *src_triangles++;
+					tri.V2 = *src_triangles++;
+				}
+
+				Meshlet& meshlet = mesh_data.meshlets.emplace_back();
+				std::memcpy(meshlet.center, meshopt_bounds.center, sizeof(Float) * 3);
+
+				meshlet.radius = meshopt_bounds.radius;
+				meshlet.vertex_count = m.vertex_count;
+				meshlet.triangle_count = m.triangle_count;
+				meshlet.vertex_offset = vertex_offset + m.vertex_offset;
+				meshlet.triangle_offset = triangle_offset;
+				triangle_offset += m.triangle_count;
+			}
+		}
+	}
+
+	void ProcessMeshData(MeshData& mesh_data, Bool supports_meshlets, Uint32 lod_count)
+	{
+		Uint64 vertex_count = mesh_data.positions_stream.size();
+
+		Bool has_tangents = !mesh_data.tangents_stream.empty();
+		if (mesh_data.normals_stream.size() != vertex_count) mesh_data.normals_stream.resize(vertex_count);
+		if (mesh_data.uvs_stream.size() != vertex_count) mesh_data.uvs_stream.resize(vertex_count);
+		if (mesh_data.tangents_stream.size() != vertex_count) mesh_data.tangents_stream.resize(vertex_count);
+
+		if (!has_tangents)
+		{
+			ComputeTangentFrame(mesh_data.indices.data(), mesh_data.indices.size(), mesh_data.positions_stream.data(),
+				mesh_data.normals_stream.data(), mesh_data.uvs_stream.data(), vertex_count, mesh_data.tangents_stream.data());
+		}
+
+		mesh_data.bounding_box = AABBFromPositions(mesh_data.positions_stream);
+
+		if (supports_meshlets)
+		{
+			meshopt_optimizeVertexCache(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
+			meshopt_optimizeOverdraw(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3), 1.05f);
+			std::vector<Uint32> remap(vertex_count);
+			meshopt_optimizeVertexFetchRemap(&remap[0], mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
+			meshopt_remapIndexBuffer(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.positions_stream.data(), mesh_data.positions_stream.data(), vertex_count, sizeof(Vector3), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.normals_stream.data(), mesh_data.normals_stream.data(), mesh_data.normals_stream.size(), sizeof(Vector3), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.tangents_stream.data(), mesh_data.tangents_stream.data(), mesh_data.tangents_stream.size(), sizeof(Vector4), &remap[0]);
+			meshopt_remapVertexBuffer(mesh_data.uvs_stream.data(), mesh_data.uvs_stream.data(), mesh_data.uvs_stream.size(), sizeof(Vector2), &remap[0]);
+		}
+
+		BuildLODs(mesh_data, lod_count);
+
+		if (!supports_meshlets)
+		{
+			return;
+		}
+		for (MeshLODData& lod : mesh_data.lods)
+		{
+			BuildMeshlets(mesh_data, lod);
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include "SubMeshGPU.h"
+
+namespace adria
+{
+	static constexpr Uint32 MeshLODMinTriangleCount = 32;
+	static constexpr Float  MeshLODMaxRelativeError = 0.1f;
+
+	struct MeshLODData
+	{
+		Uint32 first_index;
+		Uint32 index_count;
+		Uint32 first_meshlet;
+		Uint32 meshlet_count;
+		Float  error;
+	};
+
+	struct MeshData
+	{
+		DirectX::BoundingBox bounding_box;
+		Int32 material_index = -1;
+		GfxPrimitiveTopology topology = GfxPrimitiveTopology::TriangleList;
+		Bool quantized = false;
+		GfxFormat index_format = GfxFormat::R32_UINT;
+
+		std::vector<Vector3>		 positions_stream;
+		std::vector<Vector3>		 normals_stream;
+		std::vector<Vector4>		 tangents_stream;
+		std::vector<Vector2>		 uvs_stream;
+		std::vector<Uint32>			 indices;
+		std::vector<MeshLODData>	 lods;
+
+		std::vector<Meshlet>		 meshlets;
+		std::vector<Uint32>			 meshlet_vertices;
+		std::vector<MeshletTriangle> meshlet_triangles;
+	};
+
+	//fills in the missing vertex streams and the bounding box, reorders vertices and indices for the GPU when meshlets are supported
+	//and builds up to lod_count LODs and their meshlets. Only mesh_data is touched so primitives can be processed in parallel
+	void ProcessMeshData(MeshData& mesh_data, Bool supports_meshlets, Uint32 lod_count);
+}
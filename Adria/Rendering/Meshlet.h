@@ -4,6 +4,7 @@ namespace adria
 {
 	static constexpr Uint64 MESHLET_MAX_TRIANGLES = 124;
 	static constexpr Uint64 MESHLET_MAX_VERTICES = 64;
+	static constexpr Uint32 MESH_MAX_LODS = 6;
 
 	struct MeshletTriangle
 	{
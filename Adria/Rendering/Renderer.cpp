@@ -6,6 +6,7 @@
 #include "SkyModel.h"
 #include "TextureManager.h"
 #include "DebugRenderer.h"
+#include "SceneUpdate.h"
 
 #include "Editor/GUICommand.h"
 #include "Editor/Editor.h"
@@ -30,9 +31,12 @@ using namespace DirectX;
 namespace adria
 {
 	static TAutoConsoleVariable<Int>  LightingPathType("r.LightingPath", 0, "0 - Deferred, 1 - Tiled Deferred, 2 - Clustered Deferred, 3 - Path Tracing");
+	static TAutoConsoleVariable<Bool>  MeshLODs("r.Meshes.LOD", true, "0: batches are always drawn at full detail. 1: the LOD of each batch is selected from its projected simplification error");
+	static TAutoConsoleVariable<Float> MeshLODErrorThreshold("r.Meshes.LODErrorThreshold", 1.0f, "Projected simplification error in pixels a LOD is allowed to have");
+	static TAutoConsoleVariable<Bool> BVHCulling("r.BVHCulling", true, "0: batches are culled with a flat pass over all bounds. 1: batches are culled by traversing the batch BVH");
 
-	Renderer::Renderer(entt::registry& reg, GfxDevice* gfx, Uint32 width, Uint32 height) : reg(reg), gfx(gfx), resource_pool(gfx),
-		accel_structure(gfx), camera(nullptr), display_width(width), display_height(height), render_width(width), render_height(height),
+	Renderer::Renderer(entt::registry& reg, GfxDevice* gfx, Uint32 width, Uint32 height) : reg(reg), gfx(gfx), resource_pool(gfx), rg_allocator(256 * 1024),
+		render_graph(resource_pool, rg_allocator, &rg_compile_cache), accel_structure(gfx), camera(nullptr), display_width(width), display_height(height), render_width(width), render_height(height),
 		backbuffer_count(gfx->GetBackbufferCount()), backbuffer_index(gfx->GetBackbufferIndex()), final_texture(nullptr),
 		frame_cbuffer(gfx, backbuffer_count), gpu_driven_renderer(reg, gfx, width, height),
 		gbuffer_pass(reg, gfx, width, height),
@@ -52,6 +56,15 @@ namespace adria
 		CreateDisplaySizeDependentResources();
 		CreateRenderSizeDependentResources();
 		RegisterEventListeners();
+		reg.on_construct<Mesh>().connect<&Renderer::OnSceneMeshChanged>(this);
+		reg.on_update<Mesh>().connect<&Renderer::OnSceneMeshUpdated>(this);
+		reg.on_destroy<Mesh>().connect<&Renderer::OnSceneMeshChanged>(this);
+		reg.on_construct<Light>().connect<&Renderer::OnSceneLightChanged>(this);
+		reg.on_update<Light>().connect<&Renderer::OnSceneLightUpdated>(this);
+		reg.on_destroy<Light>().connect<&Renderer::OnSceneLightChanged>(this);
+		reg.on_construct<Transform>().connect<&Renderer::OnSceneTransformChanged>(this);
+		reg.on_update<Transform>().connect<&Renderer::OnSceneTransformChanged>(this);
+		reg.on_destroy<Transform>().connect<&Renderer::OnSceneTransformChanged>(this);
 		screenshot_fence.Create(gfx, "Screenshot Fence");
 	}
 
@@ -60,6 +73,15 @@ namespace adria
 		GfxTracyProfiler::Destroy();
 		g_GfxProfiler.Destroy();
 		gfx->WaitForGPU();
+		reg.on_construct<Mesh>().disconnect(this);
+		reg.on_update<Mesh>().disconnect(this);
+		reg.on_destroy<Mesh>().disconnect(this);
+		reg.on_construct<Light>().disconnect(this);
+		reg.on_update<Light>().disconnect(this);
+		reg.on_destroy<Light>().disconnect(this);
+		reg.on_construct<Transform>().disconnect(this);
+		reg.on_update<Transform>().disconnect(this);
+		reg.on_destroy<Transform>().disconnect(this);
 		reg.clear();
 		gfxcommon::Destroy();
 	}
@@ -96,14 +118,16 @@ namespace adria
 		UpdateSceneBuffers();
 		UpdateFrameConstants(dt);
 		CameraFrustumCulling();
+		SelectMeshLODs();
 	}
 	void Renderer::Render()
 	{
 		ZoneScopedN("Renderer::Render");
-		RenderGraph render_graph(resource_pool);
 		RenderImpl(render_graph);
 		render_graph.Compile();
+		rg_barrier_plan_stats = render_graph.GetBarrierPlanStats();
 		render_graph.Execute();
+		render_graph.Reset();
 		g_Editor.EndFrame();
 	}
 
@@ -241,129 +265,171 @@ namespace adria
 
 	void Renderer::UpdateSceneBuffers()
 	{
-		for (auto e : reg.view<Batch>()) reg.destroy(e);
-		reg.clear<Batch>();
-
-		std::vector<LightGPU> hlsl_lights{};
-		Uint32 light_index = 0;
-		Matrix light_transform = lighting_path == LightingPath::PathTracing ? Matrix::Identity : camera->View();
-		for (auto light_entity : reg.view<Light>())
-		{
-			Light& light = reg.get<Light>(light_entity);
-			light.light_index = light_index;
-			++light_index;
-
-			LightGPU& hlsl_light = hlsl_lights.emplace_back();
-			hlsl_light.color = light.color * light.intensity;
-			hlsl_light.position = Vector4::Transform(light.position, light_transform);
-			hlsl_light.direction = Vector4::Transform(light.direction, light_transform);
-			hlsl_light.range = light.range;
-			hlsl_light.type = static_cast<Int32>(light.type);
-			hlsl_light.inner_cosine = light.inner_cosine;
-			hlsl_light.outer_cosine = light.outer_cosine;
-			hlsl_light.volumetric = light.volumetric;
-			hlsl_light.volumetric_strength = light.volumetric_strength;
-			hlsl_light.active = light.active;
-			hlsl_light.shadow_matrix_index = light.casts_shadows ? light.shadow_matrix_index : -1;
-			hlsl_light.shadow_texture_index = light.casts_shadows ? light.shadow_texture_index : -1;
-			hlsl_light.shadow_mask_index = light.ray_traced_shadows ? light.shadow_mask_index : -1;
-			hlsl_light.use_cascades = light.use_cascades;
-		}
-
-		std::vector<MeshGPU> meshes;
-		std::vector<InstanceGPU> instances;
-		std::vector<MaterialGPU> materials;
-		Uint32 instanceID = 0;
-
-		for (auto mesh_entity : reg.view<Mesh>())
+		UpdateLightBuffer();
+		if (scene_meshes_dirty)
 		{
-			Mesh& mesh = reg.get<Mesh>(mesh_entity);
+			UpdateMeshBuffers();
+			scene_meshes_dirty = false;
+		}
+		else if (!dirty_meshes.empty())
+		{
+			UpdateDirtyMeshes();
+		}
+		dirty_meshes.clear();
 
-			GfxBuffer* mesh_buffer = g_GeometryBufferCache.GetGeometryBuffer(mesh.geometry_buffer_handle);
-			GfxDescriptor mesh_buffer_srv = g_GeometryBufferCache.GetGeometryBufferSRV(mesh.geometry_buffer_handle);
-			GfxDescriptor mesh_buffer_online_srv = gfx->AllocateDescriptorsGPU();
-			gfx->CopyDescriptors(1, mesh_buffer_online_srv, mesh_buffer_srv);
+		for (SceneBuffer& scene_buffer : scene_buffers)
+		{
+			if (!scene_buffer.buffer) continue;
+			scene_buffer.buffer_srv_gpu = gfx->AllocateDescriptorsGPU();
+			gfx->CopyDescriptors(1, scene_buffer.buffer_srv_gpu, scene_buffer.buffer_srv);
+		}
+		if (!mesh_buffer_srvs.empty())
+		{
+			mesh_buffers_srv_gpu = gfx->AllocateDescriptorsGPU((Uint32)mesh_buffer_srvs.size());
+			gfx->CopyDescriptors(mesh_buffers_srv_gpu, mesh_buffer_srvs);
+		}
+	}
 
-			for (auto const& instance : mesh.instances)
+	//light data is in view space so every light is rewritten when the camera moves, otherwise only the patched lights are
+	void Renderer::UpdateLightBuffer()
+	{
+		//shadow descriptors come from the per-frame ring, so their indices change without the light being modified
+		auto WriteShadowIndices = [](Light const& light, LightGPU& hlsl_light)
 			{
-				SubMeshGPU& submesh = mesh.submeshes[instance.submesh_index];
-				Material& material = mesh.materials[submesh.material_index];
+				Int32 const shadow_matrix_index = light.casts_shadows ? light.shadow_matrix_index : -1;
+				Int32 const shadow_texture_index = light.casts_shadows ? light.shadow_texture_index : -1;
+				Int32 const shadow_mask_index = light.ray_traced_shadows ? light.shadow_mask_index : -1;
+				Bool const changed = hlsl_light.shadow_matrix_index != shadow_matrix_index || hlsl_light.shadow_texture_index != shadow_texture_index
+								  || hlsl_light.shadow_mask_index != shadow_mask_index;
+				hlsl_light.shadow_matrix_index = shadow_matrix_index;
+				hlsl_light.shadow_texture_index = shadow_texture_index;
+				hlsl_light.shadow_mask_index = shadow_mask_index;
+				return changed;
+			};
+		auto WriteLight = [&WriteShadowIndices](Light const& light, Matrix const& light_transform, LightGPU& hlsl_light)
+			{
+				hlsl_light.color = light.color * light.intensity;
+				hlsl_light.position = Vector4::Transform(light.position, light_transform);
+				hlsl_light.direction = Vector4::Transform(light.direction, light_transform);
+				hlsl_light.range = light.range;
+				hlsl_light.type = static_cast<Int32>(light.type);
+				hlsl_light.inner_cosine = light.inner_cosine;
+				hlsl_light.outer_cosine = light.outer_cosine;
+				hlsl_light.volumetric = light.volumetric;
+				hlsl_light.volumetric_strength = light.volumetric_strength;
+				hlsl_light.active = light.active;
+				WriteShadowIndices(light, hlsl_light);
+				hlsl_light.use_cascades = light.use_cascades;
+			};
 
-				submesh.buffer_address = mesh_buffer->GetGpuAddress();
+		auto lights = reg.view<Light>();
+		Matrix const light_transform = lighting_path == LightingPath::PathTracing ? Matrix::Identity : camera->View();
+		SceneBuffer& scene_buffer = scene_buffers[SceneBuffer_Light];
+		if (scene_lights_dirty || light_transform != scene_light_transform || light_data.size() != lights.size())
+		{
+			light_data.resize(lights.size());
+			Uint32 light_index = 0;
+			for (auto light_entity : lights)
+			{
+				Light& light = lights.get<Light>(light_entity);
+				light.light_index = light_index;
+				WriteLight(light, light_transform, light_data[light_index]);
+				++light_index;
+			}
+			scene_light_transform = light_transform;
+			scene_lights_dirty = false;
+			dirty_lights.clear();
+			if (light_data.empty()) return;
 
-				entt::entity batch_entity = reg.create();
-				if (material.alpha_mode == MaterialAlphaMode::Blend)
-				{
-					reg.emplace<Transparent>(batch_entity);
-				}
-				Batch& batch = reg.emplace<Batch>(batch_entity);
-				batch.instance_id = instanceID;
-				batch.alpha_mode = material.alpha_mode;
-				batch.shading_extension = material.shading_extension;
-				batch.submesh = &submesh;
-				batch.world_transform = instance.world_transform;
-				submesh.bounding_box.Transform(batch.bounding_box, batch.world_transform);
-				
-
-				InstanceGPU& instance_gpu = instances.emplace_back();
-				instance_gpu.instance_id = instanceID;
-				instance_gpu.material_idx = static_cast<Uint32>(materials.size() + submesh.material_index);
-				instance_gpu.mesh_index = static_cast<Uint32>(meshes.size() + instance.submesh_index);
-				instance_gpu.world_matrix = instance.world_transform;
-				instance_gpu.inverse_world_matrix = XMMatrixInverse(nullptr, instance.world_transform);
-				instance_gpu.bb_origin = submesh.bounding_box.Center;
-				instance_gpu.bb_extents = submesh.bounding_box.Extents;
-
-				++instanceID;
+			if (!scene_buffer.buffer || scene_buffer.buffer->GetCount() < light_data.size())
+			{
+				scene_buffer.buffer = gfx->CreateBuffer(StructuredBufferDesc<LightGPU>(light_data.size(), false, true));
+				scene_buffer.buffer_srv = gfx->CreateBufferSRV(scene_buffer.buffer.get());
 			}
-			for (auto const& submesh : mesh.submeshes)
+			scene_buffer.buffer->Update(light_data.data(), light_data.size() * sizeof(LightGPU));
+			return;
+		}
+
+		dirty_indices.clear();
+		for (entt::entity light_entity : dirty_lights)
+		{
+			if (!reg.valid(light_entity) || !lights.contains(light_entity)) continue;
+			Light const& light = lights.get<Light>(light_entity);
+			WriteLight(light, light_transform, light_data[light.light_index]);
+			dirty_indices.push_back(light.light_index);
+		}
+		dirty_lights.clear();
+		for (auto light_entity : lights)
+		{
+			Light const& light = lights.get<Light>(light_entity);
+			if (WriteShadowIndices(light, light_data[light.light_index])) dirty_indices.push_back(light.light_index);
+		}
+		UpdateBufferRanges(scene_buffer.buffer.get(), light_data.data(), sizeof(LightGPU));
+	}
+
+	//batches and mesh, instance and material data persist until a Mesh component is added or removed, patches only rewrite the entries of their mesh
+	void Renderer::UpdateMeshBuffers()
+	{
+		for (auto e : reg.view<Batch>()) reg.destroy(e);
+		reg.clear<Batch>();
+		mesh_buffer_srvs.clear();
+		scene_mesh_ranges.clear();
+
+		SceneMeshRange range{};
+		for (auto mesh_entity : reg.view<Mesh>())
+		{
+			Mesh const& mesh = reg.get<Mesh>(mesh_entity);
+			range.buffer_idx = static_cast<Uint32>(mesh_buffer_srvs.size());
+			range.instance_count = static_cast<Uint32>(mesh.instances.size());
+			range.mesh_count = static_cast<Uint32>(mesh.submeshes.size());
+			range.material_count = static_cast<Uint32>(mesh.materials.size());
+			mesh_buffer_srvs.push_back(g_GeometryBufferCache.GetGeometryBufferSRV(mesh.geometry_buffer_handle));
+			scene_mesh_ranges[mesh_entity] = range;
+
+			range.instance_offset += range.instance_count;
+			range.mesh_offset += range.mesh_count;
+			range.material_offset += range.material_count;
+		}
+
+		Uint32 const instance_count = range.instance_offset;
+		instance_data.resize(instance_count);
+		mesh_data.resize(range.mesh_offset);
+		material_data.resize(range.material_offset);
+		batch_bounds.Resize(instance_count);
+		batch_entities.resize(instance_count);
+		for (Uint32 instance_id = 0; instance_id < instance_count; ++instance_id)
+		{
+			entt::entity batch_entity = reg.create();
+			Batch& batch = reg.emplace<Batch>(batch_entity);
+			batch.instance_id = instance_id;
+			batch_entities[instance_id] = batch_entity;
+		}
+
+		std::vector<BoundingBox> batch_boxes(instance_count);
+		for (auto const& [mesh_entity, mesh_range] : scene_mesh_ranges)
+		{
+			WriteSceneMesh(mesh_entity, mesh_range);
+			for (Uint32 i = 0; i < mesh_range.instance_count; ++i)
 			{
-				MeshGPU& mesh_gpu = meshes.emplace_back();
-				mesh_gpu.buffer_idx = mesh_buffer_online_srv.GetIndex();
-				mesh_gpu.indices_offset = submesh.indices_offset;
-				mesh_gpu.positions_offset = submesh.positions_offset;
-				mesh_gpu.normals_offset = submesh.normals_offset;
-				mesh_gpu.tangents_offset = submesh.tangents_offset;
-				mesh_gpu.uvs_offset = submesh.uvs_offset;
-
-				mesh_gpu.meshlet_offset = submesh.meshlet_offset;
-				mesh_gpu.meshlet_vertices_offset = submesh.meshlet_vertices_offset;
-				mesh_gpu.meshlet_triangles_offset = submesh.meshlet_triangles_offset;
-				mesh_gpu.meshlet_count = submesh.meshlet_count;
+				Uint32 const instance_id = mesh_range.instance_offset + i;
+				batch_boxes[instance_id] = reg.get<Batch>(batch_entities[instance_id]).bounding_box;
 			}
+		}
 
-			for (auto const& material : mesh.materials)
+		//instances keep their ids while the scene has the same instance count, so moved instances only refit the BVH
+		if (batch_bvh.GetPrimitiveCount() != instance_count)
+		{
+			batch_bvh.Build(batch_boxes);
+		}
+		else
+		{
+			for (Uint32 i = 0; i < instance_count; ++i)
 			{
-				MaterialGPU& material_gpu = materials.emplace_back();
-				material_gpu.shading_extension = (Uint32)material.shading_extension;
-				material_gpu.albedo_color = Vector3(material.albedo_color);
-				material_gpu.albedo_idx = (Uint32)material.albedo_texture;
-				material_gpu.roughness_metallic_idx = (Uint32)material.metallic_roughness_texture;
-				material_gpu.metallic_factor = material.metallic_factor;
-				material_gpu.roughness_factor = material.roughness_factor;
-
-				material_gpu.normal_idx = (Uint32)material.normal_texture;
-				material_gpu.emissive_idx = (Uint32)material.emissive_texture;
-				material_gpu.emissive_factor = material.emissive_factor;
-				material_gpu.alpha_cutoff = material.alpha_cutoff;
-				material_gpu.alpha_blended = material.alpha_mode == MaterialAlphaMode::Blend;
-
-				material_gpu.anisotropy_idx = (Int32)material.anisotropy_texture;
-				material_gpu.anisotropy_strength = material.anisotropy_strength;
-				material_gpu.anisotropy_rotation = material.anisotropy_rotation;
-
-				material_gpu.clear_coat_idx = (Uint32)material.clear_coat_texture;
-				material_gpu.clear_coat_roughness_idx = (Uint32)material.clear_coat_roughness_texture;
-				material_gpu.clear_coat_normal_idx = (Uint32)material.clear_coat_normal_texture;
-				material_gpu.clear_coat = material.clear_coat;
-				material_gpu.clear_coat_roughness = material.clear_coat_roughness;
-
-				material_gpu.sheen_color = Vector3(material.sheen_color);
-				material_gpu.sheen_color_idx = (Uint32)material.sheen_color_texture;
-				material_gpu.sheen_roughness = material.sheen_roughness;
-				material_gpu.sheen_roughness_idx = (Uint32)material.sheen_roughness_texture;
+				if (memcmp(&batch_boxes[i], &prev_batch_boxes[i], sizeof(BoundingBox)) != 0) batch_bvh.UpdateBounds(i, batch_boxes[i]);
 			}
+			batch_bvh.Refit();
 		}
+		prev_batch_boxes = std::move(batch_boxes);
 
 		auto CopyBuffer = [&]<typename T>(std::vector<T> const& data, SceneBuffer& scene_buffer)
 		{
@@ -374,13 +440,186 @@ namespace adria
 				scene_buffer.buffer_srv = gfx->CreateBufferSRV(scene_buffer.buffer.get());
 			}
 			scene_buffer.buffer->Update(data.data(), data.size() * sizeof(T));
-			scene_buffer.buffer_srv_gpu = gfx->AllocateDescriptorsGPU();
-			gfx->CopyDescriptors(1, scene_buffer.buffer_srv_gpu, scene_buffer.buffer_srv);
 		};
-		CopyBuffer(hlsl_lights, scene_buffers[SceneBuffer_Light]);
-		CopyBuffer(meshes, scene_buffers[SceneBuffer_Mesh]);
-		CopyBuffer(instances, scene_buffers[SceneBuffer_Instance]);
-		CopyBuffer(materials, scene_buffers[SceneBuffer_Material]);
+		CopyBuffer(mesh_data, scene_buffers[SceneBuffer_Mesh]);
+		CopyBuffer(instance_data, scene_buffers[SceneBuffer_Instance]);
+		CopyBuffer(material_data, scene_buffers[SceneBuffer_Material]);
+	}
+
+	void Renderer::UpdateDirtyMeshes()
+	{
+		for (entt::entity mesh_entity : dirty_meshes)
+		{
+			if (!reg.valid(mesh_entity) || !reg.all_of<Mesh>(mesh_entity)) continue;
+			auto it = scene_mesh_ranges.find(mesh_entity);
+			Mesh const& mesh = reg.get<Mesh>(mesh_entity);
+			if (it == scene_mesh_ranges.end() || it->second.instance_count != mesh.instances.size() ||
+				it->second.mesh_count != mesh.submeshes.size() || it->second.material_count != mesh.materials.size())
+			{
+				UpdateMeshBuffers();
+				return;
+			}
+		}
+
+		auto UploadRanges = [this]<typename T>(std::vector<T> const& data, SceneBuffer& scene_buffer, Uint32 SceneMeshRange::* offset, Uint32 SceneMeshRange::* count)
+			{
+				dirty_indices.clear();
+				for (entt::entity mesh_entity : dirty_meshes)
+				{
+					auto it = scene_mesh_ranges.find(mesh_entity);
+					if (it == scene_mesh_ranges.end()) continue;
+					for (Uint32 i = 0; i < it->second.*count; ++i) dirty_indices.push_back(it->second.*offset + i);
+				}
+				UpdateBufferRanges(scene_buffer.buffer.get(), data.data(), sizeof(T));
+			};
+
+		for (entt::entity mesh_entity : dirty_meshes)
+		{
+			auto it = scene_mesh_ranges.find(mesh_entity);
+			if (it == scene_mesh_ranges.end()) continue;
+			SceneMeshRange const& range = it->second;
+			WriteSceneMesh(mesh_entity, range);
+			for (Uint32 i = 0; i < range.instance_count; ++i)
+			{
+				Uint32 const instance_id = range.instance_offset + i;
+				BoundingBox const& bounding_box = reg.get<Batch>(batch_entities[instance_id]).bounding_box;
+				if (memcmp(&bounding_box, &prev_batch_boxes[instance_id], sizeof(BoundingBox)) == 0) continue;
+				prev_batch_boxes[instance_id] = bounding_box;
+				batch_bvh.UpdateBounds(instance_id, bounding_box);
+			}
+		}
+		batch_bvh.Refit();
+
+		UploadRanges(instance_data, scene_buffers[SceneBuffer_Instance], &SceneMeshRange::instance_offset, &SceneMeshRange::instance_count);
+		UploadRanges(mesh_data, scene_buffers[SceneBuffer_Mesh], &SceneMeshRange::mesh_offset, &SceneMeshRange::mesh_count);
+		UploadRanges(material_data, scene_buffers[SceneBuffer_Material], &SceneMeshRange::material_offset, &SceneMeshRange::material_count);
+	}
+
+	//writes the instance, mesh and material entries and the batches of one mesh, a Transform on the mesh entity is applied on top of the instance transforms
+	void Renderer::WriteSceneMesh(entt::entity mesh_entity, SceneMeshRange const& range)
+	{
+		Mesh& mesh = reg.get<Mesh>(mesh_entity);
+		Transform const* mesh_transform = reg.try_get<Transform>(mesh_entity);
+		GfxBuffer* mesh_buffer = g_GeometryBufferCache.GetGeometryBuffer(mesh.geometry_buffer_handle);
+
+		for (Uint32 i = 0; i < range.instance_count; ++i)
+		{
+			SubMeshInstance const& instance = mesh.instances[i];
+			SubMeshGPU& submesh = mesh.submeshes[instance.submesh_index];
+			Material const& material = mesh.materials[submesh.material_index];
+			Uint32 const instance_id = range.instance_offset + i;
+			Matrix const world_transform = mesh_transform ? instance.world_transform * mesh_transform->current_transform : instance.world_transform;
+
+			submesh.buffer_address = mesh_buffer->GetGpuAddress();
+
+			entt::entity batch_entity = batch_entities[instance_id];
+			if (material.alpha_mode == MaterialAlphaMode::Blend) reg.emplace_or_replace<Transparent>(batch_entity);
+			else reg.remove<Transparent>(batch_entity);
+
+			Batch& batch = reg.get<Batch>(batch_entity);
+			batch.alpha_mode = material.alpha_mode;
+			batch.shading_extension = material.shading_extension;
+			batch.submesh = &submesh;
+			batch.world_transform = world_transform;
+			batch.bounding_box = WriteInstance(instance_data[instance_id], instance_id, range.material_offset + submesh.material_index,
+				range.mesh_offset + instance.submesh_index, world_transform, submesh.bounding_box);
+			batch_bounds.Set(instance_id, batch.bounding_box);
+		}
+
+		for (Uint32 i = 0; i < range.mesh_count; ++i)
+		{
+			SubMeshGPU const& submesh = mesh.submeshes[i];
+			MeshGPU& mesh_gpu = mesh_data[range.mesh_offset + i];
+			mesh_gpu.buffer_idx = range.buffer_idx;
+			mesh_gpu.indices_offset = submesh.indices_offset;
+			mesh_gpu.positions_offset = submesh.positions_offset;
+			mesh_gpu.normals_offset = submesh.normals_offset;
+			mesh_gpu.tangents_offset = submesh.tangents_offset;
+			mesh_gpu.uvs_offset = submesh.uvs_offset;
+
+			mesh_gpu.meshlet_offset = submesh.meshlet_offset;
+			mesh_gpu.meshlet_vertices_offset = submesh.meshlet_vertices_offset;
+			mesh_gpu.meshlet_triangles_offset = submesh.meshlet_triangles_offset;
+			mesh_gpu.meshlet_count = submesh.meshlet_count;
+			mesh_gpu.lod_count = submesh.lod_count;
+			for (Uint32 lod = 0; lod < submesh.lod_count; ++lod)
+			{
+				mesh_gpu.lods[lod].meshlet_start = submesh.lods[lod].meshlet_start;
+				mesh_gpu.lods[lod].meshlet_count = submesh.lods[lod].meshlet_count;
+				mesh_gpu.lods[lod].error = submesh.lods[lod].error;
+			}
+
+			mesh_gpu.flags = MeshFlag_None;
+			if (submesh.quantized) mesh_gpu.flags |= MeshFlag_Quantized;
+			if (submesh.index_format == GfxFormat::R16_UINT) mesh_gpu.flags |= MeshFlag_ShortIndices;
+			mesh_gpu.position_offset = submesh.bounding_box.Center;
+			mesh_gpu.position_scale = submesh.bounding_box.Extents;
+		}
+
+		for (Uint32 i = 0; i < range.material_count; ++i)
+		{
+			Material const& material = mesh.materials[i];
+			MaterialGPU& material_gpu = material_data[range.material_offset + i];
+			material_gpu.shading_extension = (Uint32)material.shading_extension;
+			material_gpu.albedo_color = Vector3(material.albedo_color);
+			material_gpu.albedo_idx = (Uint32)material.albedo_texture;
+			material_gpu.roughness_metallic_idx = (Uint32)material.metallic_roughness_texture;
+			material_gpu.metallic_factor = material.metallic_factor;
+			material_gpu.roughness_factor = material.roughness_factor;
+
+			material_gpu.normal_idx = (Uint32)material.normal_texture;
+			material_gpu.emissive_idx = (Uint32)material.emissive_texture;
+			material_gpu.emissive_factor = material.emissive_factor;
+			material_gpu.alpha_cutoff = material.alpha_cutoff;
+			material_gpu.alpha_blended = material.alpha_mode == MaterialAlphaMode::Blend;
+
+			material_gpu.anisotropy_idx = (Int32)material.anisotropy_texture;
+			material_gpu.anisotropy_strength = material.anisotropy_strength;
+			material_gpu.anisotropy_rotation = material.anisotropy_rotation;
+
+			material_gpu.clear_coat_idx = (Uint32)material.clear_coat_texture;
+			material_gpu.clear_coat_roughness_idx = (Uint32)material.clear_coat_roughness_texture;
+			material_gpu.clear_coat_normal_idx = (Uint32)material.clear_coat_normal_texture;
+			material_gpu.clear_coat = material.clear_coat;
+			material_gpu.clear_coat_roughness = material.clear_coat_roughness;
+
+			material_gpu.sheen_color = Vector3(material.sheen_color);
+			material_gpu.sheen_color_idx = (Uint32)material.sheen_color_texture;
+			material_gpu.sheen_roughness = material.sheen_roughness;
+			material_gpu.sheen_roughness_idx = (Uint32)material.sheen_roughness_texture;
+		}
+	}
+
+	//writes the entries at dirty_indices, consecutive indices are merged into one write
+	void Renderer::UpdateBufferRanges(GfxBuffer* buffer, void const* data, Uint64 stride)
+	{
+		Uint8 const* bytes = static_cast<Uint8 const*>(data);
+		ForEachDirtyRange(dirty_indices, [=](Uint32 first_index, Uint32 count)
+			{
+				buffer->Update(bytes + first_index * stride, count * stride, first_index * stride);
+			});
+	}
+
+	void Renderer::OnSceneMeshChanged(entt::registry&, entt::entity)
+	{
+		scene_meshes_dirty = true;
+	}
+	void Renderer::OnSceneMeshUpdated(entt::registry&, entt::entity mesh_entity)
+	{
+		dirty_meshes.insert(mesh_entity);
+	}
+	void Renderer::OnSceneLightChanged(entt::registry&, entt::entity)
+	{
+		scene_lights_dirty = true;
+	}
+	void Renderer::OnSceneLightUpdated(entt::registry&, entt::entity light_entity)
+	{
+		dirty_lights.insert(light_entity);
+	}
+	void Renderer::OnSceneTransformChanged(entt::registry& registry, entt::entity entity)
+	{
+		if (registry.all_of<Light>(entity)) dirty_lights.insert(entity);
+		if (registry.all_of<Mesh>(entity)) dirty_meshes.insert(entity);
 	}
 
 	void Renderer::UpdateFrameConstants(Float dt)
@@ -420,7 +659,10 @@ namespace adria
 		frame_cbuf_data.materials_idx = (Int32)scene_buffers[SceneBuffer_Material].buffer_srv_gpu.GetIndex();
 		frame_cbuf_data.instances_idx = (Int32)scene_buffers[SceneBuffer_Instance].buffer_srv_gpu.GetIndex();
 		frame_cbuf_data.lights_idx = (Int32)scene_buffers[SceneBuffer_Light].buffer_srv_gpu.GetIndex();
-		frame_cbuf_data.light_count = (Int32)scene_buffers[SceneBuffer_Light].buffer->GetCount();
+		frame_cbuf_data.light_count = (Int32)light_data.size();
+		frame_cbuf_data.mesh_buffers_idx = (Int32)mesh_buffers_srv_gpu.GetIndex();
+		//distance per unit of object space error at which the error projects to the threshold, 0 keeps every batch at full detail
+		frame_cbuf_data.mesh_lod_error_scale = MeshLODs.Get() ? 0.5f * render_height * camera->Proj()._22 / std::max(MeshLODErrorThreshold.Get(), 0.01f) : 0.0f;
 		shadow_renderer.FillFrameCBuffer(frame_cbuf_data);
 		frame_cbuf_data.ddgi_volumes_idx = ddgi.IsEnabled() ? ddgi.GetDDGIVolumeIndex() : -1;
 		frame_cbuf_data.printf_buffer_idx = gpu_debug_printer.GetPrintfBufferIndex();
@@ -462,16 +704,101 @@ namespace adria
 		frame_cbuf_data.prev_view = camera->View();
 		frame_cbuf_data.prev_projection = camera->Proj();
 	}
+	//the picking pass only reads back a surface point, the BVH finds the instances the camera ray to it passes through
+	void Renderer::PickMesh()
+	{
+		picked_mesh = entt::null;
+		if (batch_bvh.GetPrimitiveCount() == 0) return;
+
+		Vector3 const picked_position(picking_data.position);
+		Vector3 const camera_position = camera->Position();
+		Vector3 ray_direction = picked_position - camera_position;
+		Float const picked_distance = ray_direction.Length();
+		if (picked_distance < FLT_EPSILON) return;
+		ray_direction /= picked_distance;
+
+		Float const tolerance = 1e-3f * std::max(1.0f, picked_distance);
+		std::vector<Uint32> candidates;
+		batch_bvh.QueryRay(Ray(camera_position, ray_direction), picked_distance + tolerance, candidates);
+
+		//of the boxes the ray hits, the picked point lies on the surface of the smallest one containing it
+		Uint32 picked_instance = UINT32_MAX;
+		Float picked_volume = FLT_MAX;
+		for (Uint32 instance_id : candidates)
+		{
+			BoundingBox const& box = prev_batch_boxes[instance_id];
+			Vector3 const distance = Vector3(std::abs(picked_position.x - box.Center.x), std::abs(picked_position.y - box.Center.y), std::abs(picked_position.z - box.Center.z));
+			if (distance.x > box.Extents.x + tolerance || distance.y > box.Extents.y + tolerance || distance.z > box.Extents.z + tolerance) continue;
+
+			Float const volume = box.Extents.x * box.Extents.y * box.Extents.z;
+			if (volume < picked_volume)
+			{
+				picked_volume = volume;
+				picked_instance = instance_id;
+			}
+		}
+		if (picked_instance == UINT32_MAX) return;
+
+		for (auto const& [mesh_entity, mesh_range] : scene_mesh_ranges)
+		{
+			if (picked_instance >= mesh_range.instance_offset && picked_instance < mesh_range.instance_offset + mesh_range.instance_count)
+			{
+				picked_mesh = mesh_entity;
+				break;
+			}
+		}
+	}
+	//camera and all shadow views are culled together so every box is loaded once, view 0 is the camera
 	void Renderer::CameraFrustumCulling()
 	{
-		BoundingFrustum camera_frustum = camera->Frustum();
+		culling_views.clear();
+		culling_views.push_back(MakeCullingView(camera->Frustum()));
+		shadow_renderer.AppendCullingViews(culling_views);
+
+		Uint64 const word_count = batch_bounds.GetMaskWordCount();
+		batch_visibility.resize(culling_views.size() * word_count);
+		if (BVHCulling.Get()) batch_bvh.CullMultiView(culling_views, batch_visibility);
+		else CullBoundingBoxesMultiView(culling_views, batch_bounds, batch_visibility);
+
+		std::span<Uint64 const> camera_visibility(batch_visibility.data(), word_count);
 		auto batch_view = reg.view<Batch>();
-		auto light_view = reg.view<Light>();
 		for (auto e : batch_view)
 		{
 			Batch& batch = batch_view.get<Batch>(e);
-			auto& aabb = batch.bounding_box;
-			batch.camera_visibility = camera_frustum.Intersects(aabb);
+			batch.camera_visibility = IsVisible(camera_visibility, batch.instance_id);
+		}
+		shadow_renderer.SetBatchVisibility(batch_entities, std::span<Uint64 const>(batch_visibility).subspan(word_count), word_count);
+	}
+
+	//LODs are selected from the camera for all batches, shadow views draw the same LOD so casters match the surfaces the camera sees
+	//CullInstances.hlsl makes the same choice for the GPU driven path
+	void Renderer::SelectMeshLODs()
+	{
+		mesh_lod_stats = {};
+		Float const lod_error_scale = frame_cbuf_data.mesh_lod_error_scale;
+		Vector3 const camera_position = camera->Position();
+		Float const camera_near = camera->Near();
+
+		auto batch_view = reg.view<Batch>();
+		for (auto e : batch_view)
+		{
+			Batch& batch = batch_view.get<Batch>(e);
+			SubMeshGPU const& submesh = *batch.submesh;
+			batch.lod = 0;
+			if (lod_error_scale > 0.0f)
+			{
+				Matrix const& world = batch.world_transform;
+				Vector3 const axis_scale(Vector3(world._11, world._12, world._13).Length(), Vector3(world._21, world._22, world._23).Length(), Vector3(world._31, world._32, world._33).Length());
+				Float const max_scale = std::max(std::max(axis_scale.x, axis_scale.y), axis_scale.z);
+				Float const radius = (Vector3(submesh.bounding_box.Extents) * axis_scale).Length();
+				Float const distance = std::max(Vector3::Distance(camera_position, batch.bounding_box.Center) - radius, camera_near);
+				while (batch.lod + 1 < submesh.lod_count && submesh.lods[batch.lod + 1].error * max_scale * lod_error_scale <= distance) ++batch.lod;
+			}
+
+			if (!batch.camera_visibility) continue;
+			++mesh_lod_stats.batch_counts[batch.lod];
+			mesh_lod_stats.triangle_count += submesh.lods[batch.lod].indices_count / 3;
+			mesh_lod_stats.full_detail_triangle_count += submesh.indices_count / 3;
 		}
 	}
 
@@ -527,6 +854,7 @@ namespace adria
 		{
 			picking_data = picking_pass.GetPickingData();
 			update_picking_data = false;
+			PickMesh();
 		}
 		if(renderer_debug_view_pass.GetDebugView() == RendererDebugView::TriangleOverdraw)
 		{
@@ -608,12 +936,14 @@ namespace adria
 		{
 			path_tracer.GUI();
 		}
+		gbuffer_pass.GUI();
 		shadow_renderer.GUI();
 		ocean_renderer.GUI();
 		sky_pass.GUI();
 		rain_pass.GUI();
 		transparent_pass.GUI();
 		volumetric_fog_manager.GUI();
+		g_TextureManager.GUI();
 		QueueGUI([&]()
 			{
 				if (ImGui::TreeNode("Weather Settings"))
@@ -623,6 +953,7 @@ namespace adria
 						auto lights = reg.view<Light, Transform>();
 						Light* sun_light = nullptr;
 						Transform* sun_transform = nullptr;
+						entt::entity sun_entity = entt::null;
 						for (entt::entity light : lights)
 						{
 							Light& light_data = lights.get<Light>(light);
@@ -630,6 +961,7 @@ namespace adria
 							{
 								sun_light = &light_data;
 								sun_transform = &lights.get<Transform>(light);
+								sun_entity = light;
 								break;
 							}
 						}
@@ -653,6 +985,8 @@ namespace adria
 							sun_light->position = 1e3 * sun_light->direction;
 							sun_light->direction = -sun_light->direction;
 							sun_transform->current_transform = XMMatrixTranslationFromVector(sun_light->position);
+							reg.patch<Light>(sun_entity);
+							reg.patch<Transform>(sun_entity);
 						}
 						ImGui::TreePop();
 					}
@@ -662,6 +996,52 @@ namespace adria
 					ImGui::TreePop();
 				}
 			}, GUICommandGroup_Renderer);
+		QueueGUI([&]()
+			{
+				if (ImGui::TreeNode("Mesh LODs"))
+				{
+					for (Uint32 lod = 0; lod < MESH_MAX_LODS; ++lod)
+					{
+						ImGui::Text("LOD %u: %u batches", lod, mesh_lod_stats.batch_counts[lod]);
+					}
+					Float const triangle_ratio = mesh_lod_stats.full_detail_triangle_count ? (Float)mesh_lod_stats.triangle_count / mesh_lod_stats.full_detail_triangle_count : 1.0f;
+					ImGui::Text("Visible Triangles: %llu (%.1f%% of full detail)", mesh_lod_stats.triangle_count, triangle_ratio * 100.0f);
+					ImGui::TreePop();
+				}
+			}, GUICommandGroup_Renderer);
+		QueueGUI([&]()
+			{
+				if (ImGui::TreeNode("Render Graph"))
+				{
+					RGCompileCacheStats const& compile_cache_stats = rg_compile_cache.GetStats();
+					ImGui::Text("Compile Cache Hit Rate: %.1f%%", compile_cache_stats.GetHitRate() * 100.0f);
+					ImGui::Text("Compile Cache Hits/Misses: %llu/%llu", compile_cache_stats.hit_count, compile_cache_stats.miss_count);
+					ImGui::Text("Last Compile Time: %.1f us", compile_cache_stats.last_compile_time);
+					ImGui::Text("Average Full Compile Time: %.1f us", compile_cache_stats.average_full_compile_time);
+					ImGui::Text("Compile Time Saved: %.2f ms", compile_cache_stats.total_saved_compile_time / 1000.0f);
+					if (ImGui::Button("Clear Compile Cache")) rg_compile_cache.Clear();
+
+					ImGui::Text("Barriers Requested/Planned: %u/%u", rg_barrier_plan_stats.requested_barrier_count, rg_barrier_plan_stats.planned_barrier_count);
+					ImGui::Text("Barriers Removed: %u, Split: %u", rg_barrier_plan_stats.GetRemovedBarrierCount(), rg_barrier_plan_stats.split_barrier_count);
+
+					ImGui::Text("Allocator: %.1f KB used, %.1f KB capacity, %llu chunk(s)", rg_allocator.GetSize() / 1024.0f, rg_allocator.GetCapacity() / 1024.0f, rg_allocator.GetChunkCount());
+					ImGui::Text("Allocator High-Water Mark: %.1f KB", rg_allocator.GetHighWaterMark() / 1024.0f);
+
+					RGResourcePoolStats const& pool_stats = resource_pool.GetStats();
+					ImGui::Text("Pooled Textures/Buffers: %u/%u (%.2f MB)", pool_stats.pooled_texture_count, pool_stats.pooled_buffer_count, pool_stats.pooled_memory / (1024.0f * 1024.0f));
+					ImGui::Text("Pool Texture Hits/Misses: %llu/%llu", pool_stats.texture_hits, pool_stats.texture_misses);
+					ImGui::Text("Pool Buffer Hits/Misses: %llu/%llu", pool_stats.buffer_hits, pool_stats.buffer_misses);
+					ImGui::Text("Pool Evictions: %llu", pool_stats.evictions);
+
+					RGTransientMemoryStats const& transient_memory_stats = resource_pool.GetTransientMemoryStats();
+					ImGui::Text("Placed Transient Textures: %u (%u aliased)", transient_memory_stats.placed_texture_count, transient_memory_stats.aliased_texture_count);
+					ImGui::Text("Transient Memory Without Aliasing: %.2f MB", transient_memory_stats.unaliased_size / (1024.0f * 1024.0f));
+					ImGui::Text("Transient Memory With Aliasing: %.2f MB", transient_memory_stats.aliased_size / (1024.0f * 1024.0f));
+					ImGui::Text("Peak Live Transient Memory: %.2f MB", transient_memory_stats.peak_live_size / (1024.0f * 1024.0f));
+					ImGui::Text("Transient Heap Size: %.2f MB", transient_memory_stats.heap_size / (1024.0f * 1024.0f));
+					ImGui::TreePop();
+				}
+			}, GUICommandGroup_Renderer);
 		renderer_debug_view_pass.GUI();
 		postprocessor.GUI();
 	}
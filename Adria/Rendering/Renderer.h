@@ -1,6 +1,8 @@
 #pragma once
 #include "ViewportData.h"
 #include "ShaderStructs.h"
+#include "Math/BoundingBoxCulling.h"
+#include "Math/BoundingVolumeHierarchy.h"
 #include "PostProcessor.h"
 #include "GBufferPass.h"
 #include "GPUDrivenGBufferPass.h"
@@ -27,6 +29,8 @@
 #include "Graphics/GfxShaderCompiler.h"
 #include "Graphics/GfxConstantBuffer.h"
 #include "RenderGraph/RenderGraphResourcePool.h"
+#include "RenderGraph/RenderGraphCompileCache.h"
+#include "RenderGraph/RenderGraph.h"
 
 namespace adria
 {
@@ -63,6 +67,7 @@ namespace adria
 		void OnLightChanged();
 
 		PickingData const& GetPickingData() const { return picking_data; }
+		entt::entity GetPickedMesh() const { return picked_mesh; }
 		Vector2u GetDisplayResolution() const { return Vector2u(display_width, display_height); }
 
 		void SetLightingPath(LightingPath path);
@@ -75,6 +80,10 @@ namespace adria
 		entt::registry& reg;
 		GfxDevice* gfx;
 		RGResourcePool resource_pool;
+		RGAllocator rg_allocator;
+		RGCompileCache rg_compile_cache;
+		RenderGraph render_graph;
+		RGBarrierPlanStats rg_barrier_plan_stats;
 
 		Camera const* camera;
 		Vector2 camera_jitter;
@@ -107,6 +116,43 @@ namespace adria
 			GfxDescriptor				buffer_srv_gpu;
 		};
 		std::array<SceneBuffer, SceneBuffer_Count> scene_buffers;
+		std::vector<GfxDescriptor> mesh_buffer_srvs;
+		GfxDescriptor mesh_buffers_srv_gpu;
+
+		//cpu copies of the scene buffers, Light, Transform and Mesh patches only rewrite and upload the entries they touch
+		struct SceneMeshRange
+		{
+			Uint32 buffer_idx = 0;
+			Uint32 instance_offset = 0;
+			Uint32 instance_count = 0;
+			Uint32 mesh_offset = 0;
+			Uint32 mesh_count = 0;
+			Uint32 material_offset = 0;
+			Uint32 material_count = 0;
+		};
+		std::unordered_map<entt::entity, SceneMeshRange> scene_mesh_ranges;
+		std::vector<LightGPU> light_data;
+		std::vector<MeshGPU> mesh_data;
+		std::vector<InstanceGPU> instance_data;
+		std::vector<MaterialGPU> material_data;
+		std::unordered_set<entt::entity> dirty_lights;
+		std::unordered_set<entt::entity> dirty_meshes;
+		std::vector<Uint32> dirty_indices;
+		Matrix scene_light_transform;
+		Bool scene_lights_dirty = true;
+		Bool scene_meshes_dirty = true;
+		BoundingBoxSoA batch_bounds;
+		BoundingVolumeHierarchy batch_bvh;
+		std::vector<BoundingBox> prev_batch_boxes;
+		std::vector<entt::entity> batch_entities;
+		std::vector<CullingView> culling_views;
+		std::vector<Uint64> batch_visibility;
+		struct MeshLODStats
+		{
+			std::array<Uint32, MESH_MAX_LODS> batch_counts;
+			Uint64 triangle_count;
+			Uint64 full_detail_triangle_count;
+		} mesh_lod_stats{};
 
 		//passes
 		GBufferPass  gbuffer_pass;
@@ -140,6 +186,7 @@ namespace adria
 		//picking
 		Bool update_picking_data = false;
 		PickingData picking_data;
+		entt::entity picked_mesh = entt::null;
 
 		LightingPath		lighting_path = LightingPath::Deferred;
 
@@ -173,8 +220,20 @@ namespace adria
 
 		void GUI();
 		void UpdateSceneBuffers();
+		void UpdateLightBuffer();
+		void UpdateMeshBuffers();
+		void UpdateDirtyMeshes();
+		void WriteSceneMesh(entt::entity mesh_entity, SceneMeshRange const& range);
+		void UpdateBufferRanges(GfxBuffer* buffer, void const* data, Uint64 stride);
+		void OnSceneMeshChanged(entt::registry&, entt::entity);
+		void OnSceneMeshUpdated(entt::registry&, entt::entity);
+		void OnSceneLightChanged(entt::registry&, entt::entity);
+		void OnSceneLightUpdated(entt::registry&, entt::entity);
+		void OnSceneTransformChanged(entt::registry&, entt::entity);
 		void UpdateFrameConstants(Float dt);
 		void CameraFrustumCulling();
+		void SelectMeshLODs();
+		void PickMesh();
 
 		void RenderImpl(RenderGraph& rg);
 		void Render_Deferred(RenderGraph& rg);
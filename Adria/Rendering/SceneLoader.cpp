@@ -3,23 +3,113 @@
 #define CGLTF_IMPLEMENTATION
 #include "tiny_obj_loader.h"
 #include "cgltf.h"
-#include "meshoptimizer.h"
+#include <filesystem>
 #include "SceneLoader.h"
 #include "Components.h"
+#include "CookedMesh.h"
+#include "VertexQuantization.h"
+#include "GLTFAccessorReader.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxLinearDynamicAllocator.h"
 #include "Math/BoundingVolumeUtil.h"
+#include "Math/Packing.h"
 #include "Core/Paths.h"
+#include "Core/ConsoleManager.h"
 #include "Utilities/StringUtil.h"
 #include "Utilities/FilesUtil.h"
+#include "Utilities/HashUtil.h"
 #include "Utilities/Heightmap.h"
+#include "Utilities/ThreadPool.h"
+#include "Utilities/Timer.h"
 
 
 using namespace DirectX;
+namespace fs = std::filesystem;
 
 
 namespace adria
 {
+	static TAutoConsoleVariable<Bool> CookMeshes("r.Meshes.Cook", true, "0: glTF geometry is imported from the source every time. 1: Imported glTF geometry is cooked next to the source and memory mapped on later loads");
+	static TAutoConsoleVariable<Int>  MeshLODCount("r.Meshes.LODCount", MESH_MAX_LODS, "Number of LODs, including the full detail one, generated for each imported submesh");
+	static TAutoConsoleVariable<Bool> QuantizeVertices("r.Meshes.QuantizeVertices", false, "0: Imported vertices are stored in full precision. 1: Imported vertices are quantized to 16 bits per component and small submeshes use 16 bit indices");
+
+	namespace
+	{
+		Uint32 GetMeshLODCount()
+		{
+			return (Uint32)std::clamp(MeshLODCount.Get(), 1, (Int)MESH_MAX_LODS);
+		}
+
+		//the .bin and image buffers of big models are hundreds of megabytes, they are identified by size and write time instead of their contents
+		Uint64 GetGLTFSourceHash(ModelParameters const& params, cgltf_data const* gltf_data, Bool supports_meshlets)
+		{
+			HashState hash;
+			std::ifstream is(params.model_path, std::ios::binary | std::ios::ate);
+			if (!is) return 0;
+			std::string content(static_cast<Uint64>(is.tellg()), '\0');
+			is.seekg(0);
+			is.read(content.data(), content.size());
+			hash.Combine(crc64(content.c_str(), content.size()));
+
+			fs::path const model_directory = fs::path(params.model_path).parent_path();
+			for (Uint64 i = 0; i < gltf_data->buffers_count; ++i)
+			{
+				Char const* uri = gltf_data->buffers[i].uri;
+				if (!uri || strncmp(uri, "data:", 5) == 0) continue;
+
+				std::string buffer_uri(uri);
+				buffer_uri.resize(cgltf_decode_uri(buffer_uri.data()));
+				std::string const buffer_path = (model_directory / buffer_uri).string();
+
+				std::error_code error;
+				Uint64 const buffer_size = fs::file_size(buffer_path, error);
+				if (error) return 0;
+				fs::file_time_type const buffer_write_time = fs::last_write_time(buffer_path, error);
+				if (error) return 0;
+				hash.Combine(buffer_size);
+				hash.Combine((Uint64)buffer_write_time.time_since_epoch().count());
+			}
+
+			hash.Combine(params.triangle_ccw);
+			hash.Combine(supports_meshlets);
+			hash.Combine(MESHLET_MAX_VERTICES);
+			hash.Combine(MESHLET_MAX_TRIANGLES);
+			hash.Combine(GetMeshLODCount());
+			hash.Combine(MeshLODMinTriangleCount);
+			hash.Combine(MeshLODMaxRelativeError);
+			hash.Combine(QuantizeVertices.Get());
+			return hash;
+		}
+
+		Uint64 GetGeometrySize(MeshData const& mesh_data)
+		{
+			SubMeshStrides const strides = GetSubMeshStrides(mesh_data.quantized, mesh_data.index_format);
+			Uint64 geometry_size = 0;
+			geometry_size += Align(mesh_data.indices.size() * strides.index, 16);
+			geometry_size += Align(mesh_data.positions_stream.size() * strides.position, 16);
+			geometry_size += Align(mesh_data.uvs_stream.size() * strides.uv, 16);
+			geometry_size += Align(mesh_data.normals_stream.size() * strides.normal, 16);
+			geometry_size += Align(mesh_data.tangents_stream.size() * strides.tangent, 16);
+			geometry_size += Align(mesh_data.meshlets.size() * sizeof(Meshlet), 16);
+			geometry_size += Align(mesh_data.meshlet_vertices.size() * sizeof(Uint32), 16);
+			geometry_size += Align(mesh_data.meshlet_triangles.size() * sizeof(MeshletTriangle), 16);
+			return geometry_size;
+		}
+
+		//positions are stored relative to the bounding box so the 16 bit range covers the submesh, see LoadMeshPosition in Scene.hlsli
+		void WriteQuantizedVertices(MeshData const& mesh_data, SubMeshGPU const& submesh, Uint8* geometry)
+		{
+			QuantizedVertexStreams const quantized_streams
+			{
+				.positions = reinterpret_cast<Int16*>(geometry + submesh.positions_offset),
+				.uvs = reinterpret_cast<Uint32*>(geometry + submesh.uvs_offset),
+				.normals = reinterpret_cast<Int16*>(geometry + submesh.normals_offset),
+				.tangents = reinterpret_cast<Int16*>(geometry + submesh.tangents_offset)
+			};
+			QuantizeVertices(mesh_data.bounding_box, mesh_data.positions_stream, mesh_data.uvs_stream, mesh_data.normals_stream, mesh_data.tangents_stream, quantized_streams);
+		}
+	}
+
 	std::vector<entt::entity> SceneLoader::LoadGrid(GridParameters const& params)
 	{
 		if (params.heightmap)
@@ -399,12 +489,6 @@ namespace adria
 			ADRIA_LOG(WARNING, "GLTF - Failed to load '%s'", params.model_path.c_str());
 			return entt::null;
 		}
-		result = cgltf_load_buffers(&options, gltf_data, params.model_path.c_str());
-		if (result != cgltf_result_success)
-		{
-			ADRIA_LOG(WARNING, "GLTF - Failed to load buffers '%s'", params.model_path.c_str());
-			return entt::null;
-		}
 
 		std::string model_name = GetFilename(params.model_path);
 		entt::entity mesh_entity = reg.create();
@@ -456,7 +540,7 @@ namespace adria
 				if (texture)
 				{
 					std::string texbase = params.textures_path + GetImageURI(texture);
-					return g_TextureManager.LoadTexture(texbase, srgb);
+					return g_TextureManager.LoadTextureAsync(texbase, srgb, default_handle);
 				}
 				return default_handle;
 			};
@@ -513,7 +597,7 @@ namespace adria
 			if (cgltf_texture* texture = gltf_material.normal_texture.texture)
 			{
 				std::string texnormal = params.textures_path + GetImageURI(texture);
-				material.normal_texture = g_TextureManager.LoadTexture(texnormal, false);
+				material.normal_texture = g_TextureManager.LoadTextureAsync(texnormal, false, DEFAULT_NORMAL_TEXTURE_HANDLE);
 			}
 			else
 			{
@@ -523,7 +607,7 @@ namespace adria
 			if (cgltf_texture* texture = gltf_material.emissive_texture.texture)
 			{
 				std::string texemissive = params.textures_path + GetImageURI(texture);
-				material.emissive_texture = g_TextureManager.LoadTexture(texemissive, true);
+				material.emissive_texture = g_TextureManager.LoadTextureAsync(texemissive, true, DEFAULT_BLACK_TEXTURE_HANDLE);
 			}
 			else
 			{
@@ -532,127 +616,124 @@ namespace adria
 		}
 
 		std::unordered_map<cgltf_mesh const*, std::vector<Int32>> mesh_primitives_map; //mesh -> vector of primitive indices
+		std::vector<cgltf_primitive const*> gltf_primitives;
 		Int32 primitive_count = 0;
-
-		std::vector<MeshData> mesh_datas{};
 		for (Uint32 i = 0; i < gltf_data->meshes_count; ++i)
 		{
 			cgltf_mesh const& gltf_mesh = gltf_data->meshes[i];
 			std::vector<Int32>& primitives = mesh_primitives_map[&gltf_mesh];
 			for (Uint32 j = 0; j < gltf_mesh.primitives_count; ++j)
 			{
-				auto const& gltf_primitive = gltf_mesh.primitives[j];
-				ADRIA_ASSERT(gltf_primitive.indices->count >= 0);
-
-				MeshData& mesh_data = mesh_datas.emplace_back();
-				mesh_data.material_index = (Int32)(gltf_primitive.material - gltf_data->materials);
-				mesh_data.indices.reserve(gltf_primitive.indices->count);
-				
-				Uint32 triangle_cw[] = { 0, 1, 2 };
-				Uint32 triangle_ccw[] = { 0, 2, 1 };
-				Uint32* order = params.triangle_ccw ? triangle_ccw : triangle_cw;
-				for (Uint64 i = 0; i < gltf_primitive.indices->count; i += 3)
-				{
-					mesh_data.indices.push_back((Uint32)cgltf_accessor_read_index(gltf_primitive.indices, i + order[0]));
-					mesh_data.indices.push_back((Uint32)cgltf_accessor_read_index(gltf_primitive.indices, i + order[1]));
-					mesh_data.indices.push_back((Uint32)cgltf_accessor_read_index(gltf_primitive.indices, i + order[2]));
-				}
-
-				switch (gltf_primitive.type)
-				{
-				case cgltf_primitive_type_points:
-					mesh_data.topology = GfxPrimitiveTopology::PointList;
-					break;
-				case cgltf_primitive_type_lines:
-					mesh_data.topology = GfxPrimitiveTopology::LineList;
-					break;
-				case cgltf_primitive_type_line_strip:
-					mesh_data.topology = GfxPrimitiveTopology::LineStrip;
-					break;
-				case cgltf_primitive_type_triangles:
-					mesh_data.topology = GfxPrimitiveTopology::TriangleList;
-					break;
-				case cgltf_primitive_type_triangle_strip:
-					mesh_data.topology = GfxPrimitiveTopology::TriangleStrip;
-					break;
-				default:
-					ADRIA_ASSERT(false);
-				}
-
-				for (Uint32 k = 0; k < gltf_primitive.attributes_count; ++k)
-				{
-					cgltf_attribute const& gltf_attribute = gltf_primitive.attributes[k];
-					std::string const& attr_name = gltf_attribute.name;
-
-					auto ReadAttributeData = [&]<typename T>(std::vector<T>& stream, const Char* stream_name)
-					{
-						if (!attr_name.compare(stream_name))
-						{
-							stream.resize(gltf_attribute.data->count);
-							for (Uint64 i = 0; i < gltf_attribute.data->count; ++i)
-							{
-								cgltf_accessor_read_float(gltf_attribute.data, i, &stream[i].x, sizeof(T) / sizeof(Float));
-							}
-						}
-					};
-					ReadAttributeData(mesh_data.positions_stream, "POSITION");
-					ReadAttributeData(mesh_data.normals_stream, "NORMAL");
-					ReadAttributeData(mesh_data.tangents_stream, "TANGENT");
-					ReadAttributeData(mesh_data.uvs_stream, "TEXCOORD_0");
-				}
+				gltf_primitives.push_back(&gltf_mesh.primitives[j]);
 				primitives.push_back(primitive_count++);
 			}
 		}
 
-		Uint64 const total_buffer_size = CalculateTotalBufferSize(mesh_datas);
-		GfxDynamicAllocation staging_buffer = gfx->GetDynamicAllocator()->Allocate(total_buffer_size, 16);
-		Uint32 current_offset = 0;
-		auto CopyData = [&staging_buffer, &current_offset]<typename T>(std::vector<T> const& _data)
+		Timer geometry_timer;
+		Bool const supports_meshlets = gfx->GetCapabilities().SupportsMeshShaders();
+		std::string const cooked_path = GetParentPath(params.model_path) + "/" + GetFilenameWithoutExtension(params.model_path) + ".cmesh";
+		Uint64 const source_hash = GetGLTFSourceHash(params, gltf_data, supports_meshlets);
+
+		//geometry is decoded or written straight into the upload memory the geometry buffer is initialized from
+		GfxDynamicAllocation staging_buffer{};
+		Uint64 geometry_size = 0;
+		Bool geometry_loaded = false;
+		CookedMesh cooked_mesh;
+		if (CookMeshes.Get() && source_hash != 0 && cooked_mesh.Open(cooked_path, source_hash) && cooked_mesh.GetSubMeshes().size() == (Uint64)primitive_count)
 		{
-			Uint64 current_copy_size = _data.size() * sizeof(T);
-			staging_buffer.Update(_data.data(), current_copy_size, current_offset);
-			current_offset += (Uint32)Align(current_copy_size, 16);
-		};
+			geometry_size = cooked_mesh.GetGeometrySize();
+			staging_buffer = gfx->GetDynamicAllocator()->Allocate(geometry_size, 16);
+			geometry_loaded = cooked_mesh.DecodeGeometry(static_cast<Uint8*>(staging_buffer.cpu_address));
+			if (geometry_loaded)
+			{
+				mesh.submeshes.assign(cooked_mesh.GetSubMeshes().begin(), cooked_mesh.GetSubMeshes().end());
+				ADRIA_LOG(INFO, "GLTF Model %s geometry (%.2f MB) loaded from %s in %.3f s", params.model_path.c_str(), geometry_size / (1024.0f * 1024.0f), cooked_path.c_str(), geometry_timer.ElapsedInSeconds());
+			}
+			else
+			{
+				ADRIA_LOG(WARNING, "Could not decode cooked mesh %s, importing the source", cooked_path.c_str());
+			}
+		}
+		cooked_mesh.Close();
 
-		mesh.submeshes.reserve(mesh_datas.size());
-		for (Uint64 i = 0; i < mesh_datas.size(); ++i)
+		if (!geometry_loaded)
 		{
-			MeshData const& mesh_data = mesh_datas[i];
-			SubMeshGPU& submesh = mesh.submeshes.emplace_back();
-
-			submesh.indices_offset = current_offset;
-			submesh.indices_count = (Uint32)mesh_data.indices.size();
-			CopyData(mesh_data.indices);
-
-			submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
-			submesh.positions_offset = current_offset;
-			CopyData(mesh_data.positions_stream);
-
-			submesh.uvs_offset = current_offset;
-			CopyData(mesh_data.uvs_stream);
-
-			submesh.normals_offset = current_offset;
-			CopyData(mesh_data.normals_stream);
-
-			submesh.tangents_offset = current_offset;
-			CopyData(mesh_data.tangents_stream);
+			result = cgltf_load_buffers(&options, gltf_data, params.model_path.c_str());
+			if (result != cgltf_result_success)
+			{
+				ADRIA_LOG(WARNING, "GLTF - Failed to load buffers '%s'", params.model_path.c_str());
+				cgltf_free(gltf_data);
+				reg.destroy(mesh_entity);
+				return entt::null;
+			}
 
-			submesh.meshlet_offset = current_offset;
-			CopyData(mesh_data.meshlets);
+			std::vector<MeshData> mesh_datas(primitive_count);
+			ParallelFor(mesh_datas.size(), [&](Uint64 primitive)
+				{
+					cgltf_primitive const& gltf_primitive = *gltf_primitives[primitive];
+					ADRIA_ASSERT(gltf_primitive.indices->count >= 0);
 
-			submesh.meshlet_vertices_offset = current_offset;
-			CopyData(mesh_data.meshlet_vertices);
+					MeshData& mesh_data = mesh_datas[primitive];
+					mesh_data.material_index = (Int32)(gltf_primitive.material - gltf_data->materials);
+					ReadGLTFIndices(gltf_primitive.indices, params.triangle_ccw, mesh_data.indices);
 
-			submesh.meshlet_triangles_offset = current_offset;
-			CopyData(mesh_data.meshlet_triangles);
+					switch (gltf_primitive.type)
+					{
+					case cgltf_primitive_type_points:
+						mesh_data.topology = GfxPrimitiveTopology::PointList;
+						break;
+					case cgltf_primitive_type_lines:
+						mesh_data.topology = GfxPrimitiveTopology::LineList;
+						break;
+					case cgltf_primitive_type_line_strip:
+						mesh_data.topology = GfxPrimitiveTopology::LineStrip;
+						break;
+					case cgltf_primitive_type_triangles:
+						mesh_data.topology = GfxPrimitiveTopology::TriangleList;
+						break;
+					case cgltf_primitive_type_triangle_strip:
+						mesh_data.topology = GfxPrimitiveTopology::TriangleStrip;
+						break;
+					default:
+						ADRIA_ASSERT(false);
+					}
 
-			submesh.meshlet_count = (Uint32)mesh_data.meshlets.size();
+					for (Uint32 k = 0; k < gltf_primitive.attributes_count; ++k)
+					{
+						cgltf_attribute const& gltf_attribute = gltf_primitive.attributes[k];
+						std::string const& attr_name = gltf_attribute.name;
 
-			submesh.bounding_box = mesh_data.bounding_box;
-			submesh.topology = mesh_data.topology;
-			submesh.material_index = mesh_data.material_index;
+						auto ReadAttributeData = [&]<typename T>(std::vector<T>& stream, const Char* stream_name)
+						{
+							if (!attr_name.compare(stream_name))
+							{
+								ReadGLTFAttribute(gltf_attribute.data, stream);
+							}
+						};
+						ReadAttributeData(mesh_data.positions_stream, "POSITION");
+						ReadAttributeData(mesh_data.normals_stream, "NORMAL");
+						ReadAttributeData(mesh_data.tangents_stream, "TANGENT");
+						ReadAttributeData(mesh_data.uvs_stream, "TEXCOORD_0");
+					}
+				});
+			Float const read_time = geometry_timer.MarkInSeconds();
+
+			geometry_size = CalculateTotalBufferSize(mesh_datas);
+			Float const process_time = geometry_timer.MarkInSeconds();
+
+			staging_buffer = gfx->GetDynamicAllocator()->Allocate(geometry_size, 16);
+			Uint8* geometry = static_cast<Uint8*>(staging_buffer.cpu_address);
+			WriteGeometryBuffer(mesh_datas, mesh.submeshes, geometry);
+			Float const write_time = geometry_timer.MarkInSeconds();
+			ADRIA_LOG(INFO, "GLTF Model %s geometry imported: %d primitives (%.2f MB) read in %.3f s, processed in %.3f s, written in %.3f s",
+				params.model_path.c_str(), primitive_count, geometry_size / (1024.0f * 1024.0f), read_time, process_time, write_time);
+			//cooking reads the upload memory back once, only on the first import of a model
+			if (CookMeshes.Get() && source_hash != 0 && CookedMesh::Save(cooked_path, source_hash, mesh.submeshes, std::span<Uint8 const>(geometry, geometry_size)))
+			{
+				ADRIA_LOG(INFO, "GLTF Model %s geometry cooked to %s in %.3f s", params.model_path.c_str(), cooked_path.c_str(), geometry_timer.MarkInSeconds());
+			}
 		}
-		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(staging_buffer.buffer, total_buffer_size, staging_buffer.offset);
+		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(staging_buffer.buffer, geometry_size, staging_buffer.offset);
 
 		for (Uint64 i = 0; i < gltf_data->nodes_count; ++i)
 		{
@@ -773,114 +854,69 @@ namespace adria
 			if (!obj_material.diffuse_texname.empty())
 			{
 				std::string diffuse_texture = params.textures_path + obj_material.diffuse_texname;
-				material.albedo_texture = g_TextureManager.LoadTexture(diffuse_texture, true);
+				material.albedo_texture = g_TextureManager.LoadTextureAsync(diffuse_texture, true, DEFAULT_WHITE_TEXTURE_HANDLE);
 			}
 			if (!obj_material.normal_texname.empty())
 			{
 				std::string normal_texture = params.textures_path + obj_material.normal_texname;
-				material.normal_texture = g_TextureManager.LoadTexture(normal_texture, false);
+				material.normal_texture = g_TextureManager.LoadTextureAsync(normal_texture, false, DEFAULT_NORMAL_TEXTURE_HANDLE);
 			}
 			if (!obj_material.emissive_texname.empty())
 			{
 				std::string emissive_texture = params.textures_path + obj_material.emissive_texname;
-				material.emissive_texture = g_TextureManager.LoadTexture(emissive_texture, false);
+				material.emissive_texture = g_TextureManager.LoadTextureAsync(emissive_texture, false, DEFAULT_BLACK_TEXTURE_HANDLE);
 			}
 			mesh.materials.push_back(material);
 		}
 
-		std::vector<MeshData> mesh_datas{};
-		mesh.submeshes.reserve(shapes.size());
-		for (Uint64 s = 0; s < shapes.size(); s++)
-		{
-			tinyobj::mesh_t const& obj_mesh = shapes[s].mesh;
-			MeshData& mesh_data = mesh_datas.emplace_back();
-			mesh_data.material_index = obj_mesh.material_ids[0];
-			
-			Uint32 index_offset = 0;
-			for (Uint64 f = 0; f < obj_mesh.num_face_vertices.size(); ++f)
+		std::vector<MeshData> mesh_datas(shapes.size());
+		ParallelFor(shapes.size(), [&](Uint64 s)
 			{
-				ADRIA_ASSERT(obj_mesh.num_face_vertices[f] == 3);
-				for (Uint64 v = 0; v < 3; v++)
+				tinyobj::mesh_t const& obj_mesh = shapes[s].mesh;
+				MeshData& mesh_data = mesh_datas[s];
+				mesh_data.material_index = obj_mesh.material_ids[0];
+			
+				Uint32 index_offset = 0;
+				for (Uint64 f = 0; f < obj_mesh.num_face_vertices.size(); ++f)
 				{
-					tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
-					tinyobj::real_t vx = attrib.vertices[3 * Uint64(idx.vertex_index) + 0];
-					tinyobj::real_t vy = attrib.vertices[3 * Uint64(idx.vertex_index) + 1];
-					tinyobj::real_t vz = attrib.vertices[3 * Uint64(idx.vertex_index) + 2] * -1.0f;
-
-					mesh_data.positions_stream.emplace_back(vx, vy, vz);
-					if (idx.normal_index >= 0)
+					ADRIA_ASSERT(obj_mesh.num_face_vertices[f] == 3);
+					for (Uint64 v = 0; v < 3; v++)
 					{
-						tinyobj::real_t nx = attrib.normals[3 * Uint64(idx.normal_index) + 0];
-						tinyobj::real_t ny = attrib.normals[3 * Uint64(idx.normal_index) + 1];
-						tinyobj::real_t nz = attrib.normals[3 * Uint64(idx.normal_index) + 2];
-						mesh_data.normals_stream.emplace_back(nx, ny, nz);
-					}
+						tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
+						tinyobj::real_t vx = attrib.vertices[3 * Uint64(idx.vertex_index) + 0];
+						tinyobj::real_t vy = attrib.vertices[3 * Uint64(idx.vertex_index) + 1];
+						tinyobj::real_t vz = attrib.vertices[3 * Uint64(idx.vertex_index) + 2] * -1.0f;
 
-					if (idx.texcoord_index >= 0)
-					{
-						tinyobj::real_t tx = attrib.texcoords[2 * Uint64(idx.texcoord_index) + 0];
-						tinyobj::real_t ty = attrib.texcoords[2 * Uint64(idx.texcoord_index) + 1];
-						mesh_data.uvs_stream.emplace_back(tx, ty);
+						mesh_data.positions_stream.emplace_back(vx, vy, vz);
+						if (idx.normal_index >= 0)
+						{
+							tinyobj::real_t nx = attrib.normals[3 * Uint64(idx.normal_index) + 0];
+							tinyobj::real_t ny = attrib.normals[3 * Uint64(idx.normal_index) + 1];
+							tinyobj::real_t nz = attrib.normals[3 * Uint64(idx.normal_index) + 2];
+							mesh_data.normals_stream.emplace_back(nx, ny, nz);
+						}
+
+						if (idx.texcoord_index >= 0)
+						{
+							tinyobj::real_t tx = attrib.texcoords[2 * Uint64(idx.texcoord_index) + 0];
+							tinyobj::real_t ty = attrib.texcoords[2 * Uint64(idx.texcoord_index) + 1];
+							mesh_data.uvs_stream.emplace_back(tx, ty);
+						}
 					}
+					mesh_data.indices.push_back(index_offset); 
+					mesh_data.indices.push_back(index_offset + 1);
+					mesh_data.indices.push_back(index_offset + 2);
+					index_offset += 3;
 				}
-				mesh_data.indices.push_back(index_offset); 
-				mesh_data.indices.push_back(index_offset + 1);
-				mesh_data.indices.push_back(index_offset + 2);
-				index_offset += 3;
-			}
-		}
+			});
 
-		Bool const supports_meshlets = gfx->GetCapabilities().SupportsMeshShaders();
 		Uint64 const total_buffer_size = CalculateTotalBufferSize(mesh_datas);
 		GfxDynamicAllocation staging_buffer = gfx->GetDynamicAllocator()->Allocate(total_buffer_size, 16);
+		WriteGeometryBuffer(mesh_datas, mesh.submeshes, static_cast<Uint8*>(staging_buffer.cpu_address));
 
-		Uint32 current_offset = 0;
-		auto CopyData = [&staging_buffer, &current_offset]<typename T>(std::vector<T> const& _data)
-		{
-			Uint64 current_copy_size = _data.size() * sizeof(T);
-			staging_buffer.Update(_data.data(), current_copy_size, current_offset);
-			current_offset += (Uint32)Align(current_copy_size, 16);
-		};
-
-		mesh.submeshes.reserve(mesh_datas.size());
 		mesh.instances.reserve(mesh_datas.size());
 		for (Uint32 i = 0; i < mesh_datas.size(); ++i)
 		{
-			MeshData const& mesh_data = mesh_datas[i];
-			SubMeshGPU& submesh = mesh.submeshes.emplace_back();
-
-			submesh.indices_offset = current_offset;
-			submesh.indices_count = (Uint32)mesh_data.indices.size();
-			CopyData(mesh_data.indices);
-
-			submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
-			submesh.positions_offset = current_offset;
-			CopyData(mesh_data.positions_stream);
-
-			submesh.uvs_offset = current_offset;
-			CopyData(mesh_data.uvs_stream);
-
-			submesh.normals_offset = current_offset;
-			CopyData(mesh_data.normals_stream);
-
-			submesh.tangents_offset = current_offset;
-			CopyData(mesh_data.tangents_stream);
-
-			submesh.meshlet_offset = current_offset;
-			CopyData(mesh_data.meshlets);
-
-			submesh.meshlet_vertices_offset = current_offset;
-			CopyData(mesh_data.meshlet_vertices);
-
-			submesh.meshlet_triangles_offset = current_offset;
-			CopyData(mesh_data.meshlet_triangles);
-
-			submesh.meshlet_count = (Uint32)mesh_data.meshlets.size();
-
-			submesh.bounding_box = mesh_data.bounding_box;
-			submesh.topology = mesh_data.topology;
-			submesh.material_index = mesh_data.material_index;
-
 			mesh.instances.emplace_back(mesh_entity, i, Matrix::Identity);
 		}
 		mesh.geometry_buffer_handle = g_GeometryBufferCache.CreateAndInitializeGeometryBuffer(staging_buffer.buffer, total_buffer_size, staging_buffer.offset);
@@ -893,101 +929,113 @@ namespace adria
 		return mesh_entity;
 	}
 
-	Uint64 SceneLoader::CalculateTotalBufferSize(std::vector<MeshData>& mesh_datas)
+	void SceneLoader::WriteGeometryBuffer(std::vector<MeshData> const& mesh_datas, std::vector<SubMeshGPU>& submeshes, Uint8* geometry)
 	{
-		Bool const supports_meshlets = gfx->GetCapabilities().SupportsMeshShaders();
-		Uint64 total_buffer_size = 0;
-		for (auto& mesh_data : mesh_datas)
-		{
-			std::vector<Uint32> const& indices = mesh_data.indices;
-			Uint64 vertex_count = mesh_data.positions_stream.size();
-
-			Bool has_tangents = !mesh_data.tangents_stream.empty();
-			if (mesh_data.normals_stream.size() != vertex_count) mesh_data.normals_stream.resize(vertex_count);
-			if (mesh_data.uvs_stream.size() != vertex_count) mesh_data.uvs_stream.resize(vertex_count);
-			if (mesh_data.tangents_stream.size() != vertex_count) mesh_data.tangents_stream.resize(vertex_count);
-
-			if (!has_tangents)
-			{
-				ComputeTangentFrame(mesh_data.indices.data(), mesh_data.indices.size(), mesh_data.positions_stream.data(),
-					mesh_data.normals_stream.data(), mesh_data.uvs_stream.data(), vertex_count, mesh_data.tangents_stream.data());
-			}
+		Uint64 const first_submesh = submeshes.size();
+		submeshes.resize(first_submesh + mesh_datas.size());
 
-			total_buffer_size += Align(mesh_data.indices.size() * sizeof(Uint32), 16);
-			total_buffer_size += Align(mesh_data.positions_stream.size() * sizeof(Vector3), 16);
-			total_buffer_size += Align(mesh_data.uvs_stream.size() * sizeof(Vector2), 16);
-			total_buffer_size += Align(mesh_data.normals_stream.size() * sizeof(Vector3), 16);
-			total_buffer_size += Align(mesh_data.tangents_stream.size() * sizeof(Vector4), 16);
+		Uint32 current_offset = 0;
+		auto AddStream = [&current_offset](Uint64 count, Uint64 stride)
+		{
+			Uint32 const stream_offset = current_offset;
+			current_offset += (Uint32)Align(count * stride, 16);
+			return stream_offset;
+		};
+		for (Uint64 i = 0; i < mesh_datas.size(); ++i)
+		{
+			MeshData const& mesh_data = mesh_datas[i];
+			SubMeshGPU& submesh = submeshes[first_submesh + i];
+			SubMeshStrides const strides = GetSubMeshStrides(mesh_data.quantized, mesh_data.index_format);
+			submesh.quantized = mesh_data.quantized;
+			submesh.index_format = mesh_data.index_format;
 
-			mesh_data.bounding_box = AABBFromPositions(mesh_data.positions_stream);
+			submesh.indices_offset = AddStream(mesh_data.indices.size(), strides.index);
+			submesh.indices_count = mesh_data.lods[0].index_count;
 
-			if (!supports_meshlets)
+			submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
+			submesh.positions_offset = AddStream(mesh_data.positions_stream.size(), strides.position);
+			submesh.uvs_offset = AddStream(mesh_data.uvs_stream.size(), strides.uv);
+			submesh.normals_offset = AddStream(mesh_data.normals_stream.size(), strides.normal);
+			submesh.tangents_offset = AddStream(mesh_data.tangents_stream.size(), strides.tangent);
+
+			submesh.meshlet_offset = AddStream(mesh_data.meshlets.size(), sizeof(Meshlet));
+			submesh.meshlet_vertices_offset = AddStream(mesh_data.meshlet_vertices.size(), sizeof(Uint32));
+			submesh.meshlet_triangles_offset = AddStream(mesh_data.meshlet_triangles.size(), sizeof(MeshletTriangle));
+			submesh.meshlet_count = mesh_data.lods[0].meshlet_count;
+			submesh.meshlet_vertices_count = (Uint32)mesh_data.meshlet_vertices.size();
+			submesh.meshlet_triangles_count = (Uint32)mesh_data.meshlet_triangles.size();
+
+			submesh.lod_count = (Uint32)mesh_data.lods.size();
+			for (Uint32 lod_index = 0; lod_index < submesh.lod_count; ++lod_index)
 			{
-				continue;
+				MeshLODData const& lod_data = mesh_data.lods[lod_index];
+				SubMeshLOD& lod = submesh.lods[lod_index];
+				lod.indices_offset = submesh.indices_offset + lod_data.first_index * strides.index;
+				lod.indices_count = lod_data.index_count;
+				lod.meshlet_start = lod_data.first_meshlet;
+				lod.meshlet_count = lod_data.meshlet_count;
+				lod.error = lod_data.error;
 			}
 
-			meshopt_optimizeVertexCache(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
-			meshopt_optimizeOverdraw(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, vertex_count, sizeof(Vector3), 1.05f);
-			std::vector<Uint32> remap(vertex_count);
-			meshopt_optimizeVertexFetchRemap(&remap[0], mesh_data.indices.data(), mesh_data.indices.size(), vertex_count);
-			meshopt_remapIndexBuffer(mesh_data.indices.data(), mesh_data.indices.data(), mesh_data.indices.size(), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.positions_stream.data(), mesh_data.positions_stream.data(), vertex_count, sizeof(Vector3), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.normals_stream.data(), mesh_data.normals_stream.data(), mesh_data.normals_stream.size(), sizeof(Vector3), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.tangents_stream.data(), mesh_data.tangents_stream.data(), mesh_data.tangents_stream.size(), sizeof(Vector4), &remap[0]);
-			meshopt_remapVertexBuffer(mesh_data.uvs_stream.data(), mesh_data.uvs_stream.data(), mesh_data.uvs_stream.size(), sizeof(Vector2), &remap[0]);
-
-			Uint64 const max_meshlets = meshopt_buildMeshletsBound(mesh_data.indices.size(), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
-			mesh_data.meshlets.resize(max_meshlets);
-			mesh_data.meshlet_vertices.resize(max_meshlets * MESHLET_MAX_VERTICES);
-
-			std::vector<Uchar> meshlet_triangles(max_meshlets * MESHLET_MAX_TRIANGLES * 3);
-			std::vector<meshopt_Meshlet> meshlets(max_meshlets);
-
-			Uint64 meshlet_count = meshopt_buildMeshlets(meshlets.data(), mesh_data.meshlet_vertices.data(), meshlet_triangles.data(),
-				mesh_data.indices.data(), mesh_data.indices.size(), &mesh_data.positions_stream[0].x, mesh_data.positions_stream.size(), sizeof(Vector3),
-				MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES, 0);
-
-			meshopt_Meshlet const& last = meshlets[meshlet_count - 1];
-			meshlet_triangles.resize(last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3));
-			meshlets.resize(meshlet_count);
-
-			mesh_data.meshlets.resize(meshlet_count);
-			mesh_data.meshlet_vertices.resize(last.vertex_offset + last.vertex_count);
-			mesh_data.meshlet_triangles.resize(meshlet_triangles.size() / 3);
+			submesh.bounding_box = mesh_data.bounding_box;
+			submesh.topology = mesh_data.topology;
+			submesh.material_index = mesh_data.material_index;
+		}
 
-			Uint32 triangle_offset = 0;
-			for (Uint64 i = 0; i < meshlet_count; ++i)
+		//the offsets above are a prefix sum over the stream sizes so every submesh can be copied independently
+		ParallelFor(mesh_datas.size(), [&](Uint64 i)
 			{
-				meshopt_Meshlet const& m = meshlets[i];
-				meshopt_Bounds meshopt_bounds = meshopt_computeMeshletBounds(&mesh_data.meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset],
-					m.triangle_count, reinterpret_cast<Float const*>(mesh_data.positions_stream.data()), vertex_count, sizeof(Vector3));
-
-				Uchar* src_triangles = meshlet_triangles.data() + m.triangle_offset;
-				for (Uint32 triangle_idx = 0; triangle_idx < m.triangle_count; ++triangle_idx)
+				MeshData const& mesh_data = mesh_datas[i];
+				SubMeshGPU const& submesh = submeshes[first_submesh + i];
+				auto CopyData = [geometry]<typename T>(std::vector<T> const& _data, Uint32 offset)
+				{
+					memcpy(geometry + offset, _data.data(), _data.size() * sizeof(T));
+				};
+				if (submesh.index_format == GfxFormat::R16_UINT)
+				{
+					Uint16* indices = reinterpret_cast<Uint16*>(geometry + submesh.indices_offset);
+					for (Uint64 j = 0; j < mesh_data.indices.size(); ++j) indices[j] = (Uint16)mesh_data.indices[j];
+				}
+				else
 				{
-					MeshletTriangle& tri = mesh_data.meshlet_triangles[triangle_idx + triangle_offset];
-					tri.V0 = *src_triangles++;
-					tri.V1 = *src_triangles++;
-					tri.V2 = *src_triangles++;
+					CopyData(mesh_data.indices, submesh.indices_offset);
 				}
 
-				Meshlet& meshlet = mesh_data.meshlets[i];
-				std::memcpy(meshlet.center, meshopt_bounds.center, sizeof(Float) * 3);
+				if (submesh.quantized)
+				{
+					WriteQuantizedVertices(mesh_data, submesh, geometry);
+				}
+				else
+				{
+					CopyData(mesh_data.positions_stream, submesh.positions_offset);
+					CopyData(mesh_data.uvs_stream, submesh.uvs_offset);
+					CopyData(mesh_data.normals_stream, submesh.normals_offset);
+					CopyData(mesh_data.tangents_stream, submesh.tangents_offset);
+				}
+				CopyData(mesh_data.meshlets, submesh.meshlet_offset);
+				CopyData(mesh_data.meshlet_vertices, submesh.meshlet_vertices_offset);
+				CopyData(mesh_data.meshlet_triangles, submesh.meshlet_triangles_offset);
+			});
+	}
 
-				meshlet.radius = meshopt_bounds.radius;
-				meshlet.vertex_count = m.vertex_count;
-				meshlet.triangle_count = m.triangle_count;
-				meshlet.vertex_offset = m.vertex_offset;
-				meshlet.triangle_offset = triangle_offset;
-				triangle_offset += m.triangle_count;
+	Uint64 SceneLoader::CalculateTotalBufferSize(std::vector<MeshData>& mesh_datas)
+	{
+		Bool const supports_meshlets = gfx->GetCapabilities().SupportsMeshShaders();
+		Uint32 const lod_count = GetMeshLODCount();
+		Bool const quantize = QuantizeVertices.Get();
+		ParallelFor(mesh_datas.size(), [&mesh_datas, supports_meshlets, lod_count, quantize](Uint64 i)
+			{
+				MeshData& mesh_data = mesh_datas[i];
+				ProcessMeshData(mesh_data, supports_meshlets, lod_count);
+				mesh_data.quantized = quantize;
+				mesh_data.index_format = quantize && mesh_data.positions_stream.size() <= UINT16_MAX ? GfxFormat::R16_UINT : GfxFormat::R32_UINT;
+			});
 
-			}
-			mesh_data.meshlet_triangles.resize(triangle_offset);
-			total_buffer_size += Align(mesh_data.meshlets.size() * sizeof(Meshlet), 16);
-			total_buffer_size += Align(mesh_data.meshlet_vertices.size() * sizeof(Uint32), 16);
-			total_buffer_size += Align(mesh_data.meshlet_triangles.size() * sizeof(MeshletTriangle), 16);
+		Uint64 total_buffer_size = 0;
+		for (MeshData const& mesh_data : mesh_datas)
+		{
+			total_buffer_size += GetGeometrySize(mesh_data);
 		}
 		return total_buffer_size;
 	}
-
-}
\ No newline at end of file
+}
@@ -4,7 +4,7 @@
 #include <vector>
 #include <string>
 #include "Components.h"
-#include "Meshlet.h"
+#include "MeshProcessing.h"
 #include "Math/NormalsUtil.h"
 #include "Utilities/Heightmap.h"
 #include "entt/entity/registry.hpp"
@@ -69,23 +69,6 @@ namespace adria
 		Vector3 normal;
 	};
 
-	struct MeshData
-	{
-		DirectX::BoundingBox bounding_box;
-		Int32 material_index = -1;
-		GfxPrimitiveTopology topology = GfxPrimitiveTopology::TriangleList;
-
-		std::vector<Vector3>		 positions_stream;
-		std::vector<Vector3>		 normals_stream;
-		std::vector<Vector4>		 tangents_stream;
-		std::vector<Vector2>		 uvs_stream;
-		std::vector<Uint32>			 indices;
-
-		std::vector<Meshlet>		 meshlets;
-		std::vector<Uint32>			 meshlet_vertices;
-		std::vector<MeshletTriangle> meshlet_triangles;
-	};
-
     class GfxDevice;
  
 	class SceneLoader
@@ -109,6 +92,7 @@ namespace adria
 		ADRIA_MAYBE_UNUSED entt::entity LoadModel_GLTF(ModelParameters const&);
 		ADRIA_MAYBE_UNUSED entt::entity LoadModel_OBJ(ModelParameters const&);
 		ADRIA_NODISCARD Uint64 CalculateTotalBufferSize(std::vector<MeshData>& mesh_data);
+		void WriteGeometryBuffer(std::vector<MeshData> const& mesh_datas, std::vector<SubMeshGPU>& submeshes, Uint8* geometry);
 	};
 }
 
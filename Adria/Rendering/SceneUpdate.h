@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include "ShaderStructs.h"
+
+namespace adria
+{
+	//fills the GPU entry of an instance and returns its world space bounding box
+	inline BoundingBox WriteInstance(InstanceGPU& instance_gpu, Uint32 instance_id, Uint32 material_idx, Uint32 mesh_index, Matrix const& world_transform, BoundingBox const& local_box)
+	{
+		instance_gpu.instance_id = instance_id;
+		instance_gpu.material_idx = material_idx;
+		instance_gpu.mesh_index = mesh_index;
+		instance_gpu.world_matrix = world_transform;
+		instance_gpu.inverse_world_matrix = XMMatrixInverse(nullptr, world_transform);
+		instance_gpu.bb_origin = local_box.Center;
+		instance_gpu.bb_extents = local_box.Extents;
+
+		BoundingBox world_box;
+		local_box.Transform(world_box, world_transform);
+		return world_box;
+	}
+
+	//sorts and deduplicates the dirty entry indices, then calls write_range(first_index, count) once for every run of consecutive indices
+	template<typename F>
+	void ForEachDirtyRange(std::vector<Uint32>& dirty_indices, F&& write_range)
+	{
+		std::sort(dirty_indices.begin(), dirty_indices.end());
+		dirty_indices.erase(std::unique(dirty_indices.begin(), dirty_indices.end()), dirty_indices.end());
+		for (Uint64 first = 0; first < dirty_indices.size();)
+		{
+			Uint64 last = first + 1;
+			while (last < dirty_indices.size() && dirty_indices[last] == dirty_indices[last - 1] + 1) ++last;
+			write_range(dirty_indices[first], static_cast<Uint32>(last - first));
+			first = last;
+		}
+	}
+}
@@ -0,0 +1,187 @@
+#include "ShaderCompileQueue.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	struct ShaderCompileQueue::Job
+	{
+		explicit Job(GfxShaderKey const& key) : key(key), future(promise.get_future().share()) {}
+
+		GfxShaderKey key;
+		std::atomic<Bool> claimed = false;
+		std::promise<Bool> promise;
+		std::shared_future<Bool> future;
+	};
+
+	namespace
+	{
+		std::shared_future<Bool> MakeReadyFuture(Bool value)
+		{
+			std::promise<Bool> promise;
+			promise.set_value(value);
+			return promise.get_future().share();
+		}
+	}
+
+	ShaderCompileQueue::ShaderCompileQueue(CompileFunction compile_function, CompiledCallback compiled_callback)
+		: compile_function(std::move(compile_function)), compiled_callback(std::move(compiled_callback))
+	{
+	}
+
+	ShaderCompileQueue::~ShaderCompileQueue()
+	{
+		WaitIdle();
+	}
+
+	std::shared_future<Bool> ShaderCompileQueue::Submit(GfxShaderKey const& key)
+	{
+		return SubmitJob(key, false);
+	}
+
+	std::vector<std::shared_future<Bool>> ShaderCompileQueue::Submit(std::span<GfxShaderKey const> keys)
+	{
+		std::vector<std::shared_future<Bool>> futures;
+		futures.reserve(keys.size());
+		for (GfxShaderKey const& key : keys) futures.push_back(SubmitJob(key, false));
+		return futures;
+	}
+
+	std::shared_future<Bool> ShaderCompileQueue::Recompile(GfxShaderKey const& key)
+	{
+		return SubmitJob(key, true);
+	}
+
+	Bool ShaderCompileQueue::Wait(GfxShaderKey const& key)
+	{
+		std::shared_ptr<Job> job;
+		{
+			std::lock_guard lock(mutex);
+			if (auto it = pending_jobs.find(key); it != pending_jobs.end()) job = it->second;
+			else return shader_map.contains(key);
+		}
+		if (!job->claimed.exchange(true)) ExecuteJob(*job);
+		return job->future.get();
+	}
+
+	GfxShader const* ShaderCompileQueue::Find(GfxShaderKey const& key) const
+	{
+		std::lock_guard lock(mutex);
+		auto it = shader_map.find(key);
+		return it != shader_map.end() ? &it->second : nullptr;
+	}
+
+	GfxShader const* ShaderCompileQueue::Get(GfxShaderKey const& key)
+	{
+		if (GfxShader const* shader = Find(key)) return shader;
+		SubmitJob(key, false);
+		Wait(key);
+		return Find(key);
+	}
+
+	void ShaderCompileQueue::WaitIdle()
+	{
+		std::vector<std::shared_ptr<Job>> jobs;
+		while (true)
+		{
+			jobs.clear();
+			{
+				std::lock_guard lock(mutex);
+				for (auto const& [key, job] : pending_jobs) jobs.push_back(job);
+			}
+			if (jobs.empty()) break;
+
+			for (std::shared_ptr<Job> const& job : jobs)
+			{
+				if (!job->claimed.exchange(true)) ExecuteJob(*job);
+			}
+			for (std::shared_ptr<Job> const& job : jobs) job->future.wait();
+		}
+	}
+
+	void ShaderCompileQueue::Clear()
+	{
+		WaitIdle();
+		std::lock_guard lock(mutex);
+		shader_map.clear();
+		compile_errors.clear();
+		stats = {};
+	}
+
+	ShaderCompileQueueStats ShaderCompileQueue::GetStats() const
+	{
+		std::lock_guard lock(mutex);
+		return stats;
+	}
+
+	std::vector<ShaderCompileError> ShaderCompileQueue::TakeCompileErrors()
+	{
+		std::lock_guard lock(mutex);
+		std::vector<ShaderCompileError> errors;
+		errors.reserve(compile_errors.size());
+		for (auto& [key, message] : compile_errors) errors.push_back(ShaderCompileError{ key, std::move(message) });
+		compile_errors.clear();
+		return errors;
+	}
+
+	std::shared_future<Bool> ShaderCompileQueue::SubmitJob(GfxShaderKey const& key, Bool force)
+	{
+		if (!key.IsValid()) return MakeReadyFuture(false);
+
+		std::shared_ptr<Job> job;
+		{
+			std::lock_guard lock(mutex);
+			if (!force && shader_map.contains(key))
+			{
+				++stats.cache_hit_count;
+				return MakeReadyFuture(true);
+			}
+			if (auto it = pending_jobs.find(key); it != pending_jobs.end())
+			{
+				//a job that already started compiling might have read the old source, a forced request has to queue a new one
+				if (!force || !it->second->claimed)
+				{
+					++stats.deduplicated_count;
+					return it->second->future;
+				}
+			}
+			job = std::make_shared<Job>(key);
+			pending_jobs[key] = job;
+		}
+
+		//the job only touches the queue if it was not claimed yet, WaitIdle claims all jobs before the queue is destroyed
+		g_ThreadPool.Submit([this, job]()
+			{
+				if (!job->claimed.exchange(true)) ExecuteJob(*job);
+			});
+		return job->future;
+	}
+
+	void ShaderCompileQueue::ExecuteJob(Job& job)
+	{
+		GfxShaderCompileOutput output{};
+		Bool const success = compile_function(job.key, output);
+		{
+			std::lock_guard lock(mutex);
+			//a forced job queued while this one was compiling read newer sources, its result must not be overwritten by this one
+			auto it = pending_jobs.find(job.key);
+			Bool const superseded = it != pending_jobs.end() && it->second.get() != &job;
+			if (success)
+			{
+				if (!superseded)
+				{
+					shader_map[job.key] = std::move(output.shader);
+					compile_errors.erase(job.key);
+				}
+				++stats.compiled_count;
+			}
+			else
+			{
+				if (!superseded) compile_errors[job.key] = std::move(output.errors);
+				++stats.failed_count;
+			}
+			if (it != pending_jobs.end() && !superseded) pending_jobs.erase(it);
+		}
+		if (success && compiled_callback) compiled_callback(job.key, output.includes);
+		job.promise.set_value(success);
+	}
+}
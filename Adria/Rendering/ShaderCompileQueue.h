@@ -0,0 +1,70 @@
+#pragma once
+#include <functional>
+#include <future>
+#include <mutex>
+#include <span>
+#include "Graphics/GfxShaderKey.h"
+#include "Graphics/GfxShaderCompiler.h"
+
+namespace adria
+{
+	struct ShaderCompileQueueStats
+	{
+		Uint64 compiled_count = 0;
+		Uint64 failed_count = 0;
+		Uint64 deduplicated_count = 0;
+		Uint64 cache_hit_count = 0;
+	};
+
+	struct ShaderCompileError
+	{
+		GfxShaderKey key;
+		std::string message;
+	};
+
+	//compiles shader keys as jobs on g_ThreadPool and keeps the compiled shaders
+	//requests for a key that is already queued or compiling share its future
+	//a thread that has to wait for a job that was not picked up yet runs it itself, so waiting from pool threads cannot deadlock
+	class ShaderCompileQueue
+	{
+		struct Job;
+	public:
+		using CompileFunction = std::function<Bool(GfxShaderKey const&, GfxShaderCompileOutput&)>;
+		using CompiledCallback = std::function<void(GfxShaderKey const&, std::vector<std::string> const& includes)>;
+
+		//compiled_callback runs on the compiling thread after the shader was stored
+		explicit ShaderCompileQueue(CompileFunction compile_function, CompiledCallback compiled_callback = nullptr);
+		ADRIA_NONCOPYABLE_NONMOVABLE(ShaderCompileQueue)
+		~ShaderCompileQueue();
+
+		std::shared_future<Bool> Submit(GfxShaderKey const& key);
+		std::vector<std::shared_future<Bool>> Submit(std::span<GfxShaderKey const> keys);
+		//compiles again even if the key is cached, used when one of the shader's files changed
+		std::shared_future<Bool> Recompile(GfxShaderKey const& key);
+		Bool Wait(GfxShaderKey const& key);
+
+		GfxShader const* Find(GfxShaderKey const& key) const;
+		//returns the cached shader or compiles it, waiting for the result
+		GfxShader const* Get(GfxShaderKey const& key);
+
+		void WaitIdle();
+		void Clear();
+		ShaderCompileQueueStats GetStats() const;
+		//errors of failed compiles on any thread since the last call, a key that compiles again before that is dropped from them
+		std::vector<ShaderCompileError> TakeCompileErrors();
+
+	private:
+		CompileFunction compile_function;
+		CompiledCallback compiled_callback;
+
+		mutable std::mutex mutex;
+		std::unordered_map<GfxShaderKey, GfxShader, GfxShaderKeyHash> shader_map;
+		std::unordered_map<GfxShaderKey, std::shared_ptr<Job>, GfxShaderKeyHash> pending_jobs;
+		std::unordered_map<GfxShaderKey, std::string, GfxShaderKeyHash> compile_errors;
+		ShaderCompileQueueStats stats;
+
+	private:
+		std::shared_future<Bool> SubmitJob(GfxShaderKey const& key, Bool force);
+		void ExecuteJob(Job& job);
+	};
+}
@@ -1,5 +1,5 @@
-#include <set>
 #include "ShaderManager.h"
+#include "ShaderCompileQueue.h"
 #include "Core/Paths.h"
 #include "Core/ConsoleManager.h"
 #include "Core/CommandLineOptions.h"
@@ -21,8 +21,12 @@ namespace adria
 		std::unique_ptr<FileWatcher> file_watcher;
 		ShaderRecompiledEvent shader_recompiled_event;
 		LibraryRecompiledEvent library_recompiled_event;
-		std::unordered_map<GfxShaderKey, GfxShader, GfxShaderKeyHash> shader_map;
-		std::unordered_map<fs::path, std::set<GfxShaderKey>> file_shader_map;
+		ShaderCompiledEvent shader_compiled_event;
+		std::unique_ptr<ShaderCompileQueue> compile_queue;
+		std::unordered_map<fs::path, std::unordered_set<GfxShaderKey, GfxShaderKeyHash>> file_shader_map;
+		std::mutex file_shader_map_mutex;
+		std::mutex shader_compiled_event_mutex;
+		std::thread::id main_thread_id;
 
 		inline GfxShaderCompilerFlags GetShaderCompilerFlags()
 		{
@@ -568,10 +572,8 @@ namespace adria
 			return SM_6_7;
 		}
 
-		void CompileShader(GfxShaderKey const& shader)
+		Bool CompileShader(GfxShaderKey const& shader, GfxShaderCompileOutput& output)
 		{
-			if (!shader.IsValid()) return;
-
 			GfxShaderDesc shader_desc{};
 			shader_desc.entry_point = GetEntryPoint(shader);
 			shader_desc.stage = GetShaderStage(shader);
@@ -580,35 +582,111 @@ namespace adria
 			shader_desc.flags = GetShaderCompilerFlags();
 			shader_desc.defines = shader.GetDefines();
 
-			GfxShaderCompileOutput output;
-			Bool compile_result = GfxShaderCompiler::CompileShader(shader_desc, output);
-			ADRIA_ASSERT(compile_result);
-			if (!compile_result) return;
+			return GfxShaderCompiler::CompileShader(shader_desc, output);
+		}
+		void OnShaderCompiled(GfxShaderKey const& shader, std::vector<std::string> const& includes)
+		{
+			{
+				std::lock_guard lock(file_shader_map_mutex);
+				for (std::string const& include : includes)
+				{
+					file_shader_map[fs::path(include)].insert(shader);
+				}
+			}
+			std::lock_guard lock(shader_compiled_event_mutex);
+			shader_compiled_event.Broadcast(shader);
+		}
+		//compiles fail on worker threads, their errors are collected by the queue and shown here on the main thread, one prompt for all of them at a time
+		//returns the shaders that compiled after the user fixed them, the others are given up on when the prompt is cancelled
+		std::vector<GfxShaderKey> ResolveCompileErrors()
+		{
+			std::vector<GfxShaderKey> fixed_shaders;
+			if (std::this_thread::get_id() != main_thread_id) return fixed_shaders;
 
-			shader_map[shader] = std::move(output.shader);
+			std::vector<ShaderCompileError> errors = compile_queue->TakeCompileErrors();
+			while (!errors.empty())
+			{
+				std::string msg = "Click OK after you fixed the following errors: \n";
+				for (ShaderCompileError const& error : errors) msg += error.message;
+				if (MessageBoxA(NULL, msg.c_str(), NULL, MB_OKCANCEL) != IDOK)
+				{
+					for (ShaderCompileError const& error : errors) ADRIA_LOG(ERROR, "Shader '%s' failed to compile", GetEntryPoint(error.key).c_str());
+					break;
+				}
 
-			file_shader_map[fs::path(shader_desc.file)].insert(shader);
-			for (auto const& include : output.includes)
+				std::vector<std::shared_future<Bool>> futures;
+				futures.reserve(errors.size());
+				for (ShaderCompileError const& error : errors) futures.push_back(compile_queue->Recompile(error.key));
+				for (Uint64 i = 0; i < errors.size(); ++i)
+				{
+					compile_queue->Wait(errors[i].key);
+					if (futures[i].get()) fixed_shaders.push_back(errors[i].key);
+				}
+				errors = compile_queue->TakeCompileErrors();
+			}
+			return fixed_shaders;
+		}
+		void BroadcastRecompiledShaders(std::span<GfxShaderKey const> shaders)
+		{
+			std::vector<GfxShaderKey> recompiled_shaders;
+			recompiled_shaders.reserve(shaders.size());
+			for (GfxShaderKey const& shader_key : shaders)
 			{
-				file_shader_map[fs::path(include)].insert(shader);
+				if (GetShaderStage(shader_key) == GfxShaderStage::LIB) library_recompiled_event.Broadcast(shader_key);
+				else recompiled_shaders.push_back(shader_key);
 			}
-			shader_desc.stage == GfxShaderStage::LIB ? library_recompiled_event.Broadcast(shader) : shader_recompiled_event.Broadcast(shader);
+			if (recompiled_shaders.empty()) return;
+
+			std::sort(recompiled_shaders.begin(), recompiled_shaders.end(), [](GfxShaderKey const& lhs, GfxShaderKey const& rhs) { return lhs.GetHash() < rhs.GetHash(); });
+			shader_recompiled_event.Broadcast(recompiled_shaders);
 		}
-		void OnShaderFileChanged(std::string const& filename)
+
+		//the shaders affected by a batch of changed files are recompiled in parallel, pipelines are recreated once per batch on the calling thread
+		void OnShaderFilesChanged(std::span<std::string const> files)
 		{
-			for (GfxShaderKey const& shader_key : file_shader_map[fs::path(filename)])
+			std::unordered_set<GfxShaderKey, GfxShaderKeyHash> affected_shaders;
 			{
-				CompileShader(shader_key);
+				std::lock_guard lock(file_shader_map_mutex);
+				for (std::string const& file : files)
+				{
+					if (auto it = file_shader_map.find(fs::path(file)); it != file_shader_map.end())
+					{
+						affected_shaders.insert(it->second.begin(), it->second.end());
+					}
+				}
 			}
+			for (std::string const& file : files) GfxShaderCompiler::InvalidateCachedFile(file);
+			if (affected_shaders.empty()) return;
+
+			ADRIA_LOG(INFO, "Recompiling %llu shaders affected by %llu changed files", (Uint64)affected_shaders.size(), (Uint64)files.size());
+			for (GfxShaderKey const& shader_key : affected_shaders)
+			{
+				compile_queue->Recompile(shader_key);
+			}
+
+			std::vector<GfxShaderKey> recompiled_shaders;
+			recompiled_shaders.reserve(affected_shaders.size());
+			for (GfxShaderKey const& shader_key : affected_shaders)
+			{
+				if (compile_queue->Wait(shader_key)) recompiled_shaders.push_back(shader_key);
+			}
+			//a shader that failed and was fixed in the prompt might have been counted above with its old binary
+			for (GfxShaderKey const& shader_key : ResolveCompileErrors())
+			{
+				if (std::find(recompiled_shaders.begin(), recompiled_shaders.end(), shader_key) == recompiled_shaders.end()) recompiled_shaders.push_back(shader_key);
+			}
+			GfxShaderCompiler::SaveCache();
+			BroadcastRecompiledShaders(recompiled_shaders);
 		}
 	}
 
 	void ShaderManager::Initialize()
 	{
+		main_thread_id = std::this_thread::get_id();
+		compile_queue = std::make_unique<ShaderCompileQueue>(CompileShader, OnShaderCompiled);
 		file_watcher = std::make_unique<FileWatcher>();
 		file_watcher->AddPathToWatch(paths::ShaderDir);
-		std::ignore = file_watcher->GetFileModifiedEvent().AddStatic(OnShaderFileChanged);
-		fs::create_directory(paths::ShaderCacheDir);
+		std::ignore = file_watcher->GetFilesModifiedEvent().AddStatic(OnShaderFilesChanged);
 		if (CommandLineOptions::GetShaderDebug())
 		{
 			OptimizeShaders->Set(false);
@@ -618,18 +696,46 @@ namespace adria
 	void ShaderManager::Destroy()
 	{
 		file_watcher = nullptr;
-		shader_map.clear();
+		compile_queue = nullptr;
 	}
 	void ShaderManager::CheckIfShadersHaveChanged()
 	{
 		file_watcher->CheckWatchedFiles();
+		//compiles that failed off the main thread, e.g. pipelines created while recording passes
+		std::vector<GfxShaderKey> const fixed_shaders = ResolveCompileErrors();
+		BroadcastRecompiledShaders(fixed_shaders);
+	}
+	Bool ShaderManager::HasPendingShaderChanges()
+	{
+		return file_watcher->HasPendingChanges();
 	}
 
 	GfxShader const& ShaderManager::GetGfxShader(GfxShaderKey const& shader_key)
 	{
-		if (shader_map.contains(shader_key)) return shader_map[shader_key];
-		CompileShader(shader_key);
-		return shader_map[shader_key];
+		static GfxShader const invalid_shader{};
+		GfxShader const* shader = compile_queue->Get(shader_key);
+		if (!shader)
+		{
+			ResolveCompileErrors();
+			shader = compile_queue->Find(shader_key);
+		}
+		return shader ? *shader : invalid_shader;
+	}
+
+	void ShaderManager::CompileShaders(std::span<GfxShaderKey const> shader_keys)
+	{
+		compile_queue->Submit(shader_keys);
+		for (GfxShaderKey const& shader_key : shader_keys)
+		{
+			compile_queue->Wait(shader_key);
+		}
+		ResolveCompileErrors();
+		GfxShaderCompiler::SaveCache();
+	}
+
+	ShaderCompileQueueStats ShaderManager::GetCompileStats()
+	{
+		return compile_queue->GetStats();
 	}
 
 	ShaderRecompiledEvent& ShaderManager::GetShaderRecompiledEvent()
@@ -640,5 +746,9 @@ namespace adria
 	{
 		return library_recompiled_event;
 	}
+	ShaderCompiledEvent& ShaderManager::GetShaderCompiledEvent()
+	{
+		return shader_compiled_event;
+	}
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <span>
 #include "Utilities/Delegate.h"
 
 namespace adria
@@ -6,6 +7,7 @@ namespace adria
 	class GfxDevice;
 	class GfxShader;
 	class GfxShaderKey;
+	struct ShaderCompileQueueStats;
 
 	enum ShaderID : Uint8
 	{
@@ -121,18 +123,27 @@ namespace adria
 		ShaderId_Count
 	};
 
-	DECLARE_MULTICAST_DELEGATE(ShaderRecompiledEvent, GfxShaderKey const&)
+	DECLARE_MULTICAST_DELEGATE(ShaderRecompiledEvent, std::span<GfxShaderKey const>)
 	DECLARE_MULTICAST_DELEGATE(LibraryRecompiledEvent, GfxShaderKey const&)
+	DECLARE_MULTICAST_DELEGATE(ShaderCompiledEvent, GfxShaderKey const&)
 	class ShaderManager
 	{
 	public:
 		static void Initialize();
 		static void Destroy();
 		static void CheckIfShadersHaveChanged();
+		//true when a batch of shader file changes settled or polled shader directories are due for a check, CheckIfShadersHaveChanged handles both
+		static Bool HasPendingShaderChanges();
 
+		//broadcast once per hot reload batch with all recompiled shaders, sorted by GfxShaderKey::GetHash
 		static ShaderRecompiledEvent& GetShaderRecompiledEvent();
 		static LibraryRecompiledEvent& GetLibraryRecompiledEvent();
+		//broadcast from the compiling thread after every successful compile, listeners have to be added before shaders are requested
+		static ShaderCompiledEvent& GetShaderCompiledEvent();
 		static GfxShader const& GetGfxShader(GfxShaderKey const& shader_key);
+		//compiles all shaders that are not cached yet in parallel and waits for them
+		static void CompileShaders(std::span<GfxShaderKey const> shader_keys);
+		static ShaderCompileQueueStats GetCompileStats();
 	};
 	#define GetGfxShader(key) ShaderManager::GetGfxShader(key)
 }
\ No newline at end of file
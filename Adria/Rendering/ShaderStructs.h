@@ -1,4 +1,5 @@
 #pragma once
+#include "Meshlet.h"
 
 #ifndef DECLSPEC_ALIGN
 #define DECLSPEC_ALIGN(x)   __declspec(align(x))
@@ -64,6 +65,8 @@ namespace adria
 		Int32  sheenE_idx;
 		Int32  triangle_overdraw_idx;
 		Float  rain_total_time;
+		Int32  mesh_buffers_idx;
+		Float  mesh_lod_error_scale;
 	};
 
 	struct LightGPU
@@ -87,6 +90,20 @@ namespace adria
 		Int32 padd;
 	};
 
+	struct MeshLODGPU
+	{
+		Uint32 meshlet_start;
+		Uint32 meshlet_count;
+		Float  error;
+	};
+
+	enum MeshFlag : Uint32
+	{
+		MeshFlag_None = 0x0,
+		MeshFlag_Quantized = 0x1,
+		MeshFlag_ShortIndices = 0x2
+	};
+
 	struct MeshGPU
 	{
 		Uint32 buffer_idx;
@@ -99,6 +116,11 @@ namespace adria
 		Uint32 meshlet_vertices_offset;
 		Uint32 meshlet_triangles_offset;
 		Uint32 meshlet_count;
+		Uint32 lod_count;
+		MeshLODGPU lods[MESH_MAX_LODS];
+		Uint32 flags;
+		Vector3 position_offset;
+		Vector3 position_scale;
 	};
 
 	struct MaterialGPU
@@ -1,9 +1,11 @@
+#include <bit>
 #include "ShadowRenderer.h"
 #include "Components.h"
 #include "Camera.h"
 #include "ShaderManager.h"
 #include "BlackboardData.h"
 #include "ShaderStructs.h"
+#include "Math/BoundingBoxCulling.h"
 #include "Graphics/GfxBuffer.h"
 #include "Graphics/GfxTexture.h"
 #include "Graphics/GfxDevice.h"
@@ -377,9 +379,8 @@ namespace adria
 			auto& light = light_view.get<Light>(e);
 			light.shadow_mask_index = -1;
 			light.shadow_texture_index = -1;
-			if (light.casts_shadows)
+			if (light.casts_shadows && !light.ray_traced_shadows)
 			{
-				if (light.ray_traced_shadows) continue;
 				light.shadow_matrix_index = (Uint32)light_matrices.size();
 				if (light.type == LightType::Directional)
 				{
@@ -417,7 +418,7 @@ namespace adria
 					light_matrices.push_back(XMMatrixTranspose(V * P));
 				}
 			}
-			else if (light.ray_traced_shadows)
+			else if (!light.casts_shadows && light.ray_traced_shadows)
 			{
 				AddShadowMask(light, entt::to_integral(e));
 			}
@@ -433,6 +434,15 @@ namespace adria
 		}
 	}
 
+	void ShadowRenderer::AppendCullingViews(std::vector<CullingView>& views) const
+	{
+		for (BoundingObject const& bounding_object : bounding_objects)
+		{
+			if (bounding_object.type == BoundingObject::Box) views.push_back(MakeCullingView(bounding_object.GetBox()));
+			else views.push_back(MakeCullingView(bounding_object.GetFrustum()));
+		}
+	}
+
 	void ShadowRenderer::AddShadowMapPasses(RenderGraph& rg)
 	{
 		FrameBlackboardData const& frame_data = rg.GetBlackboard().Get<FrameBlackboardData>();
@@ -562,7 +572,10 @@ namespace adria
 		gfx_pso_desc.depth_state.depth_func = GfxComparisonFunc::LessEqual;
 		gfx_pso_desc.dsv_format = GfxFormat::D32_FLOAT;
 
-		shadow_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gfx_pso_desc);
+		static constexpr GfxPermutationDefine ShadowPermutationDefines[] = { { "TRANSPARENT", "1" } };
+		shadow_psos = std::make_unique<GfxGraphicsPipelineStatePermutations>(gfx, gfx_pso_desc, ShadowPermutationDefines);
+		static constexpr Uint32 ShadowPermutations[] = { 0, 1 };
+		shadow_psos->Prewarm(ShadowPermutations, ShaderManager::CompileShaders);
 	}
 
 	void ShadowRenderer::ShadowMapPass_Common(GfxCommandList* cmd_list, LightType light_type, Uint64 light_index, Uint64 matrix_index, Uint64 matrix_offset)
@@ -576,53 +589,39 @@ namespace adria
 			.light_index = (Uint32)light_index,
 			.matrix_offset = (Uint32)matrix_offset
 		};
-		auto view = reg.view<Batch>();
+		ADRIA_ASSERT((matrix_index + 1) * visibility_word_count <= batch_visibility.size());
+		std::span<Uint64 const> visibility = batch_visibility.subspan(matrix_index * visibility_word_count, visibility_word_count);
+
 		std::vector<Batch*> masked_batches, opaque_batches;
-		for (auto batch_entity : reg.view<Batch>())
+		for (Uint64 word = 0; word < visibility.size(); ++word)
 		{
-			Batch& batch = reg.get<Batch>(batch_entity);
-			if (batch.alpha_mode == MaterialAlphaMode::Opaque) opaque_batches.push_back(&batch);
-			else masked_batches.push_back(&batch);
+			for (Uint64 bits = visibility[word]; bits != 0; bits &= bits - 1)
+			{
+				Uint64 const instance_id = word * BoundingBoxSoA::BlockSize + std::countr_zero(bits);
+				Batch& batch = reg.get<Batch>(batch_entities[instance_id]);
+				if (batch.alpha_mode == MaterialAlphaMode::Opaque) opaque_batches.push_back(&batch);
+				else masked_batches.push_back(&batch);
+			}
 		}
 
 		auto DrawBatch = [&](GfxCommandList* cmd_list, Bool masked_batch)
 		{
 			std::vector<Batch*>& batches = masked_batch ? masked_batches : opaque_batches;
-			if (masked_batch)
-			{
-				shadow_psos->AddDefine("TRANSPARENT", "1");
-			}
-			GfxPipelineState* pso = shadow_psos->Get();
+			GfxPipelineState* pso = shadow_psos->Get(masked_batch ? 1 : 0);
 			cmd_list->SetRootConstants(1, constants);
 			cmd_list->SetPipelineState(pso);
 			for (Batch* batch : batches)
 			{
-				Bool skip_batch = false;
-				switch (light_type)
-				{
-				case LightType::Directional:
-					ADRIA_ASSERT(bounding_objects[matrix_index].type == BoundingObject::Box);
-					skip_batch = !bounding_objects[matrix_index].GetBox().Intersects(batch->bounding_box);
-					break;
-				case LightType::Spot:
-				case LightType::Point:
-					ADRIA_ASSERT(bounding_objects[matrix_index].type == BoundingObject::Frustum);
-					skip_batch = !bounding_objects[matrix_index].GetFrustum().Intersects(batch->bounding_box);
-					break;
-				default:
-					ADRIA_ASSERT(false);
-				}
-				if (skip_batch) continue;
-
 				struct ModelConstants
 				{
 					Uint32 instance_id;
 				} model_constants{ .instance_id = batch->instance_id };
 				cmd_list->SetRootCBV(2, model_constants);
-				GfxIndexBufferView ibv(batch->submesh->buffer_address + batch->submesh->indices_offset, batch->submesh->indices_count);
+				SubMeshLOD const& lod = batch->submesh->lods[batch->lod];
+				GfxIndexBufferView ibv(batch->submesh->buffer_address + lod.indices_offset, lod.indices_count, batch->submesh->index_format);
 				cmd_list->SetTopology(batch->submesh->topology);
 				cmd_list->SetIndexBuffer(&ibv);
-				cmd_list->DrawIndexed(batch->submesh->indices_count);
+				cmd_list->DrawIndexed(lod.indices_count);
 			}
 		};
 
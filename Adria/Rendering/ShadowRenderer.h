@@ -1,6 +1,7 @@
 #pragma once
 #include <array>
 #include <variant>
+#include <span>
 #include "RayTracedShadowsPass.h"
 #include "Graphics/GfxMacros.h"
 #include "Graphics/GfxDescriptor.h"
@@ -15,6 +16,7 @@ namespace adria
 	class GfxTexture;
 	class RenderGraph;
 	class Camera;
+	struct CullingView;
 	struct FrameCBuffer;
 	enum class LightType : Int32;
 
@@ -26,8 +28,8 @@ namespace adria
 			Frustum
 		} type = Box;
 
-		BoundingObject(BoundingBox const& box) : data(box) {}
-		BoundingObject(BoundingFrustum const& frustum) : data(frustum) {}
+		BoundingObject(BoundingBox const& box) : type(Box), data(box) {}
+		BoundingObject(BoundingFrustum const& frustum) : type(Frustum), data(frustum) {}
 
 		BoundingBox const& GetBox() const
 		{
@@ -64,6 +66,14 @@ namespace adria
 			}
 		}
 		void SetupShadows(Camera const* camera);
+		//one view per light matrix, culled by the renderer together with the camera in a single pass over the batches
+		void AppendCullingViews(std::vector<CullingView>& views) const;
+		void SetBatchVisibility(std::span<entt::entity const> _batch_entities, std::span<Uint64 const> _visibility, Uint64 _visibility_word_count)
+		{
+			batch_entities = _batch_entities;
+			batch_visibility = _visibility;
+			visibility_word_count = _visibility_word_count;
+		}
 
 		void AddShadowMapPasses(RenderGraph& rg);
 		void AddRayTracingShadowPasses(RenderGraph& rg);
@@ -91,6 +101,9 @@ namespace adria
 		Int32						   light_matrices_gpu_index = -1;
 
 		std::vector<BoundingObject>						bounding_objects;
+		std::span<entt::entity const>					batch_entities;
+		std::span<Uint64 const>							batch_visibility;
+		Uint64											visibility_word_count = 0;
 		std::array<Float, SHADOW_CASCADE_COUNT>		    split_distances{};
 
 		ShadowTextureRenderedEvent shadow_rendered_event;
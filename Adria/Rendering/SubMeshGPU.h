@@ -0,0 +1,73 @@
+#pragma once
+#include <DirectXCollision.h>
+#include "Meshlet.h"
+#include "Graphics/GfxFormat.h"
+#include "Graphics/GfxStates.h"
+
+namespace adria
+{
+	//a simplified version of a submesh, all LODs of a submesh share its vertex streams
+	struct SubMeshLOD
+	{
+		Uint32 indices_offset;
+		Uint32 indices_count;
+		Uint32 meshlet_start; //relative to the first meshlet of the submesh
+		Uint32 meshlet_count;
+		Float  error;		  //object space distance the LOD can deviate from the full detail surface
+	};
+
+	struct SubMeshGPU
+	{
+		Uint64 buffer_address;
+
+		Uint32 indices_offset;
+		Uint32 indices_count;
+		Uint32 vertices_count;
+
+		Uint32 positions_offset;
+		Uint32 uvs_offset;
+		Uint32 normals_offset;
+		Uint32 tangents_offset;
+
+		Uint32 meshlet_offset;
+		Uint32 meshlet_vertices_offset;
+		Uint32 meshlet_triangles_offset;
+		Uint32 meshlet_count;
+		//meshlet vertices and triangles of all lods
+		Uint32 meshlet_vertices_count;
+		Uint32 meshlet_triangles_count;
+
+		//lods[0] is the full detail submesh described by the offsets above
+		Uint32 lod_count;
+		SubMeshLOD lods[MESH_MAX_LODS];
+
+		//quantized submeshes store 16 bit snorm positions relative to the bounding box with the tangent handedness in w,
+		//16 bit snorm octahedral normals and tangents and half precision uvs
+		Bool quantized;
+		GfxFormat index_format;
+
+		Uint32 material_index;
+		DirectX::BoundingBox bounding_box;
+		GfxPrimitiveTopology topology;
+	};
+
+	struct SubMeshStrides
+	{
+		Uint32 index;
+		Uint32 position;
+		Uint32 uv;
+		Uint32 normal;
+		Uint32 tangent;
+	};
+	inline SubMeshStrides GetSubMeshStrides(Bool quantized, GfxFormat index_format)
+	{
+		SubMeshStrides strides{};
+		strides.index = GetGfxFormatStride(index_format);
+		strides.position = quantized ? 4 * sizeof(Int16) : sizeof(Vector3);
+		strides.uv = quantized ? 2 * sizeof(Uint16) : sizeof(Vector2);
+		strides.normal = quantized ? 2 * sizeof(Int16) : sizeof(Vector3);
+		strides.tangent = quantized ? 2 * sizeof(Int16) : sizeof(Vector4);
+		return strides;
+	}
+	inline SubMeshStrides GetSubMeshStrides(SubMeshGPU const& submesh) { return GetSubMeshStrides(submesh.quantized, submesh.index_format); }
+}
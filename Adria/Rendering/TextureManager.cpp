@@ -1,15 +1,211 @@
 #include "d3dx12.h"
 #include "TextureManager.h"
+#include "TextureStreamer.h"
 #include "Graphics/GfxTexture.h"
+#include "Graphics/GfxBuffer.h"
+#include "Graphics/GfxFence.h"
 #include "Graphics/GfxDevice.h"
 #include "Graphics/GfxCommon.h"
 #include "Graphics/GfxCommandList.h"
 #include "Graphics/GfxShaderCompiler.h"
+#include "Editor/GUICommand.h"
+#include "Core/ConsoleManager.h"
 #include "Utilities/Image.h"
+#include "Utilities/FilesUtil.h"
 
 
 namespace adria
 {
+	static TAutoConsoleVariable<Bool> TextureStreaming("r.TextureStreaming", true, "0: Scene textures are loaded synchronously. 1: Scene textures are streamed in the background behind placeholders");
+	static TAutoConsoleVariable<Int>  TextureStreamingStagingSize("r.TextureStreaming.StagingSizeMB", 64, "Size of the upload ring used for streamed textures, textures that don't fit get their own staging buffer");
+	static TAutoConsoleVariable<Int>  TextureStreamingMaxUploads("r.TextureStreaming.MaxUploadsPerFrame", 32, "Maximum number of streamed textures recorded into one copy queue submission");
+
+	namespace
+	{
+		GfxTextureDesc GetTextureDesc(Image const& img, Bool srgb)
+		{
+			GfxTextureDesc desc{};
+			desc.type = img.Depth() > 1 ? GfxTextureType_3D : GfxTextureType_2D;
+			desc.width = img.Width();
+			desc.height = img.Height();
+			desc.array_size = img.IsCubemap() ? 6 : 1;
+			desc.depth = img.Depth();
+			desc.bind_flags = GfxBindFlag::ShaderResource;
+			desc.format = img.Format();
+			desc.initial_state = GfxResourceState::AllSRV;
+			desc.heap_type = GfxResourceUsage::Default;
+			desc.mip_levels = img.MipLevels();
+			desc.misc_flags = img.IsCubemap() ? GfxTextureMiscFlag::TextureCube : GfxTextureMiscFlag::None;
+			if (srgb)
+			{
+				desc.misc_flags |= GfxTextureMiscFlag::SRGB;
+			}
+			return desc;
+		}
+
+		std::vector<GfxTextureSubData> GetTextureSubData(Image const& img, GfxTextureDesc const& desc)
+		{
+			std::vector<GfxTextureSubData> tex_data;
+			Image const* curr_img = &img;
+			while (curr_img)
+			{
+				for (Uint32 i = 0; i < desc.mip_levels; ++i)
+				{
+					GfxTextureSubData& data = tex_data.emplace_back();
+					data.data = curr_img->MipData(i);
+					data.row_pitch = GetRowPitch(curr_img->Format(), desc.width, i);
+					data.slice_pitch = GetSlicePitch(img.Format(), desc.width, desc.height, i);
+				}
+				curr_img = curr_img->NextImage();
+			}
+			return tex_data;
+		}
+
+		GfxDescriptor GetPlaceholderSRV(TextureHandle placeholder)
+		{
+			switch (placeholder)
+			{
+			case DEFAULT_BLACK_TEXTURE_HANDLE:				return gfxcommon::GetCommonView(GfxCommonViewType::BlackTexture2D_SRV);
+			case DEFAULT_NORMAL_TEXTURE_HANDLE:				return gfxcommon::GetCommonView(GfxCommonViewType::DefaultNormal2D_SRV);
+			case DEFAULT_METALLIC_ROUGHNESS_TEXTURE_HANDLE: return gfxcommon::GetCommonView(GfxCommonViewType::MetallicRoughness2D_SRV);
+			case DEFAULT_WHITE_TEXTURE_HANDLE:
+			default:
+				return gfxcommon::GetCommonView(GfxCommonViewType::WhiteTexture2D_SRV);
+			}
+		}
+	}
+
+	//records streamed textures into copy queue command lists, textures are created in the common state
+	//so the graphics queue can read them through implicit promotion once the copy queue signaled its fence
+	class TextureUploader final : public ITextureUploader
+	{
+		static constexpr Uint32 BatchCount = 3;
+		struct Batch
+		{
+			std::unique_ptr<GfxCommandList> cmd_list;
+			std::vector<std::unique_ptr<GfxBuffer>> dedicated_staging_buffers;
+			Uint64 fence_value = 0;
+		};
+
+	public:
+		using UploadCompletedCallback = std::function<void(TextureHandle, std::unique_ptr<GfxTexture>&&)>;
+
+		TextureUploader(GfxDevice* gfx, Uint64 staging_size, UploadCompletedCallback&& upload_completed_callback)
+			: gfx(gfx), upload_completed_callback(std::move(upload_completed_callback))
+		{
+			GfxBufferDesc staging_desc{};
+			staging_desc.size = staging_size;
+			staging_desc.resource_usage = GfxResourceUsage::Upload;
+			staging_buffer = gfx->CreateBuffer(staging_desc);
+			staging_buffer->SetName("Texture Streaming Staging Buffer");
+
+			for (Batch& batch : batches)
+			{
+				batch.cmd_list = std::make_unique<GfxCommandList>(gfx, GfxCommandListType::Copy, "Texture Streaming Command List");
+			}
+			upload_fence.Create(gfx, "Texture Upload Fence");
+		}
+
+		virtual Uint64 GetStagingSize(TextureStreamRequest const& request, Image const& image) override
+		{
+			return GfxTexture::GetUploadSize(gfx, GetTextureDesc(image, request.srgb));
+		}
+
+		virtual void Upload(TextureStreamRequest const& request, Image const& image, Uint64 staging_offset) override
+		{
+			Batch& batch = BeginBatch();
+
+			GfxTextureDesc desc = GetTextureDesc(image, request.srgb);
+			desc.initial_state = GfxResourceState::Common;
+			std::unique_ptr<GfxTexture> texture = gfx->CreateTexture(desc);
+			texture->SetName(request.path.c_str());
+
+			GfxBuffer* staging = staging_buffer.get();
+			if (staging_offset == INVALID_ALLOC_OFFSET)
+			{
+				GfxBufferDesc staging_desc{};
+				staging_desc.size = GfxTexture::GetUploadSize(gfx, desc);
+				staging_desc.resource_usage = GfxResourceUsage::Upload;
+				staging = batch.dedicated_staging_buffers.emplace_back(gfx->CreateBuffer(staging_desc)).get();
+				staging_offset = 0;
+			}
+
+			std::vector<GfxTextureSubData> tex_data = GetTextureSubData(image, desc);
+			std::vector<D3D12_SUBRESOURCE_DATA> subresource_data(tex_data.size());
+			for (Uint64 i = 0; i < tex_data.size(); ++i)
+			{
+				subresource_data[i].pData = tex_data[i].data;
+				subresource_data[i].RowPitch = tex_data[i].row_pitch;
+				subresource_data[i].SlicePitch = tex_data[i].slice_pitch;
+			}
+			UpdateSubresources(batch.cmd_list->GetNative(), texture->GetNative(), staging->GetNative(), staging_offset, 0, (Uint32)subresource_data.size(), subresource_data.data());
+			pending_textures[request.handle] = std::move(texture);
+		}
+
+		virtual Uint64 Submit() override
+		{
+			ADRIA_ASSERT(batch_open);
+			Batch& batch = batches[current_batch];
+			batch.fence_value = ++fence_value;
+			batch.cmd_list->End();
+			batch.cmd_list->Signal(upload_fence, batch.fence_value);
+			batch.cmd_list->Submit();
+			current_batch = (current_batch + 1) % BatchCount;
+			batch_open = false;
+			return batch.fence_value;
+		}
+
+		virtual Uint64 GetCompletedFenceValue() const override
+		{
+			return upload_fence.GetCompletedValue();
+		}
+
+		virtual void OnUploadCompleted(TextureStreamRequest const& request) override
+		{
+			auto it = pending_textures.find(request.handle);
+			if (it == pending_textures.end()) return;
+			upload_completed_callback(request.handle, std::move(it->second));
+			pending_textures.erase(it);
+		}
+
+		void WaitIdle()
+		{
+			upload_fence.Wait(fence_value);
+		}
+
+		void Reset()
+		{
+			ADRIA_ASSERT(!batch_open);
+			pending_textures.clear();
+			for (Batch& batch : batches) batch.dedicated_staging_buffers.clear();
+		}
+
+	private:
+		GfxDevice* gfx;
+		UploadCompletedCallback upload_completed_callback;
+		std::unique_ptr<GfxBuffer> staging_buffer;
+		std::array<Batch, BatchCount> batches;
+		Uint32 current_batch = 0;
+		Bool batch_open = false;
+		GfxFence upload_fence;
+		Uint64 fence_value = 0;
+		std::unordered_map<TextureHandle, std::unique_ptr<GfxTexture>> pending_textures;
+
+	private:
+		Batch& BeginBatch()
+		{
+			Batch& batch = batches[current_batch];
+			if (!batch_open)
+			{
+				upload_fence.Wait(batch.fence_value);
+				batch.dedicated_staging_buffers.clear();
+				batch.cmd_list->ResetAllocator();
+				batch.cmd_list->Begin();
+				batch_open = true;
+			}
+			return batch;
+		}
+	};
 
     TextureManager::TextureManager() {}
     TextureManager::~TextureManager() = default;
@@ -17,10 +213,27 @@ namespace adria
 	void TextureManager::Initialize(GfxDevice* _gfx)
 	{
         gfx = _gfx;
+
+		TextureStreamerDesc streamer_desc{};
+		streamer_desc.staging_size = (Uint64)std::max(TextureStreamingStagingSize.Get(), 1) * 1024 * 1024;
+		streamer_desc.staging_alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+		streamer_desc.max_uploads_per_update = (Uint32)std::max(TextureStreamingMaxUploads.Get(), 1);
+		texture_uploader = std::make_unique<TextureUploader>(gfx, streamer_desc.staging_size,
+			[this](TextureHandle handle, std::unique_ptr<GfxTexture>&& texture) { OnTextureStreamed(handle, std::move(texture)); });
+		texture_streamer = std::make_unique<TextureStreamer>(streamer_desc, *texture_uploader, [](std::string const& path) -> std::unique_ptr<Image>
+			{
+				if (!FileExists(path)) return nullptr;
+				return std::make_unique<Image>(path);
+			});
 	}
 
 	void TextureManager::Clear()
 	{
+		texture_uploader->WaitIdle();
+		texture_streamer->Clear();
+		texture_uploader->Reset();
+		streaming_placeholders.clear();
+		pending_texture_views.clear();
 		for (auto& [handle, descriptor] : texture_srv_map)
 		{
 			gfx->FreeDescriptorCPU(descriptor, GfxDescriptorHeapType::CBV_SRV_UAV);
@@ -35,6 +248,8 @@ namespace adria
 	void TextureManager::Destroy()
 	{
 		Clear();
+		texture_streamer.reset();
+		texture_uploader.reset();
 		gfx = nullptr;
 	}
 
@@ -45,52 +260,47 @@ namespace adria
         {
             ++handle;
             loaded_textures.insert({ texture_name, handle });
-            Image img(path);
-
-			GfxTextureDesc desc{};
-			desc.type = img.Depth() > 1 ? GfxTextureType_3D : GfxTextureType_2D;
-			desc.misc_flags = GfxTextureMiscFlag::None;
-			desc.width = img.Width();
-			desc.height = img.Height();
-			desc.array_size = img.IsCubemap() ? 6 : 1;
-			desc.depth = img.Depth();
-			desc.bind_flags = GfxBindFlag::ShaderResource;
-			desc.format = img.Format();
-			desc.initial_state = GfxResourceState::AllSRV; 
-			desc.heap_type = GfxResourceUsage::Default;
-			desc.mip_levels = img.MipLevels();
-            desc.misc_flags = img.IsCubemap() ? GfxTextureMiscFlag::TextureCube : GfxTextureMiscFlag::None;
-			if (srgb)
-			{
-				desc.misc_flags |= GfxTextureMiscFlag::SRGB;
-			}
-
-            std::vector<GfxTextureSubData> tex_data;
-			const Image* curr_img = &img;
-			while (curr_img)
-			{
-				for (Uint32 i = 0; i < desc.mip_levels; ++i)
-				{
-                    GfxTextureSubData& data = tex_data.emplace_back();
-					data.data = curr_img->MipData(i);
-					data.row_pitch = GetRowPitch(curr_img->Format(), desc.width, i);
-					data.slice_pitch = GetSlicePitch(img.Format(), desc.width, desc.height, i);
-				}
-                curr_img = curr_img->NextImage();
-			}
-
-			GfxTextureData init_data{};
-			init_data.sub_data = tex_data.data();
-			init_data.sub_count = (Uint32)tex_data.size();
-            std::unique_ptr<GfxTexture> tex = gfx->CreateTexture(desc, init_data);
-
-            texture_map[handle] = std::move(tex);
+            texture_map[handle] = CreateTexture(path, srgb);
 			CreateViewForTexture(handle);
 			return handle;
         }
 	    else return it->second;
     }
 
+	TextureHandle TextureManager::LoadTextureAsync(std::string_view path, Bool srgb, TextureHandle placeholder)
+	{
+		if (!TextureStreaming.Get()) return LoadTexture(path, srgb);
+
+		std::string texture_name(path);
+		if (auto it = loaded_textures.find(texture_name); it == loaded_textures.end())
+		{
+			++handle;
+			loaded_textures.insert({ texture_name, handle });
+			streaming_placeholders[handle] = placeholder;
+			texture_streamer->Request(TextureStreamRequest{ .handle = handle, .path = std::move(texture_name), .srgb = srgb });
+			CreatePlaceholderView(handle);
+			return handle;
+		}
+		else return it->second;
+	}
+
+	Bool TextureManager::ReloadTexture(std::string_view path)
+	{
+		std::string const normalized_path = NormalizePath(path);
+		for (auto const& [texture_name, texture_handle] : loaded_textures)
+		{
+			if (NormalizePath(texture_name) != normalized_path) continue;
+			if (!texture_map[texture_handle]) return false;
+
+			Bool const srgb = HasFlag(texture_map[texture_handle]->GetDesc().misc_flags, GfxTextureMiscFlag::SRGB);
+			texture_map[texture_handle] = CreateTexture(texture_name, srgb);
+			CreateViewForTexture(texture_handle);
+			ADRIA_LOG(INFO, "Reloaded texture %s", texture_name.c_str());
+			return true;
+		}
+		return false;
+	}
+
 	TextureHandle TextureManager::LoadCubemap(std::array<std::string, 6> const& cubemap_textures)
 	{
 		++handle;
@@ -126,6 +336,7 @@ namespace adria
 
 	GfxDescriptor TextureManager::GetSRV(TextureHandle tex_handle)
 	{
+		if (auto it = streaming_placeholders.find(tex_handle); it != streaming_placeholders.end()) return GetPlaceholderSRV(it->second);
 		return texture_srv_map[tex_handle];
 	}
 
@@ -157,6 +368,56 @@ namespace adria
             }
         }
         is_scene_initialized = true;
+		for (auto const& [streaming_handle, placeholder] : streaming_placeholders)
+		{
+			CreatePlaceholderView(streaming_handle);
+		}
+	}
+
+	void TextureManager::Update()
+	{
+		texture_streamer->Update();
+
+		Uint64 const frame_index = gfx->GetFrameIndex();
+		while (!pending_texture_views.empty() && pending_texture_views.front().frame_index <= frame_index)
+		{
+			TextureHandle const streamed_handle = pending_texture_views.front().handle;
+			pending_texture_views.pop_front();
+			streaming_placeholders.erase(streamed_handle);
+			CreateViewForTexture(streamed_handle);
+		}
+	}
+
+	void TextureManager::GUI()
+	{
+		QueueGUI([&]()
+			{
+				if (ImGui::TreeNode("Texture Streaming"))
+				{
+					TextureStreamerStats stats = GetStreamingStats();
+					ImGui::Text("Queue Depth: %llu (Decoding: %llu)", stats.GetQueueDepth(), stats.decoding_count);
+					ImGui::Text("Uploads In Flight: %llu, %.2f MB", stats.uploading_count, stats.bytes_in_flight / (1024.0f * 1024.0f));
+					ImGui::Text("Completed: %llu, Failed: %llu", stats.completed_count, stats.failed_count);
+					ImGui::TreePop();
+				}
+			}, GUICommandGroup_Renderer);
+	}
+
+	TextureStreamerStats TextureManager::GetStreamingStats() const
+	{
+		return texture_streamer->GetStats();
+	}
+
+	std::unique_ptr<GfxTexture> TextureManager::CreateTexture(std::string_view path, Bool srgb)
+	{
+		Image img(path);
+		GfxTextureDesc desc = GetTextureDesc(img, srgb);
+		std::vector<GfxTextureSubData> tex_data = GetTextureSubData(img, desc);
+
+		GfxTextureData init_data{};
+		init_data.sub_data = tex_data.data();
+		init_data.sub_count = (Uint32)tex_data.size();
+		return gfx->CreateTexture(desc, init_data);
 	}
 
 	void TextureManager::CreateViewForTexture(TextureHandle handle, Bool flag)
@@ -165,8 +426,25 @@ namespace adria
 
 		GfxTexture* texture = texture_map[handle].get();
 		ADRIA_ASSERT(texture);
+		if (auto it = texture_srv_map.find(handle); it != texture_srv_map.end())
+		{
+			gfx->FreeDescriptorCPU(it->second, GfxDescriptorHeapType::CBV_SRV_UAV);
+		}
         texture_srv_map[handle] = gfx->CreateTextureSRV(texture);
         gfx->CopyDescriptors(1, gfx->GetDescriptorGPU((Uint32)handle), texture_srv_map[handle]);
 	}
 
+	void TextureManager::CreatePlaceholderView(TextureHandle handle)
+	{
+		if (!is_scene_initialized) return;
+		gfx->CopyDescriptors(1, gfx->GetDescriptorGPU((Uint32)handle), GetPlaceholderSRV(streaming_placeholders[handle]));
+	}
+
+	//frames in flight were recorded with the placeholder in the handle's descriptor slot, so the slot is only overwritten once they retired
+	void TextureManager::OnTextureStreamed(TextureHandle handle, std::unique_ptr<GfxTexture>&& texture)
+	{
+		texture_map[handle] = std::move(texture);
+		pending_texture_views.push_back(PendingTextureView{ handle, (Uint64)gfx->GetFrameIndex() + gfx->GetBackbufferCount() });
+	}
+
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <deque>
 #include "TextureHandle.h"
 #include "Graphics/GfxDescriptor.h"
 #include "Utilities/Singleton.h"
@@ -8,12 +9,21 @@ namespace adria
 {
 	class GfxDevice;
 	class GfxTexture;
+	class TextureUploader;
+	class TextureStreamer;
+	struct TextureStreamerStats;
 
 	class TextureManager : public Singleton<TextureManager>
 	{
 		friend class Singleton<TextureManager>;
 		using TextureName = std::string;
 
+		struct PendingTextureView
+		{
+			TextureHandle handle;
+			Uint64 frame_index;
+		};
+
 	public:
 
 		void Initialize(GfxDevice* gfx);
@@ -21,11 +31,19 @@ namespace adria
 		void Destroy();
 
 		ADRIA_NODISCARD TextureHandle LoadTexture(std::string_view path, Bool srgb = false);
+		//returns immediately, until the texture is decoded and uploaded the handle's descriptor is the placeholder's
+		ADRIA_NODISCARD TextureHandle LoadTextureAsync(std::string_view path, Bool srgb = false, TextureHandle placeholder = DEFAULT_WHITE_TEXTURE_HANDLE);
 		ADRIA_NODISCARD TextureHandle LoadCubemap(std::array<std::string, 6> const& cubemap_textures);
+		//recreates a loaded texture from disk keeping its handle, the GPU must not be using it
+		Bool ReloadTexture(std::string_view path);
 		ADRIA_NODISCARD GfxDescriptor GetSRV(TextureHandle handle);
 		ADRIA_NODISCARD GfxTexture* GetTexture(TextureHandle handle) const;
 		void EnableMipMaps(Bool);
 		void OnSceneInitialized();
+		//finishes streamed uploads the GPU is done with and schedules new ones, called once per frame
+		void Update();
+		void GUI();
+		TextureStreamerStats GetStreamingStats() const;
 
 	private:
 		GfxDevice* gfx = nullptr;
@@ -33,6 +51,10 @@ namespace adria
 		std::unordered_map<TextureName, TextureHandle> loaded_textures;
 		std::unordered_map<TextureHandle, std::unique_ptr<GfxTexture>> texture_map;
 		std::unordered_map<TextureHandle, GfxDescriptor> texture_srv_map;
+		std::unordered_map<TextureHandle, TextureHandle> streaming_placeholders;
+		std::deque<PendingTextureView> pending_texture_views;
+		std::unique_ptr<TextureUploader> texture_uploader;
+		std::unique_ptr<TextureStreamer> texture_streamer;
 		TextureHandle handle = TEXTURE_MANAGER_START_HANDLE;
 		Bool enable_mipmaps = true;
 		Bool is_scene_initialized = false;
@@ -41,7 +63,10 @@ namespace adria
 		TextureManager();
 		~TextureManager();
 
+		std::unique_ptr<GfxTexture> CreateTexture(std::string_view path, Bool srgb);
 		void CreateViewForTexture(TextureHandle handle, Bool flag = false);
+		void CreatePlaceholderView(TextureHandle handle);
+		void OnTextureStreamed(TextureHandle handle, std::unique_ptr<GfxTexture>&& texture);
 	};
 	#define g_TextureManager TextureManager::Get()
 
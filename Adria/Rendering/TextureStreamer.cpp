@@ -0,0 +1,146 @@
+#include "TextureStreamer.h"
+#include "Utilities/Image.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria
+{
+	TextureStreamer::TextureStreamer(TextureStreamerDesc const& desc, ITextureUploader& uploader, DecodeFunction&& decode_function)
+		: desc(desc), uploader(uploader), decode_function(std::move(decode_function)), staging_ring(desc.staging_size)
+	{
+		ADRIA_ASSERT(this->decode_function);
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		WaitForDecodeJobs();
+	}
+
+	void TextureStreamer::Request(TextureStreamRequest const& request)
+	{
+		queued_requests.push_back(request);
+	}
+
+	void TextureStreamer::Update()
+	{
+		Uint64 const completed_fence_value = uploader.GetCompletedFenceValue();
+		while (!uploads.empty() && uploads.front().fence_value <= completed_fence_value)
+		{
+			Upload const& upload = uploads.front();
+			bytes_in_flight -= upload.staging_size;
+			++completed_count;
+			uploader.OnUploadCompleted(upload.request);
+			uploads.pop_front();
+		}
+		staging_ring.ReleaseCompletedFrames(completed_fence_value);
+
+		std::erase_if(decode_jobs, [](std::future<void> const& decode_job) { return decode_job.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+		Uint64 decoded_count = 0;
+		{
+			std::lock_guard lock(decoded_mutex);
+			decoded_count = decoded_textures.size();
+		}
+		//decoded images waiting for staging memory count against the limit, a full ring stops new decodes instead of piling up images
+		while (!queued_requests.empty() && decode_jobs.size() + decoded_count < desc.max_decodes_in_flight)
+		{
+			decode_jobs.push_back(g_ThreadPool.Submit([this, request = std::move(queued_requests.front()), generation = generation]() mutable
+				{
+					std::unique_ptr<Image> image = decode_function(request.path);
+					std::lock_guard lock(decoded_mutex);
+					decoded_textures.push_back(DecodedTexture{ std::move(request), std::move(image), generation });
+				}));
+			queued_requests.pop_front();
+		}
+
+		Uint64 const first_batch_upload = uploads.size();
+		while (uploads.size() - first_batch_upload < desc.max_uploads_per_update)
+		{
+			DecodedTexture decoded;
+			{
+				std::lock_guard lock(decoded_mutex);
+				if (decoded_textures.empty()) break;
+				decoded = std::move(decoded_textures.front());
+				decoded_textures.pop_front();
+			}
+			if (decoded.generation != generation) continue;
+			if (!decoded.image)
+			{
+				ADRIA_LOG(WARNING, "Could not decode texture %s, keeping its placeholder", decoded.request.path.c_str());
+				++failed_count;
+				continue;
+			}
+
+			Uint64 const staging_size = Align(uploader.GetStagingSize(decoded.request, *decoded.image), desc.staging_alignment);
+			Uint64 staging_offset = INVALID_ALLOC_OFFSET;
+			if (staging_size <= staging_ring.MaxSize())
+			{
+				staging_offset = staging_ring.Allocate(staging_size);
+				if (staging_offset == INVALID_ALLOC_OFFSET && staging_ring.Empty())
+				{
+					//an empty ring can still fail to fit a large texture because of where its head stopped
+					staging_ring = RingOffsetAllocator(desc.staging_size);
+					staging_offset = staging_ring.Allocate(staging_size);
+				}
+				if (staging_offset == INVALID_ALLOC_OFFSET)
+				{
+					//the ring is full, the texture waits until the GPU finished earlier uploads
+					std::lock_guard lock(decoded_mutex);
+					decoded_textures.push_front(std::move(decoded));
+					break;
+				}
+			}
+
+			uploader.Upload(decoded.request, *decoded.image, staging_offset);
+			bytes_in_flight += staging_size;
+			uploads.push_back(Upload{ std::move(decoded.request), staging_size, 0 });
+		}
+
+		if (uploads.size() > first_batch_upload)
+		{
+			Uint64 const fence_value = uploader.Submit();
+			staging_ring.FinishCurrentFrame(fence_value);
+			for (Uint64 i = first_batch_upload; i < uploads.size(); ++i) uploads[i].fence_value = fence_value;
+		}
+	}
+
+	void TextureStreamer::Clear()
+	{
+		++generation;
+		queued_requests.clear();
+		WaitForDecodeJobs();
+		{
+			std::lock_guard lock(decoded_mutex);
+			decoded_textures.clear();
+		}
+		uploads.clear();
+		staging_ring = RingOffsetAllocator(desc.staging_size);
+		bytes_in_flight = 0;
+	}
+
+	Bool TextureStreamer::IsIdle() const
+	{
+		std::lock_guard lock(decoded_mutex);
+		return queued_requests.empty() && decode_jobs.empty() && decoded_textures.empty() && uploads.empty();
+	}
+
+	TextureStreamerStats TextureStreamer::GetStats() const
+	{
+		TextureStreamerStats stats{};
+		stats.queued_count = queued_requests.size();
+		stats.decoding_count = decode_jobs.size();
+		{
+			std::lock_guard lock(decoded_mutex);
+			stats.decoded_count = decoded_textures.size();
+		}
+		stats.uploading_count = uploads.size();
+		stats.bytes_in_flight = bytes_in_flight;
+		stats.completed_count = completed_count;
+		stats.failed_count = failed_count;
+		return stats;
+	}
+
+	void TextureStreamer::WaitForDecodeJobs()
+	{
+		for (std::future<void>& decode_job : decode_jobs) decode_job.wait();
+		decode_jobs.clear();
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <deque>
+#include <future>
+#include "TextureHandle.h"
+#include "Utilities/RingOffsetAllocator.h"
+
+namespace adria
+{
+	class Image;
+
+	struct TextureStreamRequest
+	{
+		TextureHandle handle = INVALID_TEXTURE_HANDLE;
+		std::string path;
+		Bool srgb = false;
+	};
+
+	struct TextureStreamerDesc
+	{
+		Uint64 staging_size = 64 * 1024 * 1024;
+		Uint64 staging_alignment = 512;
+		Uint32 max_decodes_in_flight = 16;	//decoding and decoded images that were not uploaded yet
+		Uint32 max_uploads_per_update = 32;
+	};
+
+	struct TextureStreamerStats
+	{
+		Uint64 queued_count = 0;
+		Uint64 decoding_count = 0;
+		Uint64 decoded_count = 0;
+		Uint64 uploading_count = 0;
+		Uint64 bytes_in_flight = 0;
+		Uint64 completed_count = 0;
+		Uint64 failed_count = 0;
+
+		Uint64 GetQueueDepth() const { return queued_count + decoding_count + decoded_count; }
+	};
+
+	//the GPU side of texture streaming, uploads are recorded into batches that complete when a fence value is reached
+	class ITextureUploader
+	{
+	public:
+		virtual ~ITextureUploader() = default;
+
+		virtual Uint64 GetStagingSize(TextureStreamRequest const& request, Image const& image) = 0;
+		//staging_offset is INVALID_ALLOC_OFFSET for images that don't fit into the staging ring, they need their own staging memory
+		virtual void Upload(TextureStreamRequest const& request, Image const& image, Uint64 staging_offset) = 0;
+		//submits the uploads recorded since the last call and returns the fence value signaled when they are done
+		virtual Uint64 Submit() = 0;
+		virtual Uint64 GetCompletedFenceValue() const = 0;
+		virtual void OnUploadCompleted(TextureStreamRequest const& request) = 0;
+	};
+
+	//decodes requested textures on g_ThreadPool and feeds them to an ITextureUploader through a bounded staging ring
+	//everything except the decode jobs runs on the thread calling Update, no GPU access happens here directly
+	class TextureStreamer
+	{
+		struct DecodedTexture
+		{
+			TextureStreamRequest request;
+			std::unique_ptr<Image> image;
+			Uint64 generation = 0;
+		};
+
+		struct Upload
+		{
+			TextureStreamRequest request;
+			Uint64 staging_size = 0;
+			Uint64 fence_value = 0;
+		};
+
+	public:
+		//decode_function runs on g_ThreadPool and returns nullptr if the image could not be decoded
+		using DecodeFunction = std::function<std::unique_ptr<Image>(std::string const&)>;
+
+		TextureStreamer(TextureStreamerDesc const& desc, ITextureUploader& uploader, DecodeFunction&& decode_function);
+		ADRIA_NONCOPYABLE_NONMOVABLE(TextureStreamer)
+		~TextureStreamer();
+
+		void Request(TextureStreamRequest const& request);
+		void Update();
+		//drops all requests that were not submitted yet, the uploader has to be idle
+		void Clear();
+
+		Bool IsIdle() const;
+		TextureStreamerStats GetStats() const;
+
+	private:
+		TextureStreamerDesc desc;
+		ITextureUploader& uploader;
+		DecodeFunction decode_function;
+		RingOffsetAllocator staging_ring;
+
+		std::deque<TextureStreamRequest> queued_requests;
+		std::vector<std::future<void>> decode_jobs;
+		mutable std::mutex decoded_mutex;
+		std::deque<DecodedTexture> decoded_textures;
+		std::deque<Upload> uploads;
+		Uint64 generation = 0;
+
+		Uint64 bytes_in_flight = 0;
+		Uint64 completed_count = 0;
+		Uint64 failed_count = 0;
+
+	private:
+		void WaitForDecodeJobs();
+	};
+}
@@ -120,10 +120,11 @@ namespace adria
 					}
 					cmd_list->SetRootConstants(1, constants);
 
-					GfxIndexBufferView ibv(batch.submesh->buffer_address + batch.submesh->indices_offset, batch.submesh->indices_count);
+					SubMeshLOD const& lod = batch.submesh->lods[batch.lod];
+					GfxIndexBufferView ibv(batch.submesh->buffer_address + lod.indices_offset, lod.indices_count, batch.submesh->index_format);
 					cmd_list->SetTopology(batch.submesh->topology);
 					cmd_list->SetIndexBuffer(&ibv);
-					cmd_list->DrawIndexed(batch.submesh->indices_count);
+					cmd_list->DrawIndexed(lod.indices_count);
 				}
 			}, RGPassType::Graphics, RGPassFlags::None);
 	}
@@ -0,0 +1,56 @@
+#include "VertexQuantization.h"
+#include "Math/Packing.h"
+
+namespace adria
+{
+	namespace
+	{
+		Vector3 GetQuantizationScale(BoundingBox const& bounding_box)
+		{
+			Vector3 const extents(bounding_box.Extents);
+			return Vector3(extents.x > 0.0f ? 1.0f / extents.x : 0.0f, extents.y > 0.0f ? 1.0f / extents.y : 0.0f, extents.z > 0.0f ? 1.0f / extents.z : 0.0f);
+		}
+	}
+
+	void QuantizeVertices(BoundingBox const& bounding_box, std::span<Vector3 const> positions, std::span<Vector2 const> uvs,
+		std::span<Vector3 const> normals, std::span<Vector4 const> tangents, QuantizedVertexStreams const& quantized_streams)
+	{
+		ADRIA_ASSERT(uvs.size() == positions.size() && normals.size() == positions.size() && tangents.size() == positions.size());
+		Vector3 const center(bounding_box.Center);
+		Vector3 const scale = GetQuantizationScale(bounding_box);
+		for (Uint64 i = 0; i < positions.size(); ++i)
+		{
+			Vector3 const position = (positions[i] - center) * scale;
+			Vector4 const& tangent = tangents[i];
+			quantized_streams.positions[4 * i + 0] = PackSnorm16(position.x);
+			quantized_streams.positions[4 * i + 1] = PackSnorm16(position.y);
+			quantized_streams.positions[4 * i + 2] = PackSnorm16(position.z);
+			quantized_streams.positions[4 * i + 3] = tangent.w < 0.0f ? -32767 : 32767;
+
+			quantized_streams.uvs[i] = PackTwoFloatsToUint32(uvs[i].x, uvs[i].y);
+
+			Vector2 const normal = EncodeNormalOctahedron(normals[i]);
+			quantized_streams.normals[2 * i + 0] = PackSnorm16(normal.x);
+			quantized_streams.normals[2 * i + 1] = PackSnorm16(normal.y);
+
+			Vector2 const tangent_direction = EncodeNormalOctahedron(Vector3(tangent.x, tangent.y, tangent.z));
+			quantized_streams.tangents[2 * i + 0] = PackSnorm16(tangent_direction.x);
+			quantized_streams.tangents[2 * i + 1] = PackSnorm16(tangent_direction.y);
+		}
+	}
+
+	DequantizedVertex DequantizeVertex(BoundingBox const& bounding_box, QuantizedVertexStreams const& quantized_streams, Uint64 vertex)
+	{
+		Int16 const* position = quantized_streams.positions + 4 * vertex;
+		Int16 const* normal = quantized_streams.normals + 2 * vertex;
+		Int16 const* tangent = quantized_streams.tangents + 2 * vertex;
+
+		DequantizedVertex dequantized{};
+		dequantized.position = Vector3(bounding_box.Center) + Vector3(UnpackSnorm16(position[0]), UnpackSnorm16(position[1]), UnpackSnorm16(position[2])) * Vector3(bounding_box.Extents);
+		dequantized.uv = UnpackTwoFloatsFromUint32(quantized_streams.uvs[vertex]);
+		dequantized.normal = DecodeNormalOctahedron(Vector2(UnpackSnorm16(normal[0]), UnpackSnorm16(normal[1])));
+		Vector3 const tangent_direction = DecodeNormalOctahedron(Vector2(UnpackSnorm16(tangent[0]), UnpackSnorm16(tangent[1])));
+		dequantized.tangent = Vector4(tangent_direction.x, tangent_direction.y, tangent_direction.z, UnpackSnorm16(position[3]));
+		return dequantized;
+	}
+}
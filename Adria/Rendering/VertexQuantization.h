@@ -0,0 +1,27 @@
+#pragma once
+#include <span>
+
+namespace adria
+{
+	//the streams of a quantized submesh, decoded by LoadMeshPosition, LoadMeshUV, LoadMeshNormal and LoadMeshTangent in Scene.hlsli
+	struct QuantizedVertexStreams
+	{
+		Int16*  positions;	//snorm16x4, xyz relative to the bounding box and the tangent handedness in w
+		Uint32* uvs;		//half2
+		Int16*  normals;	//snorm16x2 octahedron
+		Int16*  tangents;	//snorm16x2 octahedron
+	};
+
+	struct DequantizedVertex
+	{
+		Vector3 position;
+		Vector2 uv;
+		Vector3 normal;
+		Vector4 tangent;
+	};
+
+	//all source streams have the same number of vertices, bounding_box has to contain the positions
+	void QuantizeVertices(BoundingBox const& bounding_box, std::span<Vector3 const> positions, std::span<Vector2 const> uvs,
+		std::span<Vector3 const> normals, std::span<Vector4 const> tangents, QuantizedVertexStreams const& quantized_streams);
+	DequantizedVertex DequantizeVertex(BoundingBox const& bounding_box, QuantizedVertexStreams const& quantized_streams, Uint64 vertex);
+}
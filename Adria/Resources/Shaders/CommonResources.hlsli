@@ -51,6 +51,8 @@ struct FrameCBuffer
 	int    sheenEIdx;
 	int    triangleOverdrawIdx;
 	float  rainTotalTime;
+	int    meshBuffersIdx;
+	float  meshLODErrorScale;
 };
 ConstantBuffer<FrameCBuffer> FrameCB  : register(b0);
 
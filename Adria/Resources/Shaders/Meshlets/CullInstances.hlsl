@@ -25,6 +25,22 @@ struct CullInstancesConstants
 };
 ConstantBuffer<CullInstancesConstants> CullInstancesPassCB : register(b1);
 
+//same selection as Renderer::SelectMeshLODs: the coarsest LOD whose error projects below the threshold at the distance of the instance bounds
+uint SelectLOD(Mesh mesh, Instance instance)
+{
+	if (FrameCB.meshLODErrorScale <= 0.0f) return 0;
+
+	float3 axisScale = float3(length(instance.worldMatrix[0].xyz), length(instance.worldMatrix[1].xyz), length(instance.worldMatrix[2].xyz));
+	float maxScale = max(axisScale.x, axisScale.y, axisScale.z);
+	float3 worldCenter = mul(float4(instance.bbOrigin, 1.0f), instance.worldMatrix).xyz;
+	float radius = length(instance.bbExtents * axisScale);
+	float viewDistance = max(length(worldCenter - FrameCB.cameraPosition.xyz) - radius, FrameCB.cameraNear);
+
+	uint lod = 0;
+	while (lod + 1 < mesh.lodCount && mesh.lods[lod + 1].error * maxScale * FrameCB.meshLODErrorScale <= viewDistance) ++lod;
+	return lod;
+}
+
 [numthreads(BLOCK_SIZE, 1, 1)]
 void CullInstancesCS(uint ThreadId : SV_DispatchThreadID)
 {
@@ -85,10 +101,12 @@ void CullInstancesCS(uint ThreadId : SV_DispatchThreadID)
 		RWBuffer<uint> candidateMeshletsCounter = ResourceDescriptorHeap[CullInstancesPassCB.candidateMeshletsCounterIdx];
 		RWStructuredBuffer<MeshletCandidate> candidateMeshletsBuffer = ResourceDescriptorHeap[CullInstancesPassCB.candidateMeshletsIdx];
 
+		MeshLOD lod = mesh.lods[SelectLOD(mesh, instance)];
+
 		uint globalMeshletIndex;
-		InterlockedAdd(candidateMeshletsCounter[COUNTER_TOTAL_CANDIDATE_MESHLETS], mesh.meshletCount, globalMeshletIndex);
+		InterlockedAdd(candidateMeshletsCounter[COUNTER_TOTAL_CANDIDATE_MESHLETS], lod.meshletCount, globalMeshletIndex);
 
-		uint clampedNumMeshlets = min(globalMeshletIndex + mesh.meshletCount, MAX_NUM_MESHLETS);
+		uint clampedNumMeshlets = min(globalMeshletIndex + lod.meshletCount, MAX_NUM_MESHLETS);
 		uint numMeshletsToAdd = max(clampedNumMeshlets - globalMeshletIndex, 0);
 
 		uint elementOffset;
@@ -101,7 +119,7 @@ void CullInstancesCS(uint ThreadId : SV_DispatchThreadID)
 		{
 			MeshletCandidate meshlet;
 			meshlet.instanceID = instance.instanceId;
-			meshlet.meshletIndex = i;
+			meshlet.meshletIndex = lod.meshletStart + i;
 			candidateMeshletsBuffer[elementOffset + i] = meshlet;
 		}
 	}
@@ -209,7 +209,7 @@ struct Meshlet
 
 Meshlet GetMeshletData(uint bufferIdx, uint bufferOffset, uint meshletIdx)
 {
-	ByteAddressBuffer meshBuffer = ResourceDescriptorHeap[bufferIdx];
+	ByteAddressBuffer meshBuffer = ResourceDescriptorHeap[FrameCB.meshBuffersIdx + bufferIdx];
 	return meshBuffer.Load<Meshlet>(bufferOffset + sizeof(Meshlet) * meshletIdx);
 }
 
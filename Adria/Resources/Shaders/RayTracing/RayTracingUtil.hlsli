@@ -92,13 +92,13 @@ bool TraceRay(RayDesc ray, out HitInfo hitInfo)
 		Mesh meshData = GetMeshData(instanceData.meshIndex);
 		Material materialData = GetMaterialData(instanceData.materialIdx);
 
-		uint i0 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleId + 0);
-		uint i1 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleId + 1);
-		uint i2 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleId + 2);
+		uint i0 = LoadMeshIndex(meshData, 3 * triangleId + 0);
+		uint i1 = LoadMeshIndex(meshData, 3 * triangleId + 1);
+		uint i2 = LoadMeshIndex(meshData, 3 * triangleId + 2);
 
-		float2 uv0 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i0);
-		float2 uv1 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i1);
-		float2 uv2 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i2);
+		float2 uv0 = LoadMeshUV(meshData, i0);
+		float2 uv1 = LoadMeshUV(meshData, i1);
+		float2 uv2 = LoadMeshUV(meshData, i2);
 		float2 uv = Interpolate(uv0, uv1, uv2, q.CandidateTriangleBarycentrics());
 
 		Texture2D albedoTexture = ResourceDescriptorHeap[materialData.diffuseIdx];
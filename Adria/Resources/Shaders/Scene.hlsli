@@ -1,6 +1,19 @@
 #ifndef _SCENE_
 #define _SCENE_
 #include "CommonResources.hlsli"
+#include "Packing.hlsli"
+
+#define MESH_MAX_LODS 6
+
+#define MESH_FLAG_QUANTIZED     0x1
+#define MESH_FLAG_SHORT_INDICES 0x2
+
+struct MeshLOD
+{
+	uint  meshletStart;
+	uint  meshletCount;
+	float error;
+};
 
 struct Mesh
 {
@@ -14,6 +27,11 @@ struct Mesh
 	uint meshletVerticesOffset;
 	uint meshletTrianglesOffset;
 	uint meshletCount;
+	uint lodCount;
+	MeshLOD lods[MESH_MAX_LODS];
+	uint flags;
+	float3 positionOffset;
+	float3 positionScale;
 };
 
 
@@ -89,10 +107,71 @@ Material GetMaterialData(uint materialIdx)
 template<typename T>
 T LoadMeshBuffer(uint bufferIdx, uint bufferOffset, uint vertexId)
 {
-	ByteAddressBuffer meshBuffer = ResourceDescriptorHeap[bufferIdx];
+	ByteAddressBuffer meshBuffer = ResourceDescriptorHeap[FrameCB.meshBuffersIdx + bufferIdx];
 	return meshBuffer.Load<T>(bufferOffset + sizeof(T) * vertexId);
 }
 
+float2 UnpackSnorm16x2(uint packed)
+{
+	int2 unpacked = int2(int(packed << 16) >> 16, int(packed) >> 16);
+	return max(unpacked / 32767.0f, -1.0f);
+}
+
+//short indices are packed in pairs, byte address buffers can only be read at 4 byte granularity
+uint LoadMeshIndex(Mesh mesh, uint indexId)
+{
+	if (mesh.flags & MESH_FLAG_SHORT_INDICES)
+	{
+		ByteAddressBuffer meshBuffer = ResourceDescriptorHeap[FrameCB.meshBuffersIdx + mesh.bufferIdx];
+		uint byteOffset = mesh.indicesOffset + 2 * indexId;
+		uint packedIndices = meshBuffer.Load(byteOffset & ~3u);
+		return (byteOffset & 2) ? (packedIndices >> 16) : (packedIndices & 0xffff);
+	}
+	return LoadMeshBuffer<uint>(mesh.bufferIdx, mesh.indicesOffset, indexId);
+}
+
+//quantized positions are relative to the bounding box of the submesh
+float3 LoadMeshPosition(Mesh mesh, uint vertexId)
+{
+	if (mesh.flags & MESH_FLAG_QUANTIZED)
+	{
+		uint2 packedPosition = LoadMeshBuffer<uint2>(mesh.bufferIdx, mesh.positionsOffset, vertexId);
+		float3 position = float3(UnpackSnorm16x2(packedPosition.x), UnpackSnorm16x2(packedPosition.y).x);
+		return mesh.positionOffset + position * mesh.positionScale;
+	}
+	return LoadMeshBuffer<float3>(mesh.bufferIdx, mesh.positionsOffset, vertexId);
+}
+
+float2 LoadMeshUV(Mesh mesh, uint vertexId)
+{
+	if (mesh.flags & MESH_FLAG_QUANTIZED)
+	{
+		return UnpackHalf2(LoadMeshBuffer<uint>(mesh.bufferIdx, mesh.uvsOffset, vertexId));
+	}
+	return LoadMeshBuffer<float2>(mesh.bufferIdx, mesh.uvsOffset, vertexId);
+}
+
+float3 LoadMeshNormal(Mesh mesh, uint vertexId)
+{
+	if (mesh.flags & MESH_FLAG_QUANTIZED)
+	{
+		return DecodeNormalOctahedron(UnpackSnorm16x2(LoadMeshBuffer<uint>(mesh.bufferIdx, mesh.normalsOffset, vertexId)));
+	}
+	return LoadMeshBuffer<float3>(mesh.bufferIdx, mesh.normalsOffset, vertexId);
+}
+
+//the handedness of quantized tangents is stored in the w component of the position
+float4 LoadMeshTangent(Mesh mesh, uint vertexId)
+{
+	if (mesh.flags & MESH_FLAG_QUANTIZED)
+	{
+		float3 tangent = DecodeNormalOctahedron(UnpackSnorm16x2(LoadMeshBuffer<uint>(mesh.bufferIdx, mesh.tangentsOffset, vertexId)));
+		float handedness = UnpackSnorm16x2(LoadMeshBuffer<uint2>(mesh.bufferIdx, mesh.positionsOffset, vertexId).y).y;
+		return float4(tangent, handedness);
+	}
+	return LoadMeshBuffer<float4>(mesh.bufferIdx, mesh.tangentsOffset, vertexId);
+}
+
 struct VertexData
 {
 	float3 pos;
@@ -111,23 +190,23 @@ float2 Interpolate(in float2 x0, in float2 x1, in float2 x2, float2 bary)
 
 VertexData LoadVertexData(Mesh meshData, uint triangleIndex, float2 barycentrics)
 {
-	uint i0 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 0);
-	uint i1 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 1);
-	uint i2 = LoadMeshBuffer<uint>(meshData.bufferIdx, meshData.indicesOffset, 3 * triangleIndex + 2);
+	uint i0 = LoadMeshIndex(meshData, 3 * triangleIndex + 0);
+	uint i1 = LoadMeshIndex(meshData, 3 * triangleIndex + 1);
+	uint i2 = LoadMeshIndex(meshData, 3 * triangleIndex + 2);
 
-	float3 pos0 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i0);
-	float3 pos1 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i1);
-	float3 pos2 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.positionsOffset, i2);
+	float3 pos0 = LoadMeshPosition(meshData, i0);
+	float3 pos1 = LoadMeshPosition(meshData, i1);
+	float3 pos2 = LoadMeshPosition(meshData, i2);
 	float3 pos = Interpolate(pos0, pos1, pos2, barycentrics);
 
-	float2 uv0 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i0);
-	float2 uv1 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i1);
-	float2 uv2 = LoadMeshBuffer<float2>(meshData.bufferIdx, meshData.uvsOffset, i2);
+	float2 uv0 = LoadMeshUV(meshData, i0);
+	float2 uv1 = LoadMeshUV(meshData, i1);
+	float2 uv2 = LoadMeshUV(meshData, i2);
 	float2 uv = Interpolate(uv0, uv1, uv2, barycentrics);
 
-	float3 nor0 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i0);
-	float3 nor1 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i1);
-	float3 nor2 = LoadMeshBuffer<float3>(meshData.bufferIdx, meshData.normalsOffset, i2);
+	float3 nor0 = LoadMeshNormal(meshData, i0);
+	float3 nor1 = LoadMeshNormal(meshData, i1);
+	float3 nor2 = LoadMeshNormal(meshData, i2);
 	float3 nor = normalize(Interpolate(nor0, nor1, nor2, barycentrics));
 
 	VertexData vertex = (VertexData)0;
@@ -15,44 +15,44 @@ namespace adria
 	constexpr Bool EnableEnumBitmaskOperators = EnumBitmaskOperators<E>::enable;
 
 	template <typename E>
-	typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator|(E lhs, E rhs) 
+	constexpr typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator|(E lhs, E rhs) 
 	{
 		using T = std::underlying_type_t<E>;
 		return static_cast<E>(static_cast<T>(lhs) | static_cast<T>(rhs));
 	}
 	template <typename E>
-	typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator&(E lhs, E rhs)
+	constexpr typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator&(E lhs, E rhs)
 	{
 		using T = std::underlying_type_t<E>;
 		return static_cast<E>(static_cast<T>(lhs) & static_cast<T>(rhs));
 	}
 	template <typename E>
-	typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator^(E lhs, E rhs)
+	constexpr typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator^(E lhs, E rhs)
 	{
 		using T = std::underlying_type_t<E>;
 		return static_cast<E>(static_cast<T>(lhs) ^ static_cast<T>(rhs));
 	}
 	template <typename E>
-	typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator~(E e)
+	constexpr typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E> operator~(E e)
 	{
 		using T = std::underlying_type_t<E>;
 		return static_cast<E>(~static_cast<T>(e));
 	}
 
 	template <typename E>
-	typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E&> operator|=(E& lhs, E rhs)
+	constexpr typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E&> operator|=(E& lhs, E rhs)
 	{
 		using T = std::underlying_type_t<E>;
 		return lhs = static_cast<E>(static_cast<T>(lhs) | static_cast<T>(rhs));
 	}
 	template <typename E>
-	typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E&> operator&=(E& lhs, E rhs)
+	constexpr typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E&> operator&=(E& lhs, E rhs)
 	{
 		using T = std::underlying_type_t<E>;
 		return lhs = static_cast<E>(static_cast<T>(lhs) & static_cast<T>(rhs));
 	}
 	template <typename E>
-	typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E&> operator^=(E& lhs, E rhs)
+	constexpr typename std::enable_if_t<EnableEnumBitmaskOperators<E>, E&> operator^=(E& lhs, E rhs)
 	{
 		using T = std::underlying_type_t<E>;
 		return lhs = static_cast<E>(static_cast<T>(lhs) ^ static_cast<T>(rhs));
@@ -0,0 +1,179 @@
+#include "FileWatcher.h"
+#include "FilesUtil.h"
+#include "StringUtil.h"
+
+namespace fs = std::filesystem;
+
+namespace adria
+{
+	struct FileWatcher::WatchedDirectory
+	{
+		std::string path;
+		Bool recursive = true;
+		HANDLE directory_handle = INVALID_HANDLE_VALUE;
+		HANDLE stop_event = nullptr;
+		std::thread thread;
+	};
+
+	FileWatcher::FileWatcher(std::chrono::milliseconds debounce_window) : debounce_window(debounce_window)
+	{
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		for (std::unique_ptr<WatchedDirectory>& directory : watched_directories)
+		{
+			SetEvent(directory->stop_event);
+			if (directory->thread.joinable()) directory->thread.join();
+			CloseHandle(directory->stop_event);
+			CloseHandle(directory->directory_handle);
+		}
+		file_modified_event.RemoveAll();
+		files_modified_event.RemoveAll();
+	}
+
+	void FileWatcher::AddPathToWatch(std::string const& path, Bool recursive)
+	{
+		std::wstring wide_path = ToWideString(path);
+		HANDLE directory_handle = CreateFileW(wide_path.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+											  nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (directory_handle == INVALID_HANDLE_VALUE)
+		{
+			ADRIA_LOG(WARNING, "Could not watch directory %s for changes, falling back to polling", path.c_str());
+			AddPolledPath(path, recursive);
+			return;
+		}
+
+		std::unique_ptr<WatchedDirectory>& directory = watched_directories.emplace_back(std::make_unique<WatchedDirectory>());
+		directory->path = path;
+		directory->recursive = recursive;
+		directory->directory_handle = directory_handle;
+		directory->stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		directory->thread = std::thread(&FileWatcher::WatchDirectory, this, std::ref(*directory));
+	}
+
+	void FileWatcher::CheckWatchedFiles()
+	{
+		std::vector<std::string> changed_files;
+		{
+			std::lock_guard lock(pending_mutex);
+			if (!pending_files.empty() && Clock::now() - last_change_time >= debounce_window)
+			{
+				changed_files.assign(pending_files.begin(), pending_files.end());
+				pending_files.clear();
+			}
+		}
+
+		last_poll_time = Clock::now();
+		for (auto& [file, last_write_time] : polled_files)
+		{
+			std::error_code error;
+			fs::file_time_type current_last_write_time = fs::last_write_time(file, error);
+			if (!error && current_last_write_time != last_write_time)
+			{
+				last_write_time = current_last_write_time;
+				changed_files.push_back(file);
+			}
+		}
+
+		//notifications also arrive for directories and for files that were deleted again during the burst
+		std::erase_if(changed_files, [](std::string const& file)
+			{
+				std::error_code error;
+				return !fs::is_regular_file(file, error);
+			});
+		if (changed_files.empty()) return;
+
+		std::sort(changed_files.begin(), changed_files.end());
+		changed_files.erase(std::unique(changed_files.begin(), changed_files.end()), changed_files.end());
+		for (std::string const& file : changed_files) file_modified_event.Broadcast(file);
+		files_modified_event.Broadcast(changed_files);
+	}
+
+	Bool FileWatcher::HasPendingChanges() const
+	{
+		Clock::time_point const now = Clock::now();
+		if (!polled_files.empty() && now - last_poll_time >= debounce_window) return true;
+
+		std::lock_guard lock(pending_mutex);
+		return !pending_files.empty() && now - last_change_time >= debounce_window;
+	}
+
+	void FileWatcher::AddPolledPath(std::string const& path, Bool recursive)
+	{
+		if (recursive)
+		{
+			for (auto& entry : fs::recursive_directory_iterator(path))
+			{
+				if (entry.is_regular_file()) polled_files[NormalizePath(entry.path().string())] = fs::last_write_time(entry);
+			}
+		}
+		else
+		{
+			for (auto& entry : fs::directory_iterator(path))
+			{
+				if (entry.is_regular_file()) polled_files[NormalizePath(entry.path().string())] = fs::last_write_time(entry);
+			}
+		}
+	}
+
+	void FileWatcher::OnFileChanged(std::string file)
+	{
+		std::lock_guard lock(pending_mutex);
+		pending_files.insert(std::move(file));
+		last_change_time = Clock::now();
+	}
+
+	void FileWatcher::WatchDirectory(WatchedDirectory& directory)
+	{
+		alignas(DWORD) Uint8 buffer[32 * 1024];
+		OVERLAPPED overlapped{};
+		overlapped.hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+		DWORD const notify_filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+		std::string const directory_path = NormalizePath(directory.path);
+
+		while (true)
+		{
+			if (!ReadDirectoryChangesW(directory.directory_handle, buffer, sizeof(buffer), directory.recursive, notify_filter, nullptr, &overlapped, nullptr))
+			{
+				ADRIA_LOG(WARNING, "Watching directory %s for changes failed", directory.path.c_str());
+				break;
+			}
+
+			HANDLE wait_handles[] = { overlapped.hEvent, directory.stop_event };
+			DWORD wait_result = WaitForMultipleObjects(ARRAYSIZE(wait_handles), wait_handles, FALSE, INFINITE);
+			if (wait_result != WAIT_OBJECT_0)
+			{
+				DWORD bytes_transferred = 0;
+				CancelIoEx(directory.directory_handle, &overlapped);
+				GetOverlappedResult(directory.directory_handle, &overlapped, &bytes_transferred, TRUE);
+				break;
+			}
+
+			DWORD bytes_transferred = 0;
+			if (!GetOverlappedResult(directory.directory_handle, &overlapped, &bytes_transferred, FALSE)) continue;
+			if (bytes_transferred == 0)
+			{
+				ADRIA_LOG(WARNING, "Change notifications for directory %s overflowed, some changes were lost", directory.path.c_str());
+				continue;
+			}
+
+			Uint8 const* notification_data = buffer;
+			while (true)
+			{
+				FILE_NOTIFY_INFORMATION const* notification = reinterpret_cast<FILE_NOTIFY_INFORMATION const*>(notification_data);
+				if (notification->Action != FILE_ACTION_REMOVED && notification->Action != FILE_ACTION_RENAMED_OLD_NAME)
+				{
+					std::wstring file_name(notification->FileName, notification->FileNameLength / sizeof(Wchar));
+					std::string file = directory_path;
+					if (!file.empty() && file.back() != '/') file += '/';
+					file += NormalizePath(ToString(file_name));
+					OnFileChanged(std::move(file));
+				}
+				if (notification->NextEntryOffset == 0) break;
+				notification_data += notification->NextEntryOffset;
+			}
+		}
+		CloseHandle(overlapped.hEvent);
+	}
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include <filesystem>
+#include <chrono>
+#include <span>
 #include "Utilities/Delegate.h"
 
 namespace adria
@@ -12,50 +14,45 @@ namespace adria
 	};
 
 	DECLARE_EVENT(FileModifiedEvent, FileWatcher, std::string const&)
+	DECLARE_EVENT(FilesModifiedEvent, FileWatcher, std::span<std::string const>)
 
+	//directories are watched through OS change notifications on background threads, changes are collected until
+	//nothing was touched for the debounce window and then delivered as one batch from CheckWatchedFiles
+	//directories that can't be watched natively fall back to comparing write times, once per debounce window when driven by HasPendingChanges
 	class FileWatcher
 	{
+		using Clock = std::chrono::steady_clock;
+		struct WatchedDirectory;
+
 	public:
-		FileWatcher() = default;
-		~FileWatcher()
-		{
-			file_modified_event.RemoveAll();
-		}
-
-		void AddPathToWatch(std::string const& path, Bool recursive = true)
-		{
-			if (recursive)
-			{
-				for (auto& path : std::filesystem::recursive_directory_iterator(path))
-				{
-					if (path.is_regular_file()) files_map[path.path().string()] = std::filesystem::last_write_time(path);
-				}
-			}
-			else
-			{
-				for (auto& path : std::filesystem::directory_iterator(path))
-				{
-					if (path.is_regular_file()) files_map[path.path().string()] = std::filesystem::last_write_time(path);
-				}
-			}
-		}
-		void CheckWatchedFiles()
-		{
-			for (auto const& [file, ft] : files_map)
-			{
-				auto current_file_last_write_time = std::filesystem::last_write_time(file);
-				if (files_map[file] != current_file_last_write_time)
-				{
-					files_map[file] = current_file_last_write_time;
-					file_modified_event.Broadcast(file);
-				}
-			}
-		}
+		explicit FileWatcher(std::chrono::milliseconds debounce_window = std::chrono::milliseconds(150));
+		ADRIA_NONCOPYABLE_NONMOVABLE(FileWatcher)
+		~FileWatcher();
+
+		void AddPathToWatch(std::string const& path, Bool recursive = true);
+		void CheckWatchedFiles();
+		//true when a batch of native notifications settled or polled directories are due for another write time check
+		Bool HasPendingChanges() const;
 
 		FileModifiedEvent& GetFileModifiedEvent() { return file_modified_event; }
+		FilesModifiedEvent& GetFilesModifiedEvent() { return files_modified_event; }
 
 	private:
-		std::unordered_map<std::string, std::filesystem::file_time_type> files_map;
+		std::chrono::milliseconds debounce_window;
+		std::vector<std::unique_ptr<WatchedDirectory>> watched_directories;
+		std::unordered_map<std::string, std::filesystem::file_time_type> polled_files;
+		Clock::time_point last_poll_time;
+
+		mutable std::mutex pending_mutex;
+		std::unordered_set<std::string> pending_files;
+		Clock::time_point last_change_time;
+
 		FileModifiedEvent file_modified_event;
+		FilesModifiedEvent files_modified_event;
+
+	private:
+		void AddPolledPath(std::string const& path, Bool recursive);
+		void OnFileChanged(std::string file);
+		void WatchDirectory(WatchedDirectory& directory);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,76 @@
+#include "MemoryMappedFile.h"
+#include "StringUtil.h"
+
+namespace adria
+{
+	MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+		: file_handle(std::exchange(other.file_handle, nullptr)), mapping_handle(std::exchange(other.mapping_handle, nullptr)),
+		  data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0))
+	{
+	}
+
+	MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			file_handle = std::exchange(other.file_handle, nullptr);
+			mapping_handle = std::exchange(other.mapping_handle, nullptr);
+			data = std::exchange(other.data, nullptr);
+			size = std::exchange(other.size, 0);
+		}
+		return *this;
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		Close();
+	}
+
+	Bool MemoryMappedFile::Open(std::string_view file_path)
+	{
+		Close();
+		std::wstring wide_file_path = ToWideString(std::string(file_path));
+		HANDLE file = CreateFileW(wide_file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER file_size{};
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		file_handle = file;
+		mapping_handle = mapping;
+		data = static_cast<Uint8 const*>(view);
+		size = (Uint64)file_size.QuadPart;
+		return true;
+	}
+
+	void MemoryMappedFile::Close()
+	{
+		if (data) UnmapViewOfFile(data);
+		if (mapping_handle) CloseHandle(mapping_handle);
+		if (file_handle) CloseHandle(file_handle);
+		file_handle = nullptr;
+		mapping_handle = nullptr;
+		data = nullptr;
+		size = 0;
+	}
+}
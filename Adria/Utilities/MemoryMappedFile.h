@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <span>
+
+namespace adria
+{
+	//read only view of a whole file, the pages are loaded by the OS on first access
+	class MemoryMappedFile
+	{
+	public:
+		MemoryMappedFile() = default;
+		explicit MemoryMappedFile(std::string_view file_path) { Open(file_path); }
+		ADRIA_NONCOPYABLE(MemoryMappedFile)
+		MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+		MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+		~MemoryMappedFile();
+
+		Bool Open(std::string_view file_path);
+		void Close();
+
+		Bool IsOpen() const { return data != nullptr; }
+		Uint8 const* GetData() const { return data; }
+		Uint64 GetSize() const { return size; }
+		std::span<Uint8 const> GetSpan() const { return std::span<Uint8 const>(data, size); }
+
+	private:
+		void* file_handle = nullptr;
+		void* mapping_handle = nullptr;
+		Uint8 const* data = nullptr;
+		Uint64 size = 0;
+	};
+}
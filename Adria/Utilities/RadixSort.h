@@ -0,0 +1,45 @@
+#pragma once
+#include <span>
+#include <array>
+#include <algorithm>
+
+namespace adria
+{
+	//stable LSD radix sort over the bytes of 64-bit keys, bytes below first_byte are left out of the ordering
+	//passes in which every key has the same digit are skipped, scratch has to be at least as large as keys
+	inline void RadixSort(std::span<Uint64> keys, std::span<Uint64> scratch, Uint32 first_byte = 0)
+	{
+		ADRIA_ASSERT(scratch.size() >= keys.size());
+		Uint64 const count = keys.size();
+		if (count <= 1) return;
+
+		std::array<std::array<Uint32, 256>, 8> histograms{};
+		for (Uint64 key : keys)
+		{
+			for (Uint32 byte = first_byte; byte < 8; ++byte) ++histograms[byte][(key >> (byte * 8)) & 0xff];
+		}
+
+		Uint64* src = keys.data();
+		Uint64* dst = scratch.data();
+		for (Uint32 byte = first_byte; byte < 8; ++byte)
+		{
+			std::array<Uint32, 256>& histogram = histograms[byte];
+			if (histogram[(src[0] >> (byte * 8)) & 0xff] == count) continue;
+
+			Uint32 offset = 0;
+			for (Uint32& bucket : histogram)
+			{
+				Uint32 const bucket_count = bucket;
+				bucket = offset;
+				offset += bucket_count;
+			}
+			for (Uint64 i = 0; i < count; ++i)
+			{
+				Uint64 const key = src[i];
+				dst[histogram[(key >> (byte * 8)) & 0xff]++] = key;
+			}
+			std::swap(src, dst);
+		}
+		if (src != keys.data()) std::copy_n(src, count, keys.data());
+	}
+}
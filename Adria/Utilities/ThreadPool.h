@@ -1,6 +1,7 @@
 #pragma once
 #include <thread>
 #include <future>
+#include <atomic>
 #include <type_traits>
 #include "ConcurrentQueue.h"
 #include "Singleton.h"
@@ -19,7 +20,8 @@ namespace adria
 		{
 			done = false;
 
-			static const Uint max_threads = std::thread::hardware_concurrency();
+			//at least one worker, on a single core machine submitted tasks would never run otherwise
+			static const Uint max_threads = std::max(2u, std::thread::hardware_concurrency());
 			Uint const num_threads = pool_size == 0 ? max_threads - 1 : std::min(max_threads - 1, pool_size);
 			threads.reserve(num_threads);
 			for (Uint i = 0; i < num_threads; ++i)
@@ -59,6 +61,16 @@ namespace adria
 			return result_future;
 		}
 
+		//runs f on the pool without a future, for callers that track completion themselves
+		template<typename F>
+		void Dispatch(F&& f)
+		{
+			task_queue.Push(std::function<void()>(std::forward<F>(f)));
+			cond_var.notify_one();
+		}
+
+		Uint64 GetThreadCount() const { return threads.size(); }
+
 	private:
 		std::vector<std::thread> threads;
 		ConcurrentQueue<std::function<void()>> task_queue;
@@ -99,4 +111,41 @@ namespace adria
 		}
 	};
 	#define g_ThreadPool ThreadPool::Get()
+
+	//calls task(i) for every i in [0, count) on the pool and on the calling thread, indices are handed out one by one so uneven tasks balance out
+	//the caller returns once every index ran, helpers that only start after all indices were claimed exit without touching task
+	template<typename F>
+	void ParallelFor(Uint64 count, F&& task)
+	{
+		if (count == 0) return;
+
+		struct ParallelForState
+		{
+			std::atomic<Uint64> next_index = 0;
+			std::atomic<Uint64> remaining_count;
+		};
+		auto state = std::make_shared<ParallelForState>();
+		state->remaining_count = count;
+		auto Work = [state, &task, count]()
+			{
+				Uint64 completed_count = 0;
+				for (Uint64 i = state->next_index++; i < count; i = state->next_index++)
+				{
+					task(i);
+					++completed_count;
+				}
+				if (completed_count > 0 && state->remaining_count.fetch_sub(completed_count) == completed_count)
+				{
+					state->remaining_count.notify_one();
+				}
+			};
+
+		Uint64 const helper_count = std::min<Uint64>(count - 1, g_ThreadPool.GetThreadCount());
+		for (Uint64 i = 0; i < helper_count; ++i) g_ThreadPool.Dispatch(Work);
+		Work();
+		for (Uint64 remaining_count = state->remaining_count.load(); remaining_count != 0; remaining_count = state->remaining_count.load())
+		{
+			state->remaining_count.wait(remaining_count);
+		}
+	}
 }
\ No newline at end of file
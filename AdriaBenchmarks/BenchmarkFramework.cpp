@@ -0,0 +1,49 @@
+#include "BenchmarkFramework.h"
+#include "Utilities/ThreadPool.h"
+
+namespace adria::benchmarks
+{
+	namespace
+	{
+		volatile Uint64 consumed_value = 0;
+	}
+
+	std::vector<BenchmarkCase>& GetBenchmarkCases()
+	{
+		static std::vector<BenchmarkCase> benchmark_cases;
+		return benchmark_cases;
+	}
+
+	void ReportMeasurement(Char const* label, std::vector<Float>& times_ms)
+	{
+		if (times_ms.empty()) return;
+		std::sort(times_ms.begin(), times_ms.end());
+		std::printf("    %-48s median %10.3f ms   min %10.3f ms\n", label, times_ms[times_ms.size() / 2], times_ms.front());
+	}
+
+	void Consume(Uint64 value)
+	{
+		consumed_value = consumed_value + value;
+	}
+}
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+//runs every registered benchmark, or only the ones whose name contains the first argument
+//build and run the Release configuration, Debug timings say little about the engine
+int main(int argc, char** argv)
+{
+	g_ThreadPool.Initialize();
+
+	Char const* filter = argc > 1 ? argv[1] : nullptr;
+	for (BenchmarkCase const& benchmark_case : GetBenchmarkCases())
+	{
+		if (filter && !std::strstr(benchmark_case.name, filter)) continue;
+
+		std::printf("%s\n", benchmark_case.name);
+		benchmark_case.function();
+	}
+	g_ThreadPool.Destroy();
+	return 0;
+}
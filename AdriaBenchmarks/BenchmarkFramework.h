@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdio>
+#include "Utilities/Timer.h"
+
+namespace adria::benchmarks
+{
+	using BenchmarkFunction = void(*)();
+
+	struct BenchmarkCase
+	{
+		Char const* name;
+		BenchmarkFunction function;
+	};
+
+	std::vector<BenchmarkCase>& GetBenchmarkCases();
+	void ReportMeasurement(Char const* label, std::vector<Float>& times_ms);
+	//results are passed here so the work producing them can't be optimized away
+	void Consume(Uint64 value);
+
+	struct BenchmarkRegistrar
+	{
+		BenchmarkRegistrar(Char const* name, BenchmarkFunction function)
+		{
+			GetBenchmarkCases().push_back(BenchmarkCase{ name, function });
+		}
+	};
+
+	//runs f once to warm up caches and the thread pool, then reports the median and the fastest of repetition_count runs
+	template<typename F>
+	void Measure(Char const* label, Uint32 repetition_count, F&& f)
+	{
+		f();
+		std::vector<Float> times_ms;
+		times_ms.reserve(repetition_count);
+		for (Uint32 i = 0; i < repetition_count; ++i)
+		{
+			Timer<std::chrono::nanoseconds> timer;
+			f();
+			times_ms.push_back(timer.Elapsed() / 1e6f);
+		}
+		ReportMeasurement(label, times_ms);
+	}
+}
+
+#define ADRIA_BENCHMARK(name) \
+	static void name(); \
+	static adria::benchmarks::BenchmarkRegistrar ADRIA_CONCAT(name, _registrar)(#name, &name); \
+	static void name()
@@ -0,0 +1,30 @@
+#include "BenchmarkMeshes.h"
+
+namespace adria::benchmarks
+{
+	MeshData MakeDisplacedGrid(Uint32 grid_size, std::mt19937& rng)
+	{
+		std::uniform_real_distribution<Float> height(0.0f, 0.25f);
+		MeshData mesh_data{};
+		for (Uint32 y = 0; y <= grid_size; ++y)
+		{
+			for (Uint32 x = 0; x <= grid_size; ++x)
+			{
+				mesh_data.positions_stream.emplace_back((Float)x, height(rng), (Float)y);
+				mesh_data.uvs_stream.emplace_back((Float)x / grid_size, (Float)y / grid_size);
+				Vector3 normal(height(rng), 1.0f, height(rng));
+				normal.Normalize();
+				mesh_data.normals_stream.push_back(normal);
+			}
+		}
+		for (Uint32 y = 0; y < grid_size; ++y)
+		{
+			for (Uint32 x = 0; x < grid_size; ++x)
+			{
+				Uint32 const i = y * (grid_size + 1) + x;
+				mesh_data.indices.insert(mesh_data.indices.end(), { i, i + grid_size + 1, i + 1, i + 1, i + grid_size + 1, i + grid_size + 2 });
+			}
+		}
+		return mesh_data;
+	}
+}
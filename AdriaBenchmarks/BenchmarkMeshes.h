@@ -0,0 +1,10 @@
+#pragma once
+#include <random>
+#include "Rendering/MeshProcessing.h"
+
+namespace adria::benchmarks
+{
+	//a displaced grid as SceneLoader reads it from a glTF primitive, positions, uvs and normals without tangents
+	//and triangles in row order like most exported meshes before the vertex cache optimization
+	MeshData MakeDisplacedGrid(Uint32 grid_size, std::mt19937& rng);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <vector>
+#include <span>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <fstream>
+#include <windows.h>
+#include <dxgiformat.h>
+#include "Core/Types.h"
+#include "Core/Macros.h"
+#include "Core/Log.h"
+#include "Math/MathCommon.h"
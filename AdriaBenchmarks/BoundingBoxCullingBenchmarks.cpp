@@ -0,0 +1,73 @@
+#include <random>
+#include <bit>
+#include "BenchmarkFramework.h"
+#include "Math/BoundingBoxCulling.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	//boxes spread around the camera so that roughly a fifth of them end up in the frustum
+	std::vector<BoundingBox> MakeBatchBoxes(Uint64 count)
+	{
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<Float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<Float> extent(0.2f, 4.0f);
+		std::vector<BoundingBox> boxes(count);
+		for (BoundingBox& box : boxes)
+		{
+			box.Center = Vector3(position(rng), position(rng) * 0.1f, position(rng));
+			box.Extents = Vector3(extent(rng), extent(rng), extent(rng));
+		}
+		return boxes;
+	}
+
+	Uint64 CountVisible(std::span<Uint64 const> visibility)
+	{
+		Uint64 visible_count = 0;
+		for (Uint64 word : visibility) visible_count += std::popcount(word);
+		return visible_count;
+	}
+
+	void BenchmarkBoundingBoxCulling(Uint64 box_count)
+	{
+		std::vector<BoundingBox> const boxes = MakeBatchBoxes(box_count);
+		BoundingFrustum const frustum(Vector3(0.0f, 2.0f, -50.0f), Quaternion::Identity, 0.8f, -0.8f, 0.45f, -0.45f, 0.1f, 600.0f);
+		CullingView const view = MakeCullingView(frustum);
+		std::string const count_label = std::to_string(box_count) + " boxes";
+
+		BoundingBoxSoA soa_boxes;
+		soa_boxes.Resize(boxes.size());
+		for (Uint64 i = 0; i < boxes.size(); ++i) soa_boxes.Set(i, boxes[i]);
+		std::vector<Uint64> visibility(soa_boxes.GetMaskWordCount());
+
+		//what Renderer::CameraFrustumCulling did before, one BoundingFrustum::Intersects per batch
+		Measure((count_label + ", DirectXCollision").c_str(), 10, [&]()
+			{
+				std::fill(visibility.begin(), visibility.end(), 0);
+				for (Uint64 i = 0; i < boxes.size(); ++i)
+				{
+					if (frustum.Intersects(boxes[i])) visibility[i / BoundingBoxSoA::BlockSize] |= 1ull << (i % BoundingBoxSoA::BlockSize);
+				}
+				Consume(CountVisible(visibility));
+			});
+		Measure((count_label + ", SoA kernel").c_str(), 10, [&]()
+			{
+				CullBoundingBoxes(view, soa_boxes, visibility);
+				Consume(CountVisible(visibility));
+			});
+		Measure((count_label + ", SoA kernel, thread pool").c_str(), 10, [&]()
+			{
+				CullBoundingBoxesMultiView(std::span(&view, 1), soa_boxes, visibility);
+				Consume(CountVisible(visibility));
+			});
+	}
+}
+
+ADRIA_BENCHMARK(BoundingBoxCulling_Frustum)
+{
+	BenchmarkBoundingBoxCulling(10000);
+	BenchmarkBoundingBoxCulling(100000);
+	BenchmarkBoundingBoxCulling(1000000);
+}
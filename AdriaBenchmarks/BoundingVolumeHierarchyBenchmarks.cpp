@@ -0,0 +1,102 @@
+#include <random>
+#include "BenchmarkFramework.h"
+#include "Math/BoundingVolumeHierarchy.h"
+#include "Math/BoundingBoxCulling.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	//batches of a large scene, clustered like props around buildings rather than spread uniformly
+	std::vector<BoundingBox> MakeSceneBoxes(Uint64 count)
+	{
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<Float> cluster_position(-1000.0f, 1000.0f);
+		std::normal_distribution<Float> offset(0.0f, 20.0f);
+		std::uniform_real_distribution<Float> extent(0.2f, 4.0f);
+		std::vector<BoundingBox> boxes(count);
+		Vector3 cluster_center;
+		for (Uint64 i = 0; i < count; ++i)
+		{
+			if (i % 64 == 0) cluster_center = Vector3(cluster_position(rng), cluster_position(rng) * 0.05f, cluster_position(rng));
+			boxes[i].Center = cluster_center + Vector3(offset(rng), offset(rng) * 0.2f, offset(rng));
+			boxes[i].Extents = Vector3(extent(rng), extent(rng), extent(rng));
+		}
+		return boxes;
+	}
+
+	//a camera looking along +z and five shadow views, roughly what a frame culls
+	std::vector<CullingView> MakeFrameViews()
+	{
+		std::vector<CullingView> views;
+		views.push_back(MakeCullingView(BoundingFrustum(Vector3(0.0f, 2.0f, -200.0f), Quaternion::Identity, 0.8f, -0.8f, 0.45f, -0.45f, 0.1f, 600.0f)));
+		for (Float extent : { 25.0f, 60.0f, 150.0f, 400.0f, 900.0f })
+		{
+			views.push_back(MakeCullingView(BoundingBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(extent, 100.0f, extent))));
+		}
+		return views;
+	}
+
+	void BenchmarkBoundingVolumeHierarchy(Uint64 box_count)
+	{
+		std::vector<BoundingBox> boxes = MakeSceneBoxes(box_count);
+		std::vector<CullingView> const views = MakeFrameViews();
+		std::string const count_label = std::to_string(box_count) + " boxes";
+
+		BoundingVolumeHierarchy bvh;
+		Measure((count_label + ", build").c_str(), 5, [&]() { bvh.Build(boxes); Consume(bvh.GetNodeCount()); });
+
+		BoundingBoxSoA soa_boxes;
+		soa_boxes.Resize(boxes.size());
+		for (Uint64 i = 0; i < boxes.size(); ++i) soa_boxes.Set(i, boxes[i]);
+		std::vector<Uint64> visibility(views.size() * soa_boxes.GetMaskWordCount());
+		Measure((count_label + ", 6 views, SoA kernel").c_str(), 20, [&]()
+			{
+				CullBoundingBoxesMultiView(views, soa_boxes, visibility);
+				Consume(visibility[0]);
+			});
+		Measure((count_label + ", 6 views, BVH").c_str(), 20, [&]()
+			{
+				bvh.CullMultiView(views, visibility);
+				Consume(visibility[0]);
+			});
+
+		std::vector<Uint32> ids;
+		Measure((count_label + ", 64 sphere queries").c_str(), 20, [&]()
+			{
+				ids.clear();
+				for (Uint32 i = 0; i < 64; ++i) bvh.QuerySphere(BoundingSphere(boxes[i * (boxes.size() / 64)].Center, 30.0f), ids);
+				Consume(ids.size());
+			});
+		Measure((count_label + ", 64 ray queries").c_str(), 20, [&]()
+			{
+				ids.clear();
+				for (Uint32 i = 0; i < 64; ++i)
+				{
+					Vector3 direction = Vector3(boxes[i].Center) - Vector3(0.0f, 2.0f, -200.0f);
+					direction.Normalize();
+					bvh.QueryRay(Ray(Vector3(0.0f, 2.0f, -200.0f), direction), 2000.0f, ids);
+				}
+				Consume(ids.size());
+			});
+
+		//one percent of the scene moves every frame
+		Measure((count_label + ", refit after 1% moved").c_str(), 20, [&]()
+			{
+				for (Uint64 i = 0; i < boxes.size(); i += 100)
+				{
+					boxes[i].Center.y += 0.01f;
+					bvh.UpdateBounds((Uint32)i, boxes[i]);
+				}
+				bvh.Refit();
+				Consume(bvh.GetNodeCount());
+			});
+	}
+}
+
+ADRIA_BENCHMARK(BoundingVolumeHierarchy_BuildAndQuery)
+{
+	BenchmarkBoundingVolumeHierarchy(10000);
+	BenchmarkBoundingVolumeHierarchy(100000);
+}
@@ -0,0 +1,140 @@
+#include <filesystem>
+#include "BenchmarkFramework.h"
+#include "BenchmarkMeshes.h"
+#include "Rendering/CookedMesh.h"
+#include "Rendering/GeometryStreamCodec.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	//the geometry buffer SceneLoader uploads and the submesh records pointing into it
+	struct CookedScene
+	{
+		std::vector<Uint8> geometry;
+		std::vector<SubMeshGPU> submeshes;
+	};
+
+	template<typename T>
+	Uint32 AddStream(CookedScene& scene, std::vector<T> const& data)
+	{
+		Uint64 const offset = (scene.geometry.size() + 15) & ~15ull;
+		scene.geometry.resize(offset + data.size() * sizeof(T));
+		memcpy(scene.geometry.data() + offset, data.data(), data.size() * sizeof(T));
+		return (Uint32)offset;
+	}
+
+	//lays out a processed submesh like SceneLoader::WriteGeometryBuffer does for unquantized vertices
+	void AddSubMesh(CookedScene& scene, MeshData const& mesh_data)
+	{
+		SubMeshGPU& submesh = scene.submeshes.emplace_back();
+		submesh.indices_offset = AddStream(scene, mesh_data.indices);
+		submesh.indices_count = mesh_data.lods[0].index_count;
+		submesh.vertices_count = (Uint32)mesh_data.positions_stream.size();
+		submesh.positions_offset = AddStream(scene, mesh_data.positions_stream);
+		submesh.uvs_offset = AddStream(scene, mesh_data.uvs_stream);
+		submesh.normals_offset = AddStream(scene, mesh_data.normals_stream);
+		submesh.tangents_offset = AddStream(scene, mesh_data.tangents_stream);
+		submesh.meshlet_offset = AddStream(scene, mesh_data.meshlets);
+		submesh.meshlet_vertices_offset = AddStream(scene, mesh_data.meshlet_vertices);
+		submesh.meshlet_triangles_offset = AddStream(scene, mesh_data.meshlet_triangles);
+		submesh.meshlet_count = mesh_data.lods[0].meshlet_count;
+		submesh.meshlet_vertices_count = (Uint32)mesh_data.meshlet_vertices.size();
+		submesh.meshlet_triangles_count = (Uint32)mesh_data.meshlet_triangles.size();
+		submesh.lod_count = (Uint32)mesh_data.lods.size();
+		for (Uint32 lod_index = 0; lod_index < submesh.lod_count; ++lod_index)
+		{
+			MeshLODData const& lod_data = mesh_data.lods[lod_index];
+			submesh.lods[lod_index] = SubMeshLOD{ submesh.indices_offset + lod_data.first_index * (Uint32)sizeof(Uint32), lod_data.index_count,
+				lod_data.first_meshlet, lod_data.meshlet_count, lod_data.error };
+		}
+		submesh.bounding_box = mesh_data.bounding_box;
+		submesh.quantized = false;
+		submesh.index_format = GfxFormat::R32_UINT;
+		submesh.topology = mesh_data.topology;
+	}
+
+	void AddGridSubMesh(CookedScene& scene, Uint32 grid_size, std::mt19937& rng)
+	{
+		MeshData mesh_data = MakeDisplacedGrid(grid_size, rng);
+		ProcessMeshData(mesh_data, true, MESH_MAX_LODS);
+		AddSubMesh(scene, mesh_data);
+	}
+
+	//Sponza and Bistro aren't part of the repository, the scenes have roughly their triangle counts split in a few large and many small submeshes
+	CookedScene MakeCookedScene(Uint32 large_count, Uint32 medium_count, Uint32 small_count)
+	{
+		std::mt19937 rng(11);
+		CookedScene scene{};
+		for (Uint32 i = 0; i < large_count; ++i) AddGridSubMesh(scene, 256, rng);
+		for (Uint32 i = 0; i < medium_count; ++i) AddGridSubMesh(scene, 64, rng);
+		for (Uint32 i = 0; i < small_count; ++i) AddGridSubMesh(scene, 16, rng);
+		return scene;
+	}
+
+	//the vertex and meshlet streams follow the indices of all LODs, everything but the indices has to come back unchanged
+	Bool IsLoadedGeometryEqual(CookedScene const& scene, std::vector<Uint8> const& loaded_geometry)
+	{
+		for (SubMeshGPU const& submesh : scene.submeshes)
+		{
+			for (Uint32 lod_index = 0; lod_index < submesh.lod_count; ++lod_index)
+			{
+				SubMeshLOD const& lod = submesh.lods[lod_index];
+				GeometryStream const index_stream{ lod.indices_offset, lod.indices_count, sizeof(Uint32), GeometryStreamCodec::IndexBuffer };
+				if (!IsDecodedGeometryStreamEqual(index_stream, scene.geometry.data() + lod.indices_offset, loaded_geometry.data() + lod.indices_offset)) return false;
+			}
+			Uint64 const streams_end = submesh.meshlet_triangles_offset + submesh.meshlet_triangles_count * sizeof(MeshletTriangle);
+			if (memcmp(scene.geometry.data() + submesh.positions_offset, loaded_geometry.data() + submesh.positions_offset, streams_end - submesh.positions_offset) != 0) return false;
+		}
+		return true;
+	}
+
+	//saves, maps and decodes a real cooked mesh file, the first load after cooking finds the file in the OS file cache
+	void BenchmarkCookedMesh(Char const* scene_name, CookedScene const& scene, Uint32 repetition_count)
+	{
+		constexpr Uint64 SourceHash = 0x5eed;
+		std::string const cooked_path = (std::filesystem::temp_directory_path() / "AdriaBenchmarks.cmesh").string();
+		Measure((std::string(scene_name) + ", cook").c_str(), repetition_count, [&]()
+			{
+				Bool const saved = CookedMesh::Save(cooked_path, SourceHash, scene.submeshes, scene.geometry);
+				ADRIA_ASSERT(saved);
+				Consume(saved);
+			});
+		std::printf("    %-48s %10.2f MB -> %8.2f MB\n", (std::string(scene_name) + ", geometry -> cooked file").c_str(),
+			scene.geometry.size() / (1024.0 * 1024.0), std::filesystem::file_size(cooked_path) / (1024.0 * 1024.0));
+
+		//the upper bound for loading, the geometry copied into the upload buffer as it is
+		std::vector<Uint8> upload(scene.geometry.size());
+		Measure((std::string(scene_name) + ", copy uncompressed geometry").c_str(), repetition_count, [&]()
+			{
+				memcpy(upload.data(), scene.geometry.data(), scene.geometry.size());
+				Consume(upload.back());
+			});
+
+		CookedMesh cooked_mesh;
+		Measure((std::string(scene_name) + ", open").c_str(), repetition_count, [&]()
+			{
+				Bool const opened = cooked_mesh.Open(cooked_path, SourceHash);
+				ADRIA_ASSERT(opened);
+				Consume(cooked_mesh.GetSubMeshes().size());
+			});
+		Measure((std::string(scene_name) + ", open and decode").c_str(), repetition_count, [&]()
+			{
+				Bool const loaded = cooked_mesh.Open(cooked_path, SourceHash) && cooked_mesh.DecodeGeometry(upload.data());
+				ADRIA_ASSERT(loaded);
+				Consume(loaded + upload.back());
+			});
+		cooked_mesh.Close();
+		ADRIA_ASSERT(IsLoadedGeometryEqual(scene, upload));
+
+		std::error_code error;
+		std::filesystem::remove(cooked_path, error);
+	}
+}
+
+ADRIA_BENCHMARK(CookedMesh_CookAndLoad)
+{
+	BenchmarkCookedMesh("Sponza sized", MakeCookedScene(2, 16, 80), 10);
+	BenchmarkCookedMesh("Bistro sized", MakeCookedScene(16, 128, 800), 3);
+}
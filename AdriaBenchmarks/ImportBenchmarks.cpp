@@ -0,0 +1,51 @@
+#include "BenchmarkFramework.h"
+#include "BenchmarkMeshes.h"
+#include "Utilities/ThreadPool.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	//glTF scenes mix a few large submeshes with many small ones, the large ones decide how well the work balances
+	std::vector<MeshData> MakeImportScene()
+	{
+		std::mt19937 rng(17);
+		std::vector<MeshData> mesh_datas;
+		for (Uint32 i = 0; i < 4; ++i) mesh_datas.push_back(MakeDisplacedGrid(256, rng));
+		for (Uint32 i = 0; i < 24; ++i) mesh_datas.push_back(MakeDisplacedGrid(64, rng));
+		for (Uint32 i = 0; i < 160; ++i) mesh_datas.push_back(MakeDisplacedGrid(16, rng));
+		return mesh_datas;
+	}
+
+	//what SceneLoader::CalculateTotalBufferSize runs for every primitive, on a copy so each repetition starts from the source data
+	Uint64 ProcessSubMesh(MeshData const& source, MeshData& mesh_data)
+	{
+		mesh_data = source;
+		ProcessMeshData(mesh_data, true, MESH_MAX_LODS);
+		return mesh_data.indices.size() + mesh_data.meshlets.size();
+	}
+}
+
+ADRIA_BENCHMARK(Import_ProcessSubMeshes)
+{
+	std::vector<MeshData> const sources = MakeImportScene();
+	std::vector<MeshData> mesh_datas(sources.size());
+	std::vector<Uint64> results(sources.size());
+
+	Measure("serial", 5, [&]()
+		{
+			for (Uint64 i = 0; i < sources.size(); ++i) results[i] = ProcessSubMesh(sources[i], mesh_datas[i]);
+			Consume(results.back());
+		});
+	Measure("ParallelFor, large submeshes first", 5, [&]()
+		{
+			ParallelFor(sources.size(), [&](Uint64 i) { results[i] = ProcessSubMesh(sources[i], mesh_datas[i]); });
+			Consume(results.back());
+		});
+	Measure("ParallelFor, large submeshes last", 5, [&]()
+		{
+			ParallelFor(sources.size(), [&](Uint64 i) { Uint64 const j = sources.size() - 1 - i; results[j] = ProcessSubMesh(sources[j], mesh_datas[j]); });
+			Consume(results.back());
+		});
+}
@@ -0,0 +1,85 @@
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "BenchmarkFramework.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	constexpr Uint32 EntriesPerProducer = 20000;
+
+	Uint64 GetTimeNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+	}
+
+	//every entry starts with the time it was logged at, the logger measures how long it took to reach it
+	//Log runs on the log thread only, the main thread reads the latencies after it saw the last entry arrive
+	class LatencyLogger : public ILogger
+	{
+	public:
+		virtual void Log(LogLevel, Char const* entry, Char const*, Uint32) override
+		{
+			Uint64 const latency_ns = GetTimeNs() - std::strtoull(entry, nullptr, 10);
+			total_latency_ns += latency_ns;
+			max_latency_ns = std::max(max_latency_ns, latency_ns);
+			entry_count.fetch_add(1, std::memory_order_release);
+		}
+
+		void Reset()
+		{
+			total_latency_ns = 0;
+			max_latency_ns = 0;
+			entry_count.store(0);
+		}
+		void WaitForEntries(Uint64 count) const
+		{
+			while (entry_count.load(std::memory_order_acquire) < count) std::this_thread::yield();
+		}
+
+		Uint64 total_latency_ns = 0;
+		Uint64 max_latency_ns = 0;
+		std::atomic<Uint64> entry_count = 0;
+	};
+
+	void BenchmarkLogThroughput(Uint32 producer_count)
+	{
+		LogManager log_manager;
+		LatencyLogger* logger = new LatencyLogger;
+		log_manager.Register(logger);
+
+		Uint64 const entry_count = (Uint64)producer_count * EntriesPerProducer;
+		std::string const label = std::to_string(producer_count) + " producers, " + std::to_string(entry_count) + " entries";
+		Measure(label.c_str(), 10, [&]()
+			{
+				logger->Reset();
+				std::vector<std::thread> producers;
+				for (Uint32 i = 0; i < producer_count; ++i)
+				{
+					producers.emplace_back([&log_manager, i]()
+						{
+							for (Uint32 j = 0; j < EntriesPerProducer; ++j)
+							{
+								log_manager.LogFormat(LogLevel::LOG_INFO, __FILE__, __LINE__, "%llu producer %u entry %u", (unsigned long long)GetTimeNs(), i, j);
+							}
+						});
+				}
+				for (std::thread& producer : producers) producer.join();
+				logger->WaitForEntries(entry_count);
+				Consume(logger->max_latency_ns);
+			});
+
+		//latencies of the last run, from LogFormat to the logger
+		std::printf("    %-48s mean %10.3f us   max %10.3f us\n", (label + ", latency").c_str(),
+			logger->total_latency_ns / 1e3 / entry_count, logger->max_latency_ns / 1e3);
+	}
+}
+
+ADRIA_BENCHMARK(Log_Throughput)
+{
+	for (Uint32 producer_count : { 1u, 4u, 8u }) BenchmarkLogThroughput(producer_count);
+}
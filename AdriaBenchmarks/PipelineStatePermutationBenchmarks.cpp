@@ -0,0 +1,107 @@
+#include <climits>
+#include <d3d12.h>
+#include "BenchmarkFramework.h"
+#include "Utilities/Ref.h"
+#include "Graphics/GfxPipelineStatePermutations.h"
+#include "Rendering/ShaderManager.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	//stands in for a pipeline so lookups can be measured without a device, creating one only hashes its desc
+	struct BenchmarkPipelineState
+	{
+		BenchmarkPipelineState(GfxDevice*, GfxGraphicsPipelineStateDesc const& desc) : desc_hash(GfxGraphicsPipelineStateDescHash{}(desc)) {}
+		Uint64 desc_hash;
+	};
+}
+
+namespace adria
+{
+	template<>
+	struct PSOTraits<BenchmarkPipelineState>
+	{
+		static constexpr GfxPipelineStateType PipelineStateType = GfxPipelineStateType::Graphics;
+		using PSODescType = GfxGraphicsPipelineStateDesc;
+		using PSODescHasher = GfxGraphicsPipelineStateDescHash;
+	};
+}
+
+namespace
+{
+	constexpr Uint32 DrawCount = 4096;
+
+	constexpr GfxPermutationDefine PermutationDefines[] =
+	{
+		{ "MASK" },
+		{ "NORMAL_MAP" },
+		{ "TRIANGLE_OVERLAY", "1", GfxShaderStage::PS },
+		{ "RAIN", "1", GfxShaderStage::PS },
+	};
+
+	//roughly the gbuffer pipeline: three render targets, a depth buffer and a full vertex layout
+	GfxGraphicsPipelineStateDesc MakeGBufferDesc()
+	{
+		GfxGraphicsPipelineStateDesc desc{};
+		desc.input_layout.elements =
+		{
+			{ "POSITION", 0, GfxFormat::R32G32B32_FLOAT, 0 },
+			{ "UV", 0, GfxFormat::R32G32_FLOAT, 1 },
+			{ "NORMAL", 0, GfxFormat::R32G32B32_FLOAT, 2 },
+			{ "TANGENT", 0, GfxFormat::R32G32B32A32_FLOAT, 3 },
+		};
+		desc.num_render_targets = 3;
+		desc.rtv_formats[0] = GfxFormat::R8G8B8A8_UNORM;
+		desc.rtv_formats[1] = GfxFormat::R8G8B8A8_UNORM;
+		desc.rtv_formats[2] = GfxFormat::R8G8B8A8_UNORM;
+		desc.dsv_format = GfxFormat::D32_FLOAT;
+		desc.VS = VS_GBuffer;
+		desc.PS = PS_GBuffer;
+		return desc;
+	}
+}
+
+ADRIA_BENCHMARK(PipelineStatePermutations_Lookup)
+{
+	GfxGraphicsPipelineStateDesc const desc = MakeGBufferDesc();
+	GfxPipelineStatePermutations<BenchmarkPipelineState> permutations(nullptr, desc, PermutationDefines);
+	std::string const draw_label = std::to_string(DrawCount) + " draws";
+
+	Measure((draw_label + ", desc hash").c_str(), 20, [&]()
+		{
+			Uint64 hash = 0;
+			for (Uint32 i = 0; i < DrawCount; ++i) hash ^= GfxGraphicsPipelineStateDescHash{}(desc);
+			Consume(hash);
+		});
+
+	//defines are added per draw and the current desc is hashed into the map
+	Measure((draw_label + ", AddDefine + Get()").c_str(), 20, [&]()
+		{
+			Uint64 hash = 0;
+			for (Uint32 i = 0; i < DrawCount; ++i)
+			{
+				Uint32 const permutation_mask = i % (1u << std::size(PermutationDefines));
+				for (Uint32 j = 0; j < std::size(PermutationDefines); ++j)
+				{
+					if (!(permutation_mask & (1u << j))) continue;
+					if (PermutationDefines[j].stage == GfxShaderStage::PS) permutations.AddDefine<GfxShaderStage::PS>(PermutationDefines[j].name, PermutationDefines[j].value);
+					else permutations.AddDefine(PermutationDefines[j].name, PermutationDefines[j].value);
+				}
+				hash ^= permutations.Get()->desc_hash;
+			}
+			Consume(hash);
+		});
+
+	Measure((draw_label + ", Get(mask)").c_str(), 20, [&]()
+		{
+			Uint64 hash = 0;
+			for (Uint32 i = 0; i < DrawCount; ++i)
+			{
+				Uint32 const permutation_mask = i % (1u << std::size(PermutationDefines));
+				hash ^= permutations.Get(permutation_mask)->desc_hash;
+			}
+			Consume(hash);
+		});
+}
@@ -0,0 +1,153 @@
+#include <random>
+#include "BenchmarkFramework.h"
+#include "Utilities/HashUtil.h"
+#include "RenderGraph/RenderGraphDependencies.h"
+#include "RenderGraph/RenderGraphBarrierPlanner.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	//every pass writes a new texture and reads a few of the textures written shortly before it, like the passes of a frame
+	struct SyntheticGraph
+	{
+		std::vector<std::vector<Uint32>> texture_reads;
+		std::vector<std::vector<Uint32>> texture_writes;
+		std::vector<std::vector<Uint32>> buffer_reads;
+		std::vector<std::vector<Uint32>> buffer_writes;
+		std::vector<RGPassAccesses> pass_accesses;
+		Uint32 texture_count = 0;
+		Uint32 buffer_count = 0;
+	};
+
+	SyntheticGraph MakeSyntheticGraph(Uint32 pass_count)
+	{
+		constexpr Uint32 ReadWindow = 32;
+		std::mt19937 rng(3);
+		SyntheticGraph graph{};
+		graph.texture_reads.resize(pass_count);
+		graph.texture_writes.resize(pass_count);
+		graph.buffer_reads.resize(pass_count);
+		graph.buffer_writes.resize(pass_count);
+		graph.buffer_count = std::max(pass_count / 16, 1u);
+		for (Uint32 i = 0; i < pass_count; ++i)
+		{
+			Uint32 const read_count = std::min<Uint32>(i, 1 + rng() % 4);
+			for (Uint32 j = 0; j < read_count; ++j)
+			{
+				Uint32 const texture = i - 1 - rng() % std::min(i, ReadWindow);
+				if (std::find(graph.texture_reads[i].begin(), graph.texture_reads[i].end(), texture) == graph.texture_reads[i].end()) graph.texture_reads[i].push_back(texture);
+			}
+			graph.texture_writes[i].push_back(graph.texture_count++);
+			if (i % 16 == 0) graph.buffer_writes[i].push_back(i / 16);
+			else graph.buffer_reads[i].push_back(std::min(i / 16, graph.buffer_count - 1));
+		}
+		for (Uint32 i = 0; i < pass_count; ++i)
+		{
+			graph.pass_accesses.push_back(RGPassAccesses{ graph.texture_reads[i], graph.texture_writes[i], graph.buffer_reads[i], graph.buffer_writes[i] });
+		}
+		return graph;
+	}
+
+	//the texture uses of every dependency level, in the order RenderGraph hands them to the barrier planner
+	std::span<RGBarrierPlanUse> CollectTextureUses(RGAllocator& allocator, SyntheticGraph const& graph, RGDependencies const& dependencies)
+	{
+		Uint64 max_use_count = 0;
+		for (RGPassAccesses const& accesses : graph.pass_accesses) max_use_count += accesses.texture_reads.size() + accesses.texture_writes.size();
+		std::span<RGBarrierPlanUse> uses = allocator.AllocateArray<RGBarrierPlanUse>(max_use_count);
+		std::span<Uint32> last_level = allocator.AllocateArray<Uint32>(graph.texture_count);
+		std::span<Uint32> last_use = allocator.AllocateArray<Uint32>(graph.texture_count);
+		std::fill(last_level.begin(), last_level.end(), Uint32(-1));
+
+		Uint32 use_count = 0;
+		auto AddUse = [&](Uint32 texture, Uint32 level, GfxResourceState state)
+			{
+				if (last_level[texture] == level)
+				{
+					uses[last_use[texture]].state |= state;
+					return;
+				}
+				last_level[texture] = level;
+				last_use[texture] = use_count;
+				RGBarrierPlanUse& use = uses[use_count++];
+				use.resource = texture;
+				use.level = level;
+				use.state = state;
+			};
+		for (Uint32 level = 0; level < dependencies.dependency_levels.GetListCount(); ++level)
+		{
+			for (Uint32 pass : dependencies.dependency_levels[level])
+			{
+				for (Uint32 texture : graph.pass_accesses[pass].texture_reads)  AddUse(texture, level, GfxResourceState::AllSRV);
+				for (Uint32 texture : graph.pass_accesses[pass].texture_writes) AddUse(texture, level, GfxResourceState::RTV);
+			}
+		}
+		return uses.first(use_count);
+	}
+
+	//what the compile cache hashes to find a structurally identical graph
+	Uint64 HashGraph(SyntheticGraph const& graph)
+	{
+		HashState hash;
+		hash.Combine(graph.pass_accesses.size());
+		for (RGPassAccesses const& accesses : graph.pass_accesses)
+		{
+			for (std::span<Uint32 const> resources : { accesses.texture_reads, accesses.texture_writes, accesses.buffer_reads, accesses.buffer_writes })
+			{
+				hash.Combine(resources.size());
+				for (Uint32 resource : resources) hash.Combine(resource);
+			}
+		}
+		return hash;
+	}
+
+	void BenchmarkRenderGraphCompile(Uint32 pass_count, Uint32 repetition_count)
+	{
+		SyntheticGraph const graph = MakeSyntheticGraph(pass_count);
+		std::string const pass_label = std::to_string(pass_count) + " passes";
+		RGAllocator allocator(256 * 1024);
+
+		RGCompiledDependencies compiled_dependencies{};
+		std::vector<RGBarrierPlanUse> compiled_uses;
+		Uint64 compiled_hash = 0;
+		Measure((pass_label + ", cold compile").c_str(), repetition_count, [&]()
+			{
+				allocator.Reset();
+				RGDependencies const dependencies = BuildDependencies(allocator, graph.pass_accesses, graph.texture_count, graph.buffer_count);
+				std::span<RGBarrierPlanUse> uses = CollectTextureUses(allocator, graph, dependencies);
+
+				RGBarrierPlanInput plan_input{};
+				plan_input.uses = uses;
+				plan_input.resource_count = graph.texture_count;
+				plan_input.fixed_resources = allocator.AllocateArray<Bool>(graph.texture_count);
+				plan_input.level_fences = allocator.AllocateArray<Bool>(dependencies.dependency_levels.GetListCount());
+				RGBarrierPlanStats const stats = PlanBarriers(plan_input);
+
+				compiled_hash = HashGraph(graph);
+				compiled_dependencies.Save(dependencies);
+				compiled_uses.assign(uses.begin(), uses.end());
+				Consume(stats.planned_barrier_count);
+			});
+
+		Measure((pass_label + ", compile cache hit").c_str(), repetition_count, [&]()
+			{
+				allocator.Reset();
+				Uint64 const hash = HashGraph(graph);
+				ADRIA_ASSERT(hash == compiled_hash);
+				RGDependencies const dependencies = compiled_dependencies.Load(allocator);
+				std::span<RGBarrierPlanUse> uses = allocator.AllocateArray<RGBarrierPlanUse>(compiled_uses.size());
+				std::copy(compiled_uses.begin(), compiled_uses.end(), uses.begin());
+				Consume(hash + dependencies.dependency_levels.GetListCount() + uses.size());
+			});
+		std::printf("    %-48s %10llu levels\n", (pass_label + ", dependency levels").c_str(),
+			(unsigned long long)compiled_dependencies.level_offsets.size() - 1);
+	}
+}
+
+ADRIA_BENCHMARK(RenderGraph_Compile)
+{
+	BenchmarkRenderGraphCompile(100, 100);
+	BenchmarkRenderGraphCompile(1000, 50);
+	BenchmarkRenderGraphCompile(10000, 10);
+}
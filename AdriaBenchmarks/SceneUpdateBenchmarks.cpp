@@ -0,0 +1,116 @@
+#include <random>
+#include "BenchmarkFramework.h"
+#include "Math/BoundingVolumeHierarchy.h"
+#include "Math/BoundingBoxCulling.h"
+#include "Rendering/SceneUpdate.h"
+
+using namespace adria;
+using namespace adria::benchmarks;
+
+namespace
+{
+	constexpr Uint32 InstanceCount = 100000;
+	constexpr Uint32 SubMeshCount = 1000;
+
+	//the CPU side of the scene buffers Renderer keeps for its batches
+	struct SceneInstances
+	{
+		std::vector<BoundingBox> local_boxes;
+		std::vector<Uint32> submesh_indices;
+		std::vector<Matrix> world_transforms;
+
+		std::vector<InstanceGPU> instance_data;
+		std::vector<BoundingBox> world_boxes;
+		BoundingBoxSoA batch_bounds;
+		BoundingVolumeHierarchy batch_bvh;
+		std::vector<Uint32> dirty_indices;
+		std::vector<InstanceGPU> upload;	//stands in for the upload buffer Renderer writes with GfxBuffer::Update
+	};
+
+	SceneInstances MakeSceneInstances()
+	{
+		std::mt19937 rng(7);
+		std::uniform_real_distribution<Float> position(-1000.0f, 1000.0f);
+		std::uniform_real_distribution<Float> extent(0.2f, 4.0f);
+		std::uniform_real_distribution<Float> angle(0.0f, 6.28f);
+
+		SceneInstances scene{};
+		scene.local_boxes.resize(SubMeshCount);
+		for (BoundingBox& box : scene.local_boxes) box = BoundingBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(extent(rng), extent(rng), extent(rng)));
+		scene.submesh_indices.resize(InstanceCount);
+		scene.world_transforms.resize(InstanceCount);
+		for (Uint32 i = 0; i < InstanceCount; ++i)
+		{
+			scene.submesh_indices[i] = rng() % SubMeshCount;
+			scene.world_transforms[i] = Matrix::CreateRotationY(angle(rng)) * Matrix::CreateTranslation(position(rng), position(rng) * 0.05f, position(rng));
+		}
+		scene.instance_data.resize(InstanceCount);
+		scene.world_boxes.resize(InstanceCount);
+		scene.batch_bounds.Resize(InstanceCount);
+		scene.upload.resize(InstanceCount);
+		return scene;
+	}
+
+	void WriteSceneInstance(SceneInstances& scene, Uint32 instance_id)
+	{
+		Uint32 const submesh_index = scene.submesh_indices[instance_id];
+		scene.world_boxes[instance_id] = WriteInstance(scene.instance_data[instance_id], instance_id, submesh_index, submesh_index,
+			scene.world_transforms[instance_id], scene.local_boxes[submesh_index]);
+		scene.batch_bounds.Set(instance_id, scene.world_boxes[instance_id]);
+	}
+
+	//what a patched Transform or Mesh costs: rewrite the moved instances, refit the BVH and upload the merged dirty ranges
+	void UpdateMovedInstances(SceneInstances& scene, std::span<Uint32 const> moved_instances, Vector3 const& offset)
+	{
+		scene.dirty_indices.clear();
+		for (Uint32 instance_id : moved_instances)
+		{
+			scene.world_transforms[instance_id] *= Matrix::CreateTranslation(offset);
+			WriteSceneInstance(scene, instance_id);
+			scene.batch_bvh.UpdateBounds(instance_id, scene.world_boxes[instance_id]);
+			scene.dirty_indices.push_back(instance_id);
+		}
+		scene.batch_bvh.Refit();
+		ForEachDirtyRange(scene.dirty_indices, [&scene](Uint32 first_index, Uint32 count)
+			{
+				memcpy(scene.upload.data() + first_index, scene.instance_data.data() + first_index, count * sizeof(InstanceGPU));
+			});
+	}
+}
+
+ADRIA_BENCHMARK(SceneUpdate_Instances)
+{
+	SceneInstances scene = MakeSceneInstances();
+	std::string const count_label = std::to_string(InstanceCount) + " instances";
+
+	//what every frame cost before the incremental update, and still the cost of adding or removing a mesh
+	Measure((count_label + ", full rebuild").c_str(), 5, [&]()
+		{
+			for (Uint32 i = 0; i < InstanceCount; ++i) WriteSceneInstance(scene, i);
+			scene.batch_bvh.Build(scene.world_boxes);
+			memcpy(scene.upload.data(), scene.instance_data.data(), InstanceCount * sizeof(InstanceGPU));
+			Consume(scene.batch_bvh.GetNodeCount());
+		});
+
+	std::mt19937 rng(11);
+	for (Uint32 moved_count : { 1u, 100u, 1000u })
+	{
+		//scattered instances, e.g. dynamic props that each belong to a different mesh
+		std::vector<Uint32> moved_instances(moved_count);
+		for (Uint32& instance_id : moved_instances) instance_id = rng() % InstanceCount;
+		Measure((count_label + ", " + std::to_string(moved_count) + " scattered moved").c_str(), 20, [&]()
+			{
+				UpdateMovedInstances(scene, moved_instances, Vector3(0.01f, 0.0f, 0.0f));
+				Consume(scene.dirty_indices.size());
+			});
+	}
+
+	//one mesh entity whose instances are contiguous, a Transform patch uploads them with a single write
+	std::vector<Uint32> mesh_instances(1000);
+	for (Uint32 i = 0; i < mesh_instances.size(); ++i) mesh_instances[i] = 5000 + i;
+	Measure((count_label + ", 1000 instance mesh moved").c_str(), 20, [&]()
+		{
+			UpdateMovedInstances(scene, mesh_instances, Vector3(0.0f, 0.01f, 0.0f));
+			Consume(scene.dirty_indices.size());
+		});
+}
@@ -0,0 +1,288 @@
+#include <random>
+#include "TestFramework.h"
+#include "Math/BoundingVolumeHierarchy.h"
+#include "Math/BoundingBoxCulling.h"
+
+using namespace adria;
+
+namespace
+{
+	std::vector<BoundingBox> MakeRandomBoxes(Uint64 count, Uint32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<Float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<Float> extent(0.1f, 5.0f);
+		std::vector<BoundingBox> boxes(count);
+		for (BoundingBox& box : boxes)
+		{
+			box.Center = Vector3(position(rng), position(rng), position(rng));
+			box.Extents = Vector3(extent(rng), extent(rng), extent(rng));
+		}
+		return boxes;
+	}
+
+	Vector3 GetMin(BoundingBox const& box) { return Vector3(box.Center) - Vector3(box.Extents); }
+	Vector3 GetMax(BoundingBox const& box) { return Vector3(box.Center) + Vector3(box.Extents); }
+
+	template<typename Predicate>
+	std::vector<Uint32> BruteForceQuery(std::span<BoundingBox const> boxes, Predicate&& predicate)
+	{
+		std::vector<Uint32> ids;
+		for (Uint32 id = 0; id < boxes.size(); ++id)
+		{
+			if (predicate(GetMin(boxes[id]), GetMax(boxes[id]))) ids.push_back(id);
+		}
+		return ids;
+	}
+
+	std::vector<Uint32> Sorted(std::vector<Uint32> ids)
+	{
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+
+	Bool OutsideView(Vector3 const& min, Vector3 const& max, CullingView const& view)
+	{
+		for (Vector4 const& plane : view.planes)
+		{
+			Float const distance = plane.x * (min.x + max.x) * 0.5f + plane.y * (min.y + max.y) * 0.5f + plane.z * (min.z + max.z) * 0.5f + plane.w;
+			Float const radius = (std::abs(plane.x) * (max.x - min.x) + std::abs(plane.y) * (max.y - min.y) + std::abs(plane.z) * (max.z - min.z)) * 0.5f;
+			if (distance > radius) return true;
+		}
+		return false;
+	}
+
+	//six planes with random orientations around a point, a convex volume that is neither a frustum nor aligned to the boxes
+	CullingView MakeRandomView(std::mt19937& rng)
+	{
+		std::uniform_real_distribution<Float> position(-80.0f, 80.0f);
+		std::uniform_real_distribution<Float> distance(10.0f, 60.0f);
+		std::normal_distribution<Float> direction(0.0f, 1.0f);
+		Vector3 const center(position(rng), position(rng), position(rng));
+		CullingView view{};
+		for (Uint32 i = 0; i < 6; ++i)
+		{
+			Vector3 normal(direction(rng), direction(rng), direction(rng));
+			//one axis per plane pair keeps the volume bounded
+			(&normal.x)[i / 2] = (i % 2 ? -1.0f : 1.0f) * (2.0f + std::abs((&normal.x)[i / 2]));
+			normal.Normalize();
+			view.planes[i] = Vector4(normal.x, normal.y, normal.z, -normal.Dot(center) - distance(rng));
+		}
+		return view;
+	}
+
+	void CheckQueriesMatchBruteForce(BoundingVolumeHierarchy const& bvh, std::span<BoundingBox const> boxes, Uint32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<Float> position(-110.0f, 110.0f);
+		std::uniform_real_distribution<Float> size(1.0f, 40.0f);
+		std::normal_distribution<Float> direction(0.0f, 1.0f);
+		for (Uint32 query = 0; query < 32; ++query)
+		{
+			BoundingBox const query_box(Vector3(position(rng), position(rng), position(rng)), Vector3(size(rng), size(rng), size(rng)));
+			std::vector<Uint32> box_ids;
+			bvh.QueryBox(query_box, box_ids);
+			Vector3 const query_min = GetMin(query_box), query_max = GetMax(query_box);
+			ADRIA_CHECK(Sorted(box_ids) == BruteForceQuery(boxes, [&](Vector3 const& min, Vector3 const& max)
+				{
+					return min.x <= query_max.x && max.x >= query_min.x && min.y <= query_max.y && max.y >= query_min.y && min.z <= query_max.z && max.z >= query_min.z;
+				}));
+
+			BoundingSphere const sphere(Vector3(position(rng), position(rng), position(rng)), size(rng));
+			std::vector<Uint32> sphere_ids;
+			bvh.QuerySphere(sphere, sphere_ids);
+			ADRIA_CHECK(Sorted(sphere_ids) == BruteForceQuery(boxes, [&](Vector3 const& min, Vector3 const& max)
+				{
+					Float closest_sq = 0.0f;
+					for (Uint32 axis = 0; axis < 3; ++axis)
+					{
+						Float const center = (&sphere.Center.x)[axis];
+						Float const closest = std::clamp(center, (&min.x)[axis], (&max.x)[axis]) - center;
+						closest_sq += closest * closest;
+					}
+					return closest_sq <= sphere.Radius * sphere.Radius;
+				}));
+
+			Vector3 ray_direction(direction(rng), direction(rng), direction(rng));
+			ray_direction.Normalize();
+			Ray const ray(Vector3(position(rng), position(rng), position(rng)), ray_direction);
+			Float const max_distance = 5.0f * size(rng);
+			std::vector<Uint32> ray_ids;
+			bvh.QueryRay(ray, max_distance, ray_ids);
+			ADRIA_CHECK(Sorted(ray_ids) == BruteForceQuery(boxes, [&](Vector3 const& min, Vector3 const& max)
+				{
+					Float t_min = 0.0f, t_max = max_distance;
+					for (Uint32 axis = 0; axis < 3; ++axis)
+					{
+						Float const origin = (&ray.position.x)[axis], inv_direction = 1.0f / (&ray.direction.x)[axis];
+						Float t0 = ((&min.x)[axis] - origin) * inv_direction, t1 = ((&max.x)[axis] - origin) * inv_direction;
+						if (t0 > t1) std::swap(t0, t1);
+						t_min = std::max(t_min, t0);
+						t_max = std::min(t_max, t1);
+					}
+					return t_min <= t_max;
+				}));
+
+			BoundingFrustum const frustum(Vector3(position(rng), position(rng), position(rng)), Quaternion::Identity, 0.5f, -0.5f, 0.4f, -0.4f, 0.1f, 5.0f * size(rng));
+			std::vector<Uint32> frustum_ids;
+			bvh.QueryFrustum(frustum, frustum_ids);
+			CullingView const frustum_view = MakeCullingView(frustum);
+			ADRIA_CHECK(Sorted(frustum_ids) == BruteForceQuery(boxes, [&](Vector3 const& min, Vector3 const& max) { return !OutsideView(min, max, frustum_view); }));
+		}
+	}
+
+	void CheckMultiViewMatchesBruteForce(BoundingVolumeHierarchy const& bvh, std::span<BoundingBox const> boxes, Uint64 view_count, Uint32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::vector<CullingView> views(view_count);
+		for (CullingView& view : views) view = MakeRandomView(rng);
+
+		Uint64 const word_count = bvh.GetMaskWordCount();
+		std::vector<Uint64> visibility(view_count * word_count, ~0ull);
+		bvh.CullMultiView(views, visibility);
+		for (Uint64 v = 0; v < view_count; ++v)
+		{
+			std::span<Uint64 const> view_visibility(visibility.data() + v * word_count, word_count);
+			for (Uint32 id = 0; id < boxes.size(); ++id)
+			{
+				ADRIA_CHECK_EQ(IsVisible(view_visibility, id), !OutsideView(GetMin(boxes[id]), GetMax(boxes[id]), views[v]));
+			}
+		}
+	}
+}
+
+ADRIA_TEST(BoundingVolumeHierarchy_QueriesMatchBruteForce)
+{
+	for (Uint64 count : { 1ull, 5ull, 100ull, 3000ull })
+	{
+		std::vector<BoundingBox> const boxes = MakeRandomBoxes(count, (Uint32)count);
+		BoundingVolumeHierarchy bvh;
+		bvh.Build(boxes);
+		ADRIA_CHECK_EQ(bvh.GetPrimitiveCount(), count);
+		CheckQueriesMatchBruteForce(bvh, boxes, 3);
+	}
+}
+
+ADRIA_TEST(BoundingVolumeHierarchy_IdenticalBoxesBuildALeaf)
+{
+	//identical centroids can't be binned, the builder has to stop at a leaf instead of recursing forever
+	std::vector<BoundingBox> const boxes(200, BoundingBox(Vector3(1.0f, 2.0f, 3.0f), Vector3(0.5f, 0.5f, 0.5f)));
+	BoundingVolumeHierarchy bvh;
+	bvh.Build(boxes);
+	std::vector<Uint32> ids;
+	bvh.QueryBox(BoundingBox(Vector3(1.0f, 2.0f, 3.0f), Vector3(0.1f, 0.1f, 0.1f)), ids);
+	ADRIA_CHECK_EQ(ids.size(), boxes.size());
+}
+
+ADRIA_TEST(BoundingVolumeHierarchy_AxisAlignedRays)
+{
+	//unit boxes on an integer grid, rays along the axes start exactly on the faces shared by neighbouring boxes
+	std::vector<BoundingBox> boxes;
+	for (Int32 x = -8; x <= 8; ++x)
+		for (Int32 y = -8; y <= 8; ++y)
+			for (Int32 z = -8; z <= 8; z += 4) boxes.emplace_back(Vector3((Float)x, (Float)y, (Float)z), Vector3(0.5f, 0.5f, 0.5f));
+	BoundingVolumeHierarchy bvh;
+	bvh.Build(boxes);
+
+	for (Uint32 axis = 0; axis < 3; ++axis)
+	{
+		for (Float sign : { 1.0f, -1.0f })
+		{
+			Vector3 direction(0.0f, 0.0f, 0.0f);
+			(&direction.x)[axis] = sign;
+			Vector3 origin(1.5f, -2.5f, 0.5f);
+			(&origin.x)[axis] = -sign * 20.0f;
+			std::vector<Uint32> ids;
+			bvh.QueryRay(Ray(origin, direction), 25.0f, ids);
+			ADRIA_CHECK(!ids.empty());
+			ADRIA_CHECK(Sorted(ids) == BruteForceQuery(boxes, [&](Vector3 const& min, Vector3 const& max)
+				{
+					for (Uint32 other_axis = 0; other_axis < 3; ++other_axis)
+					{
+						if (other_axis == axis) continue;
+						Float const o = (&origin.x)[other_axis];
+						if (o < (&min.x)[other_axis] || o > (&max.x)[other_axis]) return false;
+					}
+					Float const start = (&origin.x)[axis], end = start + sign * 25.0f;
+					return std::min(start, end) <= (&max.x)[axis] && std::max(start, end) >= (&min.x)[axis];
+				}));
+		}
+	}
+}
+
+ADRIA_TEST(BoundingVolumeHierarchy_DegenerateSplitsStayWithinMaxDepth)
+{
+	//three arms of exponentially growing boxes, every SAH split peels a few boxes off the tip of an arm and the chain of nodes would get deeper than MaxDepth
+	std::vector<BoundingBox> boxes;
+	for (Int32 i = -56; i <= 56; ++i)
+	{
+		Float const distance = std::exp2((Float)i);
+		for (Uint32 axis = 0; axis < 3; ++axis)
+		{
+			Vector3 center(0.0f, 0.0f, 0.0f);
+			(&center.x)[axis] = distance;
+			boxes.emplace_back(center, Vector3(0.1f * distance, 0.1f * distance, 0.1f * distance));
+		}
+	}
+	BoundingVolumeHierarchy bvh;
+	bvh.Build(boxes);
+
+	std::vector<Uint32> ids;
+	bvh.QueryBox(BoundingBox(Vector3(0.0f, 0.0f, 0.0f), Vector3(1e18f, 1e18f, 1e18f)), ids);
+	ADRIA_CHECK_EQ(ids.size(), boxes.size());
+	CheckQueriesMatchBruteForce(bvh, boxes, 9);
+	CheckMultiViewMatchesBruteForce(bvh, boxes, 3, 10);
+}
+
+ADRIA_TEST(BoundingVolumeHierarchy_MultiViewMatchesBruteForce)
+{
+	std::vector<BoundingBox> const boxes = MakeRandomBoxes(2000, 21);
+	BoundingVolumeHierarchy bvh;
+	bvh.Build(boxes);
+	//more than 64 views are culled in groups of 64
+	CheckMultiViewMatchesBruteForce(bvh, boxes, 6, 5);
+	CheckMultiViewMatchesBruteForce(bvh, boxes, 70, 6);
+}
+
+ADRIA_TEST(BoundingVolumeHierarchy_MultiViewMatchesSoACulling)
+{
+	std::vector<BoundingBox> const boxes = MakeRandomBoxes(1000, 31);
+	BoundingVolumeHierarchy bvh;
+	bvh.Build(boxes);
+	BoundingBoxSoA soa_boxes;
+	soa_boxes.Resize(boxes.size());
+	for (Uint64 i = 0; i < boxes.size(); ++i) soa_boxes.Set(i, boxes[i]);
+
+	std::mt19937 rng(8);
+	std::vector<CullingView> views(4);
+	for (CullingView& view : views) view = MakeRandomView(rng);
+	std::vector<Uint64> bvh_visibility(views.size() * bvh.GetMaskWordCount());
+	std::vector<Uint64> soa_visibility(views.size() * soa_boxes.GetMaskWordCount());
+	bvh.CullMultiView(views, bvh_visibility);
+	CullBoundingBoxesMultiView(views, soa_boxes, soa_visibility);
+	ADRIA_CHECK(bvh_visibility == soa_visibility);
+}
+
+ADRIA_TEST(BoundingVolumeHierarchy_RefitFollowsMovedBoxes)
+{
+	std::vector<BoundingBox> boxes = MakeRandomBoxes(2000, 41);
+	BoundingVolumeHierarchy bvh;
+	bvh.Build(boxes);
+
+	//a few moved boxes refit their paths to the root, many moved boxes refit every node
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<Uint32> id(0, (Uint32)boxes.size() - 1);
+	std::uniform_real_distribution<Float> offset(-60.0f, 60.0f);
+	for (Uint32 moved_count : { 10u, 1500u })
+	{
+		for (Uint32 i = 0; i < moved_count; ++i)
+		{
+			Uint32 const moved_id = id(rng);
+			boxes[moved_id].Center = Vector3(boxes[moved_id].Center) + Vector3(offset(rng), offset(rng), offset(rng));
+			bvh.UpdateBounds(moved_id, boxes[moved_id]);
+		}
+		bvh.Refit();
+		CheckQueriesMatchBruteForce(bvh, boxes, moved_count);
+		CheckMultiViewMatchesBruteForce(bvh, boxes, 8, moved_count + 1);
+	}
+}
@@ -0,0 +1,381 @@
+#define CGLTF_IMPLEMENTATION
+#include "cgltf.h"
+#include <filesystem>
+#include <random>
+#include "TestFramework.h"
+#include "Rendering/GLTFAccessorReader.h"
+
+using namespace adria;
+
+namespace
+{
+	//a buffer, its view and an accessor over it, optionally with sparse substitutions in two more buffers
+	struct TestAccessor
+	{
+		std::vector<Uint8> data;
+		cgltf_buffer buffer{};
+		cgltf_buffer_view view{};
+
+		std::vector<Uint8> sparse_indices_data;
+		std::vector<Uint8> sparse_values_data;
+		cgltf_buffer sparse_indices_buffer{};
+		cgltf_buffer sparse_values_buffer{};
+		cgltf_buffer_view sparse_indices_view{};
+		cgltf_buffer_view sparse_values_view{};
+
+		cgltf_accessor accessor{};
+	};
+
+	struct TestAccessorDesc
+	{
+		cgltf_type type = cgltf_type_scalar;
+		cgltf_component_type component_type = cgltf_component_type_r_32f;
+		Bool normalized = false;
+		Uint64 count = 0;
+		//bytes between elements on top of the element size, 0 is tightly packed
+		Uint64 stride_padding = 0;
+		Uint64 offset = 0;
+		Bool has_buffer_view = true;
+		Uint64 sparse_count = 0;
+		cgltf_component_type sparse_indices_component_type = cgltf_component_type_r_16u;
+	};
+
+	void FillRandom(std::vector<Uint8>& data, cgltf_component_type component_type, std::mt19937& rng)
+	{
+		std::uniform_int_distribution<Uint32> byte(0, 255);
+		for (Uint8& value : data) value = (Uint8)byte(rng);
+		//random bytes can be NaNs, finite floats compare the same bitwise and by value
+		if (component_type == cgltf_component_type_r_32f)
+		{
+			std::uniform_real_distribution<Float> value(-1000.0f, 1000.0f);
+			for (Uint64 i = 0; i + sizeof(Float) <= data.size(); i += sizeof(Float))
+			{
+				Float const random_value = value(rng);
+				memcpy(data.data() + i, &random_value, sizeof(Float));
+			}
+		}
+	}
+
+	//index values have to stay below the vertex count, indices keep their component size but are limited to the count
+	void FillRandomIndices(std::vector<Uint8>& data, cgltf_component_type component_type, Uint64 max_index, std::mt19937& rng)
+	{
+		std::uniform_int_distribution<Uint32> index(0, (Uint32)max_index);
+		Uint64 const index_size = cgltf_component_size(component_type);
+		for (Uint64 i = 0; i + index_size <= data.size(); i += index_size)
+		{
+			Uint32 const value = index(rng);
+			memcpy(data.data() + i, &value, index_size);
+		}
+	}
+
+	void SetBufferView(cgltf_buffer& buffer, cgltf_buffer_view& view, std::vector<Uint8>& data)
+	{
+		buffer.size = data.size();
+		buffer.data = data.data();
+		view.buffer = &buffer;
+		view.offset = 0;
+		view.size = data.size();
+	}
+
+	std::unique_ptr<TestAccessor> MakeAccessor(TestAccessorDesc const& desc, Bool indices, std::mt19937& rng)
+	{
+		std::unique_ptr<TestAccessor> test_accessor = std::make_unique<TestAccessor>();
+		cgltf_accessor& accessor = test_accessor->accessor;
+		accessor.type = desc.type;
+		accessor.component_type = desc.component_type;
+		accessor.normalized = desc.normalized;
+		accessor.count = desc.count;
+		accessor.stride = cgltf_calc_size(desc.type, desc.component_type) + desc.stride_padding;
+		accessor.offset = desc.offset;
+
+		Uint64 const max_index = std::min<Uint64>(desc.count, desc.component_type == cgltf_component_type_r_8u ? 255 : 65535);
+		if (desc.has_buffer_view)
+		{
+			test_accessor->data.resize(desc.offset + desc.count * accessor.stride);
+			if (indices) FillRandomIndices(test_accessor->data, desc.component_type, max_index, rng);
+			else FillRandom(test_accessor->data, desc.component_type, rng);
+			SetBufferView(test_accessor->buffer, test_accessor->view, test_accessor->data);
+			accessor.buffer_view = &test_accessor->view;
+		}
+
+		if (desc.sparse_count > 0)
+		{
+			accessor.is_sparse = true;
+			cgltf_accessor_sparse& sparse = accessor.sparse;
+			sparse.count = desc.sparse_count;
+			sparse.indices_component_type = desc.sparse_indices_component_type;
+
+			//substituted elements are strictly increasing, spread over the whole accessor
+			Uint64 const sparse_index_size = cgltf_component_size(desc.sparse_indices_component_type);
+			test_accessor->sparse_indices_data.resize(desc.sparse_count * sparse_index_size);
+			for (Uint64 i = 0; i < desc.sparse_count; ++i)
+			{
+				Uint32 const element = (Uint32)(i * desc.count / desc.sparse_count);
+				memcpy(test_accessor->sparse_indices_data.data() + i * sparse_index_size, &element, sparse_index_size);
+			}
+			//sparse values are tightly packed, unlike the accessor itself
+			test_accessor->sparse_values_data.resize(desc.sparse_count * cgltf_calc_size(desc.type, desc.component_type));
+			if (indices) FillRandomIndices(test_accessor->sparse_values_data, desc.component_type, max_index, rng);
+			else FillRandom(test_accessor->sparse_values_data, desc.component_type, rng);
+
+			SetBufferView(test_accessor->sparse_indices_buffer, test_accessor->sparse_indices_view, test_accessor->sparse_indices_data);
+			SetBufferView(test_accessor->sparse_values_buffer, test_accessor->sparse_values_view, test_accessor->sparse_values_data);
+			sparse.indices_buffer_view = &test_accessor->sparse_indices_view;
+			sparse.values_buffer_view = &test_accessor->sparse_values_view;
+		}
+		return test_accessor;
+	}
+
+	//cgltf_accessor_read_* refuse sparse accessors, the reference reads the base elements and the substituted ones as two plain accessors
+	cgltf_accessor GetBaseAccessor(cgltf_accessor const& accessor)
+	{
+		cgltf_accessor base_accessor = accessor;
+		base_accessor.is_sparse = false;
+		return base_accessor;
+	}
+	cgltf_accessor GetSparseValuesAccessor(cgltf_accessor const& accessor)
+	{
+		cgltf_accessor values_accessor = GetBaseAccessor(accessor);
+		values_accessor.buffer_view = accessor.sparse.values_buffer_view;
+		values_accessor.offset = accessor.sparse.values_byte_offset;
+		values_accessor.count = accessor.sparse.count;
+		values_accessor.stride = cgltf_calc_size(accessor.type, accessor.component_type);
+		return values_accessor;
+	}
+	Uint64 GetSparseElement(cgltf_accessor const& accessor, Uint64 i)
+	{
+		cgltf_accessor indices_accessor{};
+		indices_accessor.type = cgltf_type_scalar;
+		indices_accessor.component_type = accessor.sparse.indices_component_type;
+		indices_accessor.count = accessor.sparse.count;
+		indices_accessor.stride = cgltf_component_size(accessor.sparse.indices_component_type);
+		indices_accessor.buffer_view = accessor.sparse.indices_buffer_view;
+		indices_accessor.offset = accessor.sparse.indices_byte_offset;
+		return cgltf_accessor_read_index(&indices_accessor, i);
+	}
+
+	std::vector<Uint32> ReadReferenceIndices(cgltf_accessor const& accessor, Bool flip_winding)
+	{
+		cgltf_accessor const base_accessor = GetBaseAccessor(accessor);
+		std::vector<Uint32> indices(accessor.count);
+		for (Uint64 i = 0; i < accessor.count; ++i) indices[i] = (Uint32)cgltf_accessor_read_index(&base_accessor, i);
+		if (accessor.is_sparse)
+		{
+			cgltf_accessor const values_accessor = GetSparseValuesAccessor(accessor);
+			for (Uint64 i = 0; i < accessor.sparse.count; ++i) indices[GetSparseElement(accessor, i)] = (Uint32)cgltf_accessor_read_index(&values_accessor, i);
+		}
+		if (flip_winding)
+		{
+			for (Uint64 t = 0; t + 3 <= indices.size(); t += 3) std::swap(indices[t + 1], indices[t + 2]);
+		}
+		return indices;
+	}
+
+	template<typename T>
+	std::vector<T> ReadReferenceAttribute(cgltf_accessor const& accessor)
+	{
+		Uint64 const component_count = cgltf_num_components(accessor.type);
+		Uint64 const copied_component_count = std::min<Uint64>(component_count, sizeof(T) / sizeof(Float));
+		std::vector<T> stream(accessor.count, T{});
+		auto ReadElement = [&](cgltf_accessor const& source, Uint64 source_index, T& element)
+			{
+				Float components[16] = {};
+				ADRIA_CHECK(cgltf_accessor_read_float(&source, source_index, components, component_count));
+				memcpy(&element, components, copied_component_count * sizeof(Float));
+			};
+
+		cgltf_accessor const base_accessor = GetBaseAccessor(accessor);
+		for (Uint64 i = 0; i < accessor.count; ++i) ReadElement(base_accessor, i, stream[i]);
+		if (accessor.is_sparse)
+		{
+			cgltf_accessor const values_accessor = GetSparseValuesAccessor(accessor);
+			for (Uint64 i = 0; i < accessor.sparse.count; ++i) ReadElement(values_accessor, i, stream[GetSparseElement(accessor, i)]);
+		}
+		return stream;
+	}
+
+	template<typename T>
+	Bool BitwiseEqual(std::vector<T> const& lhs, std::vector<T> const& rhs)
+	{
+		return lhs.size() == rhs.size() && memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+	}
+
+	template<typename T>
+	void CheckAttributeMatchesReference(cgltf_accessor const& accessor)
+	{
+		std::vector<T> stream;
+		ReadGLTFAttribute(&accessor, stream);
+		ADRIA_CHECK(BitwiseEqual(stream, ReadReferenceAttribute<T>(accessor)));
+	}
+
+	void CheckAttributeMatchesReference(cgltf_accessor const& accessor)
+	{
+		CheckAttributeMatchesReference<Vector2>(accessor);
+		CheckAttributeMatchesReference<Vector3>(accessor);
+		CheckAttributeMatchesReference<Vector4>(accessor);
+	}
+
+	constexpr cgltf_component_type IndexComponentTypes[] = { cgltf_component_type_r_8u, cgltf_component_type_r_16u, cgltf_component_type_r_32u };
+
+	//the models shipped in Adria/Resources, found relative to this file so the working directory doesn't matter
+	std::filesystem::path GetModelPath(Char const* model)
+	{
+		return std::filesystem::path(__FILE__).parent_path().parent_path() / "Adria" / "Resources" / "Models" / model;
+	}
+
+	//checks the index and attribute accessors of every primitive of the model, returns how many were checked
+	Uint64 CheckModelMatchesReference(std::filesystem::path const& model_path)
+	{
+		std::string const model_path_string = model_path.string();
+		cgltf_options options{};
+		cgltf_data* gltf_data = nullptr;
+		Bool const loaded = cgltf_parse_file(&options, model_path_string.c_str(), &gltf_data) == cgltf_result_success
+						 && cgltf_load_buffers(&options, gltf_data, model_path_string.c_str()) == cgltf_result_success;
+		ADRIA_CHECK(loaded);
+		if (!loaded)
+		{
+			cgltf_free(gltf_data);
+			return 0;
+		}
+
+		Uint64 checked_accessor_count = 0;
+		for (Uint64 i = 0; i < gltf_data->meshes_count; ++i)
+		{
+			cgltf_mesh const& mesh = gltf_data->meshes[i];
+			for (Uint64 j = 0; j < mesh.primitives_count; ++j)
+			{
+				cgltf_primitive const& primitive = mesh.primitives[j];
+				if (primitive.indices)
+				{
+					for (Bool flip_winding : { false, true })
+					{
+						std::vector<Uint32> indices;
+						ReadGLTFIndices(primitive.indices, flip_winding, indices);
+						ADRIA_CHECK(indices == ReadReferenceIndices(*primitive.indices, flip_winding));
+					}
+					++checked_accessor_count;
+				}
+				for (Uint64 k = 0; k < primitive.attributes_count; ++k)
+				{
+					CheckAttributeMatchesReference(*primitive.attributes[k].data);
+					++checked_accessor_count;
+				}
+			}
+		}
+		cgltf_free(gltf_data);
+		return checked_accessor_count;
+	}
+}
+
+ADRIA_TEST(GLTFAccessorReader_IndicesMatchCgltf)
+{
+	std::mt19937 rng(5);
+	//counts that leave a tail after the 16 and 8 wide widening loops and the four triangle winding loop
+	for (Uint64 count : { 3ull, 36ull, 3ull * 397 })
+	{
+		for (cgltf_component_type component_type : IndexComponentTypes)
+		{
+			Uint64 const component_size = cgltf_component_size(component_type);
+			for (Uint64 stride_padding : { Uint64(0), component_size, Uint64(4) })
+			{
+				for (Bool flip_winding : { false, true })
+				{
+					TestAccessorDesc desc{ .type = cgltf_type_scalar, .component_type = component_type, .count = count, .stride_padding = stride_padding, .offset = 4 * component_size };
+					std::unique_ptr<TestAccessor> test_accessor = MakeAccessor(desc, true, rng);
+
+					std::vector<Uint32> indices;
+					ReadGLTFIndices(&test_accessor->accessor, flip_winding, indices);
+					ADRIA_CHECK(indices == ReadReferenceIndices(test_accessor->accessor, flip_winding));
+				}
+			}
+		}
+	}
+}
+
+ADRIA_TEST(GLTFAccessorReader_SparseIndicesMatchCgltf)
+{
+	std::mt19937 rng(6);
+	for (cgltf_component_type component_type : IndexComponentTypes)
+	{
+		for (cgltf_component_type sparse_indices_component_type : IndexComponentTypes)
+		{
+			for (Bool has_buffer_view : { true, false })
+			{
+				for (Uint64 stride_padding : { 0ull, 4ull })
+				{
+					TestAccessorDesc desc{ .type = cgltf_type_scalar, .component_type = component_type, .count = 3 * 40, .stride_padding = stride_padding,
+						.has_buffer_view = has_buffer_view, .sparse_count = 17, .sparse_indices_component_type = sparse_indices_component_type };
+					std::unique_ptr<TestAccessor> test_accessor = MakeAccessor(desc, true, rng);
+
+					std::vector<Uint32> indices;
+					ReadGLTFIndices(&test_accessor->accessor, true, indices);
+					ADRIA_CHECK(indices == ReadReferenceIndices(test_accessor->accessor, true));
+				}
+			}
+		}
+	}
+}
+
+ADRIA_TEST(GLTFAccessorReader_AttributesMatchCgltf)
+{
+	struct ComponentFormat
+	{
+		cgltf_component_type component_type;
+		Bool normalized;
+	};
+	ComponentFormat const component_formats[] =
+	{
+		{ cgltf_component_type_r_32f, false },
+		{ cgltf_component_type_r_32u, false },
+		{ cgltf_component_type_r_16u, false }, { cgltf_component_type_r_16u, true },
+		{ cgltf_component_type_r_16,  false }, { cgltf_component_type_r_16,  true },
+		{ cgltf_component_type_r_8u,  false }, { cgltf_component_type_r_8u,  true },
+		{ cgltf_component_type_r_8,   false }, { cgltf_component_type_r_8,   true },
+	};
+
+	std::mt19937 rng(7);
+	for (cgltf_type type : { cgltf_type_vec2, cgltf_type_vec3, cgltf_type_vec4 })
+	{
+		for (ComponentFormat const& format : component_formats)
+		{
+			//packed, padded to the next 4 bytes like interleaved vertex buffers and a whole unrelated attribute in between
+			for (Uint64 stride_padding : { Uint64(0), Uint64(4 - cgltf_calc_size(type, format.component_type) % 4), Uint64(12) })
+			{
+				TestAccessorDesc desc{ .type = type, .component_type = format.component_type, .normalized = format.normalized, .count = 257, .stride_padding = stride_padding, .offset = 8 };
+				std::unique_ptr<TestAccessor> test_accessor = MakeAccessor(desc, false, rng);
+				CheckAttributeMatchesReference(test_accessor->accessor);
+			}
+		}
+	}
+}
+
+ADRIA_TEST(GLTFAccessorReader_SparseAttributesMatchCgltf)
+{
+	std::mt19937 rng(8);
+	for (cgltf_type type : { cgltf_type_vec2, cgltf_type_vec3, cgltf_type_vec4 })
+	{
+		for (cgltf_component_type component_type : { cgltf_component_type_r_32f, cgltf_component_type_r_16, cgltf_component_type_r_8u })
+		{
+			for (Bool has_buffer_view : { true, false })
+			{
+				//morph targets are the common case, sparse accessors without a buffer view start from zeros
+				TestAccessorDesc desc{ .type = type, .component_type = component_type, .normalized = component_type != cgltf_component_type_r_32f, .count = 100,
+					.stride_padding = has_buffer_view ? 4ull : 0ull, .has_buffer_view = has_buffer_view, .sparse_count = 9, .sparse_indices_component_type = cgltf_component_type_r_8u };
+				std::unique_ptr<TestAccessor> test_accessor = MakeAccessor(desc, false, rng);
+				CheckAttributeMatchesReference(test_accessor->accessor);
+			}
+		}
+	}
+}
+
+ADRIA_TEST(GLTFAccessorReader_ToyCarMatchesCgltf)
+{
+	ADRIA_CHECK(CheckModelMatchesReference(GetModelPath("ToyCar/ToyCar.gltf")) > 0);
+}
+
+ADRIA_TEST(GLTFAccessorReader_SponzaMatchesCgltf)
+{
+	//the repository ships Sponza.gltf without its buffer
+	if (!std::filesystem::exists(GetModelPath("Sponza/Sponza.bin"))) return;
+	ADRIA_CHECK(CheckModelMatchesReference(GetModelPath("Sponza/Sponza.gltf")) > 0);
+}
@@ -0,0 +1,190 @@
+#include <random>
+#include "TestFramework.h"
+#include "RenderGraph/RenderGraphAliasing.h"
+
+using namespace adria;
+
+namespace
+{
+	Bool LifetimesOverlap(RGAliasingRequest const& a, RGAliasingRequest const& b)
+	{
+		return a.first_level <= b.last_level && b.first_level <= a.last_level;
+	}
+
+	Bool MemoryOverlaps(RGAliasingLayout const& layout, std::span<RGAliasingRequest const> requests, Uint64 i, Uint64 j)
+	{
+		return layout.offsets[i] < layout.offsets[j] + requests[j].size && layout.offsets[j] < layout.offsets[i] + requests[i].size;
+	}
+
+	//largest sum of sizes of requests alive in the same level, no placement can use less memory
+	Uint64 ComputePeakLiveSize(std::span<RGAliasingRequest const> requests)
+	{
+		Uint32 level_count = 0;
+		for (RGAliasingRequest const& request : requests) level_count = std::max(level_count, request.last_level + 1);
+
+		Uint64 peak_live_size = 0;
+		for (Uint32 level = 0; level < level_count; ++level)
+		{
+			Uint64 live_size = 0;
+			for (RGAliasingRequest const& request : requests)
+			{
+				if (request.first_level <= level && level <= request.last_level) live_size += request.size;
+			}
+			peak_live_size = std::max(peak_live_size, live_size);
+		}
+		return peak_live_size;
+	}
+
+	void CheckLayout(std::span<RGAliasingRequest const> requests, RGAliasingLayout const& layout)
+	{
+		ADRIA_CHECK_EQ(layout.offsets.size(), requests.size());
+		ADRIA_CHECK_EQ(layout.aliased.size(), requests.size());
+
+		Uint64 unaliased_size = 0;
+		Uint64 padded_size = 0;
+		Uint64 heap_size = 0;
+		Uint64 heap_alignment = 0;
+		for (Uint64 i = 0; i < requests.size(); ++i)
+		{
+			ADRIA_CHECK(layout.offsets[i] % requests[i].alignment == 0);
+			unaliased_size += requests[i].size;
+			padded_size += requests[i].size + requests[i].alignment - 1;
+			heap_size = std::max(heap_size, layout.offsets[i] + requests[i].size);
+			heap_alignment = std::max(heap_alignment, requests[i].alignment);
+
+			Bool aliased = false;
+			for (Uint64 j = 0; j < requests.size(); ++j)
+			{
+				if (i == j || !MemoryOverlaps(layout, requests, i, j)) continue;
+				ADRIA_CHECK(!LifetimesOverlap(requests[i], requests[j]));
+				aliased = true;
+			}
+			ADRIA_CHECK_EQ(layout.aliased[i], aliased);
+		}
+		ADRIA_CHECK_EQ(layout.unaliased_size, unaliased_size);
+		ADRIA_CHECK_EQ(layout.heap_size, heap_size);
+		ADRIA_CHECK_EQ(layout.heap_alignment, heap_alignment);
+		ADRIA_CHECK_EQ(layout.peak_live_size, ComputePeakLiveSize(requests));
+		ADRIA_CHECK(layout.heap_size >= layout.peak_live_size);
+		ADRIA_CHECK(layout.heap_size <= padded_size);
+	}
+}
+
+ADRIA_TEST(Aliasing_Empty)
+{
+	RGAliasingLayout const layout = ComputeAliasingLayout({});
+	ADRIA_CHECK(layout.offsets.empty());
+	ADRIA_CHECK_EQ(layout.heap_size, 0u);
+	ADRIA_CHECK_EQ(layout.unaliased_size, 0u);
+	ADRIA_CHECK_EQ(layout.peak_live_size, 0u);
+}
+
+ADRIA_TEST(Aliasing_DisjointLifetimesShareMemory)
+{
+	RGAliasingRequest const requests[] =
+	{
+		RGAliasingRequest{ 4096, 1024, 0, 1 },
+		RGAliasingRequest{ 2048, 1024, 2, 3 },
+		RGAliasingRequest{ 4096, 1024, 4, 4 },
+	};
+	RGAliasingLayout const layout = ComputeAliasingLayout(requests);
+	CheckLayout(requests, layout);
+	ADRIA_CHECK_EQ(layout.offsets[0], 0u);
+	ADRIA_CHECK_EQ(layout.offsets[1], 0u);
+	ADRIA_CHECK_EQ(layout.offsets[2], 0u);
+	ADRIA_CHECK(layout.aliased[0] && layout.aliased[1] && layout.aliased[2]);
+	ADRIA_CHECK_EQ(layout.heap_size, 4096u);
+	ADRIA_CHECK_EQ(layout.unaliased_size, 10240u);
+}
+
+ADRIA_TEST(Aliasing_OverlappingLifetimesDoNotAlias)
+{
+	RGAliasingRequest const requests[] =
+	{
+		RGAliasingRequest{ 4096, 1024, 0, 2 },
+		RGAliasingRequest{ 4096, 1024, 1, 3 },
+	};
+	RGAliasingLayout const layout = ComputeAliasingLayout(requests);
+	CheckLayout(requests, layout);
+	ADRIA_CHECK(!layout.aliased[0] && !layout.aliased[1]);
+	ADRIA_CHECK_EQ(layout.heap_size, 8192u);
+}
+
+ADRIA_TEST(Aliasing_OnlyRealOverlapsAreAliased)
+{
+	//the small request fits next to the large one and never shares memory even though the heap is reused over time
+	RGAliasingRequest const requests[] =
+	{
+		RGAliasingRequest{ 8192, 1024, 0, 3 },
+		RGAliasingRequest{ 4096, 1024, 0, 0 },
+		RGAliasingRequest{ 4096, 1024, 2, 3 },
+		RGAliasingRequest{ 1024, 1024, 1, 1 },
+	};
+	RGAliasingLayout const layout = ComputeAliasingLayout(requests);
+	CheckLayout(requests, layout);
+	ADRIA_CHECK(!layout.aliased[0]);
+	ADRIA_CHECK(layout.aliased[1] && layout.aliased[2] && layout.aliased[3]);
+	ADRIA_CHECK_EQ(layout.heap_size, 12288u);
+}
+
+ADRIA_TEST(Aliasing_AlignmentGaps)
+{
+	RGAliasingRequest const requests[] =
+	{
+		RGAliasingRequest{ 65536 + 256, 65536, 0, 1 },
+		RGAliasingRequest{ 65536, 65536, 0, 1 },
+		RGAliasingRequest{ 256, 256, 0, 1 },
+	};
+	RGAliasingLayout const layout = ComputeAliasingLayout(requests);
+	CheckLayout(requests, layout);
+	ADRIA_CHECK_EQ(layout.offsets[0], 0u);
+	ADRIA_CHECK_EQ(layout.offsets[1], 131072u);
+	ADRIA_CHECK_EQ(layout.offsets[2], 65536u + 256u);
+	ADRIA_CHECK_EQ(layout.heap_alignment, 65536u);
+}
+
+ADRIA_TEST(Aliasing_PeakMemory)
+{
+	//nested lifetimes of equal sized requests pack into exactly the peak live memory
+	RGAliasingRequest const requests[] =
+	{
+		RGAliasingRequest{ 1024, 1024, 0, 5 },
+		RGAliasingRequest{ 1024, 1024, 0, 1 },
+		RGAliasingRequest{ 1024, 1024, 2, 3 },
+		RGAliasingRequest{ 1024, 1024, 4, 5 },
+		RGAliasingRequest{ 1024, 1024, 1, 2 },
+		RGAliasingRequest{ 1024, 1024, 3, 4 },
+	};
+	RGAliasingLayout const layout = ComputeAliasingLayout(requests);
+	CheckLayout(requests, layout);
+	ADRIA_CHECK_EQ(layout.peak_live_size, 3072u);
+	ADRIA_CHECK_EQ(layout.heap_size, 3072u);
+	ADRIA_CHECK_EQ(layout.unaliased_size, 6144u);
+}
+
+ADRIA_TEST(Aliasing_RandomLayouts)
+{
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<Uint32> size_distribution(1, 64);
+	std::uniform_int_distribution<Uint32> alignment_distribution(0, 2);
+	std::uniform_int_distribution<Uint32> level_distribution(0, 15);
+	std::uniform_int_distribution<Uint32> count_distribution(1, 40);
+	Uint64 const alignments[] = { 4096, 65536, 4 * 1024 * 1024 };
+
+	std::vector<RGAliasingRequest> requests;
+	for (Uint32 iteration = 0; iteration < 200; ++iteration)
+	{
+		requests.resize(count_distribution(rng));
+		for (RGAliasingRequest& request : requests)
+		{
+			request.alignment = alignments[alignment_distribution(rng)];
+			request.size = size_distribution(rng) * request.alignment;
+			request.first_level = level_distribution(rng);
+			request.last_level = std::max(request.first_level, level_distribution(rng));
+		}
+		RGAliasingLayout const layout = ComputeAliasingLayout(requests);
+		CheckLayout(requests, layout);
+		//sizes are multiples of the alignments like texture allocations so aliasing never costs memory
+		ADRIA_CHECK(layout.heap_size <= layout.unaliased_size);
+	}
+}
@@ -0,0 +1,58 @@
+#include "TestFramework.h"
+#include "RenderGraph/RenderGraphAllocator.h"
+
+using namespace adria;
+
+namespace
+{
+	struct alignas(256) OverAlignedData
+	{
+		Uint8 data[48];
+	};
+
+	struct NonTrivialData
+	{
+		explicit NonTrivialData(Uint32& destroy_count) : destroy_count(destroy_count) {}
+		~NonTrivialData() { ++destroy_count; }
+
+		Uint32& destroy_count;
+		alignas(64) Uint8 data[16];
+	};
+}
+
+ADRIA_TEST(RenderGraphAllocator_AlignsAddresses)
+{
+	RGAllocator allocator(1024);
+	for (Uint32 i = 0; i < 64; ++i)
+	{
+		std::span<Uint8> bytes = allocator.AllocateArray<Uint8>(i + 1);
+		ADRIA_CHECK_EQ(bytes.size(), i + 1);
+
+		std::span<OverAlignedData> over_aligned = allocator.AllocateArray<OverAlignedData>(2);
+		ADRIA_CHECK(reinterpret_cast<Uintptr>(over_aligned.data()) % alignof(OverAlignedData) == 0);
+
+		void* page_aligned = allocator.Allocate(16, 4096);
+		ADRIA_CHECK(reinterpret_cast<Uintptr>(page_aligned) % 4096 == 0);
+	}
+	ADRIA_CHECK(allocator.GetChunkCount() > 1);
+}
+
+ADRIA_TEST(RenderGraphAllocator_ResetKeepsAlignment)
+{
+	RGAllocator allocator(512);
+	Uint32 destroy_count = 0;
+	for (Uint32 frame = 0; frame < 4; ++frame)
+	{
+		for (Uint32 i = 0; i < 32; ++i)
+		{
+			NonTrivialData* object = allocator.AllocateObject<NonTrivialData>(destroy_count);
+			ADRIA_CHECK(reinterpret_cast<Uintptr>(object) % alignof(NonTrivialData) == 0);
+			std::span<OverAlignedData> over_aligned = allocator.AllocateArray<OverAlignedData>(1);
+			ADRIA_CHECK(reinterpret_cast<Uintptr>(over_aligned.data()) % alignof(OverAlignedData) == 0);
+		}
+		allocator.Reset();
+		ADRIA_CHECK_EQ(destroy_count, 32u * (frame + 1));
+	}
+	//after the first frame the high water mark fits in one chunk
+	ADRIA_CHECK_EQ(allocator.GetChunkCount(), 1u);
+}
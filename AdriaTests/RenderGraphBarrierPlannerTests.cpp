@@ -0,0 +1,227 @@
+#include "TestFramework.h"
+#include "RenderGraph/RenderGraphBarrierPlanner.h"
+#include "RenderGraph/RenderGraphAliasing.h"
+
+using namespace adria;
+
+namespace
+{
+	using enum GfxResourceState;
+
+	struct BarrierPlan
+	{
+		std::vector<RGBarrierPlanUse> uses;
+		std::vector<Bool> fixed_resources;
+		std::vector<Bool> level_fences;
+		RGBarrierPlanStats stats;
+
+		BarrierPlan(Uint32 resource_count, Uint32 level_count) : fixed_resources(resource_count, false), level_fences(level_count, false) {}
+
+		void AddUse(Uint32 resource, Uint32 level, GfxResourceState state)
+		{
+			RGBarrierPlanUse& use = uses.emplace_back();
+			use.resource = resource;
+			use.level = level;
+			use.state = state;
+		}
+
+		void Plan()
+		{
+			std::unique_ptr<Bool[]> fixed(new Bool[fixed_resources.size()]);
+			std::unique_ptr<Bool[]> fences(new Bool[level_fences.size()]);
+			std::copy(fixed_resources.begin(), fixed_resources.end(), fixed.get());
+			std::copy(level_fences.begin(), level_fences.end(), fences.get());
+
+			RGBarrierPlanInput input{};
+			input.uses = uses;
+			input.resource_count = (Uint32)fixed_resources.size();
+			input.fixed_resources = std::span<Bool const>(fixed.get(), fixed_resources.size());
+			input.level_fences = std::span<Bool const>(fences.get(), level_fences.size());
+			stats = PlanBarriers(input);
+		}
+	};
+
+	//the fields of a dependency level state entry GetBarrierBeforeUse reads
+	struct StateEntry
+	{
+		GfxResourceState state = Common;
+		GfxResourceState prev_state = Common;
+		Bool has_prev_state = false;
+		Bool created = false;
+		Bool split_end = false;
+	};
+
+	StateEntry MakeStateEntry(RGBarrierPlanUse const& use, Bool created)
+	{
+		StateEntry entry{};
+		entry.state = use.planned_state;
+		entry.prev_state = use.has_prev_state ? use.prev_state : Common;
+		entry.has_prev_state = use.has_prev_state;
+		entry.created = created;
+		entry.split_end = use.split_end;
+		return entry;
+	}
+}
+
+ADRIA_TEST(BarrierPlanner_ReadToWrite)
+{
+	BarrierPlan plan(1, 2);
+	plan.AddUse(0, 0, PixelSRV);
+	plan.AddUse(0, 1, RTV);
+	plan.Plan();
+
+	RGBarrierPlanUse const& read = plan.uses[0];
+	RGBarrierPlanUse const& write = plan.uses[1];
+	ADRIA_CHECK(!read.has_prev_state);
+	ADRIA_CHECK(!read.split_begin);
+	ADRIA_CHECK(write.has_prev_state);
+	ADRIA_CHECK(write.prev_state == PixelSRV);
+	ADRIA_CHECK(write.planned_state == RTV);
+	ADRIA_CHECK(!write.split_end);
+	ADRIA_CHECK_EQ(plan.stats.requested_barrier_count, 1u);
+	ADRIA_CHECK_EQ(plan.stats.planned_barrier_count, 1u);
+	ADRIA_CHECK_EQ(plan.stats.split_barrier_count, 0u);
+
+	RGBarrier const barrier = GetBarrierBeforeUse(MakeStateEntry(write, false), RGBarrierResource{});
+	ADRIA_CHECK(barrier == (RGBarrier{ RGBarrierType::Transition, PixelSRV, RTV }));
+}
+
+ADRIA_TEST(BarrierPlanner_WriteToRead)
+{
+	BarrierPlan plan(1, 3);
+	plan.AddUse(0, 0, RTV);
+	plan.AddUse(0, 1, PixelSRV);
+	plan.AddUse(0, 2, ComputeSRV);
+	plan.Plan();
+
+	//consecutive reads are merged into one read state so only the write to read transition is left
+	for (Uint32 i = 1; i < 3; ++i)
+	{
+		ADRIA_CHECK(plan.uses[i].planned_state == (PixelSRV | ComputeSRV));
+	}
+	ADRIA_CHECK(plan.uses[0].planned_state == RTV);
+	ADRIA_CHECK(plan.uses[1].prev_state == RTV);
+	ADRIA_CHECK(plan.uses[2].prev_state == (PixelSRV | ComputeSRV));
+	ADRIA_CHECK_EQ(plan.stats.requested_barrier_count, 2u);
+	ADRIA_CHECK_EQ(plan.stats.planned_barrier_count, 1u);
+	ADRIA_CHECK_EQ(plan.stats.GetRemovedBarrierCount(), 1u);
+
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[1], false), RGBarrierResource{}) == (RGBarrier{ RGBarrierType::Transition, RTV, PixelSRV | ComputeSRV }));
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[2], false), RGBarrierResource{}).type == RGBarrierType::None);
+}
+
+ADRIA_TEST(BarrierPlanner_ReadToReadFixedResource)
+{
+	BarrierPlan plan(1, 2);
+	plan.fixed_resources[0] = true;
+	plan.AddUse(0, 0, PixelSRV);
+	plan.AddUse(0, 1, ComputeSRV);
+	plan.Plan();
+
+	ADRIA_CHECK(plan.uses[0].planned_state == PixelSRV);
+	ADRIA_CHECK(plan.uses[1].planned_state == ComputeSRV);
+	ADRIA_CHECK_EQ(plan.stats.requested_barrier_count, 1u);
+	ADRIA_CHECK_EQ(plan.stats.planned_barrier_count, 1u);
+}
+
+ADRIA_TEST(BarrierPlanner_SplitBarrier)
+{
+	BarrierPlan plan(2, 4);
+	plan.AddUse(0, 0, RTV);
+	plan.AddUse(1, 1, ComputeUAV);
+	plan.AddUse(1, 2, ComputeSRV);
+	plan.AddUse(0, 3, PixelSRV);
+	plan.Plan();
+
+	RGBarrierPlanUse const& begin = plan.uses[0];
+	RGBarrierPlanUse const& end = plan.uses[3];
+	ADRIA_CHECK(begin.split_begin);
+	ADRIA_CHECK(begin.next_state == PixelSRV);
+	ADRIA_CHECK(end.split_end);
+	ADRIA_CHECK(end.prev_state == RTV);
+
+	//uses in adjacent levels transition right away
+	ADRIA_CHECK(!plan.uses[1].split_begin);
+	ADRIA_CHECK(!plan.uses[2].split_end);
+	ADRIA_CHECK_EQ(plan.stats.planned_barrier_count, 2u);
+	ADRIA_CHECK_EQ(plan.stats.split_barrier_count, 1u);
+
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(end, false), RGBarrierResource{}) == (RGBarrier{ RGBarrierType::SplitEnd, RTV, PixelSRV }));
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[2], false), RGBarrierResource{}) == (RGBarrier{ RGBarrierType::Transition, ComputeUAV, ComputeSRV }));
+}
+
+ADRIA_TEST(BarrierPlanner_SplitBarrierAcrossFence)
+{
+	BarrierPlan plan(1, 3);
+	plan.level_fences[1] = true;
+	plan.AddUse(0, 0, RTV);
+	plan.AddUse(0, 2, PixelSRV);
+	plan.Plan();
+
+	ADRIA_CHECK(!plan.uses[0].split_begin);
+	ADRIA_CHECK(!plan.uses[1].split_end);
+	ADRIA_CHECK_EQ(plan.stats.split_barrier_count, 0u);
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[1], false), RGBarrierResource{}) == (RGBarrier{ RGBarrierType::Transition, RTV, PixelSRV }));
+}
+
+ADRIA_TEST(BarrierPlanner_SplitBarrierFixedResource)
+{
+	BarrierPlan plan(1, 3);
+	plan.fixed_resources[0] = true;
+	plan.AddUse(0, 0, ComputeUAV);
+	plan.AddUse(0, 2, ComputeSRV);
+	plan.Plan();
+
+	ADRIA_CHECK(!plan.uses[0].split_begin);
+	ADRIA_CHECK(!plan.uses[1].split_end);
+	ADRIA_CHECK_EQ(plan.stats.split_barrier_count, 0u);
+}
+
+ADRIA_TEST(BarrierPlanner_AliasingTransitions)
+{
+	//two render targets with disjoint lifetimes share one allocation
+	RGAliasingRequest const requests[] =
+	{
+		RGAliasingRequest{ 1024, 256, 0, 1 },
+		RGAliasingRequest{ 1024, 256, 2, 3 },
+	};
+	RGAliasingLayout const layout = ComputeAliasingLayout(requests);
+	ADRIA_CHECK_EQ(layout.offsets[0], layout.offsets[1]);
+	ADRIA_CHECK(layout.aliased[0] && layout.aliased[1]);
+
+	BarrierPlan plan(2, 4);
+	plan.AddUse(0, 0, RTV);
+	plan.AddUse(0, 1, PixelSRV);
+	plan.AddUse(1, 2, RTV);
+	plan.AddUse(1, 3, PixelSRV);
+	plan.Plan();
+	ADRIA_CHECK_EQ(plan.stats.split_barrier_count, 0u);
+
+	RGBarrierResource placed_resource{};
+	placed_resource.initial_state = Common;
+	placed_resource.aliased = layout.aliased[0];
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[0], true), placed_resource) == (RGBarrier{ RGBarrierType::Aliasing, None, RTV }));
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[1], false), placed_resource) == (RGBarrier{ RGBarrierType::Transition, RTV, PixelSRV }));
+	placed_resource.aliased = layout.aliased[1];
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[2], true), placed_resource) == (RGBarrier{ RGBarrierType::Aliasing, None, RTV }));
+
+	//a resource that does not alias starts from its initial state
+	placed_resource.aliased = false;
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[2], true), placed_resource) == (RGBarrier{ RGBarrierType::Transition, Common, RTV }));
+	placed_resource.initial_state = RTV;
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[2], true), placed_resource).type == RGBarrierType::None);
+}
+
+ADRIA_TEST(BarrierPlanner_ImportedResource)
+{
+	BarrierPlan plan(1, 1);
+	plan.AddUse(0, 0, PixelSRV);
+	plan.Plan();
+
+	RGBarrierResource imported_resource{};
+	imported_resource.imported = true;
+	imported_resource.initial_state = CopyDst;
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[0], false), imported_resource) == (RGBarrier{ RGBarrierType::Transition, CopyDst, PixelSRV }));
+	imported_resource.initial_state = PixelSRV;
+	ADRIA_CHECK(GetBarrierBeforeUse(MakeStateEntry(plan.uses[0], false), imported_resource).type == RGBarrierType::None);
+}
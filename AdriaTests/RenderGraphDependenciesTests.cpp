@@ -0,0 +1,169 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "TestFramework.h"
+#include "RenderGraph/RenderGraphDependencies.h"
+
+using namespace adria;
+
+namespace
+{
+	std::atomic<Uint64> g_AllocationCount = 0;
+}
+
+//counts every allocation of the test executable, the default array and aligned forms end up here or in the CRT
+void* operator new(std::size_t size)
+{
+	g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size ? size : 1)) return memory;
+	throw std::bad_alloc();
+}
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace
+{
+	//passes and their accesses, owned by vectors so the spans handed to BuildDependencies stay valid
+	struct TestGraph
+	{
+		struct Pass
+		{
+			std::vector<Uint32> texture_reads;
+			std::vector<Uint32> texture_writes;
+			std::vector<Uint32> buffer_reads;
+			std::vector<Uint32> buffer_writes;
+		};
+		std::vector<Pass> passes;
+		std::vector<RGPassAccesses> pass_accesses;
+		Uint32 texture_count = 0;
+		Uint32 buffer_count = 0;
+
+		void AddPass(std::vector<Uint32> texture_reads, std::vector<Uint32> texture_writes, std::vector<Uint32> buffer_reads = {}, std::vector<Uint32> buffer_writes = {})
+		{
+			for (Uint32 texture : texture_writes) texture_count = std::max(texture_count, texture + 1);
+			for (Uint32 buffer : buffer_writes) buffer_count = std::max(buffer_count, buffer + 1);
+			passes.push_back(Pass{ std::move(texture_reads), std::move(texture_writes), std::move(buffer_reads), std::move(buffer_writes) });
+		}
+
+		std::span<RGPassAccesses const> GetAccesses()
+		{
+			pass_accesses.resize(passes.size());
+			for (Uint64 i = 0; i < passes.size(); ++i)
+			{
+				pass_accesses[i] = RGPassAccesses{ passes[i].texture_reads, passes[i].texture_writes, passes[i].buffer_reads, passes[i].buffer_writes };
+			}
+			return pass_accesses;
+		}
+	};
+
+	//a frame shaped like the renderer's: a few chains of passes that each read what the previous one wrote, joined at the end
+	TestGraph MakeFrameGraph(Uint32 chain_count, Uint32 chain_length)
+	{
+		TestGraph graph{};
+		graph.AddPass({}, { 0 }, {}, { 0 });
+		Uint32 texture = 1;
+		std::vector<Uint32> chain_outputs;
+		for (Uint32 chain = 0; chain < chain_count; ++chain)
+		{
+			Uint32 input = 0;
+			for (Uint32 i = 0; i < chain_length; ++i)
+			{
+				graph.AddPass({ input }, { texture }, { 0 });
+				input = texture++;
+			}
+			chain_outputs.push_back(input);
+		}
+		graph.AddPass(chain_outputs, { texture });
+		return graph;
+	}
+
+	std::vector<Uint32> ToVector(std::span<Uint32 const> values)
+	{
+		return std::vector<Uint32>(values.begin(), values.end());
+	}
+}
+
+ADRIA_TEST(RenderGraphDependencies_BuildsLevelsFromReads)
+{
+	TestGraph graph{};
+	graph.AddPass({}, { 0 });			//0
+	graph.AddPass({}, { 1 });			//1
+	graph.AddPass({ 0 }, { 2 });		//2
+	graph.AddPass({ 0, 1 }, { 3 });		//3
+	graph.AddPass({ 2, 3 }, { 4 });		//4
+	graph.AddPass({}, { 5 });			//5, independent
+
+	RGAllocator allocator(4096);
+	RGDependencies dependencies = BuildDependencies(allocator, graph.GetAccesses(), graph.texture_count, graph.buffer_count);
+	ADRIA_CHECK(ToVector(dependencies.adjacency_lists[0]) == std::vector<Uint32>({ 2, 3 }));
+	ADRIA_CHECK(ToVector(dependencies.adjacency_lists[1]) == std::vector<Uint32>({ 3 }));
+	ADRIA_CHECK(ToVector(dependencies.adjacency_lists[2]) == std::vector<Uint32>({ 4 }));
+	ADRIA_CHECK(ToVector(dependencies.adjacency_lists[3]) == std::vector<Uint32>({ 4 }));
+	ADRIA_CHECK(dependencies.adjacency_lists[4].empty());
+	ADRIA_CHECK(ToVector(dependencies.topologically_sorted_passes) == std::vector<Uint32>({ 5, 1, 0, 3, 2, 4 }));
+
+	ADRIA_CHECK_EQ(dependencies.dependency_levels.GetListCount(), 3u);
+	ADRIA_CHECK(ToVector(dependencies.dependency_levels[0]) == std::vector<Uint32>({ 0, 1, 5 }));
+	ADRIA_CHECK(ToVector(dependencies.dependency_levels[1]) == std::vector<Uint32>({ 2, 3 }));
+	ADRIA_CHECK(ToVector(dependencies.dependency_levels[2]) == std::vector<Uint32>({ 4 }));
+	ADRIA_CHECK(ToVector(dependencies.texture_readers[0]) == std::vector<Uint32>({ 2, 3 }));
+
+	RGDependencies const serial = BuildDependencies(allocator, graph.GetAccesses(), graph.texture_count, graph.buffer_count, false);
+	ADRIA_CHECK_EQ(serial.dependency_levels.GetListCount(), graph.passes.size());
+	for (Uint32 i = 0; i < graph.passes.size(); ++i) ADRIA_CHECK(ToVector(serial.dependency_levels[i]) == std::vector<Uint32>({ i }));
+}
+
+ADRIA_TEST(RenderGraphDependencies_IgnoresLaterWriters)
+{
+	//pass 1 reads what pass 0 wrote, pass 2 writes it again afterwards and must not become a dependency of pass 1
+	TestGraph graph{};
+	graph.AddPass({}, { 0 });
+	graph.AddPass({ 0 }, { 1 });
+	graph.AddPass({ 1 }, { 0 });
+
+	RGAllocator allocator(4096);
+	RGDependencies dependencies = BuildDependencies(allocator, graph.GetAccesses(), graph.texture_count, graph.buffer_count);
+	ADRIA_CHECK(ToVector(dependencies.adjacency_lists[0]) == std::vector<Uint32>({ 1 }));
+	ADRIA_CHECK(ToVector(dependencies.adjacency_lists[1]) == std::vector<Uint32>({ 2 }));
+	ADRIA_CHECK(dependencies.adjacency_lists[2].empty());
+	ADRIA_CHECK_EQ(dependencies.dependency_levels.GetListCount(), 3u);
+}
+
+ADRIA_TEST(RenderGraphDependencies_SteadyStateFramesDoNotAllocate)
+{
+	TestGraph graph = MakeFrameGraph(8, 16);
+	std::span<RGPassAccesses const> pass_accesses = graph.GetAccesses();
+
+	//the first frame misses the compile cache, after a few frames the arena has grown to its high water mark
+	RGAllocator allocator(16 * 1024);
+	RGCompiledDependencies compiled_dependencies{};
+	compiled_dependencies.Save(BuildDependencies(allocator, pass_accesses, graph.texture_count, graph.buffer_count));
+	for (Uint32 frame = 0; frame < 4; ++frame)
+	{
+		allocator.Reset();
+		ADRIA_MAYBE_UNUSED RGDependencies compiled = BuildDependencies(allocator, pass_accesses, graph.texture_count, graph.buffer_count);
+		ADRIA_MAYBE_UNUSED RGDependencies loaded = compiled_dependencies.Load(allocator);
+	}
+
+	Uint64 const allocation_count = g_AllocationCount.load();
+	Bool loaded_matches = true;
+	for (Uint32 frame = 0; frame < 16; ++frame)
+	{
+		allocator.Reset();
+		RGDependencies const compiled = BuildDependencies(allocator, pass_accesses, graph.texture_count, graph.buffer_count);
+		RGDependencies const loaded = compiled_dependencies.Load(allocator);
+		loaded_matches &= std::ranges::equal(compiled.adjacency_lists.values, loaded.adjacency_lists.values);
+		loaded_matches &= std::ranges::equal(compiled.topologically_sorted_passes, loaded.topologically_sorted_passes);
+		loaded_matches &= std::ranges::equal(compiled.dependency_levels.offsets, loaded.dependency_levels.offsets);
+		loaded_matches &= std::ranges::equal(compiled.dependency_levels.values, loaded.dependency_levels.values);
+	}
+	ADRIA_CHECK_EQ(g_AllocationCount.load(), allocation_count);
+	ADRIA_CHECK(loaded_matches);
+	ADRIA_CHECK_EQ(allocator.GetChunkCount(), 1u);
+}
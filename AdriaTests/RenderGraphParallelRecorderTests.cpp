@@ -0,0 +1,195 @@
+#include <mutex>
+#include <thread>
+#include "TestFramework.h"
+#include "RenderGraph/RenderGraphParallelRecorder.h"
+
+using namespace adria;
+
+namespace
+{
+	struct MockPass
+	{
+		Uint32 index;
+	};
+
+	//every command list and queue call is appended to one log so the test can check the order they happened in
+	struct MockCommandLog
+	{
+		std::mutex log_mutex;
+		std::vector<std::string> calls;
+
+		void Add(std::string const& call)
+		{
+			std::lock_guard lock(log_mutex);
+			calls.push_back(call);
+		}
+		Int64 Find(std::string const& call) const
+		{
+			auto it = std::find(calls.begin(), calls.end(), call);
+			return it == calls.end() ? -1 : Int64(it - calls.begin());
+		}
+	};
+
+	class MockCommandList;
+	class MockCommandQueue
+	{
+	public:
+		explicit MockCommandQueue(MockCommandLog& log) : log(log) {}
+		void ExecuteCommandLists(std::span<MockCommandList*> cmd_lists);
+
+	private:
+		MockCommandLog& log;
+	};
+
+	class MockCommandList
+	{
+	public:
+		MockCommandList(MockCommandLog& log, MockCommandQueue& queue, std::string const& name) : log(log), queue(queue), name(name) {}
+
+		void Begin() { recording = true; log.Add(name + ".Begin"); }
+		void End() { recording = false; log.Add(name + ".End"); }
+		void Submit() { log.Add(name + ".Submit"); }
+		void Record(MockPass const& pass)
+		{
+			ADRIA_CHECK(recording);
+			recorded_passes.push_back(pass.index);
+			log.Add(name + ".Record" + std::to_string(pass.index));
+		}
+		MockCommandQueue& GetQueue() { return queue; }
+
+		std::string const& GetName() const { return name; }
+		std::vector<Uint32> const& GetRecordedPasses() const { return recorded_passes; }
+
+	private:
+		MockCommandLog& log;
+		MockCommandQueue& queue;
+		std::string name;
+		std::vector<Uint32> recorded_passes;
+		Bool recording = false;
+	};
+
+	void MockCommandQueue::ExecuteCommandLists(std::span<MockCommandList*> cmd_lists)
+	{
+		std::string call = "Execute";
+		for (MockCommandList* cmd_list : cmd_lists) call += " " + cmd_list->GetName();
+		log.Add(call);
+	}
+
+	struct MockRecordingSetup
+	{
+		MockCommandLog log;
+		MockCommandQueue queue{ log };
+		MockCommandList main_cmd_list{ log, queue, "main" };
+		std::vector<std::unique_ptr<MockCommandList>> cmd_list_pool;
+		Uint64 cmd_list_count = 0;
+
+		MockCommandList* AllocateCommandList()
+		{
+			if (cmd_list_count == cmd_list_pool.size())
+			{
+				cmd_list_pool.push_back(std::make_unique<MockCommandList>(log, queue, "list" + std::to_string(cmd_list_pool.size())));
+			}
+			MockCommandList* cmd_list = cmd_list_pool[cmd_list_count++].get();
+			cmd_list->Begin();
+			return cmd_list;
+		}
+	};
+
+	void SerialFor(Uint64 count, auto&& task)
+	{
+		for (Uint64 i = 0; i < count; ++i) task(i);
+	}
+	//runs the tasks in reverse order on separate threads so the submission order can't come from the recording order
+	void ReverseThreadedFor(Uint64 count, auto&& task)
+	{
+		std::vector<std::thread> threads;
+		for (Uint64 i = count; i-- > 0;)
+		{
+			threads.emplace_back([&task, i]() { task(i); });
+		}
+		for (std::thread& thread : threads) thread.join();
+	}
+}
+
+ADRIA_TEST(RenderGraphParallelRecorder_SubmitsMainListFirst)
+{
+	MockRecordingSetup setup;
+	std::vector<MockPass> passes{ {0}, {1}, {2} };
+
+	RenderGraphParallelRecorder<MockPass, MockCommandList> recorder;
+	for (MockPass& pass : passes) recorder.AddPass(&pass);
+	recorder.Record(&setup.main_cmd_list, [&setup]() { return setup.AllocateCommandList(); },
+		[](MockPass* pass, MockCommandList* cmd_list) { cmd_list->Record(*pass); },
+		[](Uint64 count, auto&& task) { SerialFor(count, task); });
+
+	std::vector<std::string> const expected_calls
+	{
+		"list0.Begin", "list1.Begin", "list2.Begin",
+		"list0.Record0", "list0.End",
+		"list1.Record1", "list1.End",
+		"list2.Record2", "list2.End",
+		"main.End", "main.Submit",
+		"Execute list0 list1 list2",
+		"main.Begin"
+	};
+	ADRIA_CHECK(setup.log.calls == expected_calls);
+}
+
+ADRIA_TEST(RenderGraphParallelRecorder_SubmitsInPassOrder)
+{
+	MockRecordingSetup setup;
+	std::vector<MockPass> passes(8);
+	for (Uint32 i = 0; i < passes.size(); ++i) passes[i].index = i;
+
+	RenderGraphParallelRecorder<MockPass, MockCommandList> recorder;
+	for (MockPass& pass : passes) recorder.AddPass(&pass);
+	recorder.Record(&setup.main_cmd_list, [&setup]() { return setup.AllocateCommandList(); },
+		[](MockPass* pass, MockCommandList* cmd_list) { cmd_list->Record(*pass); },
+		[](Uint64 count, auto&& task) { ReverseThreadedFor(count, task); });
+
+	//every pass is recorded once into its own command list which is closed before anything is submitted
+	ADRIA_CHECK_EQ(setup.cmd_list_pool.size(), passes.size());
+	Int64 const main_end = setup.log.Find("main.End");
+	for (Uint32 i = 0; i < passes.size(); ++i)
+	{
+		MockCommandList const& cmd_list = *setup.cmd_list_pool[i];
+		ADRIA_CHECK(cmd_list.GetRecordedPasses() == std::vector<Uint32>{ i });
+		Int64 const list_end = setup.log.Find(cmd_list.GetName() + ".End");
+		ADRIA_CHECK(list_end >= 0 && list_end < main_end);
+	}
+
+	Int64 const main_submit = setup.log.Find("main.Submit");
+	Int64 const execute = setup.log.Find("Execute list0 list1 list2 list3 list4 list5 list6 list7");
+	Int64 const main_begin = setup.log.Find("main.Begin");
+	ADRIA_CHECK(main_end < main_submit);
+	ADRIA_CHECK(main_submit < execute);
+	ADRIA_CHECK(execute < main_begin);
+	ADRIA_CHECK_EQ(main_begin, Int64(setup.log.calls.size() - 1));
+}
+
+ADRIA_TEST(RenderGraphParallelRecorder_ReusesArraysBetweenLevels)
+{
+	MockRecordingSetup setup;
+	std::vector<MockPass> passes{ {0}, {1}, {2}, {3} };
+
+	RenderGraphParallelRecorder<MockPass, MockCommandList> recorder;
+	for (Uint32 level = 0; level < 3; ++level)
+	{
+		setup.log.calls.clear();
+		setup.cmd_list_count = 0;
+
+		recorder.Clear();
+		for (Uint32 i = 0; i <= level + 1; ++i) recorder.AddPass(&passes[i]);
+		ADRIA_CHECK_EQ(recorder.GetPassCount(), level + 2);
+		recorder.Record(&setup.main_cmd_list, [&setup]() { return setup.AllocateCommandList(); },
+			[](MockPass* pass, MockCommandList* cmd_list) { cmd_list->Record(*pass); },
+			[](Uint64 count, auto&& task) { SerialFor(count, task); });
+
+		//passes of earlier levels are not recorded or submitted again
+		std::string expected_execute = "Execute";
+		for (Uint32 i = 0; i <= level + 1; ++i) expected_execute += " list" + std::to_string(i);
+		ADRIA_CHECK(setup.log.Find(expected_execute) >= 0);
+		ADRIA_CHECK_EQ(std::count_if(setup.log.calls.begin(), setup.log.calls.end(), [](std::string const& call) { return call.find(".Record") != std::string::npos; }), Int64(level + 2));
+	}
+	ADRIA_CHECK_EQ(setup.cmd_list_pool.size(), 4u);
+}
@@ -0,0 +1,175 @@
+#include "TestFramework.h"
+#include "RenderGraph/RenderGraphResourceCache.h"
+
+using namespace adria;
+
+namespace
+{
+	struct FakeDesc
+	{
+		Uint32 width;
+		Uint32 height;
+
+		Bool operator==(FakeDesc const&) const = default;
+	};
+
+	struct FakeResource
+	{
+		FakeDesc desc;
+	};
+
+	//stands in for the device, counts the resources the pool had to create
+	struct FakeAllocator
+	{
+		using Cache = RenderGraphResourceCache<FakeResource, FakeResource>;
+
+		Cache cache;
+		Uint64 allocation_count = 0;
+
+		static Uint64 HashDesc(FakeDesc const& desc)
+		{
+			return (Uint64(desc.width) << 32) | desc.height;
+		}
+		static Uint64 GetSize(FakeDesc const& desc)
+		{
+			return Uint64(desc.width) * desc.height * 4;
+		}
+
+		FakeResource* AllocateTexture(FakeDesc const& desc, RGPoolHandle& handle)
+		{
+			Uint64 const bucket_hash = HashDesc(desc);
+			if (FakeResource* texture = cache.FindTexture(bucket_hash, [&desc](FakeResource const& texture) { return texture.desc == desc; }, handle)) return texture;
+			++allocation_count;
+			return cache.AddTexture(std::make_unique<FakeResource>(FakeResource{ desc }), bucket_hash, GetSize(desc), handle);
+		}
+
+		FakeResource* AllocateBuffer(FakeDesc const& desc, RGPoolHandle& handle)
+		{
+			Uint64 const bucket_hash = HashDesc(desc);
+			if (FakeResource* buffer = cache.FindBuffer(bucket_hash, [&desc](FakeResource const& buffer) { return buffer.desc == desc; }, handle)) return buffer;
+			++allocation_count;
+			return cache.AddBuffer(std::make_unique<FakeResource>(FakeResource{ desc }), bucket_hash, GetSize(desc), handle);
+		}
+	};
+
+	constexpr FakeDesc FullResolution{ 1920, 1080 };
+	constexpr FakeDesc HalfResolution{ 960, 540 };
+	constexpr FakeDesc LightBuffer{ 4096, 1 };
+
+	//allocates and releases resources in the order a render graph creates and destroys them across dependency levels
+	void SimulateFrame(FakeAllocator& allocator, Bool use_half_resolution)
+	{
+		RGPoolHandle gbuffer = InvalidRGPoolHandle, depth = InvalidRGPoolHandle, lighting = InvalidRGPoolHandle;
+		RGPoolHandle half = InvalidRGPoolHandle, lights = InvalidRGPoolHandle, post = InvalidRGPoolHandle;
+
+		allocator.AllocateTexture(FullResolution, gbuffer);
+		allocator.AllocateTexture(FullResolution, depth);
+		allocator.AllocateBuffer(LightBuffer, lights);
+		allocator.AllocateTexture(FullResolution, lighting);
+		allocator.cache.ReleaseTexture(gbuffer);
+		allocator.cache.ReleaseBuffer(lights);
+		if (use_half_resolution)
+		{
+			allocator.AllocateTexture(HalfResolution, half);
+			allocator.cache.ReleaseTexture(half);
+		}
+		allocator.AllocateTexture(FullResolution, post);
+		allocator.cache.ReleaseTexture(depth);
+		allocator.cache.ReleaseTexture(lighting);
+		allocator.cache.ReleaseTexture(post);
+	}
+}
+
+ADRIA_TEST(ResourceCache_AllocationCountStaysFlat)
+{
+	FakeAllocator allocator;
+	for (Uint32 frame = 0; frame < 100; ++frame)
+	{
+		allocator.cache.Tick(4, 0);
+		SimulateFrame(allocator, true);
+		//the post texture reuses the gbuffer texture released earlier in the frame
+		ADRIA_CHECK_EQ(allocator.allocation_count, 5u);
+	}
+
+	RGResourcePoolStats const& stats = allocator.cache.GetStats();
+	ADRIA_CHECK_EQ(stats.texture_misses, 4u);
+	ADRIA_CHECK_EQ(stats.buffer_misses, 1u);
+	ADRIA_CHECK_EQ(stats.texture_hits, 99u * 5u + 1u);
+	ADRIA_CHECK_EQ(stats.buffer_hits, 99u);
+	ADRIA_CHECK_EQ(stats.evictions, 0u);
+	ADRIA_CHECK_EQ(stats.pooled_texture_count, 4u);
+	ADRIA_CHECK_EQ(stats.pooled_buffer_count, 1u);
+}
+
+ADRIA_TEST(ResourceCache_EvictsUnusedBuckets)
+{
+	FakeAllocator allocator;
+	allocator.cache.Tick(4, 0);
+	SimulateFrame(allocator, true);
+	Uint64 const full_resolution_memory = 3 * FakeAllocator::GetSize(FullResolution) + FakeAllocator::GetSize(LightBuffer);
+	ADRIA_CHECK_EQ(allocator.cache.GetStats().pooled_memory, full_resolution_memory + FakeAllocator::GetSize(HalfResolution));
+
+	//the half resolution texture is kept alive while it has been unused for at most four frames
+	for (Uint32 frame = 0; frame < 5; ++frame)
+	{
+		allocator.cache.Tick(4, 0);
+		SimulateFrame(allocator, false);
+		ADRIA_CHECK_EQ(allocator.cache.GetStats().evictions, 0u);
+	}
+	allocator.cache.Tick(4, 0);
+	ADRIA_CHECK_EQ(allocator.cache.GetStats().evictions, 1u);
+	ADRIA_CHECK_EQ(allocator.cache.GetStats().pooled_memory, full_resolution_memory);
+
+	//coming back to it allocates once and then stays flat again
+	Uint64 const allocation_count = allocator.allocation_count;
+	for (Uint32 frame = 0; frame < 10; ++frame)
+	{
+		SimulateFrame(allocator, true);
+		allocator.cache.Tick(4, 0);
+	}
+	ADRIA_CHECK_EQ(allocator.allocation_count, allocation_count + 1);
+}
+
+ADRIA_TEST(ResourceCache_EvictsLeastRecentlyUsedOverBudget)
+{
+	FakeAllocator allocator;
+	RGPoolHandle handles[3];
+	FakeDesc const descs[3] = { FakeDesc{ 256, 256 }, FakeDesc{ 512, 512 }, FakeDesc{ 128, 128 } };
+	for (Uint32 i = 0; i < 3; ++i)
+	{
+		allocator.AllocateTexture(descs[i], handles[i]);
+		allocator.cache.ReleaseTexture(handles[i]);
+		allocator.cache.Tick(100, 0);
+	}
+
+	//over budget the oldest unused textures go first until the pool fits
+	Uint64 const budget = FakeAllocator::GetSize(descs[1]) + FakeAllocator::GetSize(descs[2]);
+	allocator.cache.Tick(100, budget);
+	ADRIA_CHECK_EQ(allocator.cache.GetStats().evictions, 1u);
+	ADRIA_CHECK_EQ(allocator.cache.GetStats().pooled_memory, budget);
+
+	Uint64 const allocation_count = allocator.allocation_count;
+	RGPoolHandle handle = InvalidRGPoolHandle;
+	allocator.AllocateTexture(descs[1], handle);
+	allocator.cache.ReleaseTexture(handle);
+	allocator.AllocateTexture(descs[2], handle);
+	allocator.cache.ReleaseTexture(handle);
+	ADRIA_CHECK_EQ(allocator.allocation_count, allocation_count);
+	allocator.AllocateTexture(descs[0], handle);
+	ADRIA_CHECK_EQ(allocator.allocation_count, allocation_count + 1);
+}
+
+ADRIA_TEST(ResourceCache_ActiveResourcesAreNeverEvicted)
+{
+	FakeAllocator allocator;
+	RGPoolHandle handle = InvalidRGPoolHandle;
+	FakeResource* texture = allocator.AllocateTexture(FullResolution, handle);
+	for (Uint32 frame = 0; frame < 10; ++frame) allocator.cache.Tick(1, 1);
+	ADRIA_CHECK_EQ(allocator.cache.GetStats().evictions, 0u);
+
+	//an active texture is never handed out twice
+	RGPoolHandle other_handle = InvalidRGPoolHandle;
+	FakeResource* other_texture = allocator.AllocateTexture(FullResolution, other_handle);
+	ADRIA_CHECK(other_texture != texture);
+	ADRIA_CHECK(other_handle != handle);
+}
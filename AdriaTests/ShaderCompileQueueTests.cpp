@@ -0,0 +1,183 @@
+#include <atomic>
+#include <thread>
+#include "TestFramework.h"
+#include "TestThreadPool.h"
+#include "Rendering/ShaderCompileQueue.h"
+#include "Rendering/ShaderManager.h"
+
+using namespace adria;
+using namespace adria::tests;
+
+namespace
+{
+	//stands in for dxc, every compile stores its sequence number as the binary so a test can tell which compile produced a shader
+	//compiles of a held key spin until the test releases them
+	class StubShaderCompiler
+	{
+	public:
+		ShaderCompileQueue::CompileFunction GetCompileFunction()
+		{
+			return [this](GfxShaderKey const& key, GfxShaderCompileOutput& output)
+				{
+					Uint32 const compile_index = ++compile_count;
+					if (key == held_key)
+					{
+						held_compile_started = true;
+						while (hold_compiles) std::this_thread::yield();
+					}
+					{
+						std::lock_guard lock(mutex);
+						compile_threads.push_back(std::this_thread::get_id());
+					}
+					if (fail_compiles)
+					{
+						output.errors = "stub error";
+						return false;
+					}
+					output.shader.SetShaderData(&compile_index, sizeof(compile_index));
+					return true;
+				};
+		}
+
+		void Hold(GfxShaderKey const& key)
+		{
+			held_key = key;
+			hold_compiles = true;
+		}
+		void Release() { hold_compiles = false; }
+
+		GfxShaderKey held_key;
+		std::atomic<Bool> hold_compiles = false;
+		std::atomic<Bool> held_compile_started = false;
+		std::atomic<Bool> fail_compiles = false;
+		std::atomic<Uint32> compile_count = 0;
+		std::mutex mutex;
+		std::vector<std::thread::id> compile_threads;
+	};
+
+	Uint32 GetCompileIndex(GfxShader const* shader)
+	{
+		Uint32 compile_index = 0;
+		if (shader && shader->GetSize() == sizeof(compile_index)) memcpy(&compile_index, shader->GetData(), sizeof(compile_index));
+		return compile_index;
+	}
+
+	//every pool worker picks up one spinning task, jobs submitted afterwards stay queued until the workers are released
+	//the flag outlives the test since a worker can still be leaving its task when the test returns
+	std::atomic<Bool> workers_blocked = false;
+	void BlockWorkers()
+	{
+		workers_blocked = true;
+		for (Uint64 i = 0; i < g_ThreadPool.GetThreadCount(); ++i)
+		{
+			g_ThreadPool.Dispatch([]() { while (workers_blocked) std::this_thread::yield(); });
+		}
+	}
+	void ReleaseWorkers()
+	{
+		workers_blocked = false;
+	}
+}
+
+ADRIA_TEST(ShaderCompileQueue_DeduplicatesPendingKeys)
+{
+	InitializeTestThreadPool();
+	StubShaderCompiler compiler;
+	ShaderCompileQueue queue(compiler.GetCompileFunction());
+
+	GfxShaderKey key(VS_Sky);
+	key.AddDefine("DEDUP");
+	compiler.Hold(key);
+	std::shared_future<Bool> first = queue.Submit(key);
+	GfxShaderKey const same_key = key;
+	std::shared_future<Bool> second = queue.Submit(same_key);
+	compiler.Release();
+
+	ADRIA_CHECK(first.get());
+	ADRIA_CHECK(second.get());
+	ADRIA_CHECK_EQ(compiler.compile_count.load(), 1u);
+	ADRIA_CHECK_EQ(queue.GetStats().deduplicated_count, 1ull);
+
+	//a cached key neither compiles nor counts as a duplicate
+	ADRIA_CHECK(queue.Submit(key).get());
+	ADRIA_CHECK_EQ(compiler.compile_count.load(), 1u);
+	ADRIA_CHECK_EQ(queue.GetStats().cache_hit_count, 1ull);
+	ADRIA_CHECK_EQ(GetCompileIndex(queue.Find(key)), 1u);
+}
+
+ADRIA_TEST(ShaderCompileQueue_WaitRunsUnclaimedJobInline)
+{
+	InitializeTestThreadPool();
+	StubShaderCompiler compiler;
+	ShaderCompileQueue queue(compiler.GetCompileFunction());
+
+	BlockWorkers();
+	GfxShaderKey const key(PS_Sky);
+	queue.Submit(key);
+	ADRIA_CHECK(queue.Wait(key));
+	ReleaseWorkers();
+
+	//the pool task queued for the job finds it claimed and does not compile it a second time
+	queue.WaitIdle();
+	ADRIA_CHECK_EQ(compiler.compile_count.load(), 1u);
+	ADRIA_CHECK_EQ(compiler.compile_threads.size(), 1ull);
+	ADRIA_CHECK(compiler.compile_threads[0] == std::this_thread::get_id());
+	ADRIA_CHECK(queue.Find(key) != nullptr);
+}
+
+ADRIA_TEST(ShaderCompileQueue_RecompileAfterClaimQueuesNewJob)
+{
+	InitializeTestThreadPool();
+	StubShaderCompiler compiler;
+	ShaderCompileQueue queue(compiler.GetCompileFunction());
+
+	//the first compile is running and might have read the old source, a forced request can't share it
+	GfxShaderKey const key(CS_HosekWilkieSky);
+	compiler.Hold(key);
+	std::shared_future<Bool> first = queue.Submit(key);
+	while (!compiler.held_compile_started) std::this_thread::yield();
+	std::shared_future<Bool> recompile = queue.Recompile(key);
+	ADRIA_CHECK_EQ(queue.GetStats().deduplicated_count, 0ull);
+	compiler.Release();
+
+	ADRIA_CHECK(first.get());
+	ADRIA_CHECK(queue.Wait(key));
+	ADRIA_CHECK(recompile.get());
+	ADRIA_CHECK_EQ(compiler.compile_count.load(), 2u);
+	ADRIA_CHECK_EQ(GetCompileIndex(queue.Find(key)), 2u);
+
+	//a forced request for a job nobody started yet shares it
+	BlockWorkers();
+	std::shared_future<Bool> queued = queue.Recompile(key);
+	std::shared_future<Bool> forced = queue.Recompile(key);
+	ADRIA_CHECK_EQ(queue.GetStats().deduplicated_count, 1ull);
+	ADRIA_CHECK(queue.Wait(key));
+	ReleaseWorkers();
+	ADRIA_CHECK(queued.get() && forced.get());
+	ADRIA_CHECK_EQ(compiler.compile_count.load(), 3u);
+}
+
+ADRIA_TEST(ShaderCompileQueue_FailedCompilesReportErrorsOnce)
+{
+	InitializeTestThreadPool();
+	StubShaderCompiler compiler;
+	ShaderCompileQueue queue(compiler.GetCompileFunction());
+
+	GfxShaderKey const key(VS_GBuffer);
+	compiler.fail_compiles = true;
+	ADRIA_CHECK(!queue.Submit(key).get());
+	ADRIA_CHECK(queue.Find(key) == nullptr);
+
+	std::vector<ShaderCompileError> errors = queue.TakeCompileErrors();
+	ADRIA_CHECK_EQ(errors.size(), 1ull);
+	ADRIA_CHECK(errors[0].key == key);
+	ADRIA_CHECK(errors[0].message == "stub error");
+	ADRIA_CHECK(queue.TakeCompileErrors().empty());
+
+	//an error that was fixed before anyone looked at it is dropped
+	ADRIA_CHECK(!queue.Recompile(key).get());
+	compiler.fail_compiles = false;
+	ADRIA_CHECK(queue.Recompile(key).get());
+	ADRIA_CHECK(queue.TakeCompileErrors().empty());
+	ADRIA_CHECK(queue.Find(key) != nullptr);
+}
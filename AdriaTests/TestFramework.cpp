@@ -0,0 +1,45 @@
+#include "TestFramework.h"
+
+namespace adria::tests
+{
+	namespace
+	{
+		Uint32 failure_count = 0;
+	}
+
+	std::vector<TestCase>& GetTestCases()
+	{
+		static std::vector<TestCase> test_cases;
+		return test_cases;
+	}
+
+	void ReportFailure(Char const* file, Int line, Char const* expression)
+	{
+		std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+		++failure_count;
+	}
+}
+
+using namespace adria;
+using namespace adria::tests;
+
+//runs every registered test, or only the ones whose name contains the first argument
+int main(int argc, char** argv)
+{
+	Char const* filter = argc > 1 ? argv[1] : nullptr;
+	Uint32 failed_test_count = 0;
+	Uint32 run_test_count = 0;
+	for (TestCase const& test_case : GetTestCases())
+	{
+		if (filter && !std::strstr(test_case.name, filter)) continue;
+
+		Uint32 const previous_failure_count = failure_count;
+		test_case.function();
+		++run_test_count;
+		Bool const passed = failure_count == previous_failure_count;
+		if (!passed) ++failed_test_count;
+		std::printf("[%s] %s\n", passed ? "PASS" : "FAIL", test_case.name);
+	}
+	std::printf("%u of %u tests passed\n", run_test_count - failed_test_count, run_test_count);
+	return failed_test_count == 0 ? 0 : 1;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdio>
+
+namespace adria::tests
+{
+	using TestFunction = void(*)();
+
+	struct TestCase
+	{
+		Char const* name;
+		TestFunction function;
+	};
+
+	std::vector<TestCase>& GetTestCases();
+	void ReportFailure(Char const* file, Int line, Char const* expression);
+
+	struct TestRegistrar
+	{
+		TestRegistrar(Char const* name, TestFunction function)
+		{
+			GetTestCases().push_back(TestCase{ name, function });
+		}
+	};
+}
+
+#define ADRIA_TEST(name) \
+	static void name(); \
+	static adria::tests::TestRegistrar ADRIA_CONCAT(name, _registrar)(#name, &name); \
+	static void name()
+
+#define ADRIA_CHECK(expr) \
+	do { if (!(expr)) adria::tests::ReportFailure(__FILE__, __LINE__, #expr); } while (0)
+
+#define ADRIA_CHECK_EQ(a, b) ADRIA_CHECK((a) == (b))
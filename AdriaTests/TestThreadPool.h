@@ -0,0 +1,16 @@
+#pragma once
+#include "Utilities/ThreadPool.h"
+
+namespace adria::tests
+{
+	//tests that run work on g_ThreadPool start it on first use, its threads are left running until the process exits
+	inline void InitializeTestThreadPool()
+	{
+		static Bool const initialized = []()
+			{
+				g_ThreadPool.Initialize(4);
+				return true;
+			}();
+		(void)initialized;
+	}
+}
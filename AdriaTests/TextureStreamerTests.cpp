@@ -0,0 +1,185 @@
+#include <thread>
+#include <chrono>
+#include <functional>
+#include "TestFramework.h"
+#include "TestThreadPool.h"
+#include "Rendering/TextureStreamer.h"
+#include "Utilities/Image.h"
+
+using namespace adria;
+using namespace adria::tests;
+
+namespace
+{
+	//records what the streamer asks the GPU for, the test decides when submitted batches complete
+	class FakeTextureUploader final : public ITextureUploader
+	{
+	public:
+		struct RecordedUpload
+		{
+			std::string path;
+			Uint64 staging_offset;
+			Uint64 fence_value;
+		};
+
+		explicit FakeTextureUploader(Uint64 staging_size) : staging_size(staging_size) {}
+
+		virtual Uint64 GetStagingSize(TextureStreamRequest const& request, Image const&) override
+		{
+			return request.path.starts_with("large") ? 4 * staging_size : staging_size;
+		}
+		virtual void Upload(TextureStreamRequest const& request, Image const&, Uint64 staging_offset) override
+		{
+			uploads.push_back(RecordedUpload{ request.path, staging_offset, fence_value + 1 });
+		}
+		virtual Uint64 Submit() override
+		{
+			return ++fence_value;
+		}
+		virtual Uint64 GetCompletedFenceValue() const override
+		{
+			return completed_fence_value;
+		}
+		virtual void OnUploadCompleted(TextureStreamRequest const& request) override
+		{
+			completed_paths.push_back(request.path);
+		}
+
+		void CompleteAll() { completed_fence_value = fence_value; }
+
+		Uint64 staging_size;
+		Uint64 fence_value = 0;
+		Uint64 completed_fence_value = 0;
+		std::vector<RecordedUpload> uploads;
+		std::vector<std::string> completed_paths;
+	};
+
+	std::unique_ptr<Image> FakeDecode(std::string const& path)
+	{
+		if (path.starts_with("missing")) return nullptr;
+		return std::make_unique<Image>(GfxFormat::R8G8B8A8_UNORM);
+	}
+
+	TextureStreamerDesc MakeDesc(Uint64 staging_size, Uint32 max_decodes_in_flight)
+	{
+		TextureStreamerDesc desc{};
+		desc.staging_size = staging_size;
+		desc.staging_alignment = 256;
+		desc.max_decodes_in_flight = max_decodes_in_flight;
+		desc.max_uploads_per_update = 32;
+		return desc;
+	}
+
+	//decodes finish on the pool at their own pace so the streamer is updated until the condition holds
+	Bool UpdateUntil(TextureStreamer& streamer, std::function<Bool()> const& condition)
+	{
+		for (Uint32 i = 0; i < 2000; ++i)
+		{
+			streamer.Update();
+			if (condition()) return true;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return false;
+	}
+
+	void Request(TextureStreamer& streamer, std::string const& path, TextureHandle handle)
+	{
+		streamer.Request(TextureStreamRequest{ .handle = handle, .path = path, .srgb = false });
+	}
+}
+
+ADRIA_TEST(TextureStreamer_CompletesUploadsAfterTheirFence)
+{
+	InitializeTestThreadPool();
+	FakeTextureUploader uploader(1024);
+	TextureStreamer streamer(MakeDesc(16 * 1024, 4), uploader, FakeDecode);
+	for (Uint32 i = 0; i < 8; ++i) Request(streamer, "texture" + std::to_string(i), i);
+
+	ADRIA_CHECK(UpdateUntil(streamer, [&]() { return uploader.uploads.size() == 8; }));
+	ADRIA_CHECK(uploader.completed_paths.empty());
+	ADRIA_CHECK_EQ(streamer.GetStats().uploading_count, 8u);
+	ADRIA_CHECK_EQ(streamer.GetStats().bytes_in_flight, 8u * 1024);
+
+	uploader.CompleteAll();
+	streamer.Update();
+	ADRIA_CHECK_EQ(uploader.completed_paths.size(), 8u);
+	ADRIA_CHECK_EQ(streamer.GetStats().completed_count, 8u);
+	ADRIA_CHECK_EQ(streamer.GetStats().bytes_in_flight, 0u);
+	ADRIA_CHECK(streamer.IsIdle());
+}
+
+ADRIA_TEST(TextureStreamer_DecodedTexturesCountAgainstDecodeLimit)
+{
+	InitializeTestThreadPool();
+	//the ring holds one texture, so decoded images back up until the GPU finishes the first upload
+	FakeTextureUploader uploader(1024);
+	TextureStreamer streamer(MakeDesc(1024, 2), uploader, FakeDecode);
+	for (Uint32 i = 0; i < 10; ++i) Request(streamer, "texture" + std::to_string(i), i);
+
+	ADRIA_CHECK(UpdateUntil(streamer, [&]() { return uploader.uploads.size() == 1 && streamer.GetStats().decoded_count == 2; }));
+	for (Uint32 i = 0; i < 50; ++i)
+	{
+		streamer.Update();
+		TextureStreamerStats const stats = streamer.GetStats();
+		ADRIA_CHECK(stats.decoding_count + stats.decoded_count <= 2);
+		ADRIA_CHECK_EQ(stats.queued_count, 7u);
+		ADRIA_CHECK_EQ(stats.uploading_count, 1u);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ADRIA_CHECK(UpdateUntil(streamer, [&]()
+		{
+			uploader.CompleteAll();
+			return uploader.completed_paths.size() == 10;
+		}));
+	ADRIA_CHECK(streamer.IsIdle());
+}
+
+ADRIA_TEST(TextureStreamer_FailedDecodesKeepPlaceholders)
+{
+	InitializeTestThreadPool();
+	FakeTextureUploader uploader(1024);
+	TextureStreamer streamer(MakeDesc(16 * 1024, 4), uploader, FakeDecode);
+	Request(streamer, "texture0", 0);
+	Request(streamer, "missing", 1);
+	Request(streamer, "texture2", 2);
+
+	ADRIA_CHECK(UpdateUntil(streamer, [&]() { return streamer.GetStats().failed_count == 1 && uploader.uploads.size() == 2; }));
+	uploader.CompleteAll();
+	streamer.Update();
+	ADRIA_CHECK_EQ(uploader.completed_paths.size(), 2u);
+	ADRIA_CHECK(std::find(uploader.completed_paths.begin(), uploader.completed_paths.end(), "missing") == uploader.completed_paths.end());
+	ADRIA_CHECK(streamer.IsIdle());
+}
+
+ADRIA_TEST(TextureStreamer_LargeTexturesBypassTheRing)
+{
+	InitializeTestThreadPool();
+	FakeTextureUploader uploader(1024);
+	TextureStreamer streamer(MakeDesc(2048, 4), uploader, FakeDecode);
+	Request(streamer, "large", 0);
+	Request(streamer, "texture1", 1);
+
+	ADRIA_CHECK(UpdateUntil(streamer, [&]() { return uploader.uploads.size() == 2; }));
+	for (FakeTextureUploader::RecordedUpload const& upload : uploader.uploads)
+	{
+		if (upload.path == "large") ADRIA_CHECK_EQ(upload.staging_offset, INVALID_ALLOC_OFFSET);
+		else ADRIA_CHECK(upload.staging_offset != INVALID_ALLOC_OFFSET);
+	}
+}
+
+ADRIA_TEST(TextureStreamer_ClearDropsPendingRequests)
+{
+	InitializeTestThreadPool();
+	FakeTextureUploader uploader(1024);
+	TextureStreamer streamer(MakeDesc(1024, 2), uploader, FakeDecode);
+	for (Uint32 i = 0; i < 6; ++i) Request(streamer, "texture" + std::to_string(i), i);
+	ADRIA_CHECK(UpdateUntil(streamer, [&]() { return uploader.uploads.size() == 1; }));
+
+	uploader.CompleteAll();
+	streamer.Clear();
+	ADRIA_CHECK(streamer.IsIdle());
+	for (Uint32 i = 0; i < 10; ++i) streamer.Update();
+	ADRIA_CHECK_EQ(uploader.uploads.size(), 1u);
+	ADRIA_CHECK(uploader.completed_paths.empty());
+}
@@ -0,0 +1,43 @@
+#include <atomic>
+#include <thread>
+#include "TestFramework.h"
+#include "TestThreadPool.h"
+
+using namespace adria;
+using namespace adria::tests;
+
+ADRIA_TEST(ParallelFor_RunsEveryIndexOnce)
+{
+	InitializeTestThreadPool();
+	for (Uint64 count : { 1ull, 2ull, 7ull, 10000ull })
+	{
+		std::vector<std::atomic<Uint32>> run_counts(count);
+		ParallelFor(count, [&run_counts](Uint64 i) { ++run_counts[i]; });
+		ADRIA_CHECK(std::all_of(run_counts.begin(), run_counts.end(), [](std::atomic<Uint32> const& run_count) { return run_count == 1; }));
+	}
+}
+
+ADRIA_TEST(ParallelFor_ReturnsWithoutWaitingForQueuedHelpers)
+{
+	InitializeTestThreadPool();
+
+	//every worker picks up one blocking task, the helpers ParallelFor queues behind them can only start after it returned
+	//the flag outlives the test since a worker can still be leaving its blocking task when the test returns
+	static std::atomic<Bool> release_workers;
+	release_workers = false;
+	for (Uint64 i = 0; i < g_ThreadPool.GetThreadCount(); ++i)
+	{
+		g_ThreadPool.Dispatch([]() { while (!release_workers) std::this_thread::yield(); });
+	}
+
+	std::thread::id const caller_thread = std::this_thread::get_id();
+	std::vector<Uint8> ran_on_caller(64, false);
+	ParallelFor(ran_on_caller.size(), [&ran_on_caller, caller_thread](Uint64 i) { ran_on_caller[i] = std::this_thread::get_id() == caller_thread; });
+	ADRIA_CHECK(std::all_of(ran_on_caller.begin(), ran_on_caller.end(), [](Uint8 ran) { return ran != 0; }));
+
+	//the late helpers find every index claimed and exit, the pool has to keep working afterwards
+	release_workers = true;
+	std::atomic<Uint64> sum = 0;
+	ParallelFor(1000, [&sum](Uint64 i) { sum += i; });
+	ADRIA_CHECK_EQ(sum.load(), 999ull * 1000 / 2);
+}
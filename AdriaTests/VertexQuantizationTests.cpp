@@ -0,0 +1,143 @@
+#include <random>
+#include <cmath>
+#include "TestFramework.h"
+#include "Rendering/VertexQuantization.h"
+
+using namespace adria;
+
+namespace
+{
+	struct SourceVertices
+	{
+		std::vector<Vector3> positions;
+		std::vector<Vector2> uvs;
+		std::vector<Vector3> normals;
+		std::vector<Vector4> tangents;
+		BoundingBox bounding_box;
+	};
+
+	struct QuantizedVertices
+	{
+		std::vector<Int16> positions;
+		std::vector<Uint32> uvs;
+		std::vector<Int16> normals;
+		std::vector<Int16> tangents;
+
+		explicit QuantizedVertices(Uint64 vertex_count) : positions(4 * vertex_count), uvs(vertex_count), normals(2 * vertex_count), tangents(2 * vertex_count) {}
+		QuantizedVertexStreams GetStreams()
+		{
+			return QuantizedVertexStreams{ .positions = positions.data(), .uvs = uvs.data(), .normals = normals.data(), .tangents = tangents.data() };
+		}
+	};
+
+	Vector3 RandomDirection(std::mt19937& rng)
+	{
+		std::normal_distribution<Float> distribution(0.0f, 1.0f);
+		Vector3 direction;
+		do
+		{
+			direction = Vector3(distribution(rng), distribution(rng), distribution(rng));
+		} while (direction.LengthSquared() < 1e-6f);
+		direction.Normalize();
+		return direction;
+	}
+
+	SourceVertices MakeSourceVertices(Uint64 vertex_count, Vector3 const& min_corner, Vector3 const& max_corner, Uint32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<Float> unit(0.0f, 1.0f);
+		std::uniform_real_distribution<Float> uv_range(-4.0f, 4.0f);
+
+		SourceVertices source{};
+		for (Uint64 i = 0; i < vertex_count; ++i)
+		{
+			source.positions.push_back(min_corner + (max_corner - min_corner) * Vector3(unit(rng), unit(rng), unit(rng)));
+			source.uvs.push_back(Vector2(uv_range(rng), uv_range(rng)));
+			source.normals.push_back(RandomDirection(rng));
+			Vector3 const tangent = RandomDirection(rng);
+			source.tangents.push_back(Vector4(tangent.x, tangent.y, tangent.z, unit(rng) < 0.5f ? -1.0f : 1.0f));
+		}
+		//the corners are part of the mesh so the box is tight, they are the values that hit the ends of the snorm range
+		source.positions[0] = min_corner;
+		source.positions[1] = max_corner;
+		BoundingBox::CreateFromPoints(source.bounding_box, source.positions.size(), source.positions.data(), sizeof(Vector3));
+		return source;
+	}
+
+	QuantizedVertices Quantize(SourceVertices const& source)
+	{
+		QuantizedVertices quantized(source.positions.size());
+		QuantizeVertices(source.bounding_box, source.positions, source.uvs, source.normals, source.tangents, quantized.GetStreams());
+		return quantized;
+	}
+
+	//rounding to the nearest snorm16 value is off by half a step, the other half covers the float error of moving into and out of the box
+	Bool PositionWithinBound(Float position, Float source_position, Float extent, Float center)
+	{
+		return std::abs(position - source_position) <= extent / 32767.0f + (std::abs(center) + extent) * 1e-6f;
+	}
+	//one step of a half float, the smallest normal half is 2^-14 and below it the steps are 2^-24
+	Bool UVWithinBound(Float uv, Float source_uv)
+	{
+		return std::abs(uv - source_uv) <= std::abs(source_uv) / 1024.0f + 1e-7f;
+	}
+	//a 16 bit octahedral encoding keeps directions within a few thousandths of a degree
+	Bool DirectionWithinBound(Vector3 const& direction, Vector3 const& source_direction)
+	{
+		return direction.Dot(source_direction) >= 0.99999f;
+	}
+}
+
+ADRIA_TEST(VertexQuantization_RoundTripStaysWithinErrorBounds)
+{
+	SourceVertices const source = MakeSourceVertices(4096, Vector3(-120.0f, 3.0f, -0.5f), Vector3(80.0f, 40.0f, 0.25f), 7);
+	QuantizedVertices quantized = Quantize(source);
+	QuantizedVertexStreams const streams = quantized.GetStreams();
+
+	Vector3 const center(source.bounding_box.Center);
+	Vector3 const extents(source.bounding_box.Extents);
+	for (Uint64 i = 0; i < source.positions.size(); ++i)
+	{
+		DequantizedVertex const vertex = DequantizeVertex(source.bounding_box, streams, i);
+		Vector3 const& source_position = source.positions[i];
+		ADRIA_CHECK(PositionWithinBound(vertex.position.x, source_position.x, extents.x, center.x));
+		ADRIA_CHECK(PositionWithinBound(vertex.position.y, source_position.y, extents.y, center.y));
+		ADRIA_CHECK(PositionWithinBound(vertex.position.z, source_position.z, extents.z, center.z));
+
+		ADRIA_CHECK(UVWithinBound(vertex.uv.x, source.uvs[i].x));
+		ADRIA_CHECK(UVWithinBound(vertex.uv.y, source.uvs[i].y));
+
+		ADRIA_CHECK(DirectionWithinBound(vertex.normal, source.normals[i]));
+		Vector4 const& source_tangent = source.tangents[i];
+		ADRIA_CHECK(DirectionWithinBound(Vector3(vertex.tangent.x, vertex.tangent.y, vertex.tangent.z), Vector3(source_tangent.x, source_tangent.y, source_tangent.z)));
+		ADRIA_CHECK_EQ(vertex.tangent.w, source_tangent.w);
+	}
+}
+
+ADRIA_TEST(VertexQuantization_BoxCornersUseTheWholeRange)
+{
+	SourceVertices const source = MakeSourceVertices(16, Vector3(-2.0f, -3.0f, -4.0f), Vector3(6.0f, 5.0f, 4.0f), 11);
+	QuantizedVertices const quantized = Quantize(source);
+
+	for (Uint32 axis = 0; axis < 3; ++axis)
+	{
+		ADRIA_CHECK_EQ(quantized.positions[0 * 4 + axis], -32767);
+		ADRIA_CHECK_EQ(quantized.positions[1 * 4 + axis], 32767);
+	}
+}
+
+ADRIA_TEST(VertexQuantization_FlatMeshesDecodeOntoTheirPlane)
+{
+	//a box without extent along y must not divide by zero, every vertex decodes exactly onto the plane
+	SourceVertices const source = MakeSourceVertices(256, Vector3(-10.0f, 2.5f, -10.0f), Vector3(10.0f, 2.5f, 10.0f), 13);
+	QuantizedVertices quantized = Quantize(source);
+	QuantizedVertexStreams const streams = quantized.GetStreams();
+
+	ADRIA_CHECK_EQ(source.bounding_box.Extents.y, 0.0f);
+	for (Uint64 i = 0; i < source.positions.size(); ++i)
+	{
+		DequantizedVertex const vertex = DequantizeVertex(source.bounding_box, streams, i);
+		ADRIA_CHECK(std::isfinite(vertex.position.x) && std::isfinite(vertex.position.z));
+		ADRIA_CHECK_EQ(vertex.position.y, 2.5f);
+	}
+}